@@ -6,24 +6,45 @@
       "cflags_cc!": ["-fno-exceptions"],
       "sources": [
         "native/AudioSystemWrapper.cpp",
+        "native/RemoteAudioSystemWrapper.cpp",
+        "../audioSystem/src/Host/EngineHostClient.cpp",
+        "../audioSystem/src/Host/SharedMemory.cpp",
         "../audioSystem/src/Core/audioSystem.cpp",
+        "../audioSystem/src/Core/LoadGovernor.cpp",
+        "../audioSystem/src/Core/FlightRecorder.cpp",
+        "../audioSystem/src/Core/EngineController.cpp",
   "../audioSystem/src/Core/audioDevice.cpp",
         "../audioSystem/src/Adapters/AudioSystemAdapter.cpp",
         "../audioSystem/src/Config/ConfigReader.cpp",
         "../audioSystem/src/Effects/IEffect.cpp",
         "../audioSystem/src/Effects/DelayEffect.cpp",
+        "../audioSystem/src/Effects/EffectPool.cpp",
+        "../audioSystem/src/Effects/EffectSlot.cpp",
         "../audioSystem/src/Effects/LowPassEffect.cpp",
         "../audioSystem/src/Effects/OctaveEffect.cpp",
+        "../audioSystem/src/Effects/SpectralEffect.cpp",
+        "../audioSystem/src/Effects/SpectralFreezeEffect.cpp",
+        "../audioSystem/src/Effects/SpectralSmearEffect.cpp",
+        "../audioSystem/src/Effects/TimeStretchEffect.cpp",
+        "../audioSystem/src/Effects/VocoderEffect.cpp",
         "../audioSystem/src/Midi/MidiDevice.cpp",
         "../audioSystem/src/Waves/SineWave.cpp",
         "../audioSystem/src/Waves/SquareWave.cpp",
         "../audioSystem/src/Waves/SawtoothWave.cpp",
         "../audioSystem/src/Waves/TriangleWave.cpp",
         "../audioSystem/src/Envelope/ADSREnvelope.cpp",
+        "../audioSystem/src/Granular/GranularSource.cpp",
+        "../audioSystem/src/Dsp/CpuFeatures.cpp",
+        "../audioSystem/src/Dsp/FFT.cpp",
+        "../audioSystem/src/Dsp/FilterBank.cpp",
+        "../audioSystem/src/Dsp/Dynamics.cpp",
+        "../audioSystem/src/Dsp/SimdKernels.cpp",
+        "../audioSystem/src/Dsp/SampleConverter.cpp",
         "../audioSystem/utilities/subject.cpp",
         "../audioSystem/utilities/threadBase.cpp",
         "../audioSystem/utilities/QueueThread.cpp",
-        "../audioSystem/utilities/TimerFd.cpp"
+        "../audioSystem/utilities/TimerFd.cpp",
+        "../audioSystem/utilities/Trace.cpp"
       ],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
@@ -35,6 +56,8 @@
         "../audioSystem/src/Effects",
         "../audioSystem/src/Waves",
         "../audioSystem/src/Envelope",
+        "../audioSystem/src/Granular",
+        "../audioSystem/src/Dsp",
         "../audioSystem/src/Midi",
         "../audioSystem/utilities",
         "/usr/include/rtaudio",
@@ -58,7 +81,93 @@
               "-lrtaudio",
               "-lrtmidi",
               "-lpthread",
-              "-lxml2"
+              "-lxml2",
+              "-lrt",
+              "-ldl"
+            ]
+          }
+        ]
+      ]
+    },
+    {
+      "target_name": "audioEngineHost",
+      "type": "executable",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "sources": [
+        "../audioSystem/src/Applications/engineHost.cpp",
+        "../audioSystem/src/Host/EngineHost.cpp",
+        "../audioSystem/src/Host/SharedMemory.cpp",
+        "../audioSystem/src/Core/audioSystem.cpp",
+        "../audioSystem/src/Core/LoadGovernor.cpp",
+        "../audioSystem/src/Core/FlightRecorder.cpp",
+        "../audioSystem/src/Core/EngineController.cpp",
+  "../audioSystem/src/Core/audioDevice.cpp",
+        "../audioSystem/src/Adapters/AudioSystemAdapter.cpp",
+        "../audioSystem/src/Config/ConfigReader.cpp",
+        "../audioSystem/src/Effects/IEffect.cpp",
+        "../audioSystem/src/Effects/DelayEffect.cpp",
+        "../audioSystem/src/Effects/EffectPool.cpp",
+        "../audioSystem/src/Effects/EffectSlot.cpp",
+        "../audioSystem/src/Effects/LowPassEffect.cpp",
+        "../audioSystem/src/Effects/OctaveEffect.cpp",
+        "../audioSystem/src/Effects/SpectralEffect.cpp",
+        "../audioSystem/src/Effects/SpectralFreezeEffect.cpp",
+        "../audioSystem/src/Effects/SpectralSmearEffect.cpp",
+        "../audioSystem/src/Effects/TimeStretchEffect.cpp",
+        "../audioSystem/src/Effects/VocoderEffect.cpp",
+        "../audioSystem/src/Midi/MidiDevice.cpp",
+        "../audioSystem/src/Waves/SineWave.cpp",
+        "../audioSystem/src/Waves/SquareWave.cpp",
+        "../audioSystem/src/Waves/SawtoothWave.cpp",
+        "../audioSystem/src/Waves/TriangleWave.cpp",
+        "../audioSystem/src/Envelope/ADSREnvelope.cpp",
+        "../audioSystem/src/Granular/GranularSource.cpp",
+        "../audioSystem/src/Dsp/CpuFeatures.cpp",
+        "../audioSystem/src/Dsp/FFT.cpp",
+        "../audioSystem/src/Dsp/FilterBank.cpp",
+        "../audioSystem/src/Dsp/Dynamics.cpp",
+        "../audioSystem/src/Dsp/SimdKernels.cpp",
+        "../audioSystem/src/Dsp/SampleConverter.cpp",
+        "../audioSystem/utilities/subject.cpp",
+        "../audioSystem/utilities/threadBase.cpp",
+        "../audioSystem/utilities/QueueThread.cpp",
+        "../audioSystem/utilities/TimerFd.cpp",
+        "../audioSystem/utilities/Trace.cpp"
+      ],
+      "include_dirs": [
+        "../audioSystem/src",
+        "../audioSystem/src/Core",
+        "../audioSystem/src/Adapters",
+        "../audioSystem/src/Common",
+        "../audioSystem/src/Config",
+        "../audioSystem/src/Effects",
+        "../audioSystem/src/Waves",
+        "../audioSystem/src/Envelope",
+        "../audioSystem/src/Granular",
+        "../audioSystem/src/Dsp",
+        "../audioSystem/src/Midi",
+        "../audioSystem/utilities",
+        "/usr/include/rtaudio",
+        "/usr/include/rtmidi",
+        "/usr/include/libxml2"
+      ],
+      "defines": [],
+      "cflags_cc": [
+        "-std=c++17",
+        "-frtti",
+        "-fexceptions"
+      ],
+      "conditions": [
+        [
+          "OS=='linux'",
+          {
+            "libraries": [
+              "-lrtaudio",
+              "-lrtmidi",
+              "-lpthread",
+              "-lxml2",
+              "-lrt"
             ]
           }
         ]
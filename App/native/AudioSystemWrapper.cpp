@@ -1,15 +1,46 @@
 #include "AudioSystemWrapper.h"
+#include "RemoteAudioSystemWrapper.h"
 #include "../../audioSystem/src/Core/StereoSampleRingBuffer.h"
-#include "../../audioSystem/src/Waves/SineWave.h"
-#include "../../audioSystem/src/Waves/SquareWave.h"
-#include "../../audioSystem/src/Waves/SawtoothWave.h"
-#include "../../audioSystem/src/Waves/TriangleWave.h"
-#include "../../audioSystem/src/Effects/DelayEffect.h"
-#include "../../audioSystem/src/Effects/LowPassEffect.h"
-#include "../../audioSystem/src/Effects/OctaveEffect.h"
+#include "../../audioSystem/src/Effects/TimeStretchEffect.h"
 #include <algorithm>
 #include <cmath>
-#include <iterator>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace
+{
+/**
+ * @brief Read a render frame (non-negative number) from the first argument
+ */
+bool frameArgument(const Napi::CallbackInfo& info, std::uint64_t& frame)
+{
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        return false;
+    }
+    const double value = info[0].As<Napi::Number>().DoubleValue();
+    if (!std::isfinite(value) || value < 0.0)
+    {
+        return false;
+    }
+    frame = static_cast<std::uint64_t>(value);
+    return true;
+}
+
+/**
+ * @brief JavaScript view of one stage's render cost
+ */
+Napi::Object costObject(Napi::Env env, const StageCost& cost)
+{
+    Napi::Object entry = Napi::Object::New(env);
+    entry.Set("name", Napi::String::New(env, cost.name));
+    entry.Set("last", Napi::Number::New(env, cost.last));
+    entry.Set("average", Napi::Number::New(env, cost.average));
+    entry.Set("peak", Napi::Number::New(env, cost.peak));
+    return entry;
+}
+}
 
 Napi::Object AudioSystemWrapper::Init(Napi::Env env, Napi::Object exports)
 {
@@ -18,6 +49,16 @@ Napi::Object AudioSystemWrapper::Init(Napi::Env env, Napi::Object exports)
         InstanceMethod("stop", &AudioSystemWrapper::Stop),
         InstanceMethod("triggerNote", &AudioSystemWrapper::TriggerNote),
         InstanceMethod("triggerNoteOff", &AudioSystemWrapper::TriggerNoteOff),
+        InstanceMethod("noteOn", &AudioSystemWrapper::NoteOn),
+        InstanceMethod("noteOff", &AudioSystemWrapper::NoteOff),
+        InstanceMethod("noteOnAt", &AudioSystemWrapper::NoteOnAt),
+        InstanceMethod("noteOffAt", &AudioSystemWrapper::NoteOffAt),
+        InstanceMethod("setPitchBendAt", &AudioSystemWrapper::SetPitchBendAt),
+        InstanceMethod("getAudioClock", &AudioSystemWrapper::GetAudioClock),
+        InstanceMethod("getParameterBlock", &AudioSystemWrapper::GetParameterBlock),
+        InstanceMethod("getTelemetry", &AudioSystemWrapper::GetTelemetry),
+        InstanceMethod("setTuningTable", &AudioSystemWrapper::SetTuningTable),
+        InstanceMethod("resetTuning", &AudioSystemWrapper::ResetTuning),
         InstanceMethod("resetEffects", &AudioSystemWrapper::ResetEffects),
         InstanceMethod("clearEffects", &AudioSystemWrapper::ClearEffects),
         InstanceMethod("updateADSRParameters", &AudioSystemWrapper::UpdateADSRParameters),
@@ -26,12 +67,33 @@ Napi::Object AudioSystemWrapper::Init(Napi::Env env, Napi::Object exports)
         InstanceMethod("addLowPassEffect", &AudioSystemWrapper::AddLowPassEffect),
         InstanceMethod("setLowPassCutoff", &AudioSystemWrapper::SetLowPassCutoff),
         InstanceMethod("getLowPassCutoff", &AudioSystemWrapper::GetLowPassCutoff),
+        InstanceMethod("setMemoryBudget", &AudioSystemWrapper::SetMemoryBudget),
         InstanceMethod("addOctaveEffect", &AudioSystemWrapper::AddOctaveEffect),
     InstanceMethod("setDriftParameters", &AudioSystemWrapper::SetDriftParameters),
     InstanceMethod("getMidiStatus", &AudioSystemWrapper::GetMidiStatus),
     InstanceMethod("getRecentWaveform", &AudioSystemWrapper::GetRecentWaveform),
     InstanceMethod("configureSecondaryOscillator", &AudioSystemWrapper::ConfigureSecondaryOscillator),
-    InstanceMethod("setPitchBend", &AudioSystemWrapper::SetPitchBend)
+    InstanceMethod("setPitchBend", &AudioSystemWrapper::SetPitchBend),
+    InstanceMethod("setGranularEnabled", &AudioSystemWrapper::SetGranularEnabled),
+    InstanceMethod("loadGranularSample", &AudioSystemWrapper::LoadGranularSample),
+    InstanceMethod("configureGranular", &AudioSystemWrapper::ConfigureGranular),
+    InstanceMethod("addSpectralFreezeEffect", &AudioSystemWrapper::AddSpectralFreezeEffect),
+    InstanceMethod("setSpectralFreeze", &AudioSystemWrapper::SetSpectralFreeze),
+    InstanceMethod("addSpectralSmearEffect", &AudioSystemWrapper::AddSpectralSmearEffect),
+    InstanceMethod("addTimeStretchEffect", &AudioSystemWrapper::AddTimeStretchEffect),
+    InstanceMethod("loadTimeStretchSample", &AudioSystemWrapper::LoadTimeStretchSample),
+    InstanceMethod("triggerTimeStretch", &AudioSystemWrapper::TriggerTimeStretch),
+    InstanceMethod("stopTimeStretch", &AudioSystemWrapper::StopTimeStretch),
+    InstanceMethod("addVocoderEffect", &AudioSystemWrapper::AddVocoderEffect),
+    InstanceMethod("loadVocoderModulator", &AudioSystemWrapper::LoadVocoderModulator),
+    InstanceMethod("setLiveInputMode", &AudioSystemWrapper::SetLiveInputMode),
+    InstanceMethod("setVocoderModulatorSource", &AudioSystemWrapper::SetVocoderModulatorSource),
+    InstanceMethod("setGranularBufferMode", &AudioSystemWrapper::SetGranularBufferMode),
+    InstanceMethod("isFullDuplex", &AudioSystemWrapper::IsFullDuplex),
+    InstanceMethod("configureCompressor", &AudioSystemWrapper::ConfigureCompressor),
+    InstanceMethod("configureLimiter", &AudioSystemWrapper::ConfigureLimiter),
+    InstanceMethod("getMasterLatency", &AudioSystemWrapper::GetMasterLatency),
+    InstanceMethod("setEffectBypass", &AudioSystemWrapper::SetEffectBypass)
     });
 
     Napi::FunctionReference* constructor = new Napi::FunctionReference();
@@ -45,7 +107,7 @@ Napi::Object AudioSystemWrapper::Init(Napi::Env env, Napi::Object exports)
 AudioSystemWrapper::AudioSystemWrapper(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<AudioSystemWrapper>(info),
       m_sampleRate(44100.0f),
-      m_currentFrequency(0.0f)
+      m_bufferFrames(512)
 {
     Napi::Env env = info.Env();
 
@@ -63,54 +125,39 @@ AudioSystemWrapper::AudioSystemWrapper(const Napi::CallbackInfo& info)
     {
         bufferFrames = info[1].As<Napi::Number>().Uint32Value();
     }
+    m_bufferFrames = bufferFrames;
+
+    bool fullDuplex = false;
+    if (info.Length() >= 3 && info[2].IsBoolean())
+    {
+        fullDuplex = info[2].As<Napi::Boolean>().Value();
+    }
+
+    EffectPool::Limits poolLimits = EffectPool::defaultLimits();
+    if (info.Length() >= 4 && !ReadEffectPoolLimits(env, info[3], poolLimits))
+    {
+        return;
+    }
+
     m_waveformBuffer = std::make_unique<StereoSampleRingBuffer>(
         static_cast<std::size_t>(std::max(2048.0f, m_sampleRate * 0.5f)));
     m_audioSystem = std::make_unique<AudioSystem>(m_sampleRate);
     m_audioSystem->setWaveformTapBuffer(m_waveformBuffer.get());
-    m_audioDevice = std::make_unique<AudioDevice>(m_audioSystem.get(), m_sampleRate, bufferFrames);
-    
-    // Initialize MIDI device and adapter
-    try {
-        // Create a temporary MidiDevice to list ports
-        RtMidiIn tempMidi;
-        unsigned int nPorts = tempMidi.getPortCount();
-        
-        int selectedPort = 0; // Default to first port
-        bool foundHardware = false;
-        
-        std::cout << "Scanning for MIDI devices..." << std::endl;
-        for (unsigned int i = 0; i < nPorts; i++) {
-            std::string portName = tempMidi.getPortName(i);
-            std::cout << "  Port " << i << ": " << portName << std::endl;
-            
-            // Skip "Midi Through", "Announce", "Timer", and PipeWire virtual ports
-            if (!foundHardware && 
-                portName.find("Midi Through") == std::string::npos &&
-                portName.find("Announce") == std::string::npos &&
-                portName.find("Timer") == std::string::npos &&
-                portName.find("PipeWire") == std::string::npos) {
-                selectedPort = i;
-                foundHardware = true;
-                std::cout << "  -> Selected hardware MIDI controller: " << portName << std::endl;
-            }
-        }
-        
-        if (nPorts > 0) {
-            m_midiDevice = std::make_unique<MidiDevice>(selectedPort);
-            m_midiDeviceName = tempMidi.getPortName(selectedPort);
-            m_adapter = std::make_unique<AudioSystemAdapter>(m_audioSystem.get());
-            m_midiDevice->attach(m_adapter.get());
-            m_midiDevice->start();
-            std::cout << "MIDI device ready!" << std::endl;
-        } else {
-            m_midiDeviceName = "";
-            std::cout << "No MIDI ports found - keyboard/mouse input will still work" << std::endl;
-        }
-    } catch (const std::exception& e) {
-        m_midiDeviceName = "";
-        std::cerr << "Warning: Failed to initialize MIDI: " << e.what() << std::endl;
-        std::cerr << "Continuing without MIDI support (keyboard/mouse input will still work)" << std::endl;
-    }
+
+    // V8 owns the block memory (external buffers are not allowed in Electron),
+    // kept alive by the reference for as long as the device may render
+    Napi::ArrayBuffer parameterBuffer = Napi::ArrayBuffer::New(env, ParameterBlock::kBytes);
+    m_parameterBuffer = Napi::Persistent(parameterBuffer);
+    m_parameterBlock = std::make_unique<ParameterBlock>(parameterBuffer.Data());
+    m_audioSystem->setParameterBlock(m_parameterBlock.get());
+
+    // Builds every insertable effect now so add*Effect() never allocates on the UI path
+    m_controller = std::make_unique<EngineController>(*m_audioSystem, m_sampleRate, bufferFrames, poolLimits);
+    m_audioDevice = std::make_unique<AudioDevice>(m_audioSystem.get(), m_sampleRate, bufferFrames, fullDuplex);
+    m_xrunDumper = FlightRecorderDumper::fromEnvironment(m_audioDevice->flightRecorder(), 10.0);
+
+    // Keyboard and mouse input keep working without MIDI
+    m_controller->openMidiInput();
 }
 
 AudioSystemWrapper::~AudioSystemWrapper()
@@ -118,10 +165,11 @@ AudioSystemWrapper::~AudioSystemWrapper()
     if (m_audioSystem)
     {
         m_audioSystem->setWaveformTapBuffer(nullptr);
+        m_audioSystem->setParameterBlock(nullptr);
     }
-    if (m_midiDevice)
+    if (m_controller)
     {
-        m_midiDevice->stop();
+        m_controller->closeMidiInput();
     }
     if (m_audioDevice)
     {
@@ -150,8 +198,7 @@ Napi::Value AudioSystemWrapper::Stop(const Napi::CallbackInfo& info)
 {
     Napi::Env env = info.Env();
     m_audioDevice->stop();
-    m_activeFrequencies.clear();
-    m_currentFrequency = 0.0f;
+    m_controller->forgetCurrentNote();
     return env.Undefined();
 }
 
@@ -166,9 +213,7 @@ Napi::Value AudioSystemWrapper::TriggerNote(const Napi::CallbackInfo& info)
         return env.Null();
     }
 
-    m_currentFrequency = info[0].As<Napi::Number>().FloatValue();
-    m_audioSystem->triggerNote(m_currentFrequency);
-    m_activeFrequencies.push_back(m_currentFrequency);
+    m_controller->triggerNote(info[0].As<Napi::Number>().FloatValue());
 
     return env.Undefined();
 }
@@ -176,39 +221,310 @@ Napi::Value AudioSystemWrapper::TriggerNote(const Napi::CallbackInfo& info)
 Napi::Value AudioSystemWrapper::TriggerNoteOff(const Napi::CallbackInfo& info)
 {
     Napi::Env env = info.Env();
-    float frequency = std::numeric_limits<float>::quiet_NaN();
 
-    if (info.Length() >= 1 && info[0].IsNumber())
+    // Without a frequency every note is released
+    const bool single = info.Length() >= 1 && info[0].IsNumber();
+    m_controller->triggerNoteOff(single ? info[0].As<Napi::Number>().FloatValue() : 0.0f);
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::NoteOn(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for MIDI note")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const int note = info[0].As<Napi::Number>().Int32Value();
+    const float velocity = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().FloatValue() : 1.0f;
+    const int channel = (info.Length() >= 3 && info[2].IsNumber()) ? info[2].As<Napi::Number>().Int32Value() : 0;
+
+    m_controller->noteOnAt(0U, note, velocity, channel);
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::NoteOff(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        m_controller->triggerNoteOff(0.0f);
+        return env.Undefined();
+    }
+
+    const int note = info[0].As<Napi::Number>().Int32Value();
+    const int channel = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().Int32Value() : 0;
+    m_controller->noteOffAt(0U, note, channel);
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::NoteOnAt(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    std::uint64_t frame = 0;
+    if (!frameArgument(info, frame) || info.Length() < 2 || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Frame and MIDI note expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const int note = info[1].As<Napi::Number>().Int32Value();
+    const float velocity = (info.Length() >= 3 && info[2].IsNumber()) ? info[2].As<Napi::Number>().FloatValue() : 1.0f;
+    const int channel = (info.Length() >= 4 && info[3].IsNumber()) ? info[3].As<Napi::Number>().Int32Value() : 0;
+
+    m_controller->noteOnAt(frame, note, velocity, channel);
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::NoteOffAt(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    std::uint64_t frame = 0;
+    if (!frameArgument(info, frame) || info.Length() < 2 || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Frame and MIDI note expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const int note = info[1].As<Napi::Number>().Int32Value();
+    const int channel = (info.Length() >= 3 && info[2].IsNumber()) ? info[2].As<Napi::Number>().Int32Value() : 0;
+    m_controller->noteOffAt(frame, note, channel);
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::SetPitchBendAt(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    std::uint64_t frame = 0;
+    if (!frameArgument(info, frame) || info.Length() < 2 || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Frame and pitch bend value expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_audioSystem->setPitchBendAt(frame, info[1].As<Napi::Number>().Int32Value());
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::GetAudioClock(const Napi::CallbackInfo& info)
+{
+    return ClockObject(info.Env(), m_audioSystem->audioClock(), m_bufferFrames);
+}
+
+Napi::Value AudioSystemWrapper::GetParameterBlock(const Napi::CallbackInfo& info)
+{
+    return ParameterBlockObject(info.Env(), m_parameterBuffer.Value());
+}
+
+Napi::Value AudioSystemWrapper::GetTelemetry(const Napi::CallbackInfo& info)
+{
+    return TelemetryObject(info.Env(), m_audioSystem->telemetry());
+}
+
+Napi::Object AudioSystemWrapper::ClockObject(Napi::Env env, const AudioClockSnapshot& clock, unsigned int bufferFrames)
+{
+    const std::int64_t now = AudioClock::hostTimeNanos();
+
+    // Host times are steady_clock milliseconds, comparable between calls only
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frame", Napi::Number::New(env, static_cast<double>(clock.frame)));
+    result.Set("hostTimeMs", Napi::Number::New(env, static_cast<double>(clock.hostTimeNanos) * 1.0e-6));
+    result.Set("nowMs", Napi::Number::New(env, static_cast<double>(now) * 1.0e-6));
+    result.Set("currentFrame", Napi::Number::New(env, static_cast<double>(clock.frameAt(now))));
+    result.Set("sampleRate", Napi::Number::New(env, clock.sampleRate));
+    result.Set("bufferFrames", Napi::Number::New(env, bufferFrames));
+    return result;
+}
+
+bool AudioSystemWrapper::ReadEffectPoolLimits(Napi::Env env, Napi::Value value, EffectPool::Limits& limits)
+{
+    if (value.IsUndefined())
     {
-        frequency = info[0].As<Napi::Number>().FloatValue();
+        return true;
     }
-    else if (!m_activeFrequencies.empty())
+    if (!value.IsObject())
     {
-        frequency = m_activeFrequencies.back();
+        Napi::TypeError::New(env, "Object expected for effect pool limits").ThrowAsJavaScriptException();
+        return false;
     }
 
-    if (!std::isnan(frequency))
+    const Napi::Object object = value.As<Napi::Object>();
+    const std::pair<const char*, std::size_t*> counts[] = {
+        {"delay", &limits.delay},
+        {"lowPass", &limits.lowPass},
+        {"octave", &limits.octave},
+        {"spectralFreeze", &limits.spectralFreeze},
+        {"spectralSmear", &limits.spectralSmear},
+    };
+    for (const auto& count : counts)
     {
-        auto matcher = [frequency](float active)
+        if (!object.Has(count.first))
         {
-            return std::fabs(active - frequency) < 1e-3f;
-        };
-        auto it = std::find_if(m_activeFrequencies.rbegin(), m_activeFrequencies.rend(), matcher);
-        if (it != m_activeFrequencies.rend())
+            continue;
+        }
+        const Napi::Value entry = object.Get(count.first);
+        const double number = entry.IsNumber() ? entry.As<Napi::Number>().DoubleValue() : -1.0;
+        if (!(number >= 0.0 && number <= static_cast<double>(EffectPool::kMaxInstances)))
         {
-            m_activeFrequencies.erase(std::next(it).base());
+            Napi::TypeError::New(env, std::string("Effect pool limit ") + count.first + " must be a number from 0 to "
+                                      + std::to_string(EffectPool::kMaxInstances))
+                .ThrowAsJavaScriptException();
+            return false;
         }
+        *count.second = static_cast<std::size_t>(number);
+    }
+    return true;
+}
+
+Napi::Object AudioSystemWrapper::ParameterBlockObject(Napi::Env env, Napi::ArrayBuffer buffer)
+{
+    // Word indices into an Int32Array over the buffer; see ParameterBlock.h
+    Napi::Object parameters = Napi::Object::New(env);
+    parameters.Set("pitchBendCents", Napi::Number::New(env, ParameterBlock::index(ParameterBlock::Id::PitchBendCents)));
+    parameters.Set("lowPassCutoffHz", Napi::Number::New(env, ParameterBlock::index(ParameterBlock::Id::LowPassCutoffHz)));
+    parameters.Set("secondaryMix", Napi::Number::New(env, ParameterBlock::index(ParameterBlock::Id::SecondaryMix)));
+    parameters.Set("secondaryDetuneCents", Napi::Number::New(env, ParameterBlock::index(ParameterBlock::Id::SecondaryDetuneCents)));
+    parameters.Set("driftRateHz", Napi::Number::New(env, ParameterBlock::index(ParameterBlock::Id::DriftRateHz)));
+    parameters.Set("driftAmountCents", Napi::Number::New(env, ParameterBlock::index(ParameterBlock::Id::DriftAmountCents)));
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("buffer", buffer);
+    result.Set("version", Napi::Number::New(env, ParameterBlock::kVersion));
+    result.Set("dirtyWord", Napi::Number::New(env, ParameterBlock::kDirtyWord));
+    result.Set("firstValueWord", Napi::Number::New(env, ParameterBlock::kFirstValueWord));
+    result.Set("parameters", parameters);
+    return result;
+}
+
+Napi::Object AudioSystemWrapper::TelemetryObject(Napi::Env env, const EngineTelemetry& state)
+{
+    static const char* const kStageNames[] = {"idle", "attack", "decay", "sustain", "release"};
+
+    Napi::Array voices = Napi::Array::New(env, EngineTelemetry::kMaxVoices);
+    for (uint32_t i = 0; i < EngineTelemetry::kMaxVoices; ++i)
+    {
+        const VoiceTelemetry& voice = state.voices[i];
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("note", Napi::Number::New(env, voice.note));
+        entry.Set("channel", Napi::Number::New(env, voice.channel));
+        entry.Set("frequency", Napi::Number::New(env, voice.frequency));
+        entry.Set("velocity", Napi::Number::New(env, voice.velocity));
+        entry.Set("stage", Napi::String::New(env, kStageNames[static_cast<std::size_t>(voice.stage)]));
+        entry.Set("envelopeLevel", Napi::Number::New(env, voice.envelopeLevel));
+        voices.Set(i, entry);
+    }
+
+    Napi::Array peak = Napi::Array::New(env, 2);
+    Napi::Array rms = Napi::Array::New(env, 2);
+    for (uint32_t channel = 0; channel < 2U; ++channel)
+    {
+        peak.Set(channel, Napi::Number::New(env, state.peak[channel]));
+        rms.Set(channel, Napi::Number::New(env, state.rms[channel]));
+    }
+
+    const uint32_t effects = std::min<uint32_t>(state.effects, EngineTelemetry::kMaxEffects);
+    Napi::Array effectCosts = Napi::Array::New(env, effects);
+    for (uint32_t i = 0; i < effects; ++i)
+    {
+        effectCosts.Set(i, costObject(env, state.effectCosts[i]));
     }
-    else
+    Napi::Object cost = Napi::Object::New(env);
+    cost.Set("voice", costObject(env, state.voiceCost));
+    cost.Set("masterBus", costObject(env, state.masterCost));
+    cost.Set("effects", effectCosts);
+
+    Napi::Object actions = Napi::Object::New(env);
+    for (uint32_t i = 0; i < GovernorTelemetry::kActions; ++i)
+    {
+        Napi::Object action = Napi::Object::New(env);
+        action.Set("shed", Napi::Number::New(env, state.governor.shed[i]));
+        action.Set("restored", Napi::Number::New(env, state.governor.restored[i]));
+        actions.Set(LoadGovernor::actionName(static_cast<LoadGovernor::Action>(i)), action);
+    }
+    Napi::Object governor = Napi::Object::New(env);
+    governor.Set("level", Napi::Number::New(env, state.governor.level));
+    governor.Set("steps", Napi::Number::New(env, state.governor.steps));
+    governor.Set("overruns", Napi::Number::New(env, state.governor.overruns));
+    governor.Set("stolenGrains", Napi::Number::New(env, static_cast<double>(state.governor.stolenGrains)));
+    governor.Set("actions", actions);
+
+    const uint32_t memoryEffects = std::min<uint32_t>(state.effects, MemoryTelemetry::kMaxEffects);
+    Napi::Array effectBytes = Napi::Array::New(env, memoryEffects);
+    for (uint32_t i = 0; i < memoryEffects; ++i)
+    {
+        effectBytes.Set(i, Napi::Number::New(env, static_cast<double>(state.memory.effectBytes[i])));
+    }
+    Napi::Object memory = Napi::Object::New(env);
+    memory.Set("effects", Napi::Number::New(env, static_cast<double>(state.memory.effects)));
+    memory.Set("voices", Napi::Number::New(env, static_cast<double>(state.memory.voices)));
+    memory.Set("rings", Napi::Number::New(env, static_cast<double>(state.memory.rings)));
+    memory.Set("tables", Napi::Number::New(env, static_cast<double>(state.memory.tables)));
+    memory.Set("master", Napi::Number::New(env, static_cast<double>(state.memory.master)));
+    memory.Set("total", Napi::Number::New(env, static_cast<double>(state.memory.total)));
+    memory.Set("budget", Napi::Number::New(env, static_cast<double>(state.memory.budget)));
+    memory.Set("rejectedEffects", Napi::Number::New(env, state.memory.rejectedEffects));
+    memory.Set("effectBytes", effectBytes);
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frame", Napi::Number::New(env, static_cast<double>(state.frame)));
+    result.Set("blockFrames", Napi::Number::New(env, state.blockFrames));
+    result.Set("heldNotes", Napi::Number::New(env, state.heldNotes));
+    result.Set("activeVoices", Napi::Number::New(env, state.activeVoices));
+    result.Set("voices", voices);
+    result.Set("pitchBendCents", Napi::Number::New(env, state.pitchBendCents));
+    result.Set("lowPassCutoffHz", Napi::Number::New(env, state.lowPassCutoffHz));
+    result.Set("effects", Napi::Number::New(env, state.effects));
+    result.Set("peak", peak);
+    result.Set("rms", rms);
+    result.Set("gainReductionDb", Napi::Number::New(env, state.gainReductionDb));
+    result.Set("cpuLoad", Napi::Number::New(env, state.cpuLoad));
+    result.Set("cost", cost);
+    result.Set("governor", governor);
+    result.Set("memory", memory);
+    result.Set("pendingEvents", Napi::Number::New(env, state.pendingEvents));
+    result.Set("droppedCommands", Napi::Number::New(env, static_cast<double>(state.droppedCommands)));
+    return result;
+}
+
+Napi::Value AudioSystemWrapper::SetTuningTable(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray())
     {
-        m_activeFrequencies.clear();
+        Napi::TypeError::New(env, "Array of 128 frequencies expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
     }
 
-    m_audioSystem->triggerNoteOff(frequency);
-    if (m_activeFrequencies.empty())
+    Napi::Array values = info[0].As<Napi::Array>();
+    std::array<float, AudioSystem::kMidiNotes> table{};
+    for (uint32_t i = 0; i < table.size() && i < values.Length(); ++i)
     {
-        m_currentFrequency = 0.0f;
+        Napi::Value value = values.Get(i);
+        table[i] = value.IsNumber() ? value.As<Napi::Number>().FloatValue() : 0.0f;
     }
+
+    // Missing or invalid entries keep their equal-tempered value
+    m_audioSystem->setTuningTable(table);
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::ResetTuning(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+    m_audioSystem->resetTuning();
     return env.Undefined();
 }
 
@@ -259,33 +575,12 @@ Napi::Value AudioSystemWrapper::SetWaveform(const Napi::CallbackInfo& info)
         return env.Null();
     }
 
-    std::string waveformType = info[0].As<Napi::String>().Utf8Value();
-    std::shared_ptr<IWave> waveform;
-
-    if (waveformType == "sine")
-    {
-        waveform = std::make_shared<SineWave>();
-    }
-    else if (waveformType == "square")
-    {
-        waveform = std::make_shared<SquareWave>();
-    }
-    else if (waveformType == "saw")
-    {
-        waveform = std::make_shared<SawtoothWave>();
-    }
-    else if (waveformType == "triangle")
-    {
-        waveform = std::make_shared<TriangleWave>();
-    }
-    else
+    if (!m_controller->setWaveform(info[0].As<Napi::String>().Utf8Value()))
     {
         Napi::TypeError::New(env, "Unknown waveform type. Use: sine, square, saw, or triangle")
             .ThrowAsJavaScriptException();
         return env.Null();
     }
-
-    m_audioSystem->setWaveform(waveform);
     return env.Undefined();
 }
 
@@ -304,8 +599,7 @@ Napi::Value AudioSystemWrapper::AddDelayEffect(const Napi::CallbackInfo& info)
     float feedback = info[1].As<Napi::Number>().FloatValue();
     float mix = info[2].As<Napi::Number>().FloatValue();
     
-    auto effect = std::make_shared<DelayEffect>(delayTime, feedback, mix, m_sampleRate);
-    m_audioSystem->addEffect(effect);
+    m_controller->addDelay(delayTime, feedback, mix);
 
     return env.Undefined();
 }
@@ -348,8 +642,7 @@ Napi::Value AudioSystemWrapper::AddLowPassEffect(const Napi::CallbackInfo& info)
         mix = info[2].As<Napi::Number>().FloatValue();
     }
     
-    auto effect = std::make_shared<LowPassEffect>(cutoff, m_sampleRate, resonance, mix);
-    m_audioSystem->addEffect(effect);
+    m_controller->addLowPass(cutoff, resonance, mix);
 
     return env.Undefined();
 }
@@ -378,6 +671,23 @@ Napi::Value AudioSystemWrapper::GetLowPassCutoff(const Napi::CallbackInfo& info)
     return Napi::Number::New(env, cutoff);
 }
 
+Napi::Value AudioSystemWrapper::SetMemoryBudget(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for memory budget (MB)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const double megabytes = std::max(info[0].As<Napi::Number>().DoubleValue(), 0.0);
+    m_audioSystem->setMemoryBudget(static_cast<std::size_t>(megabytes * 1024.0 * 1024.0));
+
+    return env.Undefined();
+}
+
 Napi::Value AudioSystemWrapper::AddOctaveEffect(const Napi::CallbackInfo& info)
 {
     Napi::Env env = info.Env();
@@ -392,15 +702,7 @@ Napi::Value AudioSystemWrapper::AddOctaveEffect(const Napi::CallbackInfo& info)
     bool higher = info[0].As<Napi::Boolean>().Value();
     float blend = info[1].As<Napi::Number>().FloatValue();
     
-    auto effect = std::make_shared<OctaveEffect>(higher, blend);
-    
-    // Initialize the octave effect with current frequency and sample rate
-    effect->setSampleRate(m_sampleRate);
-    if (m_currentFrequency > 0.0f) {
-        effect->setFrequency(m_currentFrequency);
-    }
-    
-    m_audioSystem->addEffect(effect);
+    m_controller->addOctave(higher, blend);
 
     return env.Undefined();
 }
@@ -430,8 +732,8 @@ Napi::Value AudioSystemWrapper::GetMidiStatus(const Napi::CallbackInfo& info)
     Napi::Env env = info.Env();
     Napi::Object result = Napi::Object::New(env);
     
-    result.Set("connected", Napi::Boolean::New(env, m_midiDevice != nullptr));
-    result.Set("deviceName", Napi::String::New(env, m_midiDeviceName));
+    result.Set("connected", Napi::Boolean::New(env, m_controller->midiConnected()));
+    result.Set("deviceName", Napi::String::New(env, m_controller->midiDeviceName()));
     
     return result;
 }
@@ -521,10 +823,368 @@ Napi::Value AudioSystemWrapper::SetPitchBend(const Napi::CallbackInfo& info)
     return env.Undefined();
 }
 
+Napi::Value AudioSystemWrapper::SetGranularEnabled(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Boolean expected for granular enabled flag")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const bool enabled = info[0].As<Napi::Boolean>().Value();
+    m_controller->setGranularEnabled(enabled);
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::LoadGranularSample(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: samples:Float32Array, sampleRate:number, rootFrequency?:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Float32Array samples = info[0].As<Napi::Float32Array>();
+    const float sourceRate = info[1].As<Napi::Number>().FloatValue();
+    float rootFrequency = 261.625565f;
+    if (info.Length() >= 3 && info[2].IsNumber())
+    {
+        rootFrequency = info[2].As<Napi::Number>().FloatValue();
+    }
+
+    const float* data = samples.Data();
+    std::vector<float> buffer(data, data + samples.ElementLength());
+    m_controller->loadGranularSample(buffer, sourceRate, rootFrequency);
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::ConfigureGranular(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 6 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber() ||
+        !info[3].IsNumber() || !info[4].IsNumber() || !info[5].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: density:number, grainMs:number, position:number, positionSpread:number, pitchSpreadCents:number, panSpread:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_controller->configureGranular(info[0].As<Napi::Number>().FloatValue(), info[1].As<Napi::Number>().FloatValue(),
+                                    info[2].As<Napi::Number>().FloatValue(), info[3].As<Napi::Number>().FloatValue(),
+                                    info[4].As<Napi::Number>().FloatValue(), info[5].As<Napi::Number>().FloatValue());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::AddSpectralFreezeEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    float mix = 1.0f;
+    if (info.Length() >= 1)
+    {
+        if (!info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Mix must be a number")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        mix = info[0].As<Napi::Number>().FloatValue();
+    }
+
+    m_controller->addSpectralFreeze(mix);
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::SetSpectralFreeze(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Boolean expected for freeze flag")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const bool found = m_audioSystem->setSpectralFreeze(info[0].As<Napi::Boolean>().Value());
+    return Napi::Boolean::New(env, found);
+}
+
+Napi::Value AudioSystemWrapper::AddSpectralSmearEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: amount:number, mix?:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const float amount = info[0].As<Napi::Number>().FloatValue();
+    float mix = 1.0f;
+    if (info.Length() >= 2 && info[1].IsNumber())
+    {
+        mix = info[1].As<Napi::Number>().FloatValue();
+    }
+
+    m_controller->addSpectralSmear(amount, mix);
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::AddTimeStretchEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: speed:number, gain?:number, loop?:boolean")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() >= 2 && info[1].IsNumber())
+    {
+        m_controller->timeStretch().setGain(info[1].As<Napi::Number>().FloatValue());
+    }
+    if (info.Length() >= 3 && info[2].IsBoolean())
+    {
+        m_controller->timeStretch().setLooping(info[2].As<Napi::Boolean>().Value());
+    }
+    m_controller->addTimeStretch(info[0].As<Napi::Number>().FloatValue());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::LoadTimeStretchSample(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: samples:Float32Array, sampleRate:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Float32Array samples = info[0].As<Napi::Float32Array>();
+    const float sourceRate = info[1].As<Napi::Number>().FloatValue();
+
+    const float* data = samples.Data();
+    std::vector<float> buffer(data, data + samples.ElementLength());
+    m_controller->loadTimeStretchSample(buffer, sourceRate);
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::TriggerTimeStretch(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+    m_controller->timeStretch().trigger();
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::StopTimeStretch(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+    m_controller->timeStretch().stopPlayback();
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::AddVocoderEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: bands:number, mix:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_controller->addVocoder(info[0].As<Napi::Number>().Uint32Value(), info[1].As<Napi::Number>().FloatValue());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::LoadVocoderModulator(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: samples:Float32Array, sampleRate:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Float32Array samples = info[0].As<Napi::Float32Array>();
+    const float sourceRate = info[1].As<Napi::Number>().FloatValue();
+
+    const float* data = samples.Data();
+    std::vector<float> buffer(data, data + samples.ElementLength());
+    m_controller->loadVocoderModulator(buffer, sourceRate);
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::SetLiveInputMode(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Expected arguments: mode:string, gain?:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    float gain = 1.0f;
+    if (info.Length() >= 2 && info[1].IsNumber())
+    {
+        gain = info[1].As<Napi::Number>().FloatValue();
+    }
+
+    const std::string mode = info[0].As<Napi::String>().Utf8Value();
+    m_audioSystem->setLiveInputMode(AudioSystem::liveInputModeFromString(mode), gain);
+
+    // Input is only delivered when the device was opened full duplex
+    return Napi::Boolean::New(env, m_audioDevice->isFullDuplex());
+}
+
+Napi::Value AudioSystemWrapper::SetVocoderModulatorSource(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Expected argument: source:'sample'|'live'")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_controller->setVocoderModulatorSource(info[0].As<Napi::String>().Utf8Value());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::SetGranularBufferMode(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Expected argument: mode:'sample'|'live'")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_controller->setGranularBufferMode(info[0].As<Napi::String>().Utf8Value());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::IsFullDuplex(const Napi::CallbackInfo& info)
+{
+    return Napi::Boolean::New(info.Env(), m_audioDevice->isFullDuplex());
+}
+
+Napi::Value AudioSystemWrapper::ConfigureCompressor(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 6 || !info[0].IsBoolean() || !info[1].IsNumber() || !info[2].IsNumber() ||
+        !info[3].IsNumber() || !info[4].IsNumber() || !info[5].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: enabled:boolean, thresholdDb:number, ratio:number, attackMs:number, releaseMs:number, makeupDb:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_audioSystem->configureCompressor(
+        info[0].As<Napi::Boolean>().Value(),
+        info[1].As<Napi::Number>().FloatValue(),
+        info[2].As<Napi::Number>().FloatValue(),
+        info[3].As<Napi::Number>().FloatValue(),
+        info[4].As<Napi::Number>().FloatValue(),
+        info[5].As<Napi::Number>().FloatValue());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::ConfigureLimiter(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsBoolean() || !info[1].IsNumber() || !info[2].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: enabled:boolean, ceilingDb:number, releaseMs:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    m_audioSystem->configureLimiter(
+        info[0].As<Napi::Boolean>().Value(),
+        info[1].As<Napi::Number>().FloatValue(),
+        info[2].As<Napi::Number>().FloatValue());
+
+    return env.Undefined();
+}
+
+Napi::Value AudioSystemWrapper::GetMasterLatency(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    const unsigned int frames = m_audioSystem->masterLatencyFrames();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frames", Napi::Number::New(env, frames));
+    result.Set("milliseconds", Napi::Number::New(env, 1000.0 * frames / m_sampleRate));
+    result.Set("gainReductionDb", Napi::Number::New(env, m_audioSystem->masterGainReductionDb()));
+    return result;
+}
+
+Napi::Value AudioSystemWrapper::SetEffectBypass(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Expected arguments: effect:string, bypassed:boolean, keepWarm?:boolean")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    bool keepWarm = false;
+    if (info.Length() >= 3 && info[2].IsBoolean())
+    {
+        keepWarm = info[2].As<Napi::Boolean>().Value();
+    }
+
+    const bool found = m_audioSystem->setEffectBypass(
+        info[0].As<Napi::String>().Utf8Value(),
+        info[1].As<Napi::Boolean>().Value(),
+        keepWarm);
+
+    return Napi::Boolean::New(env, found);
+}
+
 // Module initialization
 Napi::Object InitAll(Napi::Env env, Napi::Object exports)
 {
-    return AudioSystemWrapper::Init(env, exports);
+    AudioSystemWrapper::Init(env, exports);
+    return RemoteAudioSystemWrapper::Init(env, exports);
 }
 
 NODE_API_MODULE(audioSystemNative, InitAll)
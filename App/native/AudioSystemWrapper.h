@@ -6,8 +6,8 @@
 #include <limits>
 #include "../../audioSystem/src/Core/audioSystem.h"
 #include "../../audioSystem/src/Core/audioDevice.h"
-#include "../../audioSystem/src/Midi/MidiDevice.h"
-#include "../../audioSystem/src/Adapters/AudioSystemAdapter.h"
+#include "../../audioSystem/src/Core/EngineController.h"
+#include "../../audioSystem/src/Effects/EffectPool.h"
 
 class StereoSampleRingBuffer;
 
@@ -31,7 +31,9 @@ public:
 
     /**
      * @brief Constructor
-     * @param info Callback info containing the sample rate and buffer size
+     * @param info Callback info containing the sample rate, buffer size,
+     *             optional full-duplex flag (opens the default input device) and
+     *             optional effect pool limits (see ReadEffectPoolLimits())
      */
     AudioSystemWrapper(const Napi::CallbackInfo& info);
 
@@ -40,22 +42,50 @@ public:
      */
     ~AudioSystemWrapper();
 
+    /// JavaScript view of an audio clock snapshot (getAudioClock())
+    static Napi::Object ClockObject(Napi::Env env, const AudioClockSnapshot& clock, unsigned int bufferFrames);
+
+    /// JavaScript description of a parameter block held in buffer (getParameterBlock())
+    static Napi::Object ParameterBlockObject(Napi::Env env, Napi::ArrayBuffer buffer);
+
+    /// JavaScript view of an engine telemetry snapshot (getTelemetry())
+    static Napi::Object TelemetryObject(Napi::Env env, const EngineTelemetry& state);
+
+    /**
+     * @brief Read effect pool limits from a constructor option
+     * @param value undefined, or an object with optional delay, lowPass, octave,
+     *              spectralFreeze and spectralSmear instance counts
+     * @param limits Updated with the counts given; the others keep their value
+     * @return false, with a TypeError thrown, if the option is malformed
+     */
+    static bool ReadEffectPoolLimits(Napi::Env env, Napi::Value value, EffectPool::Limits& limits);
+
 private:
+    Napi::Reference<Napi::ArrayBuffer> m_parameterBuffer;   ///< Memory of m_parameterBlock, shared with JavaScript; outlives the device
+    std::unique_ptr<ParameterBlock> m_parameterBlock;
     std::unique_ptr<StereoSampleRingBuffer> m_waveformBuffer;
     std::unique_ptr<AudioSystem> m_audioSystem;
     std::unique_ptr<AudioDevice> m_audioDevice;
-    std::unique_ptr<MidiDevice> m_midiDevice;
-    std::unique_ptr<AudioSystemAdapter> m_adapter;
-    std::string m_midiDeviceName;
+    std::unique_ptr<FlightRecorderDumper> m_xrunDumper;     ///< Writes callback history after an xrun when AUDIO_XRUN_DIR is set
+    std::unique_ptr<EngineController> m_controller;         ///< Effects, sources and MIDI input shared with the engine host
     float m_sampleRate;
-    float m_currentFrequency;
-    std::vector<float> m_activeFrequencies;
+    unsigned int m_bufferFrames;
 
     // JavaScript-accessible methods
     Napi::Value Start(const Napi::CallbackInfo& info);
     Napi::Value Stop(const Napi::CallbackInfo& info);
     Napi::Value TriggerNote(const Napi::CallbackInfo& info);
     Napi::Value TriggerNoteOff(const Napi::CallbackInfo& info);
+    Napi::Value NoteOn(const Napi::CallbackInfo& info);
+    Napi::Value NoteOff(const Napi::CallbackInfo& info);
+    Napi::Value NoteOnAt(const Napi::CallbackInfo& info);
+    Napi::Value NoteOffAt(const Napi::CallbackInfo& info);
+    Napi::Value SetPitchBendAt(const Napi::CallbackInfo& info);
+    Napi::Value GetAudioClock(const Napi::CallbackInfo& info);
+    Napi::Value GetParameterBlock(const Napi::CallbackInfo& info);
+    Napi::Value GetTelemetry(const Napi::CallbackInfo& info);
+    Napi::Value SetTuningTable(const Napi::CallbackInfo& info);
+    Napi::Value ResetTuning(const Napi::CallbackInfo& info);
     Napi::Value ResetEffects(const Napi::CallbackInfo& info);
     Napi::Value ClearEffects(const Napi::CallbackInfo& info);
     Napi::Value UpdateADSRParameters(const Napi::CallbackInfo& info);
@@ -64,10 +94,31 @@ private:
     Napi::Value AddLowPassEffect(const Napi::CallbackInfo& info);
     Napi::Value SetLowPassCutoff(const Napi::CallbackInfo& info);
     Napi::Value GetLowPassCutoff(const Napi::CallbackInfo& info);
+    Napi::Value SetMemoryBudget(const Napi::CallbackInfo& info);
     Napi::Value AddOctaveEffect(const Napi::CallbackInfo& info);
     Napi::Value SetDriftParameters(const Napi::CallbackInfo& info);
     Napi::Value GetMidiStatus(const Napi::CallbackInfo& info);
     Napi::Value GetRecentWaveform(const Napi::CallbackInfo& info);
     Napi::Value ConfigureSecondaryOscillator(const Napi::CallbackInfo& info);
     Napi::Value SetPitchBend(const Napi::CallbackInfo& info);
+    Napi::Value SetGranularEnabled(const Napi::CallbackInfo& info);
+    Napi::Value LoadGranularSample(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureGranular(const Napi::CallbackInfo& info);
+    Napi::Value AddSpectralFreezeEffect(const Napi::CallbackInfo& info);
+    Napi::Value SetSpectralFreeze(const Napi::CallbackInfo& info);
+    Napi::Value AddSpectralSmearEffect(const Napi::CallbackInfo& info);
+    Napi::Value AddTimeStretchEffect(const Napi::CallbackInfo& info);
+    Napi::Value LoadTimeStretchSample(const Napi::CallbackInfo& info);
+    Napi::Value TriggerTimeStretch(const Napi::CallbackInfo& info);
+    Napi::Value StopTimeStretch(const Napi::CallbackInfo& info);
+    Napi::Value AddVocoderEffect(const Napi::CallbackInfo& info);
+    Napi::Value LoadVocoderModulator(const Napi::CallbackInfo& info);
+    Napi::Value SetLiveInputMode(const Napi::CallbackInfo& info);
+    Napi::Value SetVocoderModulatorSource(const Napi::CallbackInfo& info);
+    Napi::Value SetGranularBufferMode(const Napi::CallbackInfo& info);
+    Napi::Value IsFullDuplex(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureCompressor(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureLimiter(const Napi::CallbackInfo& info);
+    Napi::Value GetMasterLatency(const Napi::CallbackInfo& info);
+    Napi::Value SetEffectBypass(const Napi::CallbackInfo& info);
 };
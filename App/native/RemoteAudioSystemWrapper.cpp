@@ -0,0 +1,1015 @@
+#include "RemoteAudioSystemWrapper.h"
+#include "AudioSystemWrapper.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <dlfcn.h>
+
+namespace
+{
+/**
+ * @brief Read a render frame (non-negative number) from the first argument
+ */
+bool frameArgument(const Napi::CallbackInfo& info, std::uint64_t& frame)
+{
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        return false;
+    }
+    const double value = info[0].As<Napi::Number>().DoubleValue();
+    if (!std::isfinite(value) || value < 0.0)
+    {
+        return false;
+    }
+    frame = static_cast<std::uint64_t>(value);
+    return true;
+}
+
+HostCommand makeCommand(HostCommand::Type type)
+{
+    HostCommand command;
+    command.type = type;
+    return command;
+}
+
+/**
+ * @brief Default location of the host binary: AUDIO_ENGINE_HOST, else next to this addon
+ */
+std::string defaultHostPath()
+{
+    const char* configured = std::getenv("AUDIO_ENGINE_HOST");
+    if (configured != nullptr && configured[0] != '\0')
+    {
+        return configured;
+    }
+
+    Dl_info module;
+    if (dladdr(reinterpret_cast<void*>(&defaultHostPath), &module) != 0 && module.dli_fname != nullptr)
+    {
+        const std::string addon = module.dli_fname;
+        const std::size_t slash = addon.find_last_of('/');
+        if (slash != std::string::npos)
+        {
+            return addon.substr(0, slash + 1U) + "audioEngineHost";
+        }
+    }
+    return "audioEngineHost";
+}
+
+constexpr unsigned int kStartTimeoutMs = 5000;
+constexpr unsigned int kQueryTimeoutMs = 100;
+constexpr auto kForwardInterval = std::chrono::milliseconds(1);
+}
+
+Napi::Object RemoteAudioSystemWrapper::Init(Napi::Env env, Napi::Object exports)
+{
+    Napi::Function func = DefineClass(env, "RemoteAudioSystem", {
+        InstanceMethod("start", &RemoteAudioSystemWrapper::Start),
+        InstanceMethod("stop", &RemoteAudioSystemWrapper::Stop),
+        InstanceMethod("triggerNote", &RemoteAudioSystemWrapper::TriggerNote),
+        InstanceMethod("triggerNoteOff", &RemoteAudioSystemWrapper::TriggerNoteOff),
+        InstanceMethod("noteOn", &RemoteAudioSystemWrapper::NoteOn),
+        InstanceMethod("noteOff", &RemoteAudioSystemWrapper::NoteOff),
+        InstanceMethod("noteOnAt", &RemoteAudioSystemWrapper::NoteOnAt),
+        InstanceMethod("noteOffAt", &RemoteAudioSystemWrapper::NoteOffAt),
+        InstanceMethod("setPitchBendAt", &RemoteAudioSystemWrapper::SetPitchBendAt),
+        InstanceMethod("getAudioClock", &RemoteAudioSystemWrapper::GetAudioClock),
+        InstanceMethod("getParameterBlock", &RemoteAudioSystemWrapper::GetParameterBlock),
+        InstanceMethod("getTelemetry", &RemoteAudioSystemWrapper::GetTelemetry),
+        InstanceMethod("setTuningTable", &RemoteAudioSystemWrapper::SetTuningTable),
+        InstanceMethod("resetTuning", &RemoteAudioSystemWrapper::ResetTuning),
+        InstanceMethod("resetEffects", &RemoteAudioSystemWrapper::ResetEffects),
+        InstanceMethod("clearEffects", &RemoteAudioSystemWrapper::ClearEffects),
+        InstanceMethod("updateADSRParameters", &RemoteAudioSystemWrapper::UpdateADSRParameters),
+        InstanceMethod("setWaveform", &RemoteAudioSystemWrapper::SetWaveform),
+        InstanceMethod("addDelayEffect", &RemoteAudioSystemWrapper::AddDelayEffect),
+        InstanceMethod("addLowPassEffect", &RemoteAudioSystemWrapper::AddLowPassEffect),
+        InstanceMethod("setLowPassCutoff", &RemoteAudioSystemWrapper::SetLowPassCutoff),
+        InstanceMethod("getLowPassCutoff", &RemoteAudioSystemWrapper::GetLowPassCutoff),
+        InstanceMethod("setMemoryBudget", &RemoteAudioSystemWrapper::SetMemoryBudget),
+        InstanceMethod("addOctaveEffect", &RemoteAudioSystemWrapper::AddOctaveEffect),
+        InstanceMethod("setDriftParameters", &RemoteAudioSystemWrapper::SetDriftParameters),
+        InstanceMethod("getMidiStatus", &RemoteAudioSystemWrapper::GetMidiStatus),
+        InstanceMethod("getRecentWaveform", &RemoteAudioSystemWrapper::GetRecentWaveform),
+        InstanceMethod("configureSecondaryOscillator", &RemoteAudioSystemWrapper::ConfigureSecondaryOscillator),
+        InstanceMethod("setPitchBend", &RemoteAudioSystemWrapper::SetPitchBend),
+        InstanceMethod("setGranularEnabled", &RemoteAudioSystemWrapper::SetGranularEnabled),
+        InstanceMethod("loadGranularSample", &RemoteAudioSystemWrapper::LoadGranularSample),
+        InstanceMethod("configureGranular", &RemoteAudioSystemWrapper::ConfigureGranular),
+        InstanceMethod("addSpectralFreezeEffect", &RemoteAudioSystemWrapper::AddSpectralFreezeEffect),
+        InstanceMethod("setSpectralFreeze", &RemoteAudioSystemWrapper::SetSpectralFreeze),
+        InstanceMethod("addSpectralSmearEffect", &RemoteAudioSystemWrapper::AddSpectralSmearEffect),
+        InstanceMethod("addTimeStretchEffect", &RemoteAudioSystemWrapper::AddTimeStretchEffect),
+        InstanceMethod("loadTimeStretchSample", &RemoteAudioSystemWrapper::LoadTimeStretchSample),
+        InstanceMethod("triggerTimeStretch", &RemoteAudioSystemWrapper::TriggerTimeStretch),
+        InstanceMethod("stopTimeStretch", &RemoteAudioSystemWrapper::StopTimeStretch),
+        InstanceMethod("addVocoderEffect", &RemoteAudioSystemWrapper::AddVocoderEffect),
+        InstanceMethod("loadVocoderModulator", &RemoteAudioSystemWrapper::LoadVocoderModulator),
+        InstanceMethod("setLiveInputMode", &RemoteAudioSystemWrapper::SetLiveInputMode),
+        InstanceMethod("setVocoderModulatorSource", &RemoteAudioSystemWrapper::SetVocoderModulatorSource),
+        InstanceMethod("setGranularBufferMode", &RemoteAudioSystemWrapper::SetGranularBufferMode),
+        InstanceMethod("isFullDuplex", &RemoteAudioSystemWrapper::IsFullDuplex),
+        InstanceMethod("configureCompressor", &RemoteAudioSystemWrapper::ConfigureCompressor),
+        InstanceMethod("configureLimiter", &RemoteAudioSystemWrapper::ConfigureLimiter),
+        InstanceMethod("getMasterLatency", &RemoteAudioSystemWrapper::GetMasterLatency),
+        InstanceMethod("setEffectBypass", &RemoteAudioSystemWrapper::SetEffectBypass)
+    });
+
+    exports.Set("RemoteAudioSystem", func);
+    return exports;
+}
+
+RemoteAudioSystemWrapper::RemoteAudioSystemWrapper(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<RemoteAudioSystemWrapper>(info),
+      m_forwarding(false),
+      m_sampleRate(44100.0f),
+      m_bufferFrames(512)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for sample rate")
+            .ThrowAsJavaScriptException();
+        return;
+    }
+
+    m_sampleRate = info[0].As<Napi::Number>().FloatValue();
+    if (info.Length() >= 2 && info[1].IsNumber())
+    {
+        m_bufferFrames = info[1].As<Napi::Number>().Uint32Value();
+    }
+
+    bool fullDuplex = false;
+    if (info.Length() >= 3 && info[2].IsBoolean())
+    {
+        fullDuplex = info[2].As<Napi::Boolean>().Value();
+    }
+
+    std::string hostPath = defaultHostPath();
+    if (info.Length() >= 4 && info[3].IsString())
+    {
+        hostPath = info[3].As<Napi::String>().Utf8Value();
+    }
+
+    EffectPool::Limits poolLimits = EffectPool::defaultLimits();
+    if (info.Length() >= 5 && !AudioSystemWrapper::ReadEffectPoolLimits(env, info[4], poolLimits))
+    {
+        return;
+    }
+
+    try
+    {
+        m_host = std::make_unique<EngineHostClient>(hostPath, m_sampleRate, m_bufferFrames, fullDuplex, poolLimits);
+    }
+    catch (const std::exception& e)
+    {
+        Napi::Error::New(env, std::string("Failed to start the audio engine host: ") + e.what())
+            .ThrowAsJavaScriptException();
+        return;
+    }
+
+    Napi::ArrayBuffer parameterBuffer = Napi::ArrayBuffer::New(env, ParameterBlock::kBytes);
+    m_parameterBuffer = Napi::Persistent(parameterBuffer);
+    m_parameterBlock = std::make_unique<ParameterBlock>(parameterBuffer.Data());
+
+    m_forwarding.store(true);
+    m_forwarder = std::thread([this]() { forwardParameters(); });
+}
+
+RemoteAudioSystemWrapper::~RemoteAudioSystemWrapper()
+{
+    m_forwarding.store(false);
+    if (m_forwarder.joinable())
+    {
+        m_forwarder.join();
+    }
+    // EngineHostClient shuts the host down
+}
+
+void RemoteAudioSystemWrapper::forwardParameters()
+{
+    ParameterBlock& shared = m_host->parameterBlock();
+    while (m_forwarding.load(std::memory_order_relaxed))
+    {
+        std::uint32_t dirty = m_parameterBlock->takeDirty();
+        while (dirty != 0U)
+        {
+            const std::uint32_t bit = dirty & (~dirty + 1U);
+            dirty &= dirty - 1U;
+
+            std::uint32_t index = 0;
+            while ((bit >> index) != 1U)
+            {
+                ++index;
+            }
+            const auto id = static_cast<ParameterBlock::Id>(index);
+            shared.set(id, m_parameterBlock->value(id));
+        }
+        std::this_thread::sleep_for(kForwardInterval);
+    }
+}
+
+bool RemoteAudioSystemWrapper::post(const HostCommand& command)
+{
+    if (m_host->post(command))
+    {
+        return true;
+    }
+    std::cerr << "Warning: audio engine host is not accepting commands, change dropped" << std::endl;
+    return false;
+}
+
+Napi::Value RemoteAudioSystemWrapper::postSample(const Napi::CallbackInfo& info, HostCommand::Type type, bool withRootFrequency)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, withRootFrequency
+            ? "Expected arguments: samples:Float32Array, sampleRate:number, rootFrequency?:number"
+            : "Expected arguments: samples:Float32Array, sampleRate:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Float32Array samples = info[0].As<Napi::Float32Array>();
+    HostCommand command = makeCommand(type);
+    command.values[0] = info[1].As<Napi::Number>().FloatValue();
+    command.values[1] = 261.625565f;
+    if (withRootFrequency && info.Length() >= 3 && info[2].IsNumber())
+    {
+        command.values[1] = info[2].As<Napi::Number>().FloatValue();
+    }
+
+    try
+    {
+        m_host->postSample(command, samples.Data(), samples.ElementLength());
+    }
+    catch (const std::exception& e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::Start(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (!m_host->request(makeCommand(HostCommand::Type::Start), kStartTimeoutMs))
+    {
+        const std::string error = m_host->lastError();
+        Napi::Error::New(env, std::string("Failed to start audio: ") +
+                              (error.empty() ? std::string("engine host did not respond") : error))
+            .ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::Stop(const Napi::CallbackInfo& info)
+{
+    post(makeCommand(HostCommand::Type::Stop));
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::TriggerNote(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for frequency")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::TriggerNote);
+    command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::TriggerNoteOff(const Napi::CallbackInfo& info)
+{
+    // Without a frequency every note is released
+    HostCommand command = makeCommand(HostCommand::Type::TriggerNoteOff);
+    if (info.Length() >= 1 && info[0].IsNumber())
+    {
+        command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::NoteOn(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for MIDI note")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::NoteOn);
+    command.ints[0] = info[0].As<Napi::Number>().Int32Value();
+    command.ints[1] = (info.Length() >= 3 && info[2].IsNumber()) ? info[2].As<Napi::Number>().Int32Value() : 0;
+    command.values[0] = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().FloatValue() : 1.0f;
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::NoteOff(const Napi::CallbackInfo& info)
+{
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        post(makeCommand(HostCommand::Type::TriggerNoteOff));
+        return info.Env().Undefined();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::NoteOff);
+    command.ints[0] = info[0].As<Napi::Number>().Int32Value();
+    command.ints[1] = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().Int32Value() : 0;
+    post(command);
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::NoteOnAt(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    HostCommand command = makeCommand(HostCommand::Type::NoteOn);
+    if (!frameArgument(info, command.frame) || info.Length() < 2 || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Frame and MIDI note expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    command.ints[0] = info[1].As<Napi::Number>().Int32Value();
+    command.ints[1] = (info.Length() >= 4 && info[3].IsNumber()) ? info[3].As<Napi::Number>().Int32Value() : 0;
+    command.values[0] = (info.Length() >= 3 && info[2].IsNumber()) ? info[2].As<Napi::Number>().FloatValue() : 1.0f;
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::NoteOffAt(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    HostCommand command = makeCommand(HostCommand::Type::NoteOff);
+    if (!frameArgument(info, command.frame) || info.Length() < 2 || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Frame and MIDI note expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    command.ints[0] = info[1].As<Napi::Number>().Int32Value();
+    command.ints[1] = (info.Length() >= 3 && info[2].IsNumber()) ? info[2].As<Napi::Number>().Int32Value() : 0;
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetPitchBendAt(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    HostCommand command = makeCommand(HostCommand::Type::PitchBend);
+    if (!frameArgument(info, command.frame) || info.Length() < 2 || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Frame and pitch bend value expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    command.ints[0] = info[1].As<Napi::Number>().Int32Value();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetAudioClock(const Napi::CallbackInfo& info)
+{
+    return AudioSystemWrapper::ClockObject(info.Env(), m_host->audioClock(), m_bufferFrames);
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetParameterBlock(const Napi::CallbackInfo& info)
+{
+    return AudioSystemWrapper::ParameterBlockObject(info.Env(), m_parameterBuffer.Value());
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetTelemetry(const Napi::CallbackInfo& info)
+{
+    return AudioSystemWrapper::TelemetryObject(info.Env(), m_host->telemetry());
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetTuningTable(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray())
+    {
+        Napi::TypeError::New(env, "Array of 128 frequencies expected")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Array values = info[0].As<Napi::Array>();
+    std::array<float, AudioSystem::kMidiNotes> table{};
+    for (uint32_t i = 0; i < table.size() && i < values.Length(); ++i)
+    {
+        Napi::Value value = values.Get(i);
+        table[i] = value.IsNumber() ? value.As<Napi::Number>().FloatValue() : 0.0f;
+    }
+
+    // The host applies the table once the last chunk arrives
+    for (std::size_t first = 0; first < table.size(); first += HostCommand::kValues)
+    {
+        HostCommand command = makeCommand(HostCommand::Type::TuningChunk);
+        command.ints[0] = static_cast<std::int32_t>(first);
+        command.ints[1] = (first + HostCommand::kValues >= table.size()) ? 1 : 0;
+        for (std::size_t i = 0; i < HostCommand::kValues && first + i < table.size(); ++i)
+        {
+            command.values[i] = table[first + i];
+        }
+        if (!post(command))
+        {
+            break;
+        }
+    }
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::ResetTuning(const Napi::CallbackInfo& info)
+{
+    post(makeCommand(HostCommand::Type::ResetTuning));
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::ResetEffects(const Napi::CallbackInfo& info)
+{
+    post(makeCommand(HostCommand::Type::ResetEffects));
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::ClearEffects(const Napi::CallbackInfo& info)
+{
+    post(makeCommand(HostCommand::Type::ClearEffects));
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::UpdateADSRParameters(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 4 || !info[0].IsNumber() || !info[1].IsNumber() ||
+        !info[2].IsNumber() || !info[3].IsNumber())
+    {
+        Napi::TypeError::New(env, "Four numbers expected (attack, decay, sustain, release)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::Envelope);
+    for (std::size_t i = 0; i < 4U; ++i)
+    {
+        command.values[i] = info[i].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetWaveform(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "String expected for waveform type")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    const std::string waveformType = info[0].As<Napi::String>().Utf8Value();
+    if (waveformType != "sine" && waveformType != "square" && waveformType != "saw" && waveformType != "triangle")
+    {
+        Napi::TypeError::New(env, "Unknown waveform type. Use: sine, square, saw, or triangle")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::Waveform);
+    command.setText(waveformType.c_str());
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddDelayEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber())
+    {
+        Napi::TypeError::New(env, "Three numbers expected (delayTime, feedback, mix)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::AddDelay);
+    for (std::size_t i = 0; i < 3U; ++i)
+    {
+        command.values[i] = info[i].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddLowPassEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for cutoff frequency")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (info.Length() >= 2 && !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Resonance must be a number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (info.Length() >= 3 && !info[2].IsNumber())
+    {
+        Napi::TypeError::New(env, "Mix must be a number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::AddLowPass);
+    command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    command.values[1] = info.Length() >= 2 ? info[1].As<Napi::Number>().FloatValue() : 0.9f;
+    command.values[2] = info.Length() >= 3 ? info[2].As<Napi::Number>().FloatValue() : 1.0f;
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetLowPassCutoff(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for cutoff frequency")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::LowPassCutoff);
+    command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetLowPassCutoff(const Napi::CallbackInfo& info)
+{
+    // As of the host's last control poll, at most a couple of milliseconds old
+    return Napi::Number::New(info.Env(), m_host->lowPassCutoff());
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetMemoryBudget(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for memory budget (MB)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::MemoryBudget);
+    command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddOctaveEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsBoolean() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Boolean and Number expected (higher, blend)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::AddOctave);
+    command.ints[0] = info[0].As<Napi::Boolean>().Value() ? 1 : 0;
+    command.values[0] = info[1].As<Napi::Number>().FloatValue();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetDriftParameters(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber())
+    {
+        Napi::TypeError::New(env, "Three numbers expected (rateHz, amountCents, jitterCents)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::Drift);
+    for (std::size_t i = 0; i < 3U; ++i)
+    {
+        command.values[i] = info[i].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetMidiStatus(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+    Napi::Object result = Napi::Object::New(env);
+
+    result.Set("connected", Napi::Boolean::New(env, m_host->midiConnected()));
+    result.Set("deviceName", Napi::String::New(env, m_host->midiDeviceName()));
+
+    return result;
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetRecentWaveform(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    std::size_t requestedFrames = 1024U;
+    if (info.Length() >= 1)
+    {
+        if (!info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Number expected for maxFrames")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        const double value = info[0].As<Napi::Number>().DoubleValue();
+        requestedFrames = value <= 0.0 ? 0U : static_cast<std::size_t>(value);
+    }
+
+    const WaveformSnapshot& snapshot = m_host->waveform();
+    const std::size_t framesToCopy = std::min<std::size_t>(requestedFrames, snapshot.frames);
+
+    Napi::Float32Array result = Napi::Float32Array::New(env, framesToCopy * 2U);
+    if (framesToCopy == 0U)
+    {
+        return result;
+    }
+
+    // The snapshot is oldest first; keep its newest frames
+    const float* newest = snapshot.samples + (snapshot.frames - framesToCopy) * 2U;
+    std::copy(newest, newest + framesToCopy * 2U, result.Data());
+    return result;
+}
+
+Napi::Value RemoteAudioSystemWrapper::ConfigureSecondaryOscillator(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 4 || !info[0].IsBoolean() || !info[1].IsNumber() || !info[2].IsNumber() || !info[3].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: enabled:boolean, mix:number, detuneCents:number, octaveOffset:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::SecondaryOscillator);
+    command.ints[0] = info[0].As<Napi::Boolean>().Value() ? 1 : 0;
+    command.values[0] = info[1].As<Napi::Number>().FloatValue();
+    command.values[1] = info[2].As<Napi::Number>().FloatValue();
+    command.ints[1] = info[3].As<Napi::Number>().Int32Value();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetPitchBend(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected for pitch bend value")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::PitchBend);
+    command.ints[0] = std::max(-8192, std::min(8191, info[0].As<Napi::Number>().Int32Value()));
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetGranularEnabled(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Boolean expected for granular enabled flag")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::GranularEnabled);
+    command.ints[0] = info[0].As<Napi::Boolean>().Value() ? 1 : 0;
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::LoadGranularSample(const Napi::CallbackInfo& info)
+{
+    return postSample(info, HostCommand::Type::LoadGranularSample, true);
+}
+
+Napi::Value RemoteAudioSystemWrapper::ConfigureGranular(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 6 || !info[0].IsNumber() || !info[1].IsNumber() || !info[2].IsNumber() ||
+        !info[3].IsNumber() || !info[4].IsNumber() || !info[5].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: density:number, grainMs:number, position:number, positionSpread:number, pitchSpreadCents:number, panSpread:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::GranularConfig);
+    for (std::size_t i = 0; i < 6U; ++i)
+    {
+        command.values[i] = info[i].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddSpectralFreezeEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    HostCommand command = makeCommand(HostCommand::Type::AddSpectralFreeze);
+    command.values[0] = 1.0f;
+    if (info.Length() >= 1)
+    {
+        if (!info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Mix must be a number")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetSpectralFreeze(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Boolean expected for freeze flag")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::SpectralFreeze);
+    command.ints[0] = info[0].As<Napi::Boolean>().Value() ? 1 : 0;
+    return Napi::Boolean::New(env, m_host->request(command, kQueryTimeoutMs));
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddSpectralSmearEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: amount:number, mix?:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::AddSpectralSmear);
+    command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    command.values[1] = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().FloatValue() : 1.0f;
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddTimeStretchEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: speed:number, gain?:number, loop?:boolean")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    // A negative gain and ints[0] == 0 leave the player's current gain and looping alone
+    HostCommand command = makeCommand(HostCommand::Type::AddTimeStretch);
+    command.values[0] = info[0].As<Napi::Number>().FloatValue();
+    command.values[1] = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().FloatValue() : -1.0f;
+    if (info.Length() >= 3 && info[2].IsBoolean())
+    {
+        command.ints[0] = 1;
+        command.ints[1] = info[2].As<Napi::Boolean>().Value() ? 1 : 0;
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::LoadTimeStretchSample(const Napi::CallbackInfo& info)
+{
+    return postSample(info, HostCommand::Type::LoadTimeStretchSample, false);
+}
+
+Napi::Value RemoteAudioSystemWrapper::TriggerTimeStretch(const Napi::CallbackInfo& info)
+{
+    post(makeCommand(HostCommand::Type::TriggerTimeStretch));
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::StopTimeStretch(const Napi::CallbackInfo& info)
+{
+    post(makeCommand(HostCommand::Type::StopTimeStretch));
+    return info.Env().Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::AddVocoderEffect(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: bands:number, mix:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::AddVocoder);
+    command.ints[0] = static_cast<std::int32_t>(info[0].As<Napi::Number>().Uint32Value());
+    command.values[0] = info[1].As<Napi::Number>().FloatValue();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::LoadVocoderModulator(const Napi::CallbackInfo& info)
+{
+    return postSample(info, HostCommand::Type::LoadVocoderModulator, false);
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetLiveInputMode(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Expected arguments: mode:string, gain?:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::LiveInputMode);
+    command.setText(info[0].As<Napi::String>().Utf8Value().c_str());
+    command.values[0] = (info.Length() >= 2 && info[1].IsNumber()) ? info[1].As<Napi::Number>().FloatValue() : 1.0f;
+    post(command);
+
+    // Input is only delivered when the host opened the device full duplex
+    return Napi::Boolean::New(env, m_host->fullDuplex());
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetVocoderModulatorSource(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Expected argument: source:'sample'|'live'")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::VocoderModulatorSource);
+    command.setText(info[0].As<Napi::String>().Utf8Value().c_str());
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetGranularBufferMode(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString())
+    {
+        Napi::TypeError::New(env, "Expected argument: mode:'sample'|'live'")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::GranularBufferMode);
+    command.setText(info[0].As<Napi::String>().Utf8Value().c_str());
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::IsFullDuplex(const Napi::CallbackInfo& info)
+{
+    return Napi::Boolean::New(info.Env(), m_host->fullDuplex());
+}
+
+Napi::Value RemoteAudioSystemWrapper::ConfigureCompressor(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 6 || !info[0].IsBoolean() || !info[1].IsNumber() || !info[2].IsNumber() ||
+        !info[3].IsNumber() || !info[4].IsNumber() || !info[5].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: enabled:boolean, thresholdDb:number, ratio:number, attackMs:number, releaseMs:number, makeupDb:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::Compressor);
+    command.ints[0] = info[0].As<Napi::Boolean>().Value() ? 1 : 0;
+    for (std::size_t i = 0; i < 5U; ++i)
+    {
+        command.values[i] = info[i + 1U].As<Napi::Number>().FloatValue();
+    }
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::ConfigureLimiter(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsBoolean() || !info[1].IsNumber() || !info[2].IsNumber())
+    {
+        Napi::TypeError::New(env, "Expected arguments: enabled:boolean, ceilingDb:number, releaseMs:number")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::Limiter);
+    command.ints[0] = info[0].As<Napi::Boolean>().Value() ? 1 : 0;
+    command.values[0] = info[1].As<Napi::Number>().FloatValue();
+    command.values[1] = info[2].As<Napi::Number>().FloatValue();
+    post(command);
+    return env.Undefined();
+}
+
+Napi::Value RemoteAudioSystemWrapper::GetMasterLatency(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    const unsigned int frames = m_host->masterLatencyFrames();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frames", Napi::Number::New(env, frames));
+    result.Set("milliseconds", Napi::Number::New(env, 1000.0 * frames / m_sampleRate));
+    result.Set("gainReductionDb", Napi::Number::New(env, m_host->telemetry().gainReductionDb));
+    return result;
+}
+
+Napi::Value RemoteAudioSystemWrapper::SetEffectBypass(const Napi::CallbackInfo& info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsString() || !info[1].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Expected arguments: effect:string, bypassed:boolean, keepWarm?:boolean")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    HostCommand command = makeCommand(HostCommand::Type::EffectBypass);
+    command.setText(info[0].As<Napi::String>().Utf8Value().c_str());
+    command.ints[0] = info[1].As<Napi::Boolean>().Value() ? 1 : 0;
+    command.ints[1] = (info.Length() >= 3 && info[2].IsBoolean() && info[2].As<Napi::Boolean>().Value()) ? 1 : 0;
+
+    // Effects are applied in order, so the answer reflects every change posted before
+    return Napi::Boolean::New(env, m_host->request(command, kQueryTimeoutMs));
+}
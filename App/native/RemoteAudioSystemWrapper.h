@@ -0,0 +1,119 @@
+#pragma once
+
+#include <napi.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include "../../audioSystem/src/Host/EngineHostClient.h"
+
+/**
+ * @class RemoteAudioSystemWrapper
+ * @brief N-API class with the AudioSystem interface, backed by an engine host process
+ *
+ * The audio engine, the audio device and MIDI input run in a separate
+ * audioEngineHost process, so garbage collection pauses and stalls in
+ * Node never touch the realtime threads and a crash in the engine does
+ * not take down the UI. Calls are turned into HostCommands on a shared
+ * memory ring; meters, clock and waveform are read back from the same
+ * mapping without a system call.
+ *
+ * JavaScript writes continuous controllers into a V8-owned parameter block
+ * (external buffers are not allowed in Electron); a forwarder thread copies
+ * flagged values into the shared block every millisecond.
+ */
+class RemoteAudioSystemWrapper : public Napi::ObjectWrap<RemoteAudioSystemWrapper>
+{
+public:
+    /**
+     * @brief Initialize the N-API wrapper class
+     * @param env N-API environment
+     * @param exports Module exports object
+     * @return Exports object with the RemoteAudioSystem class attached
+     */
+    static Napi::Object Init(Napi::Env env, Napi::Object exports);
+
+    /**
+     * @brief Constructor
+     * @param info Callback info containing the sample rate, buffer size, optional
+     *             full-duplex flag, optional path of the audioEngineHost binary
+     *             (defaults to AUDIO_ENGINE_HOST, then the addon's directory) and
+     *             optional effect pool limits for the host
+     *             (see AudioSystemWrapper::ReadEffectPoolLimits())
+     */
+    RemoteAudioSystemWrapper(const Napi::CallbackInfo& info);
+
+    /**
+     * @brief Destructor - stops the forwarder and shuts the host down
+     */
+    ~RemoteAudioSystemWrapper();
+
+private:
+    Napi::Reference<Napi::ArrayBuffer> m_parameterBuffer;   ///< Memory of m_parameterBlock, shared with JavaScript
+    std::unique_ptr<ParameterBlock> m_parameterBlock;
+    std::unique_ptr<EngineHostClient> m_host;
+    std::thread m_forwarder;
+    std::atomic<bool> m_forwarding;
+    float m_sampleRate;
+    unsigned int m_bufferFrames;
+
+    /// Copy flagged parameter values into the host's block until m_forwarding clears
+    void forwardParameters();
+
+    /// Queue a command, warning when the host is gone or not keeping up
+    bool post(const HostCommand& command);
+
+    /// Copy a Float32Array into the host and queue the command that loads it
+    Napi::Value postSample(const Napi::CallbackInfo& info, HostCommand::Type type, bool withRootFrequency);
+
+    // JavaScript-accessible methods
+    Napi::Value Start(const Napi::CallbackInfo& info);
+    Napi::Value Stop(const Napi::CallbackInfo& info);
+    Napi::Value TriggerNote(const Napi::CallbackInfo& info);
+    Napi::Value TriggerNoteOff(const Napi::CallbackInfo& info);
+    Napi::Value NoteOn(const Napi::CallbackInfo& info);
+    Napi::Value NoteOff(const Napi::CallbackInfo& info);
+    Napi::Value NoteOnAt(const Napi::CallbackInfo& info);
+    Napi::Value NoteOffAt(const Napi::CallbackInfo& info);
+    Napi::Value SetPitchBendAt(const Napi::CallbackInfo& info);
+    Napi::Value GetAudioClock(const Napi::CallbackInfo& info);
+    Napi::Value GetParameterBlock(const Napi::CallbackInfo& info);
+    Napi::Value GetTelemetry(const Napi::CallbackInfo& info);
+    Napi::Value SetTuningTable(const Napi::CallbackInfo& info);
+    Napi::Value ResetTuning(const Napi::CallbackInfo& info);
+    Napi::Value ResetEffects(const Napi::CallbackInfo& info);
+    Napi::Value ClearEffects(const Napi::CallbackInfo& info);
+    Napi::Value UpdateADSRParameters(const Napi::CallbackInfo& info);
+    Napi::Value SetWaveform(const Napi::CallbackInfo& info);
+    Napi::Value AddDelayEffect(const Napi::CallbackInfo& info);
+    Napi::Value AddLowPassEffect(const Napi::CallbackInfo& info);
+    Napi::Value SetLowPassCutoff(const Napi::CallbackInfo& info);
+    Napi::Value GetLowPassCutoff(const Napi::CallbackInfo& info);
+    Napi::Value SetMemoryBudget(const Napi::CallbackInfo& info);
+    Napi::Value AddOctaveEffect(const Napi::CallbackInfo& info);
+    Napi::Value SetDriftParameters(const Napi::CallbackInfo& info);
+    Napi::Value GetMidiStatus(const Napi::CallbackInfo& info);
+    Napi::Value GetRecentWaveform(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureSecondaryOscillator(const Napi::CallbackInfo& info);
+    Napi::Value SetPitchBend(const Napi::CallbackInfo& info);
+    Napi::Value SetGranularEnabled(const Napi::CallbackInfo& info);
+    Napi::Value LoadGranularSample(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureGranular(const Napi::CallbackInfo& info);
+    Napi::Value AddSpectralFreezeEffect(const Napi::CallbackInfo& info);
+    Napi::Value SetSpectralFreeze(const Napi::CallbackInfo& info);
+    Napi::Value AddSpectralSmearEffect(const Napi::CallbackInfo& info);
+    Napi::Value AddTimeStretchEffect(const Napi::CallbackInfo& info);
+    Napi::Value LoadTimeStretchSample(const Napi::CallbackInfo& info);
+    Napi::Value TriggerTimeStretch(const Napi::CallbackInfo& info);
+    Napi::Value StopTimeStretch(const Napi::CallbackInfo& info);
+    Napi::Value AddVocoderEffect(const Napi::CallbackInfo& info);
+    Napi::Value LoadVocoderModulator(const Napi::CallbackInfo& info);
+    Napi::Value SetLiveInputMode(const Napi::CallbackInfo& info);
+    Napi::Value SetVocoderModulatorSource(const Napi::CallbackInfo& info);
+    Napi::Value SetGranularBufferMode(const Napi::CallbackInfo& info);
+    Napi::Value IsFullDuplex(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureCompressor(const Napi::CallbackInfo& info);
+    Napi::Value ConfigureLimiter(const Napi::CallbackInfo& info);
+    Napi::Value GetMasterLatency(const Napi::CallbackInfo& info);
+    Napi::Value SetEffectBypass(const Napi::CallbackInfo& info);
+};
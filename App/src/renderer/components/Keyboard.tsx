@@ -8,9 +8,9 @@ import './Keyboard.css';
  * Interface Segregation Principle - receives only the callbacks it needs
  */
 interface KeyboardProps {
-  onNoteOn: (frequency: number) => void;
-  onNoteOff: (frequency: number) => void;
-  activeFrequencies: number[];
+  onNoteOn: (midiNote: number, eventTime?: number) => void;
+  onNoteOff: (midiNote: number, eventTime?: number) => void;
+  activeNotes: number[];
 }
 
 interface KeyInfo {
@@ -22,7 +22,7 @@ interface KeyInfo {
 export const Keyboard: React.FC<KeyboardProps> = ({
   onNoteOn,
   onNoteOff,
-  activeFrequencies
+  activeNotes
 }) => {
   const pressedKeysRef = useRef<Set<number>>(new Set());
   const [pressedKeys, setPressedKeys] = useState<Set<number>>(new Set());
@@ -53,29 +53,29 @@ export const Keyboard: React.FC<KeyboardProps> = ({
     return keys;
   }, []);
 
-  const handleKeyDown = (midiNote: number) => {
+  // Event timestamps let the engine place notes at the time they were played
+  // rather than when the event loop got around to them
+  const handleKeyDown = (midiNote: number, eventTime?: number) => {
     if (pressedKeysRef.current.has(midiNote)) {
       return;
     }
-    const frequency = NoteCalculator.midiToFrequency(midiNote);
     pressedKeysRef.current.add(midiNote);
     updatePressedKeys();
-    onNoteOn(frequency);
+    onNoteOn(midiNote, eventTime);
   };
 
-  const handleKeyUp = (midiNote: number) => {
+  const handleKeyUp = (midiNote: number, eventTime?: number) => {
     if (!pressedKeysRef.current.has(midiNote)) {
       return;
     }
     pressedKeysRef.current.delete(midiNote);
     updatePressedKeys();
-    const frequency = NoteCalculator.midiToFrequency(midiNote);
-    onNoteOff(frequency);
+    onNoteOff(midiNote, eventTime);
   };
 
-  const isFrequencyActive = useCallback(
-    (frequency: number) => activeFrequencies.some(active => Math.abs(active - frequency) < 1e-3),
-    [activeFrequencies]
+  const isNoteActive = useCallback(
+    (midiNote: number) => activeNotes.includes(midiNote),
+    [activeNotes]
   );
 
   const keys = generateKeys();
@@ -86,16 +86,15 @@ export const Keyboard: React.FC<KeyboardProps> = ({
     <div className="keyboard">
       <div className="keyboard-keys">
         {whiteKeys.map((key) => {
-          const frequency = NoteCalculator.midiToFrequency(key.midiNote);
-          const isPressed = pressedKeys.has(key.midiNote) || isFrequencyActive(frequency);
+          const isPressed = pressedKeys.has(key.midiNote) || isNoteActive(key.midiNote);
 
           return (
             <div
               key={key.midiNote}
               className={`key white-key ${isPressed ? 'pressed' : ''}`}
-              onMouseDown={() => handleKeyDown(key.midiNote)}
-              onMouseUp={() => handleKeyUp(key.midiNote)}
-              onMouseLeave={() => handleKeyUp(key.midiNote)}
+              onMouseDown={(event) => handleKeyDown(key.midiNote, event.timeStamp)}
+              onMouseUp={(event) => handleKeyUp(key.midiNote, event.timeStamp)}
+              onMouseLeave={(event) => handleKeyUp(key.midiNote, event.timeStamp)}
             >
               <span className="key-label">{key.name}</span>
             </div>
@@ -104,17 +103,16 @@ export const Keyboard: React.FC<KeyboardProps> = ({
         {blackKeys.map((key) => {
           const whiteKeysBefore = whiteKeys.filter(wk => wk.midiNote < key.midiNote).length;
           const position = whiteKeysBefore * 60 - 20; // 60px white key width, -20px offset
-          const frequency = NoteCalculator.midiToFrequency(key.midiNote);
-          const isPressed = pressedKeys.has(key.midiNote) || isFrequencyActive(frequency);
+          const isPressed = pressedKeys.has(key.midiNote) || isNoteActive(key.midiNote);
 
           return (
             <div
               key={key.midiNote}
               className={`key black-key ${isPressed ? 'pressed' : ''}`}
               style={{ left: `${position}px` }}
-              onMouseDown={() => handleKeyDown(key.midiNote)}
-              onMouseUp={() => handleKeyUp(key.midiNote)}
-              onMouseLeave={() => handleKeyUp(key.midiNote)}
+              onMouseDown={(event) => handleKeyDown(key.midiNote, event.timeStamp)}
+              onMouseUp={(event) => handleKeyUp(key.midiNote, event.timeStamp)}
+              onMouseLeave={(event) => handleKeyUp(key.midiNote, event.timeStamp)}
             >
               <span className="key-label">{key.name}</span>
             </div>
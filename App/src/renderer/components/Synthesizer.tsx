@@ -31,13 +31,14 @@ const DEFAULT_SECONDARY_OSC: SecondaryOscillatorSettings = {
  * Follows Open/Closed Principle - extensible through child components
  */
 export const Synthesizer: React.FC = () => {
-  const [audioService] = useState(() => new AudioService(44100));
+  // AUDIO_OUT_OF_PROCESS=1 runs the engine in the audioEngineHost process
+  const [audioService] = useState(() => new AudioService(44100, false, process.env.AUDIO_OUT_OF_PROCESS === '1'));
   const [initError, setInitError] = useState<string | null>(null);
   const effectsTimeoutRef = useRef<NodeJS.Timeout | null>(null);
   const [synthState, setSynthState] = useState<SynthState>({
     isPlaying: false,
-    currentFrequency: null,
-    activeFrequencies: [],
+    currentNote: null,
+    activeNotes: [],
     waveform: 'sine',
     adsr: {
       attack: 0.01,
@@ -156,25 +157,25 @@ export const Synthesizer: React.FC = () => {
     setDriftSettings(settings);
   };
 
-  const handleNoteOn = (frequency: number) => {
-    audioService.playNote(frequency);
-    const activeFrequencies = audioService.getActiveFrequencies();
+  const handleNoteOn = (midiNote: number, eventTime?: number) => {
+    audioService.playNote(midiNote, 1, eventTime);
+    const activeNotes = audioService.getActiveNotes();
     setSynthState(prev => ({
       ...prev,
-      isPlaying: activeFrequencies.length > 0,
-      currentFrequency: frequency,
-      activeFrequencies
+      isPlaying: activeNotes.length > 0,
+      currentNote: midiNote,
+      activeNotes
     }));
   };
 
-  const handleNoteOff = (frequency: number) => {
-    audioService.stopNote(frequency);
-    const activeFrequencies = audioService.getActiveFrequencies();
+  const handleNoteOff = (midiNote: number, eventTime?: number) => {
+    audioService.stopNote(midiNote, eventTime);
+    const activeNotes = audioService.getActiveNotes();
     setSynthState(prev => ({
       ...prev,
-      isPlaying: activeFrequencies.length > 0,
-      currentFrequency: activeFrequencies.length ? activeFrequencies[activeFrequencies.length - 1] : null,
-      activeFrequencies
+      isPlaying: activeNotes.length > 0,
+      currentNote: activeNotes.length ? activeNotes[activeNotes.length - 1] : null,
+      activeNotes
     }));
   };
 
@@ -299,7 +300,7 @@ export const Synthesizer: React.FC = () => {
         <Keyboard
           onNoteOn={handleNoteOn}
           onNoteOff={handleNoteOff}
-          activeFrequencies={synthState.activeFrequencies}
+          activeNotes={synthState.activeNotes}
         />
       </div>
     </div>
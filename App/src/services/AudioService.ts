@@ -1,5 +1,45 @@
-import { IAudioSystemNative, IAudioSystemNativeModule, WaveformType, ADSRParameters } from '../types/native';
-import { SecondaryOscillatorSettings } from '../types';
+import { IAudioSystemNative, IAudioSystemNativeModule, WaveformType, ADSRParameters, LiveInputMode, EngineTelemetry } from '../types/native';
+import { SecondaryOscillatorSettings, GranularSettings, MasterCompressorSettings } from '../types';
+import { ParameterBlockWriter } from './ParameterBlockWriter';
+
+/**
+ * Effect chain settings accepted by AudioService.applyEffects
+ */
+export interface EffectChainSettings {
+  delay?: { enabled: boolean; time: number; feedback: number; mix: number };
+  lowPass?: { enabled: boolean; cutoff: number; resonance?: number };
+  freeze?: { enabled: boolean; mix: number };
+  smear?: { enabled: boolean; amount: number; mix: number };
+  timeStretch?: { enabled: boolean; speed: number; gain: number; loop: boolean };
+  vocoder?: { enabled: boolean; bands: number; mix: number };
+}
+
+type EffectKey = keyof EffectChainSettings;
+
+/** Names the native chain uses for bypass lookups */
+const NATIVE_EFFECT_NAMES: Record<EffectKey, string> = {
+  delay: 'delay',
+  lowPass: 'lowpass',
+  freeze: 'freeze',
+  smear: 'smear',
+  timeStretch: 'timestretch',
+  vocoder: 'vocoder'
+};
+
+/** Effect settings that can change through the parameter block without a rebuild */
+const CONTINUOUS_EFFECT_PARAMETERS: Partial<Record<EffectKey, string[]>> = {
+  lowPass: ['cutoff']
+};
+
+/** Serialize an effect's parameters, ignoring its enabled flag and any listed keys */
+function effectParameters(effect: { enabled: boolean }, ignored: string[] = []): string {
+  const copy: Record<string, unknown> = { ...effect };
+  delete copy.enabled;
+  for (const key of ignored) {
+    delete copy[key];
+  }
+  return JSON.stringify(copy);
+}
 
 /**
  * @class AudioService
@@ -10,13 +50,33 @@ import { SecondaryOscillatorSettings } from '../types';
  * It provides a clean API for the application layer.
  */
 export class AudioService {
+  /** Extra delay for timed notes so callback jitter does not make them late */
+  private static readonly SCHEDULE_MARGIN_MS = 2;
+
   private audioSystem: IAudioSystemNative | null = null;
   private readonly sampleRate: number;
+  private readonly fullDuplex: boolean;
+  private readonly outOfProcess: boolean;
   private isInitialized: boolean = false;
-  private readonly activeFrequencies: Set<number> = new Set();
+  private activeNotes: number[] = [];
+  private parameters: ParameterBlockWriter | null = null;
+  private secondaryShape: { enabled: boolean; octave: number } | null = null;
+  private driftJitter: number | null = null;
+  /** Cutoff last written through the parameter block, until MIDI moves the filter */
+  private blockCutoff: number | null = null;
+  /** Cutoff the native side last reported or was given */
+  private nativeCutoff: number | null = null;
+  private appliedEffects: EffectChainSettings | null = null;
+  private readonly chainEffects: Set<EffectKey> = new Set();
 
-  constructor(sampleRate: number = 44100) {
+  /**
+   * @param outOfProcess Run the engine in the audioEngineHost process, so renderer
+   *                     stalls cannot cause dropouts and an engine crash spares the UI
+   */
+  constructor(sampleRate: number = 44100, fullDuplex: boolean = false, outOfProcess: boolean = false) {
     this.sampleRate = sampleRate;
+    this.fullDuplex = fullDuplex;
+    this.outOfProcess = outOfProcess;
   }
 
   /**
@@ -35,10 +95,17 @@ export class AudioService {
       console.log('Loading native module from: ../audioSystemNative.node (relative to dist/renderer)');
       const nativeModule: IAudioSystemNativeModule = require('../audioSystemNative.node');
       
-    this.audioSystem = new nativeModule.AudioSystem(this.sampleRate);
+    this.audioSystem = this.outOfProcess
+      ? new nativeModule.RemoteAudioSystem(this.sampleRate, 512, this.fullDuplex)
+      : new nativeModule.AudioSystem(this.sampleRate, 512, this.fullDuplex);
     this.audioSystem.start(); // Start the audio output stream
+    this.parameters = ParameterBlockWriter.create(this.audioSystem.getParameterBlock());
+    this.secondaryShape = null;
+    this.driftJitter = null;
+    this.blockCutoff = null;
+    this.nativeCutoff = null;
     this.isInitialized = true;
-    this.activeFrequencies.clear();
+    this.activeNotes = [];
     console.log('✓ Audio system initialized successfully');
     } catch (error) {
       console.error('✗ Failed to initialize audio system:', error);
@@ -52,34 +119,83 @@ export class AudioService {
   public shutdown(): void {
     if (this.audioSystem) {
       this.audioSystem.stop();
-      this.activeFrequencies.clear();
+      this.activeNotes = [];
       this.isInitialized = false;
     }
   }
 
   /**
-   * Play a note at the specified frequency
+   * Play a MIDI note; the engine derives the frequency from its tuning table
+   * @param eventTime - performance.now() time of the input event; when given,
+   *   the note is placed on the audio clock at a fixed delay from that time
    */
-  public playNote(frequency: number): void {
+  public playNote(midiNote: number, velocity: number = 1, eventTime?: number): void {
     this.ensureInitialized();
-    this.audioSystem!.triggerNote(frequency);
-    if (Number.isFinite(frequency)) {
-      this.activeFrequencies.add(frequency);
+    if (!Number.isInteger(midiNote) || midiNote < 0 || midiNote > 127) {
+      return;
     }
+    const frame = this.frameForEvent(eventTime);
+    if (frame === null) {
+      this.audioSystem!.noteOn(midiNote, velocity);
+    } else {
+      this.audioSystem!.noteOnAt(frame, midiNote, velocity);
+    }
+    this.activeNotes = this.activeNotes.filter(note => note !== midiNote).concat(midiNote);
   }
 
   /**
-   * Stop the currently playing note
+   * Stop a MIDI note, or every note when omitted
    */
-  public stopNote(frequency?: number): void {
+  public stopNote(midiNote?: number, eventTime?: number): void {
     this.ensureInitialized();
-    if (typeof frequency === 'number' && Number.isFinite(frequency)) {
-      this.activeFrequencies.delete(frequency);
-      this.audioSystem!.triggerNoteOff(frequency);
+    if (typeof midiNote === 'number' && Number.isInteger(midiNote)) {
+      this.activeNotes = this.activeNotes.filter(note => note !== midiNote);
+      const frame = this.frameForEvent(eventTime);
+      if (frame === null) {
+        this.audioSystem!.noteOff(midiNote);
+      } else {
+        this.audioSystem!.noteOffAt(frame, midiNote);
+      }
     } else {
-      this.activeFrequencies.clear();
-      this.audioSystem!.triggerNoteOff();
+      this.activeNotes = [];
+      this.audioSystem!.noteOff();
+    }
+  }
+
+  /**
+   * Map an input event time to a frame on the audio clock
+   *
+   * The event is placed one device buffer (plus a small margin) after the
+   * frame that was playing when it happened, so every event gets the same
+   * delay no matter how late the event loop delivered it.
+   */
+  private frameForEvent(eventTime?: number): number | null {
+    if (typeof eventTime !== 'number' || !Number.isFinite(eventTime)) {
+      return null;
+    }
+    const clock = this.audioSystem!.getAudioClock();
+    if (clock.hostTimeMs === 0) {
+      return null;
     }
+    const ageFrames = Math.max(0, performance.now() - eventTime) * clock.sampleRate / 1000;
+    const aheadFrames = clock.bufferFrames + AudioService.SCHEDULE_MARGIN_MS * clock.sampleRate / 1000;
+    return Math.max(0, Math.round(clock.currentFrame - ageFrames + aheadFrames));
+  }
+
+  /**
+   * Replace the tuning table (128 frequencies in Hz, indexed by MIDI note)
+   */
+  public setTuningTable(frequencies: number[]): void {
+    this.ensureInitialized();
+    this.audioSystem!.setTuningTable(frequencies);
+  }
+
+  /**
+   * Return to 12-tone equal temperament
+   */
+  public resetTuning(): void {
+    this.ensureInitialized();
+    this.audioSystem!.resetTuning();
   }
 
   /**
@@ -113,18 +229,24 @@ export class AudioService {
 
   /**
    * Apply effects based on settings
-   * This rebuilds the effect chain by clearing and adding enabled effects
+   * When only enabled flags changed for effects already in the chain, they are
+   * bypassed in place (crossfaded, state kept). Otherwise the chain is rebuilt
+   * by clearing and adding enabled effects.
    */
-  public applyEffects(settings: {
-    delay?: { enabled: boolean; time: number; feedback: number; mix: number };
-    lowPass?: { enabled: boolean; cutoff: number; resonance?: number };
-  }): void {
+  public applyEffects(settings: EffectChainSettings): void {
     this.ensureInitialized();
+
+    if (this.toggleEffectsInPlace(settings)) {
+      this.appliedEffects = settings;
+      return;
+    }
     
     console.log('=== Rebuilding Effects Chain ===');
     
     // Clear the effects chain first (removes ALL effects)
     this.audioSystem!.clearEffects();
+    this.chainEffects.clear();
+    this.appliedEffects = settings;
     console.log('✓ All effects cleared');
 
     // Add effects in order based on what's enabled
@@ -141,6 +263,7 @@ export class AudioService {
         settings.delay.feedback,
         settings.delay.mix
       );
+      this.chainEffects.add('delay');
       effectCount++;
     } else {
       console.log('✗ Delay: disabled');
@@ -154,14 +277,98 @@ export class AudioService {
       });
       this.audioSystem!.addLowPassEffect(settings.lowPass.cutoff, resonance);
       this.audioSystem!.setLowPassCutoff(settings.lowPass.cutoff);
+      this.blockCutoff = null;
+      this.nativeCutoff = Math.fround(settings.lowPass.cutoff);
+      this.chainEffects.add('lowPass');
       effectCount++;
     } else {
       console.log('✗ Low-Pass Filter: disabled');
     }
+
+    if (settings.freeze?.enabled) {
+      console.log('✓ Adding Spectral Freeze:', { mix: (settings.freeze.mix * 100).toFixed(0) + '%' });
+      this.audioSystem!.addSpectralFreezeEffect(settings.freeze.mix);
+      this.chainEffects.add('freeze');
+      effectCount++;
+    }
+
+    if (settings.smear?.enabled) {
+      console.log('✓ Adding Spectral Smear:', {
+        amount: (settings.smear.amount * 100).toFixed(0) + '%',
+        mix: (settings.smear.mix * 100).toFixed(0) + '%'
+      });
+      this.audioSystem!.addSpectralSmearEffect(settings.smear.amount, settings.smear.mix);
+      this.chainEffects.add('smear');
+      effectCount++;
+    }
+
+    if (settings.timeStretch?.enabled) {
+      console.log('✓ Adding Time Stretch:', { speed: settings.timeStretch.speed.toFixed(2) + 'x' });
+      this.audioSystem!.addTimeStretchEffect(
+        settings.timeStretch.speed,
+        settings.timeStretch.gain,
+        settings.timeStretch.loop
+      );
+      this.chainEffects.add('timeStretch');
+      effectCount++;
+    }
+
+    if (settings.vocoder?.enabled) {
+      const bands = Math.max(16, Math.min(32, Math.round(settings.vocoder.bands)));
+      console.log('✓ Adding Vocoder:', { bands, mix: (settings.vocoder.mix * 100).toFixed(0) + '%' });
+      this.audioSystem!.addVocoderEffect(bands, settings.vocoder.mix);
+      this.chainEffects.add('vocoder');
+      effectCount++;
+    }
     
     console.log(`=== Effects chain complete: ${effectCount} effect(s) active ===`);
   }
 
+  /**
+   * Toggle effects through bypass instead of rebuilding the chain.
+   * Returns false when an effect must be added or its parameters changed.
+   */
+  private toggleEffectsInPlace(settings: EffectChainSettings): boolean {
+    const previous = this.appliedEffects;
+    if (!previous) {
+      return false;
+    }
+
+    const keys = Object.keys(NATIVE_EFFECT_NAMES) as EffectKey[];
+    for (const key of keys) {
+      const next = settings[key];
+      const prev = previous[key];
+      if (next?.enabled && !this.chainEffects.has(key)) {
+        return false;
+      }
+      const ignored = this.parameters ? CONTINUOUS_EFFECT_PARAMETERS[key] : undefined;
+      if (this.chainEffects.has(key) && next && prev && effectParameters(next, ignored) !== effectParameters(prev, ignored)) {
+        return false;
+      }
+    }
+
+    const cutoff = settings.lowPass?.cutoff;
+    if (this.chainEffects.has('lowPass') && cutoff !== undefined && cutoff !== previous.lowPass?.cutoff) {
+      this.setLowPassCutoff(cutoff);
+    }
+
+    for (const key of this.chainEffects) {
+      const enabled = settings[key]?.enabled ?? false;
+      this.audioSystem!.setEffectBypass(NATIVE_EFFECT_NAMES[key], !enabled);
+      console.log(`${enabled ? '✓' : '✗'} ${key}: ${enabled ? 'active' : 'bypassed'}`);
+    }
+    return true;
+  }
+
+  /**
+   * Bypass or re-enable an effect already in the chain (crossfaded).
+   * @param keepWarm keep the effect processing while bypassed so its tail stays current
+   */
+  public setEffectBypass(effect: string, bypassed: boolean, keepWarm: boolean = false): boolean {
+    this.ensureInitialized();
+    return this.audioSystem!.setEffectBypass(effect, bypassed, keepWarm);
+  }
+
   /**
    * Check if the service is initialized
    */
@@ -174,7 +381,14 @@ export class AudioService {
    */
   public updateDrift(rateHz: number, amountCents: number, jitterCents: number): void {
     this.ensureInitialized();
+    // Jitter is drawn per note on the native control side, so only it needs a call
+    if (this.parameters && this.driftJitter === jitterCents) {
+      this.parameters.set('driftRateHz', Math.max(0, rateHz));
+      this.parameters.set('driftAmountCents', Math.max(0, amountCents));
+      return;
+    }
     this.audioSystem!.setDriftParameters(rateHz, amountCents, jitterCents);
+    this.driftJitter = jitterCents;
   }
 
   /**
@@ -182,6 +396,11 @@ export class AudioService {
    */
   public setLowPassCutoff(cutoff: number): void {
     this.ensureInitialized();
+    if (this.parameters) {
+      this.parameters.set('lowPassCutoffHz', cutoff);
+      this.blockCutoff = cutoff;
+      return;
+    }
     this.audioSystem!.setLowPassCutoff(cutoff);
   }
 
@@ -190,7 +409,22 @@ export class AudioService {
    */
   public getLowPassCutoff(): number {
     this.ensureInitialized();
-    return this.audioSystem!.getLowPassCutoff();
+    const nativeCutoff = this.audioSystem!.getLowPassCutoff();
+    // A change on the native side (MIDI CC) takes over from block writes
+    if (this.blockCutoff !== null && nativeCutoff === this.nativeCutoff) {
+      return this.blockCutoff;
+    }
+    this.blockCutoff = null;
+    this.nativeCutoff = nativeCutoff;
+    return nativeCutoff;
+  }
+
+  /**
+   * Engine state from the latest audio block in a single read
+   */
+  public getTelemetry(): EngineTelemetry {
+    this.ensureInitialized();
+    return this.audioSystem!.getTelemetry();
   }
 
   /**
@@ -228,7 +462,142 @@ export class AudioService {
     const detune = Math.max(0, settings.detuneCents);
     const octave = Math.max(-2, Math.min(2, Math.round(settings.octaveOffset)));
 
+    // Mix and detune glide through the parameter block; switching the
+    // oscillator or its octave still goes through the native call
+    const shape = this.secondaryShape;
+    if (this.parameters && shape && shape.enabled === enabled && shape.octave === octave) {
+      if (enabled) {
+        this.parameters.set('secondaryMix', mix);
+        this.parameters.set('secondaryDetuneCents', detune);
+      }
+      return;
+    }
     this.audioSystem!.configureSecondaryOscillator(enabled, mix, detune, octave);
+    this.secondaryShape = { enabled, octave };
+  }
+
+  /**
+   * Route notes through the granular source instead of the oscillators.
+   */
+  public setGranularEnabled(enabled: boolean): void {
+    this.ensureInitialized();
+    this.audioSystem!.setGranularEnabled(Boolean(enabled));
+  }
+
+  /**
+   * Load mono sample data for the granular source.
+   */
+  public loadGranularSample(samples: Float32Array, sampleRate: number, rootFrequency?: number): void {
+    this.ensureInitialized();
+    this.audioSystem!.loadGranularSample(samples, sampleRate, rootFrequency);
+  }
+
+  /**
+   * Configure the granular cloud (density, grain length, position and spreads).
+   */
+  public configureGranular(settings: GranularSettings): void {
+    this.ensureInitialized();
+
+    this.audioSystem!.configureGranular(
+      Math.max(0.5, settings.density),
+      Math.max(5, settings.grainMs),
+      Math.max(0, Math.min(1, settings.position)),
+      Math.max(0, Math.min(1, settings.positionSpread)),
+      Math.max(0, settings.pitchSpreadCents),
+      Math.max(0, Math.min(1, settings.panSpread))
+    );
+  }
+
+  /**
+   * Engage or release the spectral freeze. Returns false if no freeze effect is active.
+   */
+  public setSpectralFreeze(frozen: boolean): boolean {
+    this.ensureInitialized();
+    return this.audioSystem!.setSpectralFreeze(Boolean(frozen));
+  }
+
+  /**
+   * Load mono sample data for the time-stretch player.
+   */
+  public loadTimeStretchSample(samples: Float32Array, sampleRate: number): void {
+    this.ensureInitialized();
+    this.audioSystem!.loadTimeStretchSample(samples, sampleRate);
+  }
+
+  /**
+   * Start or stop time-stretch playback.
+   */
+  public triggerTimeStretch(play: boolean = true): void {
+    this.ensureInitialized();
+    if (play) {
+      this.audioSystem!.triggerTimeStretch();
+    } else {
+      this.audioSystem!.stopTimeStretch();
+    }
+  }
+
+  /**
+   * Load a looping modulator sample for the vocoder.
+   */
+  public loadVocoderModulator(samples: Float32Array, sampleRate: number): void {
+    this.ensureInitialized();
+    this.audioSystem!.loadVocoderModulator(samples, sampleRate);
+  }
+
+  /**
+   * Route live device input through the engine.
+   * Returns false when the device was not opened full duplex.
+   */
+  public setLiveInputMode(mode: LiveInputMode, gain: number = 1.0): boolean {
+    this.ensureInitialized();
+    return this.audioSystem!.setLiveInputMode(mode, gain);
+  }
+
+  /**
+   * Feed the vocoder modulator from the loaded sample or from live input.
+   */
+  public setVocoderModulatorSource(source: 'sample' | 'live'): void {
+    this.ensureInitialized();
+    this.audioSystem!.setVocoderModulatorSource(source);
+  }
+
+  /**
+   * Read grains from the loaded sample or from the live input buffer.
+   */
+  public setGranularBufferMode(mode: 'sample' | 'live'): void {
+    this.ensureInitialized();
+    this.audioSystem!.setGranularBufferMode(mode);
+  }
+
+  /**
+   * Configure the master bus compressor.
+   */
+  public configureCompressor(settings: MasterCompressorSettings): void {
+    this.ensureInitialized();
+    this.audioSystem!.configureCompressor(
+      settings.enabled,
+      settings.thresholdDb,
+      settings.ratio,
+      settings.attackMs,
+      settings.releaseMs,
+      settings.makeupDb
+    );
+  }
+
+  /**
+   * Configure the master bus limiter.
+   */
+  public configureLimiter(enabled: boolean, ceilingDb: number = -1.0, releaseMs: number = 50): void {
+    this.ensureInitialized();
+    this.audioSystem!.configureLimiter(enabled, ceilingDb, releaseMs);
+  }
+
+  /**
+   * Latency added by the master bus limiter lookahead.
+   */
+  public getMasterLatency(): { frames: number; milliseconds: number; gainReductionDb: number } {
+    this.ensureInitialized();
+    return this.audioSystem!.getMasterLatency();
   }
 
   /**
@@ -243,15 +612,21 @@ export class AudioService {
     }
 
     const clamped = Math.max(-8192, Math.min(8191, Math.round(rawValue)));
+    if (this.parameters) {
+      // Same mapping as the native side: +/- one semitone
+      const normalized = clamped >= 0 ? clamped / 8191 : clamped / 8192;
+      this.parameters.set('pitchBendCents', normalized * 100);
+      return;
+    }
     this.audioSystem!.setPitchBend(clamped);
   }
 
   /**
-   * Get a snapshot of currently active note frequencies
+   * Get a snapshot of the held MIDI notes, oldest first
    */
-  public getActiveFrequencies(): number[] {
+  public getActiveNotes(): number[] {
     this.ensureInitialized();
-    return Array.from(this.activeFrequencies);
+    return [...this.activeNotes];
   }
 
   private ensureInitialized(): void {
@@ -0,0 +1,52 @@
+import { ParameterBlockInfo, ParameterName } from '../types/native';
+
+/** Layout version this writer understands (ParameterBlock::kVersion) */
+const SUPPORTED_VERSION = 1;
+
+/**
+ * @class ParameterBlockWriter
+ * @brief Writes continuous controller values straight into the engine's parameter block
+ *
+ * The native engine polls the block once per audio callback and glides to
+ * the new values, so a write here is a couple of atomic stores with no
+ * N-API call. Values are stored as float bits through an Int32Array because
+ * Atomics only operates on integer views.
+ */
+export class ParameterBlockWriter {
+  private readonly words: Int32Array;
+  private readonly dirtyWord: number;
+  private readonly firstValueWord: number;
+  private readonly parameters: Record<ParameterName, number>;
+  private readonly scratchFloat = new Float32Array(1);
+  private readonly scratchBits = new Int32Array(this.scratchFloat.buffer);
+
+  private constructor(info: ParameterBlockInfo) {
+    this.words = new Int32Array(info.buffer);
+    this.dirtyWord = info.dirtyWord;
+    this.firstValueWord = info.firstValueWord;
+    this.parameters = info.parameters;
+  }
+
+  /**
+   * Wrap a block, or return null if its layout is not one this writer knows
+   */
+  public static create(info: ParameterBlockInfo | undefined): ParameterBlockWriter | null {
+    if (!info || info.version !== SUPPORTED_VERSION) {
+      return null;
+    }
+    return new ParameterBlockWriter(info);
+  }
+
+  /**
+   * Store a value and flag it for the audio thread
+   */
+  public set(name: ParameterName, value: number): void {
+    if (!Number.isFinite(value)) {
+      return;
+    }
+    const index = this.parameters[name];
+    this.scratchFloat[0] = value;
+    Atomics.store(this.words, this.firstValueWord + index, this.scratchBits[0]);
+    Atomics.or(this.words, this.dirtyWord, 1 << index);
+  }
+}
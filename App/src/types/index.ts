@@ -10,8 +10,8 @@ export interface Note {
 
 export interface SynthState {
   isPlaying: boolean;
-  currentFrequency: number | null;
-  activeFrequencies: number[];
+  currentNote: number | null;
+  activeNotes: number[];
   waveform: 'sine' | 'square' | 'saw' | 'triangle';
   adsr: {
     attack: number;
@@ -28,3 +28,21 @@ export interface SecondaryOscillatorSettings {
   detuneCents: number; // >= 0
   octaveOffset: number; // -2 to +2
 }
+
+export interface GranularSettings {
+  density: number; // grains per second
+  grainMs: number; // grain length in milliseconds
+  position: number; // 0.0 - 1.0
+  positionSpread: number; // 0.0 - 1.0
+  pitchSpreadCents: number; // >= 0
+  panSpread: number; // 0.0 - 1.0
+}
+
+export interface MasterCompressorSettings {
+  enabled: boolean;
+  thresholdDb: number; // -60 - 0 dBFS
+  ratio: number; // 1 - 20
+  attackMs: number;
+  releaseMs: number;
+  makeupDb: number; // 0 - 24
+}
@@ -9,6 +9,11 @@ export interface StereoSample {
 
 export type WaveformType = 'sine' | 'square' | 'saw' | 'triangle';
 
+/**
+ * Routing of live device input through the engine
+ */
+export type LiveInputMode = 'off' | 'through' | 'mix' | 'sidechain';
+
 export interface ADSRParameters {
   attack: number;
   decay: number;
@@ -16,6 +21,162 @@ export interface ADSRParameters {
   release: number;
 }
 
+/**
+ * Audio clock snapshot: the latest rendered block and the host time it started
+ */
+export interface AudioClockInfo {
+  /** Frames rendered before the latest block */
+  frame: number;
+  /** Host time the block started (steady clock, ms); 0 before the first block */
+  hostTimeMs: number;
+  /** Host time of this call on the same clock */
+  nowMs: number;
+  /** Estimated frame being rendered now */
+  currentFrame: number;
+  sampleRate: number;
+  /** Requested device buffer size; schedule at least this far ahead */
+  bufferFrames: number;
+}
+
+/**
+ * Voice state in an engine telemetry snapshot
+ */
+export interface VoiceTelemetry {
+  /** Sounding MIDI note, -1 when none is held */
+  note: number;
+  channel: number;
+  /** Base frequency before drift and pitch bend (Hz) */
+  frequency: number;
+  velocity: number;
+  stage: 'idle' | 'attack' | 'decay' | 'sustain' | 'release';
+  envelopeLevel: number;
+}
+
+/**
+ * Render time of one stage, as a fraction of the block duration
+ * (1.0 = the stage alone took as long as the audio it rendered)
+ */
+export interface StageCost {
+  /** 'voice', 'masterBus', or the effect's name */
+  name: string;
+  /** Latest block */
+  last: number;
+  /** Exponential average, 0.5 s time constant */
+  average: number;
+  /** Highest block, decaying with a 2 s time constant */
+  peak: number;
+}
+
+/**
+ * Times one load governor action was applied and undone
+ */
+export interface GovernorActionCount {
+  shed: number;
+  restored: number;
+}
+
+/**
+ * Load governor state (see the <governor> config section)
+ */
+export interface GovernorTelemetry {
+  /** Steps currently shed */
+  level: number;
+  /** Steps in the ladder, 0 when the governor is off */
+  steps: number;
+  /** Blocks whose render took longer than their duration */
+  overruns: number;
+  /** Granular grains ended early by the grain limit */
+  stolenGrains: number;
+  actions: {
+    grains: GovernorActionCount;
+    unison: GovernorActionCount;
+    oversampling: GovernorActionCount;
+    tails: GovernorActionCount;
+  };
+}
+
+/**
+ * Bytes the engine holds, by component (see the <memory> config section)
+ */
+export interface MemoryTelemetry {
+  /** Effects in the rendered chain, with their slots */
+  effects: number;
+  /** Envelope and granular source (loaded sample, live ring, grain pool) */
+  voices: number;
+  /** Command queues, telemetry buffers, stage buffers and the waveform tap */
+  rings: number;
+  /** Tuning table, grain windows and FFT plans */
+  tables: number;
+  /** Master compressor and limiter */
+  master: number;
+  total: number;
+  /** Limit checked when effects are inserted, 0 when unlimited */
+  budget: number;
+  /** Effect insertions refused by the budget since start */
+  rejectedEffects: number;
+  /** Bytes of each effect, in chain order */
+  effectBytes: number[];
+}
+
+/**
+ * Engine state published by the audio thread after every block
+ */
+export interface EngineTelemetry {
+  /** Audio clock frame at the start of the block */
+  frame: number;
+  blockFrames: number;
+  heldNotes: number;
+  activeVoices: number;
+  voices: VoiceTelemetry[];
+  pitchBendCents: number;
+  /** Effective cutoff of the first low-pass effect, 0 without one */
+  lowPassCutoffHz: number;
+  effects: number;
+  /** Output peak per channel over the block */
+  peak: [number, number];
+  /** Output RMS per channel over the block */
+  rms: [number, number];
+  gainReductionDb: number;
+  /** Render time divided by the block duration */
+  cpuLoad: number;
+  /** Per-stage render time; effects are in chain order */
+  cost: {
+    voice: StageCost;
+    masterBus: StageCost;
+    effects: StageCost[];
+  };
+  governor: GovernorTelemetry;
+  memory: MemoryTelemetry;
+  pendingEvents: number;
+  droppedCommands: number;
+}
+
+/**
+ * Continuous controllers carried by the shared parameter block
+ */
+export type ParameterName =
+  | 'pitchBendCents'
+  | 'lowPassCutoffHz'
+  | 'secondaryMix'
+  | 'secondaryDetuneCents'
+  | 'driftRateHz'
+  | 'driftAmountCents';
+
+/**
+ * Shared parameter block: 32-bit words the audio thread polls once per block
+ */
+export interface ParameterBlockInfo {
+  buffer: ArrayBuffer;
+  /** Layout version */
+  version: number;
+  /** Word holding one dirty bit per parameter */
+  dirtyWord: number;
+  /** Word of the first value (float bits); parameter i is at firstValueWord + i */
+  firstValueWord: number;
+  /** Parameter index (dirty bit and value offset) by name */
+  parameters: Record<ParameterName, number>;
+}
+
 /**
  * Native AudioSystem interface exposed through N-API
  */
@@ -42,6 +203,63 @@ export interface IAudioSystemNative {
    */
   triggerNoteOff(frequency?: number): void;
 
+  /**
+   * Start a MIDI note; the engine resolves the pitch from its tuning table
+   * @param note - MIDI note number (0-127)
+   * @param velocity - Velocity (0.0-1.0, default 1); 0 releases the note
+   * @param channel - MIDI channel (0-15, default 0)
+   */
+  noteOn(note: number, velocity?: number, channel?: number): void;
+
+  /**
+   * Release a MIDI note, or every note when omitted
+   * @param note - MIDI note number (0-127)
+   * @param channel - MIDI channel (0-15, default 0)
+   */
+  noteOff(note?: number, channel?: number): void;
+
+  /**
+   * Start a MIDI note at a frame on the audio clock
+   * @param frame - Render frame (see getAudioClock); past frames play at the next block
+   */
+  noteOnAt(frame: number, note: number, velocity?: number, channel?: number): void;
+
+  /**
+   * Release a MIDI note at a frame on the audio clock
+   */
+  noteOffAt(frame: number, note: number, channel?: number): void;
+
+  /**
+   * Set the pitch bend (-8192 to 8191) at a frame on the audio clock
+   */
+  setPitchBendAt(frame: number, value: number): void;
+
+  /**
+   * Read the audio clock to schedule timed events
+   */
+  getAudioClock(): AudioClockInfo;
+
+  /**
+   * Shared block for continuous controllers; write it with ParameterBlockWriter
+   */
+  getParameterBlock(): ParameterBlockInfo;
+
+  /**
+   * Latest engine state snapshot (voices, cutoff, meters, CPU load)
+   */
+  getTelemetry(): EngineTelemetry;
+
+  /**
+   * Replace the note-to-frequency table used by noteOn()
+   * @param frequencies - 128 frequencies in Hz; invalid entries keep equal temperament
+   */
+  setTuningTable(frequencies: number[]): void;
+
+  /**
+   * Return to 12-tone equal temperament at A4 = 440 Hz
+   */
+  resetTuning(): void;
+
   /**
    * Reset all audio effects (clears internal state without removing from chain)
    */
@@ -92,6 +310,13 @@ export interface IAudioSystemNative {
    */
   getLowPassCutoff(): number;
 
+  /**
+   * Limit the memory the engine may hold; effects that would exceed it are
+   * not added (counted in getTelemetry().memory.rejectedEffects)
+   * @param megabytes - Budget in MB, 0 for no limit
+   */
+  setMemoryBudget(megabytes: number): void;
+
   /**
    * Add an octave effect to the effects chain
    * @param higher - true for higher octave, false for lower
@@ -109,6 +334,143 @@ export interface IAudioSystemNative {
   configureSecondaryOscillator(enabled: boolean, mix: number, detuneCents: number, octaveOffset: number): void;
   setPitchBend(value: number): void;
 
+  /**
+   * Switch note rendering between the oscillators and the granular source
+   * @param enabled - true to play notes through the granular source
+   */
+  setGranularEnabled(enabled: boolean): void;
+
+  /**
+   * Load mono sample data for the granular source
+   * @param samples - Mono samples
+   * @param sampleRate - Sample rate of the material in Hz
+   * @param rootFrequency - Pitch of the material in Hz (default: middle C)
+   */
+  loadGranularSample(samples: Float32Array, sampleRate: number, rootFrequency?: number): void;
+
+  /**
+   * Configure the granular cloud
+   * @param density - Grains per second
+   * @param grainMs - Grain length in milliseconds
+   * @param position - Read position (0.0 - 1.0)
+   * @param positionSpread - Random read position spread (0.0 - 1.0)
+   * @param pitchSpreadCents - Random per-grain detune range in cents
+   * @param panSpread - Random stereo spread (0.0 - 1.0)
+   */
+  configureGranular(
+    density: number,
+    grainMs: number,
+    position: number,
+    positionSpread: number,
+    pitchSpreadCents: number,
+    panSpread: number
+  ): void;
+
+  /**
+   * Add a spectral freeze effect to the effects chain
+   * @param mix - Level of the frozen layer (0.0 - 1.0, default 1.0)
+   */
+  addSpectralFreezeEffect(mix?: number): void;
+
+  /**
+   * Engage or release all spectral freeze effects in the chain
+   * @returns true if a freeze effect was found
+   */
+  setSpectralFreeze(frozen: boolean): boolean;
+
+  /**
+   * Add a spectral smear effect to the effects chain
+   * @param amount - Smear amount (0.0 - 1.0)
+   * @param mix - Wet/dry mix (0.0 - 1.0, default 1.0)
+   */
+  addSpectralSmearEffect(amount: number, mix?: number): void;
+
+  /**
+   * Add the time-stretch sample player to the effects chain
+   * @param speed - Playback speed (0.125 - 4.0), pitch is preserved
+   * @param gain - Output level of the player (default 1.0)
+   * @param loop - Loop the sample (default false)
+   */
+  addTimeStretchEffect(speed: number, gain?: number, loop?: boolean): void;
+
+  /**
+   * Load mono sample data for the time-stretch player
+   * @param samples - Mono samples
+   * @param sampleRate - Sample rate of the material in Hz
+   */
+  loadTimeStretchSample(samples: Float32Array, sampleRate: number): void;
+
+  /** Start time-stretch playback from the beginning */
+  triggerTimeStretch(): void;
+
+  /** Stop time-stretch playback */
+  stopTimeStretch(): void;
+
+  /**
+   * Add the channel vocoder to the effects chain (synth is the carrier)
+   * @param bands - Number of bands (16 - 32)
+   * @param mix - Wet/dry mix (0.0 - 1.0)
+   */
+  addVocoderEffect(bands: number, mix: number): void;
+
+  /**
+   * Load a looping mono modulator sample for the vocoder
+   * @param samples - Mono samples
+   * @param sampleRate - Sample rate of the material in Hz
+   */
+  loadVocoderModulator(samples: Float32Array, sampleRate: number): void;
+
+  /**
+   * Route device input (requires a full-duplex instance)
+   * @param mode - 'off', 'through', 'mix' or 'sidechain'
+   * @param gain - Gain applied to audible input (0.0 - 4.0)
+   * @returns True when the device is delivering input
+   */
+  setLiveInputMode(mode: LiveInputMode, gain?: number): boolean;
+
+  /** Choose whether the vocoder modulator is the loaded sample or live input */
+  setVocoderModulatorSource(source: 'sample' | 'live'): void;
+
+  /** Choose whether grains read the loaded sample or the live input buffer */
+  setGranularBufferMode(mode: 'sample' | 'live'): void;
+
+  /** True when the stream was opened with an input device */
+  isFullDuplex(): boolean;
+
+  /**
+   * Configure the master bus compressor (off by default)
+   * @param enabled - Whether the compressor is active
+   * @param thresholdDb - Threshold in dBFS (-60 - 0)
+   * @param ratio - Ratio above the threshold (1 - 20)
+   * @param attackMs - Attack time in milliseconds
+   * @param releaseMs - Release time in milliseconds
+   * @param makeupDb - Makeup gain in dB (0 - 24)
+   */
+  configureCompressor(enabled: boolean, thresholdDb: number, ratio: number,
+                      attackMs: number, releaseMs: number, makeupDb: number): void;
+
+  /**
+   * Configure the master bus lookahead limiter (on by default)
+   * @param enabled - Whether the limiter reduces gain
+   * @param ceilingDb - True-peak ceiling in dBFS (-24 - 0)
+   * @param releaseMs - Release time in milliseconds
+   */
+  configureLimiter(enabled: boolean, ceilingDb: number, releaseMs: number): void;
+
+  /**
+   * Delay added by the master bus and its current gain reduction
+   */
+  getMasterLatency(): { frames: number; milliseconds: number; gainReductionDb: number };
+
+  /**
+   * Bypass or re-enable effects in the chain without rebuilding it (crossfaded)
+   * @param effect - Effect name, e.g. 'delay', 'lowpass', 'freeze', 'smear', 'timestretch', 'vocoder'
+   * @param bypassed - True to take the effect out of the signal path
+   * @param keepWarm - Keep processing while bypassed so tails and state stay current
+   * @returns True if a matching effect is in the chain
+   */
+  setEffectBypass(effect: string, bypassed: boolean, keepWarm?: boolean): boolean;
+
   /**
    * Get MIDI device connection status
    * @returns Object with connection status and device name
@@ -123,13 +485,36 @@ export interface IAudioSystemNative {
   getRecentWaveform(maxFrames?: number): Float32Array;
 }
 
+/**
+ * Effect instances built at startup per type (0 to 16 each, default 2).
+ * Keep two of any type that is toggled, since a chain rebuild claims new
+ * instances before the old ones are released.
+ */
+export interface IEffectPoolLimits {
+  delay?: number;
+  lowPass?: number;
+  octave?: number;
+  spectralFreeze?: number;
+  spectralSmear?: number;
+}
+
 /**
  * Native module constructor
  */
 export interface IAudioSystemNativeConstructor {
-  new (sampleRate: number): IAudioSystemNative;
+  new (sampleRate: number, bufferFrames?: number, fullDuplex?: boolean, effectPool?: IEffectPoolLimits): IAudioSystemNative;
+}
+
+/**
+ * Same interface, with the engine, audio device and MIDI input running in a
+ * separate audioEngineHost process reached over shared memory
+ */
+export interface IRemoteAudioSystemNativeConstructor {
+  new (sampleRate: number, bufferFrames?: number, fullDuplex?: boolean, hostPath?: string,
+       effectPool?: IEffectPoolLimits): IAudioSystemNative;
 }
 
 export interface IAudioSystemNativeModule {
   AudioSystem: IAudioSystemNativeConstructor;
+  RemoteAudioSystem: IRemoteAudioSystemNativeConstructor;
 }
@@ -0,0 +1,292 @@
+/**
+ * @file bench_control.cpp
+ * @brief Concurrent control-API stress test for AudioSystem
+ *
+ * Several threads play the roles of a MIDI input, the UI and a sequencer and
+ * call the control API at once, while a render thread pulls blocks from the
+ * engine the way a device callback would, without opening any audio device.
+ *
+ * Reports command throughput, dropped commands, render cost per block, and
+ * the command-to-audio latency: the time from a call returning to the start
+ * of the first block rendered after it, which is where queued commands are
+ * applied.
+ *
+ * Build with -DBUILD_BENCHMARKS=ON and run audioStress [seconds] [--fast]
+ * (--help prints usage; anything else is rejected).
+ * --fast renders back to back instead of at the device rate. Configure with
+ * -DENABLE_TSAN=ON (or ./build.sh --tsan) to run the same load under
+ * ThreadSanitizer.
+ */
+
+#include "Core/audioSystem.h"
+#include "Effects/EffectPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr float kSampleRate = 48000.0f;
+constexpr unsigned int kBlockFrames = 256;
+
+/**
+ * @brief Call timestamps collected by one control thread
+ */
+struct ControlLog
+{
+    const char* name;
+    std::vector<Clock::time_point> posted;   ///< Time each call returned
+};
+
+double microseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+double percentile(std::vector<double>& values, double fraction)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    const std::size_t index = std::min(values.size() - 1U, static_cast<std::size_t>(fraction * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+/**
+ * @brief Latency from each call to the start of the next rendered block
+ */
+std::vector<double> applyLatencies(const ControlLog& log, const std::vector<Clock::time_point>& blockStarts)
+{
+    std::vector<double> latencies;
+    latencies.reserve(log.posted.size());
+    for (const auto& posted : log.posted)
+    {
+        auto block = std::lower_bound(blockStarts.begin(), blockStarts.end(), posted);
+        if (block != blockStarts.end())
+        {
+            latencies.push_back(microseconds(*block - posted));
+        }
+    }
+    return latencies;
+}
+
+void printUsage(const char* program)
+{
+    std::printf("usage: %s [seconds] [--fast]\n"
+                "  seconds  run length, at least 0.5 (default 5)\n"
+                "  --fast   render back to back instead of at the device rate\n",
+                program);
+}
+
+void report(const char* name, std::vector<double> latencies, double seconds)
+{
+    const std::size_t count = latencies.size();
+    const double p50 = percentile(latencies, 0.50);
+    const double p99 = percentile(latencies, 0.99);
+    const double worst = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+    std::printf("%-10s %12zu %12.0f %10.1f %10.1f %10.1f\n",
+                name, count, static_cast<double>(count) / seconds, p50, p99, worst);
+}
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 5.0;
+    bool fast = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        char* end = nullptr;
+        const double value = std::strtod(argv[i], &end);
+        if (std::strcmp(argv[i], "--fast") == 0)
+        {
+            fast = true;
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (end != argv[i] && *end == '\0' && value > 0.0)
+        {
+            seconds = std::max(0.5, value);
+        }
+        else
+        {
+            std::fprintf(stderr, "%s: unknown argument '%s'\n", argv[0], argv[i]);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("AudioSystem control stress test: %.1f s, %u-frame blocks at %.0f Hz%s\n",
+                seconds, kBlockFrames, static_cast<double>(kSampleRate), fast ? ", unpaced" : "");
+
+    AudioSystem audio(kSampleRate);
+    std::atomic<bool> running{true};
+
+    // Null backend: render blocks on a dedicated thread at the device rate for
+    // as long as the control threads post, so every call has a block after it.
+    // The reserve is only an estimate; the logs grow outside the timed region.
+    const std::size_t expectedBlocks = static_cast<std::size_t>(seconds * kSampleRate / kBlockFrames * (fast ? 64.0 : 2.0)) + 16U;
+    std::vector<Clock::time_point> blockStarts;
+    std::vector<double> renderMicros;
+    blockStarts.reserve(expectedBlocks);
+    renderMicros.reserve(expectedBlocks);
+    std::size_t lateBlocks = 0;
+
+    std::thread renderer([&]()
+    {
+        std::vector<float> output(2U * kBlockFrames);
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(kBlockFrames) / kSampleRate));
+        auto deadline = Clock::now();
+
+        while (running.load(std::memory_order_relaxed))
+        {
+            const auto start = Clock::now();
+            audio.renderBlock(nullptr, 0U, output.data(), kBlockFrames);
+            const auto end = Clock::now();
+            blockStarts.push_back(start);
+            renderMicros.push_back(microseconds(end - start));
+
+            if (!fast)
+            {
+                deadline += period;
+                if (end > deadline)
+                {
+                    ++lateBlocks;
+                    deadline = end;
+                }
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+    });
+
+    const std::size_t expectedCalls = static_cast<std::size_t>(seconds * 200000.0);
+    std::vector<ControlLog> logs = {{"midi", {}}, {"ui", {}}, {"sequencer", {}}};
+    for (auto& log : logs)
+    {
+        log.posted.reserve(expectedCalls);
+    }
+
+    auto record = [&](ControlLog& log)
+    {
+        if (log.posted.size() < log.posted.capacity())
+        {
+            log.posted.push_back(Clock::now());
+        }
+    };
+
+    // MIDI: dense note on/off pairs with pitch bend sweeps
+    std::thread midi([&]()
+    {
+        std::mt19937 random(1U);
+        std::uniform_int_distribution<int> noteDist(36, 84);
+        int bend = 0;
+        while (running.load(std::memory_order_relaxed))
+        {
+            const float frequency = 440.0f * std::pow(2.0f, static_cast<float>(noteDist(random) - 69) / 12.0f);
+            audio.triggerNote(frequency);
+            record(logs[0]);
+            bend = (bend + 512) % 16384;
+            audio.setPitchBend(bend - 8192);
+            record(logs[0]);
+            audio.triggerNoteOff(frequency);
+            record(logs[0]);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    // UI: envelope edits and effect chain rebuilds from a pool
+    std::thread ui([&]()
+    {
+        EffectPool pool(kSampleRate, false);
+        std::mt19937 random(2U);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        unsigned int iteration = 0;
+        while (running.load(std::memory_order_relaxed))
+        {
+            audio.updateADSRParameters(0.005f + 0.1f * unit(random), 0.05f + 0.2f * unit(random),
+                                       unit(random), 0.05f + 0.3f * unit(random));
+            record(logs[1]);
+
+            if (++iteration % 8U == 0U)
+            {
+                audio.clearEffects();
+                record(logs[1]);
+                if (auto delay = pool.acquireDelay(0.1f + 0.3f * unit(random), 0.4f, 0.3f))
+                {
+                    audio.addEffect(delay);
+                    record(logs[1]);
+                }
+                if (auto lowPass = pool.acquireLowPass(400.0f + 4000.0f * unit(random), 0.9f, 1.0f))
+                {
+                    audio.addEffect(lowPass);
+                    record(logs[1]);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    // Sequencer: steady sixteenth notes at a fast tempo
+    std::thread sequencer([&]()
+    {
+        const float pattern[] = {110.0f, 220.0f, 164.81f, 196.0f};
+        unsigned int step = 0;
+        auto next = Clock::now();
+        while (running.load(std::memory_order_relaxed))
+        {
+            const float frequency = pattern[step++ % 4U];
+            audio.triggerNote(frequency);
+            record(logs[2]);
+            next += std::chrono::milliseconds(25);
+            std::this_thread::sleep_until(next - std::chrono::milliseconds(5));
+            audio.triggerNoteOff(frequency);
+            record(logs[2]);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running.store(false);
+    midi.join();
+    ui.join();
+    sequencer.join();
+    renderer.join();
+
+    // Leave the engine empty so retired effects are released here
+    audio.triggerNoteOff();
+    audio.clearEffects();
+    std::vector<float> flush(2U * kBlockFrames);
+    audio.renderBlock(nullptr, 0U, flush.data(), kBlockFrames);
+    audio.clearEffects();
+
+    std::printf("\n%-10s %12s %12s %10s %10s %10s\n", "thread", "calls", "calls/s", "p50 us", "p99 us", "max us");
+    std::size_t totalCalls = 0;
+    for (const auto& log : logs)
+    {
+        report(log.name, applyLatencies(log, blockStarts), seconds);
+        totalCalls += log.posted.size();
+    }
+
+    std::vector<double> render(renderMicros);
+    std::printf("\ntotal calls: %zu (%.0f/s), dropped commands: %zu\n",
+                totalCalls, static_cast<double>(totalCalls) / seconds, audio.droppedCommands());
+    std::printf("blocks: %zu, late: %zu, render us p50 %.1f p99 %.1f (budget %.1f)\n",
+                renderMicros.size(), lateBlocks, percentile(render, 0.50), percentile(render, 0.99),
+                1.0e6 * kBlockFrames / static_cast<double>(kSampleRate));
+    return 0;
+}
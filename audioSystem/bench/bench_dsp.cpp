@@ -0,0 +1,416 @@
+/**
+ * @file bench_dsp.cpp
+ * @brief Micro-benchmarks for the DSP building blocks in src/Dsp
+ *
+ * Build with -DBUILD_BENCHMARKS=ON and run audioBench from the build directory.
+ * Every case reports the median time of several timed batches so a single
+ * scheduler hiccup does not skew the result. The kernel table compares every
+ * SimdLevel the host supports; AUDIO_SIMD=<level> caps the level used by the
+ * other cases. The FFT is first checked against a direct DFT at every level,
+ * and the exit status is non-zero if any transform is wrong.
+ */
+
+#include "Dsp/FFT.h"
+#include "Dsp/FilterBank.h"
+#include "Dsp/Dynamics.h"
+#include "Dsp/SimdKernels.h"
+#include "Dsp/SampleConverter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr int kBatches = 9;
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+/**
+ * @brief Time a callable and return the median nanoseconds per call
+ * @param iterations Calls per timed batch
+ * @param fn Operation under test
+ */
+template <typename Fn>
+double medianNanoseconds(std::size_t iterations, Fn&& fn)
+{
+    std::vector<double> results;
+    results.reserve(kBatches);
+
+    for (int batch = 0; batch < kBatches; ++batch)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            fn();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double total = std::chrono::duration<double, std::nano>(end - start).count();
+        results.push_back(total / static_cast<double>(iterations));
+    }
+
+    std::sort(results.begin(), results.end());
+    return results[results.size() / 2U];
+}
+
+void benchRealFFT()
+{
+    std::printf("\nRealFFT (forward + inverse round trip)\n");
+    std::printf("%8s %14s %14s %12s %14s\n", "size", "forward ns", "inverse ns", "ns/sample", "max error");
+
+    std::mt19937 random(1234U);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    for (std::size_t size = RealFFT::kMinSize; size <= RealFFT::kMaxSize; size *= 2U)
+    {
+        RealFFT fft(size);
+        std::vector<float> input(size);
+        std::vector<float> spectrum(2U * fft.binCount());
+        std::vector<float> output(size);
+
+        for (auto& sample : input)
+        {
+            sample = dist(random);
+        }
+
+        // Keep total work per batch roughly constant across sizes
+        const std::size_t iterations = std::max<std::size_t>(16U, (1U << 22) / size);
+
+        const double forwardNs = medianNanoseconds(iterations, [&]() { fft.forward(input.data(), spectrum.data()); });
+        const double inverseNs = medianNanoseconds(iterations, [&]() { fft.inverse(spectrum.data(), output.data()); });
+
+        float maxError = 0.0f;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            maxError = std::max(maxError, std::fabs(output[i] - input[i]));
+        }
+
+        std::printf("%8zu %14.1f %14.1f %12.3f %14.3g\n",
+                    size, forwardNs, inverseNs, forwardNs / static_cast<double>(size), static_cast<double>(maxError));
+    }
+}
+
+/**
+ * @brief Largest error of a forward transform against a double-precision DFT, relative to the peak bin
+ * @param input size interleaved complex values
+ * @param output Transform of input to check
+ */
+double dftError(const std::vector<float>& input, const std::vector<float>& output, std::size_t size)
+{
+    std::vector<double> cosine(size);
+    std::vector<double> sine(size);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        const double angle = -kTwoPi * static_cast<double>(k) / static_cast<double>(size);
+        cosine[k] = std::cos(angle);
+        sine[k] = std::sin(angle);
+    }
+
+    double peak = 0.0;
+    double maxError = 0.0;
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        double re = 0.0;
+        double im = 0.0;
+        for (std::size_t n = 0; n < size; ++n)
+        {
+            const std::size_t index = (k * n) % size;
+            const double xr = input[2U * n];
+            const double xi = input[2U * n + 1U];
+            re += xr * cosine[index] - xi * sine[index];
+            im += xr * sine[index] + xi * cosine[index];
+        }
+        peak = std::max(peak, std::hypot(re, im));
+        maxError = std::max(maxError, std::hypot(output[2U * k] - re, output[2U * k + 1U] - im));
+    }
+    return maxError / std::max(peak, 1e-30);
+}
+
+/**
+ * @brief Check every level's FFT stage kernel, and RealFFT, against a direct DFT
+ * @return false if any transform is off by more than float rounding explains
+ */
+bool checkFFT()
+{
+    std::printf("\nFFT vs direct DFT (max error / peak bin)\n");
+    std::printf("%-8s %8s %14s\n", "level", "size", "error");
+
+    constexpr double kTolerance = 1e-5;
+    std::mt19937 random(99U);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    bool passed = true;
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512};
+    for (std::size_t size = FFTPlan::kMinSize; size <= 4096U; size *= 2U)
+    {
+        std::vector<float> input(2U * size);
+        for (auto& value : input)
+        {
+            value = dist(random);
+        }
+        std::vector<float> twiddles(size);
+        for (std::size_t k = 0; k < size / 2U; ++k)
+        {
+            const double angle = -kTwoPi * static_cast<double>(k) / static_cast<double>(size);
+            twiddles[2U * k] = static_cast<float>(std::cos(angle));
+            twiddles[2U * k + 1U] = static_cast<float>(std::sin(angle));
+        }
+
+        for (SimdLevel level : levels)
+        {
+            const SimdKernels& kernels = simdKernelsFor(level);
+            if (kernels.level != level)
+            {
+                continue;
+            }
+
+            // Same stage order as FFTPlan::forward()
+            std::vector<float> a(input);
+            std::vector<float> b(2U * size);
+            for (std::size_t n = size, s = 1U; n > 1U; n /= 2U, s *= 2U)
+            {
+                kernels.fftStage(n, s, a.data(), b.data(), twiddles.data(), 1.0f);
+                a.swap(b);
+            }
+
+            const double error = dftError(input, a, size);
+            passed = passed && error < kTolerance;
+            std::printf("%-8s %8zu %14.3g%s\n", simdLevelName(level), size, error, error < kTolerance ? "" : "  FAIL");
+        }
+
+        if (size < RealFFT::kMinSize)
+        {
+            continue;
+        }
+
+        // The real transform of size samples is the complex DFT of them with zero imaginary parts
+        std::vector<float> samples(size);
+        std::vector<float> complexSamples(2U * size, 0.0f);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            samples[i] = input[i];
+            complexSamples[2U * i] = input[i];
+        }
+        RealFFT fft(size);
+        std::vector<float> spectrum(2U * fft.binCount());
+        fft.forward(samples.data(), spectrum.data());
+        std::vector<float> full(2U * size, 0.0f);
+        for (std::size_t k = 0; k < fft.binCount(); ++k)
+        {
+            full[2U * k] = spectrum[2U * k];
+            full[2U * k + 1U] = spectrum[2U * k + 1U];
+            if (k > 0U && k < size / 2U)
+            {
+                full[2U * (size - k)] = spectrum[2U * k];
+                full[2U * (size - k) + 1U] = -spectrum[2U * k + 1U];
+            }
+        }
+        const double error = dftError(complexSamples, full, size);
+        passed = passed && error < kTolerance;
+        std::printf("%-8s %8zu %14.3g%s\n", "real", size, error, error < kTolerance ? "" : "  FAIL");
+    }
+    return passed;
+}
+
+void benchFilterBank()
+{
+    std::printf("\nBiquadBank + EnvelopeBank (one input sample through every band)\n");
+    std::printf("%8s %14s %14s\n", "bands", "ns/sample", "ns/band");
+
+    for (std::size_t bands = 8; bands <= 64; bands *= 2U)
+    {
+        BiquadBank bank(bands);
+        EnvelopeBank envelopes(bank.paddedCount());
+        envelopes.setTimes(0.005f, 0.05f, 44100.0f);
+        for (std::size_t band = 0; band < bands; ++band)
+        {
+            bank.setBandPass(band, 80.0f * std::pow(1.15f, static_cast<float>(band)), 8.0f, 44100.0f);
+        }
+
+        std::vector<float> outputs(bank.paddedCount());
+        float phase = 0.0f;
+        const double ns = medianNanoseconds(1U << 16, [&]()
+        {
+            phase += 0.01f;
+            bank.process(std::sin(phase), outputs.data());
+            envelopes.process(outputs.data());
+        });
+
+        std::printf("%8zu %14.1f %14.2f\n", bands, ns, ns / static_cast<double>(bands));
+    }
+}
+
+void benchDynamics()
+{
+    std::printf("\nMaster dynamics (interleaved stereo, 512-frame blocks)\n");
+    std::printf("%-22s %14s\n", "stage", "ns/frame");
+
+    constexpr std::size_t kFrames = 512;
+    std::mt19937 random(99U);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    std::vector<float> source(2U * kFrames);
+    for (auto& sample : source)
+    {
+        sample = dist(random);
+    }
+    std::vector<float> block(source);
+
+    Compressor compressor(48000.0f);
+    compressor.setEnabled(true);
+    const double compressorNs = medianNanoseconds(256U, [&]()
+    {
+        std::copy(source.begin(), source.end(), block.begin());
+        compressor.process(block.data(), kFrames);
+    });
+
+    LookaheadLimiter limiter(48000.0f);
+    const double limiterNs = medianNanoseconds(256U, [&]()
+    {
+        std::copy(source.begin(), source.end(), block.begin());
+        limiter.process(block.data(), kFrames);
+    });
+
+    limiter.setTruePeak(false);
+    const double samplePeakNs = medianNanoseconds(256U, [&]()
+    {
+        std::copy(source.begin(), source.end(), block.begin());
+        limiter.process(block.data(), kFrames);
+    });
+
+    std::printf("%-22s %14.2f\n", "compressor", compressorNs / kFrames);
+    std::printf("%-22s %14.2f\n", "limiter (true peak)", limiterNs / kFrames);
+    std::printf("%-22s %14.2f\n", "limiter (sample peak)", samplePeakNs / kFrames);
+    std::printf("limiter latency: %zu frames at 48 kHz\n", limiter.latencyFrames());
+}
+
+void benchSimdKernels()
+{
+    std::printf("\nSIMD kernels by level (ns per call, 64 bands / 256 frames)\n");
+    std::printf("%-8s %12s %12s %12s %12s %12s %12s\n", "level", "biquad", "envelope", "dot", "peaks", "gain", "quantize");
+
+    constexpr std::size_t kBands = 64;
+    constexpr std::size_t kFrames = 256;
+    std::mt19937 random(7U);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    std::vector<float> coeffs(5U * kBands);
+    for (auto& value : coeffs)
+    {
+        value = 0.2f * dist(random);
+    }
+    std::vector<float> state(2U * kBands, 0.0f);
+    std::vector<float> bands(kBands);
+    std::vector<float> envelope(kBands, 0.0f);
+    std::vector<float> audio(2U * kFrames);
+    for (auto& sample : audio)
+    {
+        sample = dist(random);
+    }
+    std::vector<float> perFrame(kFrames, 0.999f);
+    std::vector<float> noise(2U * kFrames, 0.25f);
+    std::vector<std::int32_t> codes(2U * kFrames);
+
+    const BiquadLanes lanes = {&coeffs[0], &coeffs[kBands], &coeffs[2U * kBands], &coeffs[3U * kBands],
+                               &coeffs[4U * kBands], &state[0], &state[kBands]};
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512};
+
+    for (SimdLevel level : levels)
+    {
+        const SimdKernels& kernels = simdKernelsFor(level);
+        if (kernels.level != level)
+        {
+            continue;
+        }
+
+        float input = 0.0f;
+        const double biquadNs = medianNanoseconds(1U << 16, [&]()
+        {
+            input = -input + 0.25f;
+            kernels.biquadBank(lanes, input, bands.data(), kBands);
+        });
+        const double envelopeNs = medianNanoseconds(1U << 16, [&]()
+        {
+            kernels.envelopeFollow(bands.data(), envelope.data(), kBands, 0.3f, 0.01f);
+        });
+        float sumLeft = 0.0f;
+        float sumRight = 0.0f;
+        const double dotNs = medianNanoseconds(1U << 16, [&]()
+        {
+            kernels.dualDotProduct(envelope.data(), bands.data(), audio.data(), kBands, &sumLeft, &sumRight);
+            envelope[0] = sumLeft * 1e-9f;
+        });
+        const double peaksNs = medianNanoseconds(1U << 14, [&]()
+        {
+            kernels.linkedPeaks(audio.data(), perFrame.data(), kFrames);
+        });
+        std::fill(perFrame.begin(), perFrame.end(), 1.0f);
+        const double gainNs = medianNanoseconds(1U << 14, [&]()
+        {
+            kernels.applyStereoGain(audio.data(), perFrame.data(), kFrames);
+        });
+        const double quantizeNs = medianNanoseconds(1U << 14, [&]()
+        {
+            kernels.quantizeSamples(audio.data(), noise.data(), codes.data(), 2U * kFrames, 32768.0f, 32767.0f);
+        });
+
+        std::printf("%-8s %12.1f %12.1f %12.1f %12.1f %12.1f %12.1f\n",
+                    simdLevelName(level), biquadNs, envelopeNs, dotNs, peaksNs, gainNs, quantizeNs);
+    }
+    std::printf("selected: %s\n", simdLevelName(simdKernels().level));
+}
+
+void benchSampleConverter()
+{
+    std::printf("\nOutput conversion (interleaved stereo, 512-frame blocks)\n");
+    std::printf("%-22s %14s\n", "format", "ns/frame");
+
+    constexpr std::size_t kFrames = 512;
+    std::mt19937 random(5U);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> source(2U * kFrames);
+    for (auto& sample : source)
+    {
+        sample = dist(random);
+    }
+    std::vector<std::int32_t> device(2U * kFrames);
+
+    struct Case
+    {
+        const char* name;
+        SampleFormat format;
+        bool dither;
+        bool noiseShaping;
+    };
+    const Case cases[] = {
+        {"s32", SampleFormat::Int32, false, false},
+        {"s24 dither", SampleFormat::Int24, true, false},
+        {"s16", SampleFormat::Int16, false, false},
+        {"s16 dither", SampleFormat::Int16, true, false},
+        {"s16 noise shaped", SampleFormat::Int16, true, true},
+    };
+
+    for (const Case& test : cases)
+    {
+        SampleConverter converter(test.format, test.dither, test.noiseShaping);
+        const double ns = medianNanoseconds(1024U, [&]()
+        {
+            converter.fromFloat(source.data(), device.data(), kFrames);
+        });
+        std::printf("%-22s %14.2f\n", test.name, ns / kFrames);
+    }
+}
+}
+
+int main()
+{
+    std::printf("AudioSystem DSP benchmarks\n");
+    const bool fftCorrect = checkFFT();
+    benchSimdKernels();
+    benchRealFFT();
+    benchFilterBank();
+    benchDynamics();
+    benchSampleConverter();
+    return fftCorrect ? 0 : 1;
+}
@@ -20,6 +20,9 @@ BUILD_GUI="ON"
 BUILD_DIR="build"
 CLEAN_BUILD=false
 INSTALL_DEPS=false
+BUILD_BENCHMARKS="OFF"
+BUILD_TESTS="OFF"
+ENABLE_TSAN="OFF"
 
 # Parse command line arguments
 while [[ $# -gt 0 ]]; do
@@ -44,6 +47,21 @@ while [[ $# -gt 0 ]]; do
             INSTALL_DEPS=true
             shift
             ;;
+        --bench)
+            BUILD_BENCHMARKS="ON"
+            shift
+            ;;
+        --tests)
+            BUILD_TESTS="ON"
+            shift
+            ;;
+        --tsan)
+            ENABLE_TSAN="ON"
+            BUILD_BENCHMARKS="ON"
+            BUILD_TESTS="ON"
+            BUILD_DIR="build-tsan"
+            shift
+            ;;
         --build-dir)
             BUILD_DIR="$2"
             shift 2
@@ -57,6 +75,9 @@ while [[ $# -gt 0 ]]; do
             echo "  --no-gui        Skip GUI application build"
             echo "  --clean         Clean build directory before building"
             echo "  --install-deps  Install system dependencies"
+            echo "  --bench         Build the benchmarks (audioBench, audioStress)"
+            echo "  --tests         Build the engine tests (test_engine, run with ctest)"
+            echo "  --tsan          Build with ThreadSanitizer into build-tsan (implies --bench --tests)"
             echo "  --build-dir DIR Use custom build directory (default: build)"
             echo "  --help, -h      Show this help message"
             exit 0
@@ -125,6 +146,9 @@ cd "$BUILD_DIR"
 echo -e "${YELLOW}⚙️  Configuring CMake...${NC}"
 cmake -DCMAKE_BUILD_TYPE="$BUILD_TYPE" \
       -DBUILD_GUI="$BUILD_GUI" \
+      -DBUILD_BENCHMARKS="$BUILD_BENCHMARKS" \
+      -DBUILD_TESTS="$BUILD_TESTS" \
+      -DENABLE_TSAN="$ENABLE_TSAN" \
       ..
 
 # Build
@@ -142,6 +166,12 @@ echo -e "  Console app: ${GREEN}./$BUILD_DIR/bin/audioApp${NC}"
 if [ "$BUILD_GUI" = "ON" ] && [ -f "bin/audioGUI" ]; then
     echo -e "  GUI app:     ${GREEN}./$BUILD_DIR/bin/audioGUI${NC}"
 fi
+if [ "$BUILD_BENCHMARKS" = "ON" ]; then
+    echo -e "  Stress test: ${GREEN}./$BUILD_DIR/bin/audioStress [seconds] [--fast]${NC}"
+fi
+if [ "$BUILD_TESTS" = "ON" ]; then
+    echo -e "  Tests:       ${GREEN}./$BUILD_DIR/bin/test_engine${NC} (or ctest in $BUILD_DIR)"
+fi
 
 echo ""
 echo -e "${BLUE}🔧 To install system-wide:${NC}"
@@ -1,5 +1,4 @@
 #include "AudioSystemAdapter.h"
-#include "Common/notes.h"
 #include <cmath>
 #include <stdexcept>
 
@@ -19,21 +18,21 @@ void AudioSystemAdapter::update(void* params)
     
     // Cast params to MidiEvent
     const MidiEvent* event = static_cast<const MidiEvent*>(params);
+
+    // Counted as MIDI input in the engine's block stats
+    AudioSystem::MidiInputScope midiInput;
     
     switch (event->type) {
         case MidiEventType::NOTE_ON:
         {
-            const unsigned char noteNumber = event->data1;
-            if (noteNumber < MIDI_NOTE_FREQUENCIES.size()) {
-                itsAudioSystem->triggerNote(MIDI_NOTE_FREQUENCIES[noteNumber]);
-            }
+            // Velocity 0 is a note off; noteOn() handles that case
+            itsAudioSystem->noteOn(event->data1, static_cast<float>(event->data2) / 127.0f, event->channel);
             break;
         }
         case MidiEventType::NOTE_OFF:
         {
-            const unsigned char noteNumber = event->data1;
-            if (noteNumber < MIDI_NOTE_FREQUENCIES.size()) {
-                itsAudioSystem->triggerNoteOff(MIDI_NOTE_FREQUENCIES[noteNumber]);
+            if (event->data1 < AudioSystem::kMidiNotes) {
+                itsAudioSystem->noteOff(event->data1, event->channel);
             } else {
                 itsAudioSystem->triggerNoteOff();
             }
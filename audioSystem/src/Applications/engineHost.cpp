@@ -0,0 +1,91 @@
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <csignal>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include "audioSystem.h"
+#include "audioDevice.h"
+#include "FlightRecorder.h"
+#include "Host/EngineHost.h"
+#include "Host/SharedMemory.h"
+#include "Trace.h"
+
+/**
+ * @file engineHost.cpp
+ * @brief Standalone engine process driven by the Node addon over shared memory
+ *
+ * Usage: audioEngineHost <shared-memory-name>
+ *
+ * The addon (EngineHostClient) creates and initialises the mapping, then
+ * starts this process. Sample rate, buffer size and duplex mode come from
+ * the mapping; the process exits on a Shutdown command, SIGTERM/SIGINT, or
+ * when its parent goes away.
+ */
+
+namespace {
+    volatile std::sig_atomic_t g_stopRequested = 0;
+
+    void requestStop(int) {
+        g_stopRequested = 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <shared-memory-name>" << std::endl;
+        return 2;
+    }
+
+    // Ask the kernel to stop us with the addon; the getppid() check below covers the race
+    const pid_t parent = getppid();
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    std::signal(SIGTERM, requestStop);
+    std::signal(SIGINT, requestStop);
+
+    SharedMemory memory;
+    try {
+        memory = SharedMemory::open(argv[1]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    if (memory.size() < sizeof(EngineHostShared)) {
+        std::cerr << "Error: shared memory " << argv[1] << " is too small" << std::endl;
+        return 1;
+    }
+    EngineHostShared& shared = *static_cast<EngineHostShared*>(memory.data());
+
+    try {
+        auto traceDumper = Trace::TraceDumper::fromEnvironment();
+        AudioSystem audioSystem(shared.sampleRate);
+        AudioDevice audioDevice(&audioSystem, shared.sampleRate, shared.bufferFrames, shared.fullDuplexRequested != 0U);
+        // AUDIO_XRUN_DIR=<dir> writes the latest callbacks there after an xrun
+        auto xrunDumper = FlightRecorderDumper::fromEnvironment(audioDevice.flightRecorder(), 10.0);
+        EngineHost host(shared, audioSystem, &audioDevice);
+
+        host.openMidiInput();
+        host.markRunning();
+        while (g_stopRequested == 0 && getppid() == parent && host.poll()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        host.closeMidiInput();
+        audioDevice.stop();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        const std::string message = e.what();
+        const std::size_t length = std::min(message.size(), EngineHostShared::kErrorBytes - 1U);
+        message.copy(shared.error, length);
+        shared.error[length] = '\0';
+        shared.state.store(static_cast<std::uint32_t>(HostState::Failed), std::memory_order_release);
+        return 1;
+    }
+
+    return 0;
+}
@@ -2,14 +2,25 @@
 #include <thread>
 #include <chrono>
 #include <stdexcept>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <array>
+#include <csignal>
+#include <pthread.h>
 #include "audioSystem.h"
 #include "audioDevice.h"
+#include "FlightRecorder.h"
 #include "Midi/MidiDevice.h"
 #include "AudioSequencer.h"
 #include "notes.h"
 #include "AudioSystemAdapter.h"
 #include "ConfigReader.h"
 #include "AudioConfig.h"
+#include "ParameterBlock.h"
+#include "Control/ControlServer.h"
+#include "Trace.h"
 
 /**
  * @brief Initialize and configure the audio system from XML configuration
@@ -26,6 +37,81 @@ AudioSystem initializeAudioSystem(const AudioConfig& config) {
     return audioSystem;
 }
 
+/**
+ * @brief Prints the engine telemetry once a second while in scope
+ *
+ * Enabled by setting AUDIO_STATUS to a non-zero value.
+ */
+class StatusPrinter {
+public:
+    explicit StatusPrinter(AudioSystem& audioSystem) : m_audioSystem(audioSystem), m_running(true) {
+        const char* status = std::getenv("AUDIO_STATUS");
+        if (status != nullptr && status[0] != '\0' && status[0] != '0') {
+            m_thread = std::thread([this]() { run(); });
+        }
+    }
+
+    ~StatusPrinter() {
+        m_running.store(false);
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+private:
+    void run() {
+        static const char* const stageNames[] = {"idle", "attack", "decay", "sustain", "release"};
+        while (m_running.load()) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const EngineTelemetry state = m_audioSystem.telemetry();
+            const VoiceTelemetry& voice = state.voices[0];
+
+            // Most expensive stage by average cost
+            const StageCost* top = &state.voiceCost;
+            for (std::uint32_t i = 0; i < state.effects && i < EngineTelemetry::kMaxEffects; ++i) {
+                if (state.effectCosts[i].average > top->average) {
+                    top = &state.effectCosts[i];
+                }
+            }
+            std::printf("[status] notes %d  note %d %-7s %.2f  bend %+.0f c  cutoff %.0f Hz  peak %.2f/%.2f  GR %.1f dB  cpu %.1f%% (top %s %.1f%%)  shed %u/%u  overruns %u  mem %.1f MB  dropped %zu\n",
+                        state.heldNotes, voice.note, stageNames[static_cast<int>(voice.stage)], voice.envelopeLevel,
+                        state.pitchBendCents, state.lowPassCutoffHz, state.peak[0], state.peak[1],
+                        state.gainReductionDb, 100.0f * state.cpuLoad, top->name, 100.0f * top->average,
+                        state.governor.level, state.governor.steps, state.governor.overruns,
+                        static_cast<double>(state.memory.total) / (1024.0 * 1024.0), state.droppedCommands);
+            std::fflush(stdout);
+        }
+    }
+
+    AudioSystem& m_audioSystem;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+};
+
+/**
+ * @brief Block SIGINT and SIGTERM in this thread and every thread it starts
+ *
+ * Call before any thread is created, so the signals are only taken by
+ * waitForShutdownSignal().
+ */
+sigset_t blockShutdownSignals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    return signals;
+}
+
+/**
+ * @brief Wait for SIGINT or SIGTERM blocked by blockShutdownSignals()
+ */
+void waitForShutdownSignal(const sigset_t& signals) {
+    int signal = 0;
+    sigwait(&signals, &signal);
+    std::cout << "\nReceived " << (signal == SIGTERM ? "SIGTERM" : "SIGINT") << std::endl;
+}
+
 /**
  * @brief Main application entry point
  */
@@ -38,10 +124,53 @@ int main()
         ConfigReader    configReader;
         std::string     configPath = "config/config.xml";
         AudioConfig     config = configReader.loadConfigWithFallback(configPath);
+
+        // With a control socket the app runs headless: stdin is ignored and
+        // SIGINT/SIGTERM stop it, so block them before any thread starts
+        const bool headless = !config.controlSocket.empty();
+        sigset_t shutdownSignals;
+        sigemptyset(&shutdownSignals);
+        if (headless) {
+            shutdownSignals = blockShutdownSignals();
+        }
+
+        // AUDIO_TRACE=<file> writes a Chrome trace of the engine (ENABLE_TRACING builds)
+        auto traceDumper = Trace::TraceDumper::fromEnvironment();
+
+        // Continuous controllers from the control server; outlives the engine reading it
+        std::array<std::uint32_t, ParameterBlock::kWords> parameterWords{};
+        ParameterBlock parameterBlock(parameterWords.data());
         
         // Initialize audio system with configuration
         AudioSystem audioSystem = initializeAudioSystem(config);
-        AudioDevice audioDevice(&audioSystem, config.sampleRate, config.bufferFrames);
+        if (headless) {
+            audioSystem.setParameterBlock(&parameterBlock);
+        }
+        const bool liveInput = audioSystem.liveInputMode() != AudioSystem::LiveInputMode::Off;
+
+        // <outputFormat> auto prefers float and falls back to the device's native integer format
+        AudioDevice::OutputFormat outputFormat;
+        outputFormat.dither = config.outputDither;
+        outputFormat.noiseShaping = config.outputNoiseShaping;
+        if (config.outputFormat != "auto") {
+            if (sampleFormatFromName(config.outputFormat, outputFormat.format)) {
+                outputFormat.native = false;
+            } else {
+                std::cerr << "Warning: unknown output format '" << config.outputFormat << "', using auto" << std::endl;
+            }
+        }
+        AudioDevice audioDevice(&audioSystem, config.sampleRate, config.bufferFrames, liveInput, outputFormat);
+
+        // <flightRecorder> writes the latest callbacks to disk after an xrun
+        std::unique_ptr<FlightRecorderDumper> xrunDumper;
+        if (!config.xrunDirectory.empty()) {
+            try {
+                xrunDumper.reset(new FlightRecorderDumper(audioDevice.flightRecorder(), config.xrunDirectory,
+                                                          config.xrunSeconds));
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: xrun dumps disabled: " << e.what() << std::endl;
+            }
+        }
 
         // Create the AudioSystemAdapter for MIDI integration
         AudioSystemAdapter audioSystemAdapter(&audioSystem);
@@ -50,6 +179,18 @@ int main()
         std::cout << "Starting audio device..." << std::endl;
         audioDevice.start();
 
+        // AUDIO_STATUS=1 prints engine telemetry once a second
+        StatusPrinter statusPrinter(audioSystem);
+
+        // <control><socket> opens the binary control plane (see Control/ControlProtocol.h)
+        std::unique_ptr<ControlServer> controlServer;
+        if (headless) {
+            controlServer.reset(new ControlServer(config.controlSocket, config.presetDirectory,
+                                                  audioSystem, parameterBlock));
+            controlServer->start();
+            std::cout << "Control server listening on " << config.controlSocket << std::endl;
+        }
+
         // Add a delay to let the audio system initialize fully
         std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         
@@ -64,14 +205,18 @@ int main()
             
             std::cout << "🎵 Audio system ready in SEQUENCER mode!" << std::endl;
             std::cout << "Playing " << config.sequenceType << " sequence..." << std::endl;
-            std::cout << "Press Enter to replay, or Ctrl+C to stop." << std::endl;
+            std::cout << (headless ? "Send SIGTERM or press Ctrl+C to stop." : "Press Enter to replay, or Ctrl+C to stop.") << std::endl;
             
             // Play the initial sequence
             sequencer.playSequenceOnce(config.sequenceType);
+
+            if (headless) {
+                waitForShutdownSignal(shutdownSignals);
+            }
             
             // Main program loop - replay sequence when user presses Enter
             std::string input;
-            while (std::getline(std::cin, input)) {
+            while (!headless && std::getline(std::cin, input)) {
                 if (input.empty()) {
                     // Empty input (just Enter pressed) - replay sequence
                     std::cout << "\n🔄 Replaying sequence..." << std::endl;
@@ -96,14 +241,22 @@ int main()
             std::cout << "Starting MIDI device..." << std::endl;
             midiDevice.start();
             
-            std::cout << "🎹 Audio system ready in MIDI mode! Play your MIDI controller or press Enter to stop..." << std::endl;
+            std::cout << "🎹 Audio system ready in MIDI mode! Play your MIDI controller or "
+                      << (headless ? "send SIGTERM to stop..." : "press Enter to stop...") << std::endl;
             
             // Main program loop - keep system alive while waiting for input
-            std::cin.get();
+            if (headless) {
+                waitForShutdownSignal(shutdownSignals);
+            } else {
+                std::cin.get();
+            }
             
             std::cout << "Shutting down MIDI device..." << std::endl;
             midiDevice.stop();
         }
+        if (controlServer) {
+            controlServer->Stop();
+        }
         audioDevice.stop();
         
         // Final sleep to ensure all resources are released
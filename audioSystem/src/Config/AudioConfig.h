@@ -21,12 +21,47 @@ struct AudioConfig
     float defaultFrequency;             ///< Default frequency for testing (Hz)
     std::string inputMode;              ///< Input mode: "midi" or "sequencer" for testing
     std::string sequenceType;           ///< Type of sequence for sequencer mode
+    std::string liveInput;              ///< Live input routing: "off", "through", "mix" or "sidechain"
+    float liveInputGain;                ///< Gain applied to live input when it is heard
+    std::string outputFormat;           ///< Stream sample format: "auto", "float32", "s32", "s24" or "s16"
+    bool outputDither;                  ///< TPDF dither when the stream is 16 or 24 bit
+    bool outputNoiseShaping;            ///< Shape the dither noise toward Nyquist
     
     // ADSR envelope parameters
     float attackTime;                   ///< ADSR attack time in seconds
     float decayTime;                    ///< ADSR decay time in seconds
     float sustainLevel;                 ///< ADSR sustain level [0.0-1.0]
     float releaseTime;                  ///< ADSR release time in seconds
+
+    // Master bus dynamics
+    bool compressorEnabled;             ///< Enable the master compressor
+    float compressorThreshold;          ///< Compressor threshold in dBFS
+    float compressorRatio;              ///< Compressor ratio above the threshold
+    float compressorAttack;             ///< Compressor attack time in seconds
+    float compressorRelease;            ///< Compressor release time in seconds
+    float compressorMakeup;             ///< Compressor makeup gain in dB
+    bool limiterEnabled;                ///< Enable the master lookahead limiter
+    float limiterCeiling;               ///< Limiter ceiling in dBFS (true peak)
+    float limiterLookahead;             ///< Limiter lookahead in seconds (adds latency)
+    float limiterRelease;               ///< Limiter release time in seconds
+
+    // Load governor
+    bool governorEnabled;               ///< Shed work when blocks come close to their deadline
+    float governorHighLoad;             ///< Block load (render time / block duration) that sheds a step
+    float governorLowLoad;              ///< Block load under which shed steps come back
+    float governorRestoreSeconds;       ///< Time below the low load before a step comes back
+    std::vector<std::string> governorOrder;  ///< Actions in shedding order
+
+    // Memory
+    float memoryBudgetMB;               ///< Most the engine may hold before effect insertion fails, 0 for no limit
+
+    // Flight recorder
+    std::string xrunDirectory;          ///< Where callback history is written after an xrun, empty to disable
+    float xrunSeconds;                  ///< Seconds of history written per xrun
+
+    // Control plane
+    std::string controlSocket;          ///< UNIX socket path for the control server, empty to disable
+    std::string presetDirectory;        ///< Directory of preset XML files the control server loads
     
     // Default constructor with sensible defaults
     AudioConfig() : 
@@ -37,9 +72,33 @@ struct AudioConfig
         defaultFrequency(440.0f),
         inputMode("midi"),
         sequenceType("demo"),
+        liveInput("off"),
+        liveInputGain(1.0f),
+        outputFormat("auto"),
+        outputDither(true),
+        outputNoiseShaping(false),
         attackTime(0.1f),
         decayTime(0.2f),
         sustainLevel(0.7f),
-        releaseTime(0.3f)
+        releaseTime(0.3f),
+        compressorEnabled(false),
+        compressorThreshold(-18.0f),
+        compressorRatio(3.0f),
+        compressorAttack(0.01f),
+        compressorRelease(0.12f),
+        compressorMakeup(0.0f),
+        limiterEnabled(true),
+        limiterCeiling(-1.0f),
+        limiterLookahead(0.0015f),
+        limiterRelease(0.05f),
+        governorEnabled(true),
+        governorHighLoad(0.8f),
+        governorLowLoad(0.5f),
+        governorRestoreSeconds(2.0f),
+        governorOrder{"grains", "unison", "oversampling", "tails"},
+        memoryBudgetMB(0.0f),
+        xrunDirectory("xruns"),
+        xrunSeconds(10.0f),
+        presetDirectory("config/presets")
     {}
 };
@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <cstring>
+#include <cctype>
 
 ConfigReader::ConfigReader()
 {
@@ -56,6 +57,31 @@ AudioConfig ConfigReader::loadConfig(const std::string& filename)
             if (bufferFramesNode) {
                 config.bufferFrames = getNodeInt(bufferFramesNode, config.bufferFrames);
             }
+
+            xmlNode* liveInputNode = findChildNode(node, "liveInput");
+            if (liveInputNode) {
+                config.liveInput = getNodeText(liveInputNode);
+            }
+
+            xmlNode* liveInputGainNode = findChildNode(node, "liveInputGain");
+            if (liveInputGainNode) {
+                config.liveInputGain = getNodeFloat(liveInputGainNode, config.liveInputGain);
+            }
+
+            xmlNode* outputFormatNode = findChildNode(node, "outputFormat");
+            if (outputFormatNode) {
+                config.outputFormat = getNodeText(outputFormatNode);
+            }
+
+            xmlNode* ditherNode = findChildNode(node, "dither");
+            if (ditherNode) {
+                config.outputDither = getNodeBool(ditherNode, config.outputDither);
+            }
+
+            xmlNode* noiseShapingNode = findChildNode(node, "noiseShaping");
+            if (noiseShapingNode) {
+                config.outputNoiseShaping = getNodeBool(noiseShapingNode, config.outputNoiseShaping);
+            }
         }
         else if (nodeName == "waveform") {
             // Parse waveform configuration
@@ -122,6 +148,86 @@ AudioConfig ConfigReader::loadConfig(const std::string& filename)
                 config.releaseTime = getNodeFloat(releaseNode, config.releaseTime);
             }
         }
+        else if (nodeName == "master") {
+            // Parse master bus dynamics configuration
+            xmlNode* compressorNode = findChildNode(node, "compressor");
+            if (compressorNode) {
+                xmlNode* child = findChildNode(compressorNode, "enabled");
+                if (child) config.compressorEnabled = getNodeBool(child, config.compressorEnabled);
+                child = findChildNode(compressorNode, "threshold");
+                if (child) config.compressorThreshold = getNodeFloat(child, config.compressorThreshold);
+                child = findChildNode(compressorNode, "ratio");
+                if (child) config.compressorRatio = getNodeFloat(child, config.compressorRatio);
+                child = findChildNode(compressorNode, "attack");
+                if (child) config.compressorAttack = getNodeFloat(child, config.compressorAttack);
+                child = findChildNode(compressorNode, "release");
+                if (child) config.compressorRelease = getNodeFloat(child, config.compressorRelease);
+                child = findChildNode(compressorNode, "makeup");
+                if (child) config.compressorMakeup = getNodeFloat(child, config.compressorMakeup);
+            }
+
+            xmlNode* limiterNode = findChildNode(node, "limiter");
+            if (limiterNode) {
+                xmlNode* child = findChildNode(limiterNode, "enabled");
+                if (child) config.limiterEnabled = getNodeBool(child, config.limiterEnabled);
+                child = findChildNode(limiterNode, "ceiling");
+                if (child) config.limiterCeiling = getNodeFloat(child, config.limiterCeiling);
+                child = findChildNode(limiterNode, "lookahead");
+                if (child) config.limiterLookahead = getNodeFloat(child, config.limiterLookahead);
+                child = findChildNode(limiterNode, "release");
+                if (child) config.limiterRelease = getNodeFloat(child, config.limiterRelease);
+            }
+        }
+        else if (nodeName == "governor") {
+            // Parse load governor configuration
+            xmlNode* child = findChildNode(node, "enabled");
+            if (child) config.governorEnabled = getNodeBool(child, config.governorEnabled);
+            child = findChildNode(node, "high");
+            if (child) config.governorHighLoad = getNodeFloat(child, config.governorHighLoad);
+            child = findChildNode(node, "low");
+            if (child) config.governorLowLoad = getNodeFloat(child, config.governorLowLoad);
+            child = findChildNode(node, "restore");
+            if (child) config.governorRestoreSeconds = getNodeFloat(child, config.governorRestoreSeconds);
+
+            // <shed> entries replace the default order when present
+            std::vector<std::string> order;
+            for (xmlNode* shedNode = node->children; shedNode; shedNode = shedNode->next) {
+                if (shedNode->type == XML_ELEMENT_NODE &&
+                    strcmp((const char*)shedNode->name, "shed") == 0) {
+                    std::string action = getNodeText(shedNode);
+                    if (!action.empty()) {
+                        order.push_back(action);
+                    }
+                }
+            }
+            if (!order.empty()) {
+                config.governorOrder = order;
+            }
+        }
+        else if (nodeName == "memory") {
+            // Parse engine memory budget
+            xmlNode* child = findChildNode(node, "budget");
+            if (child) config.memoryBudgetMB = getNodeFloat(child, config.memoryBudgetMB);
+        }
+        else if (nodeName == "flightRecorder") {
+            // Parse xrun flight recorder configuration
+            xmlNode* child = findChildNode(node, "directory");
+            if (child) config.xrunDirectory = getNodeText(child);
+            child = findChildNode(node, "seconds");
+            if (child) config.xrunSeconds = getNodeFloat(child, config.xrunSeconds);
+        }
+        else if (nodeName == "control") {
+            // Parse control server configuration
+            xmlNode* socketNode = findChildNode(node, "socket");
+            if (socketNode) {
+                config.controlSocket = getNodeText(socketNode);
+            }
+
+            xmlNode* presetsNode = findChildNode(node, "presets");
+            if (presetsNode) {
+                config.presetDirectory = getNodeText(presetsNode);
+            }
+        }
     }
     
     xmlFreeDoc(doc);
@@ -156,6 +262,18 @@ void ConfigReader::printConfig(const AudioConfig& config, const std::string& sou
     std::cout << "  Waveform: " << config.waveform << std::endl;
     std::cout << "  Sample Rate: " << config.sampleRate << " Hz" << std::endl;
     std::cout << "  Buffer Frames: " << config.bufferFrames << std::endl;
+    std::cout << "  Live Input: " << config.liveInput;
+    if (config.liveInput != "off") {
+        std::cout << " (gain " << config.liveInputGain << ")";
+    }
+    std::cout << std::endl;
+    std::cout << "  Output Format: " << config.outputFormat;
+    if (config.outputNoiseShaping) {
+        std::cout << " (dither, noise shaping)";
+    } else if (config.outputDither) {
+        std::cout << " (dither)";
+    }
+    std::cout << std::endl;
     std::cout << "  Input Mode: " << config.inputMode << std::endl;
     
     if (config.inputMode == "midi") {
@@ -181,6 +299,46 @@ void ConfigReader::printConfig(const AudioConfig& config, const std::string& sou
     std::cout << "    Decay:   " << config.decayTime << " s" << std::endl;
     std::cout << "    Sustain: " << config.sustainLevel << std::endl;
     std::cout << "    Release: " << config.releaseTime << " s" << std::endl;
+    std::cout << "  Master Compressor: ";
+    if (config.compressorEnabled) {
+        std::cout << config.compressorThreshold << " dB, " << config.compressorRatio << ":1" << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
+    std::cout << "  Master Limiter: ";
+    if (config.limiterEnabled) {
+        std::cout << "ceiling " << config.limiterCeiling << " dBTP, lookahead "
+                  << config.limiterLookahead * 1000.0f << " ms" << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
+    std::cout << "  Load Governor: ";
+    if (config.governorEnabled) {
+        std::cout << "shed above " << config.governorHighLoad * 100.0f << "% load (";
+        for (size_t i = 0; i < config.governorOrder.size(); ++i) {
+            std::cout << config.governorOrder[i];
+            if (i < config.governorOrder.size() - 1) std::cout << ", ";
+        }
+        std::cout << ")" << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
+    std::cout << "  Memory Budget: ";
+    if (config.memoryBudgetMB > 0.0f) {
+        std::cout << config.memoryBudgetMB << " MB" << std::endl;
+    } else {
+        std::cout << "unlimited" << std::endl;
+    }
+    std::cout << "  Xrun Recorder: ";
+    if (!config.xrunDirectory.empty()) {
+        std::cout << config.xrunSeconds << " s to " << config.xrunDirectory << std::endl;
+    } else {
+        std::cout << "off" << std::endl;
+    }
+    if (!config.controlSocket.empty()) {
+        std::cout << "  Control Socket: " << config.controlSocket
+                  << " (presets in " << config.presetDirectory << ")" << std::endl;
+    }
     std::cout << "--------------------------------" << std::endl;
 }
 
@@ -220,6 +378,16 @@ int ConfigReader::getNodeInt(xmlNode* node, int defaultValue)
     }
 }
 
+bool ConfigReader::getNodeBool(xmlNode* node, bool defaultValue)
+{
+    std::string text = getNodeText(node);
+    for (auto& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    if (text == "true" || text == "yes" || text == "on" || text == "1") return true;
+    if (text == "false" || text == "no" || text == "off" || text == "0") return false;
+    return defaultValue;
+}
+
 xmlNode* ConfigReader::findChildNode(xmlNode* parent, const std::string& name)
 {
     if (parent == NULL) return NULL;
@@ -75,6 +75,14 @@ private:
      * @return Integer value parsed from node content
      */
     int getNodeInt(xmlNode* node, int defaultValue = 0);
+
+    /**
+     * @brief Parse a text node and return its content as boolean
+     * @param node XML node to parse
+     * @param defaultValue Default value to return if the text is not a boolean
+     * @return true for "true", "yes", "on" or "1"; false for "false", "no", "off" or "0"
+     */
+    bool getNodeBool(xmlNode* node, bool defaultValue = false);
     
     /**
      * @brief Find a child node by name
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file ControlProtocol.h
+ * @brief Binary messages of the audioApp control socket
+ *
+ * A connection carries a stream of frames in both directions. Each frame is
+ * a ControlFrameHeader followed by `length` payload bytes. All fields are
+ * little-endian and the structs below have no padding, so a client can
+ * build a frame with one memcpy of the header and one of the payload.
+ *
+ * Note and parameter messages are fire-and-forget: nothing is sent back
+ * unless they are malformed. A preset switch answers PresetApplied or
+ * Error; a stats request answers Stats. Replies come in request order.
+ */
+
+/**
+ * @enum ControlMessage
+ * @brief Frame types; replies from the server have the top bit set
+ */
+enum class ControlMessage : std::uint8_t
+{
+    NoteOn = 0x01,          ///< ControlNoteEvent; velocity 0 releases the note
+    NoteOff = 0x02,         ///< ControlNoteEvent; velocity is ignored
+    PitchBend = 0x03,       ///< ControlPitchBend
+    Parameters = 0x04,      ///< 1 to kMaxParameters ControlParameter entries
+    Preset = 0x05,          ///< Preset name, 1 to kMaxPresetName bytes of [A-Za-z0-9_-.]
+    StatsRequest = 0x06,    ///< Empty payload
+
+    PresetApplied = 0x85,   ///< Reply to Preset, empty payload
+    Stats = 0x86,           ///< Reply to StatsRequest, ControlStats
+    Error = 0xFF            ///< Reply to a rejected frame, ControlError
+};
+
+/**
+ * @struct ControlFrameHeader
+ * @brief Prefix of every frame
+ */
+struct ControlFrameHeader
+{
+    std::uint8_t type;          ///< ControlMessage
+    std::uint8_t reserved;      ///< Must be zero
+    std::uint16_t length;       ///< Payload bytes after the header
+};
+
+/**
+ * @struct ControlNoteEvent
+ * @brief Payload of NoteOn and NoteOff
+ */
+struct ControlNoteEvent
+{
+    std::uint64_t frame;        ///< Frame on the engine's audio clock, 0 plays at the next block
+    std::uint8_t note;          ///< MIDI note (0-127)
+    std::uint8_t velocity;      ///< MIDI velocity (0-127)
+    std::uint8_t channel;       ///< MIDI channel (0-15)
+    std::uint8_t reserved[5];   ///< Must be zero
+};
+
+/**
+ * @struct ControlPitchBend
+ * @brief Payload of PitchBend
+ */
+struct ControlPitchBend
+{
+    std::uint64_t frame;        ///< Frame on the engine's audio clock, 0 applies at the next block
+    std::int32_t value;         ///< Signed 14-bit MIDI bend (-8192 to 8191, 0 is centre)
+    std::uint32_t reserved;     ///< Must be zero
+};
+
+/**
+ * @struct ControlParameter
+ * @brief One entry of a Parameters message
+ */
+struct ControlParameter
+{
+    std::uint32_t id;           ///< ParameterBlock::Id
+    float value;
+};
+
+/**
+ * @enum ControlErrorCode
+ * @brief Reason carried by an Error reply
+ */
+enum class ControlErrorCode : std::uint8_t
+{
+    UnknownMessage = 1,     ///< Type not understood; the payload was skipped
+    BadLength = 2,          ///< Payload size does not fit the type
+    BadValue = 3,           ///< Note, channel, bend or parameter id out of range, or a reserved field set
+    PresetFailed = 4,       ///< Preset name rejected, or the file could not be loaded
+    FrameTooLarge = 5       ///< Length above kMaxPayload; the connection is closed
+};
+
+/**
+ * @struct ControlError
+ * @brief Payload of Error
+ */
+struct ControlError
+{
+    std::uint8_t request;       ///< Type of the rejected frame
+    std::uint8_t code;          ///< ControlErrorCode
+    std::uint16_t reserved;
+};
+
+/**
+ * @struct ControlStats
+ * @brief Payload of Stats: the latest engine telemetry and server counters
+ */
+struct ControlStats
+{
+    std::uint64_t frame;                ///< Clock frame at the start of the latest block
+    std::uint64_t droppedCommands;      ///< Engine control changes rejected since start
+    std::uint64_t messages;             ///< Frames handled by the server since start
+    std::uint32_t protocolErrors;       ///< Error replies sent since start
+    std::uint32_t clients;              ///< Connections open now
+    std::uint32_t heldNotes;
+    std::uint32_t activeVoices;
+    std::uint32_t effects;              ///< Effects in the rendered chain
+    std::uint32_t pendingEvents;        ///< Timed events waiting for their frame
+    float pitchBendCents;
+    float lowPassCutoffHz;
+    float peak[2];
+    float rms[2];
+    float gainReductionDb;
+    float cpuLoad;                      ///< Render time divided by the block duration
+};
+
+namespace ControlProtocol
+{
+    constexpr std::size_t kMaxParameters = 32;
+    constexpr std::size_t kMaxPresetName = 64;
+    constexpr std::size_t kMaxPayload = kMaxParameters * sizeof(ControlParameter);
+
+    static_assert(sizeof(ControlFrameHeader) == 4, "Header layout is part of the protocol");
+    static_assert(sizeof(ControlNoteEvent) == 16, "Note layout is part of the protocol");
+    static_assert(sizeof(ControlPitchBend) == 16, "Bend layout is part of the protocol");
+    static_assert(sizeof(ControlParameter) == 8, "Parameter layout is part of the protocol");
+    static_assert(sizeof(ControlError) == 4, "Error layout is part of the protocol");
+    static_assert(sizeof(ControlStats) == 80, "Stats layout is part of the protocol");
+    static_assert(std::is_trivially_copyable<ControlStats>::value, "Messages are copied as bytes");
+    static_assert(kMaxPayload >= sizeof(ControlStats) && kMaxPayload >= kMaxPresetName, "Every message fits");
+}
@@ -0,0 +1,571 @@
+#include "ControlServer.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "audioSystem.h"
+#include "ConfigReader.h"
+#include "ParameterBlock.h"
+
+constexpr std::size_t ControlServer::kMaxClients;
+constexpr std::size_t ControlServer::kReceiveBytes;
+
+namespace {
+    constexpr std::uint64_t kListenTag = ControlServer::kMaxClients;
+    constexpr std::uint64_t kWakeTag = ControlServer::kMaxClients + 1U;
+    constexpr std::size_t kHeaderBytes = sizeof(ControlFrameHeader);
+
+    // Share of the engine command queue the server fills before holding back
+    constexpr std::size_t kQueueShare = AudioSystem::kCommandCapacity * 3U / 4U;
+    constexpr int kStallRetryMs = 1;
+
+    static_assert(kHeaderBytes + ControlProtocol::kMaxPayload <= ControlServer::kReceiveBytes,
+                  "A receive buffer holds at least one whole frame");
+
+    [[noreturn]] void throwErrno(const std::string& what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    /// Names are looked up as <directory>/<name>.xml, so they must not leave the directory
+    bool validPresetName(const std::uint8_t* name, std::size_t length) {
+        if (length == 0U || length > ControlProtocol::kMaxPresetName || name[0] == '.') {
+            return false;
+        }
+        for (std::size_t i = 0; i < length; ++i) {
+            const char c = static_cast<char>(name[i]);
+            const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                                 c == '_' || c == '-' || c == '.';
+            if (!allowed) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+ControlServer::ControlServer(const std::string& socketPath, const std::string& presetDirectory,
+                             AudioSystem& audioSystem, ParameterBlock& parameters)
+    : m_socketPath(socketPath)
+    , m_presetDirectory(presetDirectory)
+    , m_audioSystem(audioSystem)
+    , m_parameters(parameters)
+    , m_listenFd(-1)
+    , m_epollFd(-1)
+    , m_wakeFd(-1)
+    , m_clients(kMaxClients)
+    , m_messages(0U)
+    , m_protocolErrors(0U)
+    , m_clientCount(0U)
+    , m_stalledCount(0U)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Control socket path must be 1 to " +
+                                 std::to_string(sizeof(address.sun_path) - 1U) + " characters: " + socketPath);
+    }
+    socketPath.copy(address.sun_path, socketPath.size());
+
+    try
+    {
+        // A socket left behind by a previous run would make bind() fail
+        struct stat existing;
+        if (::lstat(socketPath.c_str(), &existing) == 0)
+        {
+            if (!S_ISSOCK(existing.st_mode))
+            {
+                throw std::runtime_error("Control socket path exists and is not a socket: " + socketPath);
+            }
+            ::unlink(socketPath.c_str());
+        }
+
+        m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_listenFd < 0)
+        {
+            throwErrno("Cannot create control socket");
+        }
+        if (::bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            throwErrno("Cannot bind control socket " + socketPath);
+        }
+        if (::listen(m_listenFd, static_cast<int>(kMaxClients)) < 0)
+        {
+            throwErrno("Cannot listen on control socket " + socketPath);
+        }
+
+        m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        m_wakeFd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_epollFd < 0 || m_wakeFd < 0)
+        {
+            throwErrno("Cannot create control server events");
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = kListenTag;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &event) < 0)
+        {
+            throwErrno("Cannot watch control socket");
+        }
+        event.data.u64 = kWakeTag;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event) < 0)
+        {
+            throwErrno("Cannot watch control server wakeup");
+        }
+    }
+    catch (...)
+    {
+        for (int fd : {m_listenFd, m_epollFd, m_wakeFd})
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+        if (m_listenFd >= 0)
+        {
+            ::unlink(m_socketPath.c_str());
+        }
+        throw;
+    }
+}
+
+ControlServer::~ControlServer()
+{
+    Stop();
+
+    for (Client& client : m_clients)
+    {
+        closeClient(client);
+    }
+    ::close(m_listenFd);
+    ::close(m_epollFd);
+    ::close(m_wakeFd);
+    ::unlink(m_socketPath.c_str());
+}
+
+void ControlServer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+
+    // The eventfd stays readable, so the loop wakes whenever it checks
+    const std::uint64_t one = 1U;
+    if (::write(m_wakeFd, &one, sizeof(one)) < 0)
+    {
+        std::cerr << "Control server wakeup failed: " << std::strerror(errno) << std::endl;
+    }
+
+    stop();
+}
+
+void ControlServer::thread()
+{
+    epoll_event events[kMaxClients + 2U];
+
+    while (m_running)
+    {
+        const int timeout = m_stalledCount > 0U ? kStallRetryMs : -1;
+        const int count = ::epoll_wait(m_epollFd, events, static_cast<int>(kMaxClients + 2U), timeout);
+        if (count < 0)
+        {
+            if (errno == EINTR) continue;
+            std::cerr << "Control server wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count && m_running; ++i)
+        {
+            const std::uint64_t tag = events[i].data.u64;
+            if (tag == kWakeTag)
+            {
+                continue;
+            }
+            if (tag == kListenTag)
+            {
+                acceptClients();
+                continue;
+            }
+
+            // One read per wakeup keeps a flooding client from starving the others
+            Client& client = m_clients[static_cast<std::size_t>(tag)];
+            if (client.fd >= 0 && !receive(client))
+            {
+                closeClient(client);
+            }
+        }
+
+        if (m_stalledCount > 0U)
+        {
+            resumeStalled();
+        }
+    }
+}
+
+void ControlServer::resumeStalled()
+{
+    for (std::size_t slot = 0; slot < kMaxClients; ++slot)
+    {
+        Client& client = m_clients[slot];
+        if (client.fd < 0 || !client.stalled)
+        {
+            continue;
+        }
+
+        client.stalled = false;
+        --m_stalledCount;
+        if (!decode(client))
+        {
+            closeClient(client);
+            continue;
+        }
+        if (client.stalled)
+        {
+            continue;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = slot;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, client.fd, &event) < 0)
+        {
+            std::cerr << "Control server cannot watch connection: " << std::strerror(errno) << std::endl;
+            closeClient(client);
+        }
+    }
+}
+
+void ControlServer::acceptClients()
+{
+    while (true)
+    {
+        const int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                std::cerr << "Control server accept failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        std::size_t slot = 0;
+        while (slot < kMaxClients && m_clients[slot].fd >= 0)
+        {
+            ++slot;
+        }
+        if (slot == kMaxClients)
+        {
+            std::cerr << "Control server: refusing connection, " << kMaxClients << " already open" << std::endl;
+            ::close(fd);
+            continue;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = slot;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            std::cerr << "Control server cannot watch connection: " << std::strerror(errno) << std::endl;
+            ::close(fd);
+            continue;
+        }
+
+        m_clients[slot].fd = fd;
+        m_clients[slot].used = 0U;
+        m_clients[slot].stalled = false;
+        ++m_clientCount;
+    }
+}
+
+void ControlServer::closeClient(Client& client)
+{
+    if (client.fd < 0)
+    {
+        return;
+    }
+    if (client.stalled)
+    {
+        client.stalled = false;
+        --m_stalledCount;
+    }
+    else
+    {
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+    }
+    ::close(client.fd);
+    client.fd = -1;
+    client.used = 0U;
+    --m_clientCount;
+}
+
+bool ControlServer::receive(Client& client)
+{
+    ssize_t received = 0;
+    do
+    {
+        received = ::recv(client.fd, client.buffer.data() + client.used, kReceiveBytes - client.used, 0);
+    } while (received < 0 && errno == EINTR);
+
+    if (received == 0)
+    {
+        return false;
+    }
+    if (received < 0)
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    client.used += static_cast<std::size_t>(received);
+    return decode(client);
+}
+
+bool ControlServer::decode(Client& client)
+{
+    // Decode every complete frame in place
+    std::size_t offset = 0;
+    while (client.used - offset >= kHeaderBytes)
+    {
+        ControlFrameHeader header;
+        std::memcpy(&header, client.buffer.data() + offset, kHeaderBytes);
+        if (header.length > ControlProtocol::kMaxPayload)
+        {
+            // Framing cannot be trusted past this point
+            replyError(client, header, ControlErrorCode::FrameTooLarge);
+            return false;
+        }
+
+        const std::size_t frameBytes = kHeaderBytes + header.length;
+        if (client.used - offset < frameBytes)
+        {
+            break;
+        }
+
+        // Engine events wait here, unread, until the audio thread makes room
+        const ControlMessage type = static_cast<ControlMessage>(header.type);
+        const bool engineEvent = type == ControlMessage::NoteOn || type == ControlMessage::NoteOff ||
+                                 type == ControlMessage::PitchBend;
+        if (engineEvent && m_audioSystem.pendingCommands() >= kQueueShare)
+        {
+            ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+            client.stalled = true;
+            ++m_stalledCount;
+            break;
+        }
+
+        if (!handleFrame(client, header, client.buffer.data() + offset + kHeaderBytes))
+        {
+            return false;
+        }
+        offset += frameBytes;
+    }
+
+    // Keep the partial frame at the front for the next read
+    if (offset > 0U)
+    {
+        std::memmove(client.buffer.data(), client.buffer.data() + offset, client.used - offset);
+        client.used -= offset;
+    }
+    return true;
+}
+
+bool ControlServer::handleFrame(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload)
+{
+    ++m_messages;
+
+    if (header.reserved != 0U)
+    {
+        return replyError(client, header, ControlErrorCode::BadValue);
+    }
+
+    switch (static_cast<ControlMessage>(header.type))
+    {
+        case ControlMessage::NoteOn:
+        case ControlMessage::NoteOff:
+            return handleNote(client, header, payload);
+        case ControlMessage::PitchBend:
+            return handlePitchBend(client, header, payload);
+        case ControlMessage::Parameters:
+            return handleParameters(client, header, payload);
+        case ControlMessage::Preset:
+            return handlePreset(client, header, payload);
+        case ControlMessage::StatsRequest:
+            return handleStats(client, header);
+        default:
+            return replyError(client, header, ControlErrorCode::UnknownMessage);
+    }
+}
+
+bool ControlServer::handleNote(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload)
+{
+    if (header.length != sizeof(ControlNoteEvent))
+    {
+        return replyError(client, header, ControlErrorCode::BadLength);
+    }
+
+    ControlNoteEvent event;
+    std::memcpy(&event, payload, sizeof(event));
+    static const std::uint8_t kZero[sizeof(event.reserved)] = {};
+    if (event.note > 127U || event.velocity > 127U || event.channel > 15U ||
+        std::memcmp(event.reserved, kZero, sizeof(kZero)) != 0)
+    {
+        return replyError(client, header, ControlErrorCode::BadValue);
+    }
+
+    const bool noteOn = static_cast<ControlMessage>(header.type) == ControlMessage::NoteOn && event.velocity > 0U;
+    if (noteOn)
+    {
+        m_audioSystem.noteOnAt(event.frame, event.note, static_cast<float>(event.velocity) / 127.0f, event.channel);
+    }
+    else
+    {
+        m_audioSystem.noteOffAt(event.frame, event.note, event.channel);
+    }
+    return true;
+}
+
+bool ControlServer::handlePitchBend(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload)
+{
+    if (header.length != sizeof(ControlPitchBend))
+    {
+        return replyError(client, header, ControlErrorCode::BadLength);
+    }
+
+    ControlPitchBend bend;
+    std::memcpy(&bend, payload, sizeof(bend));
+    if (bend.value < -8192 || bend.value > 8191 || bend.reserved != 0U)
+    {
+        return replyError(client, header, ControlErrorCode::BadValue);
+    }
+
+    m_audioSystem.setPitchBendAt(bend.frame, bend.value);
+    return true;
+}
+
+bool ControlServer::handleParameters(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload)
+{
+    const std::size_t count = header.length / sizeof(ControlParameter);
+    if (count == 0U || header.length % sizeof(ControlParameter) != 0U)
+    {
+        return replyError(client, header, ControlErrorCode::BadLength);
+    }
+
+    // All or nothing, so a batch never lands half applied
+    ControlParameter parameters[ControlProtocol::kMaxParameters];
+    std::memcpy(parameters, payload, header.length);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (parameters[i].id >= ParameterBlock::kCount || !std::isfinite(parameters[i].value))
+        {
+            return replyError(client, header, ControlErrorCode::BadValue);
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        m_parameters.set(static_cast<ParameterBlock::Id>(parameters[i].id), parameters[i].value);
+    }
+    return true;
+}
+
+bool ControlServer::handlePreset(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload)
+{
+    if (!validPresetName(payload, header.length))
+    {
+        return replyError(client, header, ControlErrorCode::PresetFailed);
+    }
+
+    const std::string name(reinterpret_cast<const char*>(payload), header.length);
+    const std::string path = m_presetDirectory + "/" + name + ".xml";
+    try
+    {
+        ConfigReader reader;
+        m_audioSystem.applyPreset(reader.loadConfig(path));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Control server: cannot apply preset " << path << ": " << e.what() << std::endl;
+        return replyError(client, header, ControlErrorCode::PresetFailed);
+    }
+
+    std::cout << "Control server: applied preset " << name << std::endl;
+    return reply(client, ControlMessage::PresetApplied, nullptr, 0U);
+}
+
+bool ControlServer::handleStats(Client& client, const ControlFrameHeader& header)
+{
+    if (header.length != 0U)
+    {
+        return replyError(client, header, ControlErrorCode::BadLength);
+    }
+
+    const EngineTelemetry state = m_audioSystem.telemetry();
+
+    ControlStats stats{};
+    stats.frame = state.frame;
+    stats.droppedCommands = state.droppedCommands;
+    stats.messages = m_messages;
+    stats.protocolErrors = m_protocolErrors;
+    stats.clients = m_clientCount;
+    stats.heldNotes = static_cast<std::uint32_t>(state.heldNotes);
+    stats.activeVoices = state.activeVoices;
+    stats.effects = state.effects;
+    stats.pendingEvents = state.pendingEvents;
+    stats.pitchBendCents = state.pitchBendCents;
+    stats.lowPassCutoffHz = state.lowPassCutoffHz;
+    stats.peak[0] = state.peak[0];
+    stats.peak[1] = state.peak[1];
+    stats.rms[0] = state.rms[0];
+    stats.rms[1] = state.rms[1];
+    stats.gainReductionDb = state.gainReductionDb;
+    stats.cpuLoad = state.cpuLoad;
+    return reply(client, ControlMessage::Stats, &stats, sizeof(stats));
+}
+
+bool ControlServer::reply(Client& client, ControlMessage type, const void* payload, std::size_t length)
+{
+    std::uint8_t frame[kHeaderBytes + ControlProtocol::kMaxPayload];
+    ControlFrameHeader header{};
+    header.type = static_cast<std::uint8_t>(type);
+    header.length = static_cast<std::uint16_t>(length);
+    std::memcpy(frame, &header, kHeaderBytes);
+    if (length > 0U)
+    {
+        std::memcpy(frame + kHeaderBytes, payload, length);
+    }
+
+    // Replies are small; a client whose socket buffer is full has stopped reading them
+    ssize_t sent = 0;
+    do
+    {
+        sent = ::send(client.fd, frame, kHeaderBytes + length, MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    return sent == static_cast<ssize_t>(kHeaderBytes + length);
+}
+
+bool ControlServer::replyError(Client& client, const ControlFrameHeader& header, ControlErrorCode code)
+{
+    ++m_protocolErrors;
+
+    ControlError error{};
+    error.request = header.type;
+    error.code = static_cast<std::uint8_t>(code);
+    return reply(client, ControlMessage::Error, &error, sizeof(error));
+}
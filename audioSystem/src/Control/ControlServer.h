@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "threadBase.h"
+#include "ControlProtocol.h"
+
+class AudioSystem;
+class ParameterBlock;
+
+/**
+ * @class ControlServer
+ * @brief UNIX domain socket control plane for a headless audioApp
+ *
+ * One thread serves every connection from an epoll loop. Frames (see
+ * ControlProtocol.h) are decoded in place from a fixed receive buffer per
+ * connection, so nothing is allocated per message, and forwarded to the
+ * engine's lock-free paths: notes and bends go into the AudioSystem command
+ * queue, parameters into the shared ParameterBlock. The audio thread never
+ * waits on the server. The server keeps a quarter of the command queue
+ * free for MIDI and other control threads: when its share is used it stops
+ * reading the connection until the next block drains the queue, so a burst
+ * backs up into the socket (and the client) instead of being dropped.
+ *
+ * A preset switch reads `<presetDirectory>/<name>.xml` and applies it with
+ * AudioSystem::applyPreset() on the server thread, which builds the waveform
+ * and effects there and queues every change for the audio thread; other
+ * connections are served again once the file is loaded.
+ */
+class ControlServer : public ThreadBase
+{
+public:
+    static constexpr std::size_t kMaxClients = 8;
+    static constexpr std::size_t kReceiveBytes = 4096;
+
+    /**
+     * @brief Bind and listen on a socket path; call start() to begin serving
+     * @param socketPath Filesystem path of the socket; a stale socket there is replaced
+     * @param presetDirectory Directory holding the preset XML files
+     * @param audioSystem Engine to control
+     * @param parameters Block attached to audioSystem with setParameterBlock()
+     * @throws std::runtime_error if the socket cannot be created
+     */
+    ControlServer(const std::string& socketPath, const std::string& presetDirectory,
+                  AudioSystem& audioSystem, ParameterBlock& parameters);
+
+    /**
+     * @brief Stop serving, close every connection and remove the socket file
+     */
+    ~ControlServer() override;
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /**
+     * @brief Wake the server thread and wait for it to exit
+     */
+    void Stop();
+
+protected:
+    void thread() override;
+
+private:
+    /**
+     * @struct Client
+     * @brief One connection and the bytes received but not yet decoded
+     */
+    struct Client
+    {
+        int fd = -1;
+        std::size_t used = 0;
+        bool stalled = false;           ///< Waiting for room in the engine queue, not watched by epoll
+        std::array<std::uint8_t, kReceiveBytes> buffer;
+    };
+
+    void acceptClients();
+    void closeClient(Client& client);
+
+    /// Read what is available and decode it; false when the connection ended
+    bool receive(Client& client);
+
+    /// Handle every complete frame until the engine queue is full; false if the connection must be closed
+    bool decode(Client& client);
+
+    /// Retry stalled connections once the audio thread has taken commands
+    void resumeStalled();
+
+    /// Handle one frame; false if the connection must be closed
+    bool handleFrame(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload);
+
+    bool handleNote(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload);
+    bool handlePitchBend(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload);
+    bool handleParameters(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload);
+    bool handlePreset(Client& client, const ControlFrameHeader& header, const std::uint8_t* payload);
+    bool handleStats(Client& client, const ControlFrameHeader& header);
+
+    /// Queue a reply frame; false if the client does not keep up with its replies
+    bool reply(Client& client, ControlMessage type, const void* payload, std::size_t length);
+    bool replyError(Client& client, const ControlFrameHeader& header, ControlErrorCode code);
+
+    std::string m_socketPath;
+    std::string m_presetDirectory;
+    AudioSystem& m_audioSystem;
+    ParameterBlock& m_parameters;
+
+    int m_listenFd;
+    int m_epollFd;
+    int m_wakeFd;                       ///< eventfd that Stop() signals
+    std::vector<Client> m_clients;      ///< kMaxClients slots, allocated once
+
+    // Counters, server thread only
+    std::uint64_t m_messages;
+    std::uint32_t m_protocolErrors;
+    std::uint32_t m_clientCount;
+    std::uint32_t m_stalledCount;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @file AudioClock.h
+ * @brief Render position of the audio thread, mapped to host time
+ */
+
+/**
+ * @struct AudioClockSnapshot
+ * @brief Frame position of one rendered block and the host time it started
+ */
+struct AudioClockSnapshot
+{
+    std::uint64_t frame = 0;          ///< Frames rendered before the block
+    std::int64_t hostTimeNanos = 0;   ///< steady_clock time the block started, 0 before the first block
+    double sampleRate = 0.0;          ///< Frames per second
+
+    /**
+     * @brief Estimate the frame the audio thread is rendering at a host time
+     *
+     * Extrapolates from the block start, so between callbacks the estimate
+     * keeps moving at the sample rate instead of stepping a block at a time.
+     */
+    std::uint64_t frameAt(std::int64_t hostNanos) const
+    {
+        if (hostTimeNanos == 0 || hostNanos <= hostTimeNanos)
+        {
+            return frame;
+        }
+        const double elapsed = static_cast<double>(hostNanos - hostTimeNanos) * 1.0e-9;
+        return frame + static_cast<std::uint64_t>(elapsed * sampleRate);
+    }
+};
+
+/**
+ * @class AudioClock
+ * @brief Single-writer clock the audio thread stamps at the start of every block
+ *
+ * A sequence counter guards the two values, so readers on any thread see a
+ * frame and host time from the same block without the writer ever waiting.
+ */
+class AudioClock
+{
+public:
+    explicit AudioClock(double sampleRate)
+        : m_sampleRate(sampleRate)
+        , m_sequence(0U)
+        , m_frame(0U)
+        , m_hostTimeNanos(0)
+    {
+    }
+
+    AudioClock(const AudioClock&) = delete;
+    AudioClock& operator=(const AudioClock&) = delete;
+
+    /**
+     * @brief Current steady_clock time in nanoseconds, the host time domain of the clock
+     */
+    static std::int64_t hostTimeNanos()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Record the start of a block (audio thread only)
+     */
+    void publish(std::uint64_t frame, std::int64_t hostNanos)
+    {
+        // Release stores keep the odd sequence ahead of the data for any
+        // reader that sees the new data, without a standalone fence
+        const std::uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1U, std::memory_order_relaxed);
+        m_frame.store(frame, std::memory_order_release);
+        m_hostTimeNanos.store(hostNanos, std::memory_order_release);
+        m_sequence.store(sequence + 2U, std::memory_order_release);
+    }
+
+    /**
+     * @brief Latest published block (any thread)
+     */
+    AudioClockSnapshot snapshot() const
+    {
+        AudioClockSnapshot result;
+        result.sampleRate = m_sampleRate;
+        for (;;)
+        {
+            const std::uint32_t before = m_sequence.load(std::memory_order_acquire);
+            result.frame = m_frame.load(std::memory_order_acquire);
+            result.hostTimeNanos = m_hostTimeNanos.load(std::memory_order_acquire);
+            const std::uint32_t after = m_sequence.load(std::memory_order_relaxed);
+            if ((before & 1U) == 0U && before == after)
+            {
+                return result;
+            }
+        }
+    }
+
+private:
+    const double m_sampleRate;
+    std::atomic<std::uint32_t> m_sequence;      ///< Odd while a block is being published
+    std::atomic<std::uint64_t> m_frame;
+    std::atomic<std::int64_t> m_hostTimeNanos;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @file CommandQueue.h
+ * @brief Bounded lock-free queue for handing commands to and from the audio thread
+ */
+
+/**
+ * @class CommandQueue
+ * @brief Fixed-capacity multi-producer queue that never blocks or allocates
+ *
+ * Every cell carries a sequence number that tells producers and consumers
+ * whether it is free or filled for their current lap, so any number of
+ * control threads (Node, MIDI, sequencer) can push while the audio thread
+ * pops. Consumers are also safe to run concurrently, which lets the same
+ * type carry retired objects back from the audio thread.
+ *
+ * Values are moved in and out of their cells, so a popped command does not
+ * keep a reference alive inside the queue.
+ *
+ * @tparam T Command type; must be default constructible and movable
+ * @tparam Capacity Number of cells; must be a power of two
+ */
+template <typename T, std::size_t Capacity>
+class CommandQueue
+{
+    static_assert(Capacity >= 2U && (Capacity & (Capacity - 1U)) == 0U, "Capacity must be a power of two");
+
+public:
+    CommandQueue()
+        : m_enqueuePosition(0U)
+        , m_dequeuePosition(0U)
+        , m_rejected(0U)
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+     * @brief Append a value
+     * @return false if the queue is full (the value is left untouched)
+     */
+    bool tryPush(T&& value)
+    {
+        std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+
+        for (;;)
+        {
+            cell = &m_cells[position & kMask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                m_rejected.fetch_add(1U, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1U, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value)
+    {
+        T copy(value);
+        return tryPush(std::move(copy));
+    }
+
+    /**
+     * @brief Remove the oldest value
+     * @return false if the queue is empty
+     */
+    bool tryPop(T& value)
+    {
+        std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+
+        for (;;)
+        {
+            cell = &m_cells[position & kMask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1U);
+
+            if (difference == 0)
+            {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(position + kMask + 1U, std::memory_order_release);
+        return true;
+    }
+
+    /// Approximate number of queued values (exact when no thread is pushing or popping)
+    std::size_t sizeApprox() const
+    {
+        const std::size_t enqueued = m_enqueuePosition.load(std::memory_order_relaxed);
+        const std::size_t dequeued = m_dequeuePosition.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? enqueued - dequeued : 0U;
+    }
+
+    /// Number of pushes refused because the queue was full
+    std::size_t rejectedCount() const { return m_rejected.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1U;
+    static constexpr std::size_t kCacheLine = 64;
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // Padding keeps the two positions on separate cache lines without
+    // over-aligning the type, which C++14 operator new would not honour
+    std::array<Cell, Capacity> m_cells;
+    char m_padding0[kCacheLine];
+    std::atomic<std::size_t> m_enqueuePosition;   ///< Shared by producers
+    char m_padding1[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_dequeuePosition;   ///< Shared by consumers
+    char m_padding2[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_rejected;
+};
+
+template <typename T, std::size_t Capacity>
+constexpr std::size_t CommandQueue<T, Capacity>::kMask;
+
+template <typename T, std::size_t Capacity>
+constexpr std::size_t CommandQueue<T, Capacity>::kCacheLine;
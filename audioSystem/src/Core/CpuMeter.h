@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @class CpuMeter
+ * @brief Render time of one stage as a fraction of the block duration
+ *
+ * The audio thread adds the time it spends in the stage while rendering a
+ * block and closes the block with endBlock(), which folds that block into
+ * an exponential average and a decaying peak. 1.0 means the stage alone
+ * took as long as the audio it rendered. Audio thread only; other threads
+ * read the figures through EngineTelemetry.
+ */
+class CpuMeter
+{
+public:
+    /// Add time spent in the stage during the current block
+    void add(std::int64_t nanos) { m_blockNanos += nanos; }
+
+    /**
+     * @brief Fold the current block into the average and peak and start the next
+     * @param blockNanos Duration of the audio the block rendered
+     * @param averageDecay Weight the average keeps per block (0-1)
+     * @param peakDecay Weight the peak keeps per block (0-1)
+     */
+    void endBlock(double blockNanos, float averageDecay, float peakDecay)
+    {
+        m_last = blockNanos > 0.0 ? static_cast<float>(static_cast<double>(m_blockNanos) / blockNanos) : 0.0f;
+        m_blockNanos = 0;
+        m_average = m_last + averageDecay * (m_average - m_last);
+        m_peak = std::max(m_last, m_peak * peakDecay);
+    }
+
+    float last() const { return m_last; }
+    float average() const { return m_average; }
+    float peak() const { return m_peak; }
+
+private:
+    std::int64_t m_blockNanos = 0;     ///< Time added since the last endBlock()
+    float m_last = 0.0f;               ///< Cost of the latest block
+    float m_average = 0.0f;
+    float m_peak = 0.0f;
+};
@@ -0,0 +1,340 @@
+#include "EngineController.h"
+#include "AudioSystemAdapter.h"
+#include "Effects/DelayEffect.h"
+#include "Effects/LowPassEffect.h"
+#include "Effects/OctaveEffect.h"
+#include "Effects/SpectralFreezeEffect.h"
+#include "Effects/SpectralSmearEffect.h"
+#include "Effects/TimeStretchEffect.h"
+#include "Effects/VocoderEffect.h"
+#include "Granular/GranularSource.h"
+#include "Midi/MidiDevice.h"
+#include "Waves/SineWave.h"
+#include "Waves/SquareWave.h"
+#include "Waves/SawtoothWave.h"
+#include "Waves/TriangleWave.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    /// ALSA and PipeWire ports that are not a controller someone plays
+    bool isVirtualMidiPort(const std::string& name) {
+        return name.find("Midi Through") != std::string::npos ||
+               name.find("Announce") != std::string::npos ||
+               name.find("Timer") != std::string::npos ||
+               name.find("PipeWire") != std::string::npos;
+    }
+}
+
+constexpr int EngineController::kNoHeldNote;
+
+// -----------------------------------------------------------------------------
+// EngineController implementation
+// -----------------------------------------------------------------------------
+
+EngineController::EngineController(AudioSystem& audioSystem, float sampleRate, unsigned int bufferFrames,
+                                   const EffectPool::Limits& poolLimits)
+    : m_audioSystem(audioSystem)
+    , m_sampleRate(sampleRate)
+    , m_bufferFrames(bufferFrames)
+    , m_heldKey(kNoHeldNote)
+    , m_heldFrequency(0.0f)
+{
+    m_granularSource = std::make_shared<GranularSource>(m_sampleRate);
+    // Spectral workers start on first use, so effects never inserted cost no thread
+    m_timeStretch = std::make_shared<TimeStretchEffect>(1.0f, 1.0f, m_sampleRate, 2048, false);
+    m_vocoder = std::make_shared<VocoderEffect>(24, 1.0f, m_sampleRate);
+    // Build every insertable effect now so add*() never allocates on the control path
+    m_effectPool.reset(new EffectPool(m_sampleRate, useSpectralWorker(EffectPool::kSpectralFrameSize), poolLimits));
+}
+
+EngineController::~EngineController()
+{
+    closeMidiInput();
+}
+
+void EngineController::triggerNote(float frequency)
+{
+    m_audioSystem.triggerNote(frequency);
+    // Same range check and key as the engine, so the release below finds the note
+    if (frequency > 0.0f && frequency <= 20000.0f)
+    {
+        m_heldKey = AudioSystem::nearestMidiNote(frequency);
+        m_heldFrequency = frequency;
+    }
+}
+
+void EngineController::triggerNoteOff(float frequency)
+{
+    // The engine tracks held notes; without a frequency every note is released
+    if (frequency > 0.0f)
+    {
+        m_audioSystem.triggerNoteOff(frequency);
+        releaseHeldKey(AudioSystem::nearestMidiNote(frequency));
+    }
+    else
+    {
+        m_audioSystem.triggerNoteOff();
+        forgetCurrentNote();
+    }
+}
+
+void EngineController::noteOnAt(std::uint64_t frame, int note, float velocity, int channel)
+{
+    m_audioSystem.noteOnAt(frame, note, velocity, channel);
+    if (note < 0 || note >= AudioSystem::kMidiNotes || channel < 0 || channel >= AudioSystem::kMidiChannels)
+    {
+        return;
+    }
+    if (velocity > 0.0f)
+    {
+        // The voice keeps the frequency it started with even if the tuning changes later
+        m_heldKey = channel * AudioSystem::kMidiNotes + note;
+        m_heldFrequency = m_audioSystem.noteFrequency(note);
+    }
+    else
+    {
+        releaseHeldKey(channel * AudioSystem::kMidiNotes + note);
+    }
+}
+
+void EngineController::noteOffAt(std::uint64_t frame, int note, int channel)
+{
+    m_audioSystem.noteOffAt(frame, note, channel);
+    if (note >= 0 && note < AudioSystem::kMidiNotes && channel >= 0 && channel < AudioSystem::kMidiChannels)
+    {
+        releaseHeldKey(channel * AudioSystem::kMidiNotes + note);
+    }
+}
+
+void EngineController::forgetCurrentNote()
+{
+    m_heldKey = kNoHeldNote;
+    m_heldFrequency = 0.0f;
+}
+
+bool EngineController::setWaveform(const std::string& name)
+{
+    std::shared_ptr<IWave> waveform;
+    if (name == "sine")
+    {
+        waveform = std::make_shared<SineWave>();
+    }
+    else if (name == "square")
+    {
+        waveform = std::make_shared<SquareWave>();
+    }
+    else if (name == "saw")
+    {
+        waveform = std::make_shared<SawtoothWave>();
+    }
+    else if (name == "triangle")
+    {
+        waveform = std::make_shared<TriangleWave>();
+    }
+    else
+    {
+        return false;
+    }
+
+    m_audioSystem.setWaveform(waveform);
+    return true;
+}
+
+void EngineController::addDelay(float delaySeconds, float feedback, float mix)
+{
+    auto effect = m_effectPool->acquireDelay(delaySeconds, feedback, mix);
+    if (!effect)
+    {
+        std::cerr << "Warning: delay pool exhausted, allocating a new instance" << std::endl;
+        effect = std::make_shared<DelayEffect>(delaySeconds, feedback, mix, m_sampleRate);
+    }
+    m_audioSystem.addEffect(effect);
+}
+
+void EngineController::addLowPass(float cutoffHz, float resonance, float mix)
+{
+    auto effect = m_effectPool->acquireLowPass(cutoffHz, resonance, mix);
+    if (!effect)
+    {
+        std::cerr << "Warning: low-pass pool exhausted, allocating a new instance" << std::endl;
+        effect = std::make_shared<LowPassEffect>(cutoffHz, m_sampleRate, resonance, mix);
+    }
+    m_audioSystem.addEffect(effect);
+}
+
+void EngineController::addOctave(bool higher, float blend)
+{
+    auto effect = m_effectPool->acquireOctave(higher, blend, m_heldFrequency);
+    if (!effect)
+    {
+        std::cerr << "Warning: octave pool exhausted, allocating a new instance" << std::endl;
+        effect = std::make_shared<OctaveEffect>(higher, blend);
+        effect->setSampleRate(m_sampleRate);
+        if (m_heldFrequency > 0.0f)
+        {
+            effect->setFrequency(m_heldFrequency);
+        }
+    }
+    m_audioSystem.addEffect(effect);
+}
+
+void EngineController::addSpectralFreeze(float mix)
+{
+    auto effect = m_effectPool->acquireSpectralFreeze(mix);
+    if (!effect)
+    {
+        std::cerr << "Warning: spectral freeze pool exhausted, allocating a new instance" << std::endl;
+        effect = std::make_shared<SpectralFreezeEffect>(mix, m_sampleRate, EffectPool::kSpectralFrameSize,
+                                                        useSpectralWorker(EffectPool::kSpectralFrameSize));
+    }
+    m_audioSystem.addEffect(effect);
+}
+
+void EngineController::addSpectralSmear(float amount, float mix)
+{
+    auto effect = m_effectPool->acquireSpectralSmear(amount, mix);
+    if (!effect)
+    {
+        std::cerr << "Warning: spectral smear pool exhausted, allocating a new instance" << std::endl;
+        effect = std::make_shared<SpectralSmearEffect>(amount, mix, m_sampleRate, EffectPool::kSpectralFrameSize,
+                                                       useSpectralWorker(EffectPool::kSpectralFrameSize));
+    }
+    m_audioSystem.addEffect(effect);
+}
+
+void EngineController::addTimeStretch(float speed)
+{
+    prepareTimeStretch();
+    m_timeStretch->setSpeed(speed);
+    m_audioSystem.addEffect(m_timeStretch);
+}
+
+void EngineController::loadTimeStretchSample(const std::vector<float>& samples, float sourceSampleRate)
+{
+    prepareTimeStretch();
+    m_audioSystem.loadTimeStretchSample(m_timeStretch, samples, sourceSampleRate);
+}
+
+void EngineController::addVocoder(std::size_t bands, float mix)
+{
+    // The audio thread may still be running the vocoder, so the bands change through the queue
+    m_audioSystem.configureVocoder(m_vocoder, bands);
+    m_vocoder->setMix(mix);
+    m_audioSystem.addEffect(m_vocoder);
+}
+
+void EngineController::loadVocoderModulator(const std::vector<float>& samples, float sourceSampleRate)
+{
+    m_audioSystem.loadVocoderModulator(m_vocoder, samples, sourceSampleRate);
+}
+
+void EngineController::setVocoderModulatorSource(const std::string& source)
+{
+    m_vocoder->setModulatorSource(source == "live"
+        ? VocoderEffect::ModulatorSource::Live
+        : VocoderEffect::ModulatorSource::Sample);
+}
+
+void EngineController::setGranularEnabled(bool enabled)
+{
+    m_audioSystem.setGranularSource(enabled ? m_granularSource : nullptr);
+}
+
+void EngineController::configureGranular(float density, float grainMs, float position, float positionSpread,
+                                         float pitchSpreadCents, float panSpread)
+{
+    m_granularSource->setDensity(density);
+    m_granularSource->setGrainDuration(grainMs / 1000.0f);
+    m_granularSource->setPosition(position);
+    m_granularSource->setPositionSpread(positionSpread);
+    m_granularSource->setPitchSpread(pitchSpreadCents);
+    m_granularSource->setPanSpread(panSpread);
+}
+
+void EngineController::setGranularBufferMode(const std::string& mode)
+{
+    m_granularSource->setBufferMode(mode == "live"
+        ? GranularSource::BufferMode::Live
+        : GranularSource::BufferMode::Sample);
+}
+
+void EngineController::loadGranularSample(const std::vector<float>& samples, float sourceSampleRate,
+                                          float rootFrequency)
+{
+    m_audioSystem.loadGranularSample(m_granularSource, samples, sourceSampleRate, rootFrequency);
+}
+
+bool EngineController::openMidiInput()
+{
+    closeMidiInput();
+
+    try
+    {
+        RtMidiIn probe;
+        const unsigned int ports = probe.getPortCount();
+        if (ports == 0)
+        {
+            std::cout << "No MIDI ports found" << std::endl;
+            return false;
+        }
+
+        unsigned int selected = 0;
+        for (unsigned int i = 0; i < ports; ++i)
+        {
+            if (!isVirtualMidiPort(probe.getPortName(i)))
+            {
+                selected = i;
+                break;
+            }
+        }
+
+        const std::string name = probe.getPortName(selected);
+        m_midiAdapter.reset(new AudioSystemAdapter(&m_audioSystem));
+        m_midiDevice.reset(new MidiDevice(static_cast<int>(selected)));
+        m_midiDevice->attach(m_midiAdapter.get());
+        m_midiDevice->start();
+        m_midiDeviceName = name;
+        std::cout << "MIDI input: " << m_midiDeviceName << std::endl;
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Warning: Failed to initialize MIDI: " << e.what() << std::endl;
+        m_midiDevice.reset();
+        m_midiDeviceName.clear();
+        return false;
+    }
+}
+
+void EngineController::closeMidiInput()
+{
+    if (m_midiDevice)
+    {
+        m_midiDevice->stop();
+        m_midiDevice.reset();
+    }
+    m_midiDeviceName.clear();
+}
+
+bool EngineController::useSpectralWorker(std::size_t frameSize) const
+{
+    return frameSize / SpectralEffect::kOverlap >= m_bufferFrames;
+}
+
+void EngineController::prepareTimeStretch()
+{
+    // Only adding or loading the player hands it to the audio thread, and both come here first
+    if (useSpectralWorker(m_timeStretch->frameSize()))
+    {
+        m_timeStretch->startWorker();
+    }
+}
+
+void EngineController::releaseHeldKey(int key)
+{
+    if (key == m_heldKey)
+    {
+        forgetCurrentNote();
+    }
+}
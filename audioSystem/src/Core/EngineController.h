@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "audioSystem.h"
+#include "Effects/EffectPool.h"
+
+class AudioSystemAdapter;
+class GranularSource;
+class MidiDevice;
+class TimeStretchEffect;
+class VocoderEffect;
+
+/**
+ * @class EngineController
+ * @brief Control-thread front end of an AudioSystem, shared by the Node addon and the engine host
+ *
+ * Owns what outlives effect chain rebuilds: the granular source, the
+ * time-stretch player, the vocoder, the effect pool and the MIDI input. It
+ * turns the requests both front ends accept into AudioSystem calls, so the
+ * in-process addon and the out-of-process host behave the same; they only
+ * differ in how the requests reach it.
+ *
+ * Pooled effects are used while the pool has a free instance; after that a
+ * new one is allocated with a warning. Spectral effects get a background
+ * worker when their hop spans at least one device buffer.
+ *
+ * Not thread safe; call it from one control thread. The MIDI input talks to
+ * the AudioSystem directly from its own thread.
+ */
+class EngineController
+{
+public:
+    /**
+     * @param audioSystem Engine to control; must outlive the controller
+     * @param sampleRate Engine sample rate in Hz
+     * @param bufferFrames Device buffer size, which decides the spectral workers
+     * @param poolLimits Instances built up front per pooled effect type
+     */
+    EngineController(AudioSystem& audioSystem, float sampleRate, unsigned int bufferFrames,
+                     const EffectPool::Limits& poolLimits = EffectPool::defaultLimits());
+
+    /// Stops the MIDI input
+    ~EngineController();
+
+    EngineController(const EngineController&) = delete;
+    EngineController& operator=(const EngineController&) = delete;
+
+    AudioSystem& audioSystem() { return m_audioSystem; }
+
+    /**
+     * @brief Play a note by frequency (see AudioSystem::triggerNote())
+     */
+    void triggerNote(float frequency);
+
+    /**
+     * @brief Release a note started by triggerNote(), or every note when frequency is not positive
+     */
+    void triggerNoteOff(float frequency);
+
+    /**
+     * @brief Start a MIDI note at a render frame, 0 for the next block (see AudioSystem::noteOnAt())
+     */
+    void noteOnAt(std::uint64_t frame, int note, float velocity, int channel);
+
+    /**
+     * @brief Release a MIDI note at a render frame, 0 for the next block
+     */
+    void noteOffAt(std::uint64_t frame, int note, int channel);
+
+    /**
+     * @brief Forget the note that tunes new octave effects, e.g. once the device stops
+     */
+    void forgetCurrentNote();
+
+    /**
+     * @brief Select the oscillator waveform
+     * @param name "sine", "square", "saw" or "triangle"
+     * @return false, with nothing changed, for any other name
+     */
+    bool setWaveform(const std::string& name);
+
+    void addDelay(float delaySeconds, float feedback, float mix);
+    void addLowPass(float cutoffHz, float resonance, float mix);
+    /// Tuned to the latest note still held, if any
+    void addOctave(bool higher, float blend);
+    void addSpectralFreeze(float mix);
+    void addSpectralSmear(float amount, float mix);
+
+    /**
+     * @brief Insert the time-stretch player, which keeps its sample across chain rebuilds
+     *
+     * Its gain, looping and transport are set through timeStretch().
+     */
+    void addTimeStretch(float speed);
+    void loadTimeStretchSample(const std::vector<float>& samples, float sourceSampleRate);
+    /// The time-stretch player; its setters and transport are safe from the control thread
+    TimeStretchEffect& timeStretch() { return *m_timeStretch; }
+
+    /**
+     * @brief Insert the vocoder, which keeps its modulator across chain rebuilds
+     * @param bands Band count, applied by the audio thread (AudioSystem::configureVocoder())
+     * @param mix Dry/wet mix
+     */
+    void addVocoder(std::size_t bands, float mix);
+    void loadVocoderModulator(const std::vector<float>& samples, float sourceSampleRate);
+    /// "live" follows the live input; anything else plays the loaded modulator
+    void setVocoderModulatorSource(const std::string& source);
+
+    void setGranularEnabled(bool enabled);
+    void configureGranular(float density, float grainMs, float position, float positionSpread,
+                           float pitchSpreadCents, float panSpread);
+    /// "live" grains from the live input; anything else from the loaded sample
+    void setGranularBufferMode(const std::string& mode);
+    void loadGranularSample(const std::vector<float>& samples, float sourceSampleRate, float rootFrequency);
+
+    /**
+     * @brief Open the first hardware MIDI input and play it through the engine
+     *
+     * Skips the ALSA and PipeWire virtual ports (Midi Through, Announce,
+     * Timer, PipeWire) and falls back to port 0. Failures are reported on
+     * stderr; the engine keeps running without MIDI.
+     *
+     * @return Whether an input is open
+     */
+    bool openMidiInput();
+
+    /// Stop the MIDI input, if open
+    void closeMidiInput();
+
+    bool midiConnected() const { return m_midiDevice != nullptr; }
+    /// Name of the open MIDI input, "" without one
+    const std::string& midiDeviceName() const { return m_midiDeviceName; }
+
+private:
+    /// Spectral effects use the background worker when a hop spans a device buffer
+    bool useSpectralWorker(std::size_t frameSize) const;
+    /// Start the time-stretch player's worker before its first use, if it should have one
+    void prepareTimeStretch();
+    /// Forget the held note if key (channel * kMidiNotes + note, as the engine keys voices) is it
+    void releaseHeldKey(int key);
+
+    static constexpr int kNoHeldNote = -1;
+
+    AudioSystem& m_audioSystem;
+    float m_sampleRate;
+    unsigned int m_bufferFrames;
+    std::shared_ptr<GranularSource> m_granularSource;
+    std::shared_ptr<TimeStretchEffect> m_timeStretch;
+    std::shared_ptr<VocoderEffect> m_vocoder;
+    std::unique_ptr<EffectPool> m_effectPool;       ///< Prebuilt delay, filter, octave and spectral instances
+    std::unique_ptr<AudioSystemAdapter> m_midiAdapter;
+    std::unique_ptr<MidiDevice> m_midiDevice;
+    std::string m_midiDeviceName;
+    int m_heldKey;                      ///< Engine key of the latest note started, kNoHeldNote once released
+    float m_heldFrequency;              ///< Frequency m_heldKey plays at, 0 without one; tunes new octave effects
+};
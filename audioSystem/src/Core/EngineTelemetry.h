@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file EngineTelemetry.h
+ * @brief Snapshot of engine state published by the audio thread after every block
+ */
+
+/**
+ * @enum EnvelopeStage
+ * @brief Voice envelope stage as reported in telemetry
+ */
+enum class EnvelopeStage : std::uint8_t
+{
+    Idle,
+    Attack,
+    Decay,
+    Sustain,
+    Release
+};
+
+/**
+ * @struct VoiceTelemetry
+ * @brief State of one voice at the end of a block
+ */
+struct VoiceTelemetry
+{
+    int note = -1;                      ///< Sounding MIDI note, -1 when no note is held
+    int channel = -1;                   ///< MIDI channel of the sounding note
+    float frequency = 0.0f;             ///< Base frequency before drift and pitch bend, in Hz
+    float velocity = 0.0f;              ///< Velocity of the current phrase
+    EnvelopeStage stage = EnvelopeStage::Idle;
+    float envelopeLevel = 0.0f;         ///< Envelope output [0.0-1.0], before velocity
+};
+
+/**
+ * @struct StageCost
+ * @brief Render time of one stage as a fraction of the audio it rendered
+ *
+ * Measured per engine quantum (AudioSystem::kQuantumFrames), so figures
+ * compare across device buffer sizes. 1.0 means the stage alone took as
+ * long as the audio it rendered.
+ */
+struct StageCost
+{
+    static constexpr std::size_t kNameLength = 16;
+
+    char name[kNameLength] = {};        ///< Stage or effect name, NUL-terminated
+    float last = 0.0f;                  ///< Latest quantum
+    float average = 0.0f;               ///< Exponential average, 0.5 s time constant
+    float peak = 0.0f;                  ///< Highest quantum, decaying with a 2 s time constant
+};
+
+/**
+ * @struct GovernorTelemetry
+ * @brief Load governor state and counters (see LoadGovernor)
+ */
+struct GovernorTelemetry
+{
+    static constexpr std::size_t kActions = 4;     ///< Indexed by LoadGovernor::Action
+
+    std::uint32_t level = 0;            ///< Steps currently shed
+    std::uint32_t steps = 0;            ///< Steps in the ladder, 0 when the governor is off
+    std::uint32_t overruns = 0;         ///< Blocks whose render took longer than their duration
+    std::uint32_t shed[kActions] = {};      ///< Times each action was applied since start
+    std::uint32_t restored[kActions] = {};  ///< Times each action was undone since start
+    std::uint64_t stolenGrains = 0;     ///< Granular grains ended early by the grain limit
+};
+
+/**
+ * @struct MemoryTelemetry
+ * @brief Bytes the engine holds, by component
+ *
+ * Counts the objects and the buffers they allocated, from the capacity of
+ * each buffer. What the host keeps outside the engine (idle pooled
+ * effects, the audio device) is not included.
+ */
+struct MemoryTelemetry
+{
+    static constexpr std::size_t kMaxEffects = 32;     ///< Same as EngineTelemetry::kMaxEffects
+
+    std::uint64_t effects = 0;          ///< Effects in the rendered chain, with their slots
+    std::uint64_t voices = 0;           ///< Envelope and granular source (loaded sample, live ring, grain pool)
+    std::uint64_t rings = 0;            ///< Command queues, telemetry buffers, stage buffers and the waveform tap
+    std::uint64_t tables = 0;           ///< Tuning table, grain windows and FFT plans
+    std::uint64_t master = 0;           ///< Master compressor and limiter
+    std::uint64_t total = 0;            ///< Sum of the above
+    std::uint64_t budget = 0;           ///< Limit checked when effects are inserted, 0 when unlimited
+    std::uint32_t rejectedEffects = 0;  ///< Insertions refused by the budget since start
+    std::uint64_t effectBytes[kMaxEffects] = {};  ///< The first `effects` chain entries, in chain order
+};
+
+/**
+ * @struct EngineTelemetry
+ * @brief Compact engine state for meters and status displays
+ *
+ * Plain data so it can be copied through a TripleBuffer. The engine is
+ * monophonic, so there is one voice; kMaxVoices leaves room for more.
+ */
+struct EngineTelemetry
+{
+    static constexpr std::size_t kMaxVoices = 1;
+    static constexpr std::size_t kMaxEffects = 32;     ///< Same as AudioSystem::kMaxEffects
+
+    std::uint64_t frame = 0;            ///< Clock frame at the start of the block
+    std::uint32_t blockFrames = 0;      ///< Frames in the block
+    int heldNotes = 0;                  ///< Notes currently held across all channels
+    std::uint32_t activeVoices = 0;     ///< Voices producing sound (envelope not idle)
+    VoiceTelemetry voices[kMaxVoices];
+
+    float pitchBendCents = 0.0f;        ///< Pitch bend currently applied
+    float lowPassCutoffHz = 0.0f;       ///< Effective cutoff of the first low-pass effect, 0 without one
+    std::uint32_t effects = 0;          ///< Effects in the rendered chain
+
+    float peak[2] = {0.0f, 0.0f};       ///< Output sample peak per channel over the block
+    float rms[2] = {0.0f, 0.0f};        ///< Output RMS per channel over the block
+    float gainReductionDb = 0.0f;       ///< Master compressor plus limiter reduction
+
+    float cpuLoad = 0.0f;               ///< Render time divided by the block duration
+    StageCost voiceCost;                ///< Voice rendering and live input
+    StageCost masterCost;               ///< Master compressor and limiter
+    StageCost effectCosts[kMaxEffects]; ///< The first `effects` entries, in chain order
+    GovernorTelemetry governor;
+    MemoryTelemetry memory;
+    std::uint32_t pendingEvents = 0;    ///< Timed events waiting for their frame
+    std::size_t droppedCommands = 0;    ///< Control changes rejected since start
+};
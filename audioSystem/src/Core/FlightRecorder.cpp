@@ -0,0 +1,250 @@
+#include "FlightRecorder.h"
+#include "AudioClock.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace {
+    const char* const kFlagNames[] = {"underflow", "overflow", "deadline"};
+
+    std::size_t ringSize(float sampleRate, unsigned int bufferFrames) {
+        const double callbacks = FlightRecorder::kRingSeconds * static_cast<double>(sampleRate)
+                               / static_cast<double>(std::max(bufferFrames, 1U));
+        std::size_t size = 64U;
+        while (static_cast<double>(size) < callbacks) {
+            size *= 2U;
+        }
+        return size;
+    }
+}
+
+constexpr double FlightRecorder::kRingSeconds;
+constexpr std::size_t FlightRecorder::kWords;
+
+// -----------------------------------------------------------------------------
+// FlightRecorder implementation
+// -----------------------------------------------------------------------------
+
+FlightRecorder::FlightRecorder(float sampleRate, unsigned int bufferFrames)
+    : m_sampleRate(sampleRate),
+      m_slots(ringSize(sampleRate, bufferFrames)),
+      m_mask(m_slots.size() - 1U)
+{
+}
+
+void FlightRecorder::record(Entry entry)
+{
+    const double blockNanos = 1.0e9 * static_cast<double>(entry.frames) / static_cast<double>(m_sampleRate);
+    if (static_cast<double>(entry.durationNanos) > blockNanos)
+    {
+        entry.flags |= DeadlineMiss;
+    }
+
+    std::uint64_t words[kWords];
+    std::memcpy(words, &entry, sizeof(entry));
+
+    const std::uint64_t index = m_written.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[static_cast<std::size_t>(index) & m_mask];
+    slot.sequence.store(2U * index + 1U, std::memory_order_relaxed);
+    for (std::size_t word = 0; word < kWords; ++word)
+    {
+        // Release, so a reader that sees this word also sees the odd sequence
+        slot.words[word].store(words[word], std::memory_order_release);
+    }
+    slot.sequence.store(2U * index + 2U, std::memory_order_release);
+    m_written.store(index + 1U, std::memory_order_release);
+
+    if (entry.flags != 0U)
+    {
+        m_triggers.fetch_add(1U, std::memory_order_release);
+    }
+}
+
+std::vector<FlightRecorder::Entry> FlightRecorder::snapshot(double seconds) const
+{
+    const std::uint64_t end = m_written.load(std::memory_order_acquire);
+    const std::uint64_t begin = end > m_slots.size() ? end - m_slots.size() : 0U;
+
+    std::vector<Entry> entries;
+    entries.reserve(static_cast<std::size_t>(end - begin));
+    for (std::uint64_t index = begin; index < end; ++index)
+    {
+        const Slot& slot = m_slots[static_cast<std::size_t>(index) & m_mask];
+        const std::uint64_t expected = 2U * index + 2U;
+        if (slot.sequence.load(std::memory_order_acquire) != expected)
+        {
+            continue;   // Being overwritten by a newer callback
+        }
+
+        std::uint64_t words[kWords];
+        for (std::size_t word = 0; word < kWords; ++word)
+        {
+            words[word] = slot.words[word].load(std::memory_order_acquire);
+        }
+        if (slot.sequence.load(std::memory_order_relaxed) != expected)
+        {
+            continue;
+        }
+
+        Entry entry;
+        std::memcpy(&entry, words, sizeof(entry));
+        entries.push_back(entry);
+    }
+
+    if (!entries.empty())
+    {
+        const std::int64_t from = entries.back().startNanos - static_cast<std::int64_t>(seconds * 1.0e9);
+        const auto first = std::find_if(entries.begin(), entries.end(),
+                                        [from](const Entry& entry) { return entry.startNanos >= from; });
+        entries.erase(entries.begin(), first);
+    }
+    return entries;
+}
+
+std::string FlightRecorder::flagNames(std::uint8_t flags)
+{
+    std::string names;
+    for (std::size_t bit = 0; bit < sizeof(kFlagNames) / sizeof(kFlagNames[0]); ++bit)
+    {
+        if ((flags & (1U << bit)) != 0U)
+        {
+            if (!names.empty())
+            {
+                names += '|';
+            }
+            names += kFlagNames[bit];
+        }
+    }
+    return names;
+}
+
+// -----------------------------------------------------------------------------
+// FlightRecorderDumper implementation
+// -----------------------------------------------------------------------------
+
+FlightRecorderDumper::FlightRecorderDumper(const FlightRecorder& recorder, const std::string& directory,
+                                           double seconds, std::chrono::milliseconds interval)
+    : m_recorder(recorder),
+      m_directory(directory.empty() ? std::string(".") : directory),
+      m_seconds(std::max(0.0, std::min(seconds, FlightRecorder::kRingSeconds))),
+      m_seenTriggers(recorder.triggers()),
+      m_holdUntilNanos(0)
+{
+    if (::mkdir(m_directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        throw std::runtime_error("Cannot create xrun directory " + m_directory + ": " + std::string(strerror(errno)));
+    }
+
+    SetTimer(interval, interval);
+    Start();
+}
+
+FlightRecorderDumper::~FlightRecorderDumper()
+{
+    Stop();
+}
+
+std::unique_ptr<FlightRecorderDumper> FlightRecorderDumper::fromEnvironment(const FlightRecorder& recorder,
+                                                                            double seconds)
+{
+    const char* directory = std::getenv("AUDIO_XRUN_DIR");
+    if (directory == nullptr || directory[0] == '\0')
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        return std::unique_ptr<FlightRecorderDumper>(new FlightRecorderDumper(recorder, directory, seconds));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Warning: xrun dumps disabled: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void FlightRecorderDumper::onTimeout()
+{
+    const std::uint32_t triggers = m_recorder.triggers();
+    if (triggers == m_seenTriggers || AudioClock::hostTimeNanos() < m_holdUntilNanos)
+    {
+        return;
+    }
+
+    const std::string path = dump();
+    m_seenTriggers = triggers;
+    m_holdUntilNanos = AudioClock::hostTimeNanos() + static_cast<std::int64_t>(m_seconds * 1.0e9);
+    if (!path.empty())
+    {
+        m_dumps.fetch_add(1U, std::memory_order_relaxed);
+        std::cerr << "Xrun: flight recorder written to " << path << std::endl;
+    }
+}
+
+std::string FlightRecorderDumper::dump()
+{
+    const std::vector<FlightRecorder::Entry> entries = m_recorder.snapshot(m_seconds);
+    if (entries.empty())
+    {
+        return std::string();
+    }
+
+    char stamp[32];
+    const std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &local);
+    const std::string path = m_directory + "/xrun-" + stamp + "-" + std::to_string(dumps() + 1U) + ".csv";
+
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr)
+    {
+        std::cerr << "Warning: cannot write " << path << ": " << strerror(errno) << std::endl;
+        return std::string();
+    }
+
+    // Times are relative to the first flagged callback in the window
+    std::size_t flagged = 0;
+    std::int64_t origin = entries.back().startNanos;
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+    {
+        if (it->flags != 0U)
+        {
+            origin = it->startNanos;
+            ++flagged;
+        }
+    }
+
+    std::fprintf(file, "# flight recorder: %zu callbacks, %zu flagged, sample rate %.0f\n",
+                 entries.size(), flagged, static_cast<double>(m_recorder.sampleRate()));
+    std::fputs("time_ms,duration_us,frames,load,voices,grains,commands,midi,governor,flags\n", file);
+    for (const FlightRecorder::Entry& entry : entries)
+    {
+        const double blockNanos = 1.0e9 * static_cast<double>(entry.frames) / static_cast<double>(m_recorder.sampleRate());
+        const double load = blockNanos > 0.0 ? static_cast<double>(entry.durationNanos) / blockNanos : 0.0;
+        std::fprintf(file, "%.3f,%.1f,%u,%.3f,%u,%u,%u,%u,%u,%s\n",
+                     static_cast<double>(entry.startNanos - origin) * 1.0e-6,
+                     static_cast<double>(entry.durationNanos) * 1.0e-3,
+                     static_cast<unsigned int>(entry.frames), load,
+                     static_cast<unsigned int>(entry.voices), static_cast<unsigned int>(entry.grains),
+                     static_cast<unsigned int>(entry.commands), static_cast<unsigned int>(entry.midiEvents),
+                     static_cast<unsigned int>(entry.governorLevel),
+                     FlightRecorder::flagNames(entry.flags).c_str());
+    }
+
+    if (std::fclose(file) != 0)
+    {
+        std::cerr << "Warning: cannot write " << path << ": " << strerror(errno) << std::endl;
+        return std::string();
+    }
+    return path;
+}
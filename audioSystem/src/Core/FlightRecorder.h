@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TimerFd.h"
+
+/**
+ * @class FlightRecorder
+ * @brief Always-on record of the latest audio callbacks, kept for xrun post-mortems
+ *
+ * The audio thread writes one Entry per callback into a fixed ring sized
+ * once, when the stream is opened; recording never allocates, blocks or
+ * does I/O. A callback that reports an RtAudio underflow/overflow or that
+ * ran longer than its buffer lasts raises a trigger, and a
+ * FlightRecorderDumper thread copies the ring out and writes it to disk.
+ *
+ * Each slot is guarded by a sequence number (a seqlock), so a reader on
+ * another thread skips the few slots the audio thread overwrites while
+ * they are being copied instead of ever making the writer wait.
+ */
+class FlightRecorder
+{
+public:
+    /**
+     * @brief Why a callback was flagged; an entry may carry several
+     */
+    enum Flag : std::uint8_t
+    {
+        OutputUnderflow = 1U << 0,  ///< RtAudio: the device ran out of output
+        InputOverflow   = 1U << 1,  ///< RtAudio: input was dropped
+        DeadlineMiss    = 1U << 2   ///< The callback took longer than the audio it rendered
+    };
+
+    /**
+     * @brief One audio callback
+     */
+    struct Entry
+    {
+        std::int64_t startNanos = 0;        ///< steady_clock time the callback started
+        std::int64_t durationNanos = 0;     ///< Time spent in the callback
+        std::uint32_t frames = 0;           ///< Frames rendered
+        std::uint16_t voices = 0;           ///< Voices sounding at the end of the block
+        std::uint16_t grains = 0;           ///< Granular grains sounding at the end of the block
+        std::uint16_t commands = 0;         ///< Control commands applied during the block
+        std::uint16_t midiEvents = 0;       ///< Of those, the ones that came from MIDI input
+        std::uint8_t flags = 0;             ///< Flag bits
+        std::uint8_t governorLevel = 0;     ///< Load governor steps shed
+        std::uint16_t reserved = 0;
+    };
+
+    static constexpr double kRingSeconds = 30.0;   ///< History kept, at the stream's buffer size
+
+    /**
+     * @brief Size the ring for kRingSeconds of callbacks
+     * @param sampleRate Stream sample rate
+     * @param bufferFrames Frames per callback, as opened
+     */
+    FlightRecorder(float sampleRate, unsigned int bufferFrames);
+
+    /**
+     * @brief Append a callback, flagging a deadline miss, and raise the trigger if flagged (audio thread)
+     */
+    void record(Entry entry);
+
+    /// Callbacks recorded so far
+    std::uint64_t recorded() const { return m_written.load(std::memory_order_acquire); }
+
+    /// Flagged callbacks so far; a change means there is something to dump
+    std::uint32_t triggers() const { return m_triggers.load(std::memory_order_acquire); }
+
+    float sampleRate() const { return m_sampleRate; }
+
+    /// Callbacks the ring holds
+    std::size_t capacity() const { return m_slots.size(); }
+
+    /**
+     * @brief Copy the callbacks that started within the last few seconds (any thread)
+     * @param seconds Window ending at the most recent callback
+     * @return Entries oldest first; slots overwritten during the copy are left out
+     */
+    std::vector<Entry> snapshot(double seconds) const;
+
+    /// Names of the flags set in an entry, '|'-separated, or "" for none
+    static std::string flagNames(std::uint8_t flags);
+
+private:
+    static constexpr std::size_t kWords = sizeof(Entry) / sizeof(std::uint64_t);
+    static_assert(sizeof(Entry) % sizeof(std::uint64_t) == 0, "Entry is stored as whole words");
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence{0};    ///< 2 * (index + 1) when complete, odd while written
+        std::atomic<std::uint64_t> words[kWords];
+    };
+
+    float m_sampleRate;
+    std::vector<Slot> m_slots;                      ///< Power-of-two ring
+    std::size_t m_mask;
+    std::atomic<std::uint64_t> m_written{0};        ///< Entries recorded; the next index
+    std::atomic<std::uint32_t> m_triggers{0};       ///< Flagged entries recorded
+};
+
+/**
+ * @class FlightRecorderDumper
+ * @brief Writes the flight recorder to a file after a flagged callback
+ *
+ * Polls the recorder's trigger count from its own thread. When it moves
+ * the last seconds of callbacks are written as CSV to
+ * <directory>/xrun-<date>-<time>-<n>.csv, with times relative to the
+ * first flagged callback. After a dump further triggers are held until a
+ * whole window has passed, so a burst of xruns produces one file covering
+ * all of them rather than one per callback.
+ */
+class FlightRecorderDumper : public TimerFd
+{
+public:
+    /**
+     * @brief Start watching a recorder
+     * @param recorder Recorder to dump; must outlive the dumper
+     * @param directory Where files go; created if missing
+     * @param seconds Length of history written per dump, at most FlightRecorder::kRingSeconds
+     * @throws std::runtime_error if the directory cannot be created
+     */
+    FlightRecorderDumper(const FlightRecorder& recorder, const std::string& directory, double seconds,
+                         std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+
+    ~FlightRecorderDumper();
+
+    /**
+     * @brief Start a dumper writing to $AUDIO_XRUN_DIR, if that is set
+     * @return The running dumper, or nullptr when the variable is unset or the directory is unusable
+     */
+    static std::unique_ptr<FlightRecorderDumper> fromEnvironment(const FlightRecorder& recorder, double seconds);
+
+    /// Files written so far
+    std::uint32_t dumps() const { return m_dumps.load(std::memory_order_relaxed); }
+
+protected:
+    void onTimeout() override;
+
+private:
+    /// Write the current window; returns the file name, or "" on failure
+    std::string dump();
+
+    const FlightRecorder& m_recorder;
+    std::string m_directory;
+    double m_seconds;
+    std::uint32_t m_seenTriggers;                   ///< Trigger count covered by the last dump
+    std::int64_t m_holdUntilNanos;                  ///< No dump before this steady_clock time
+    std::atomic<std::uint32_t> m_dumps{0};
+};
@@ -0,0 +1,132 @@
+#include "LoadGovernor.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+    const char* const kActionNames[LoadGovernor::kActions] = {"grains", "unison", "oversampling", "tails"};
+
+    std::size_t actionIndex(LoadGovernor::Action action) {
+        return static_cast<std::size_t>(action);
+    }
+}
+
+constexpr std::size_t LoadGovernor::kActions;
+constexpr std::size_t LoadGovernor::kMaxSteps;
+constexpr double LoadGovernor::kShedHoldSeconds;
+
+// -----------------------------------------------------------------------------
+// LoadGovernor implementation
+// -----------------------------------------------------------------------------
+
+void LoadGovernor::configure(const Settings& settings)
+{
+    m_settings = settings;
+    m_settings.steps = std::min(m_settings.steps, kMaxSteps);
+    m_settings.lowLoad = std::max(0.0f, std::min(m_settings.lowLoad, m_settings.highLoad));
+    m_settings.restoreSeconds = std::max(0.0f, m_settings.restoreSeconds);
+    m_calmSeconds = 0.0;
+}
+
+LoadGovernor::Decision LoadGovernor::update(float load, double blockSeconds)
+{
+    if (load >= 1.0f)
+    {
+        ++m_counters.overruns;
+    }
+    m_sinceStep += blockSeconds;
+
+    // Disabled, or the ladder got shorter: hand the extra steps back
+    const std::size_t allowed = m_settings.enabled ? m_settings.steps : 0U;
+    if (m_level > allowed)
+    {
+        return restoreStep();
+    }
+
+    if (load > m_settings.highLoad)
+    {
+        m_calmSeconds = 0.0;
+        if (m_level < allowed && m_sinceStep >= kShedHoldSeconds)
+        {
+            m_action = m_settings.order[m_level];
+            m_shedActions[m_level] = m_action;
+            ++m_level;
+            ++m_counters.shed[actionIndex(m_action)];
+            m_sinceStep = 0.0;
+            return Decision::Shed;
+        }
+        return Decision::None;
+    }
+
+    if (load >= m_settings.lowLoad)
+    {
+        m_calmSeconds = 0.0;
+        return Decision::None;
+    }
+
+    m_calmSeconds += blockSeconds;
+    if (m_level > 0U && m_calmSeconds >= m_settings.restoreSeconds)
+    {
+        m_calmSeconds = 0.0;
+        return restoreStep();
+    }
+    return Decision::None;
+}
+
+LoadGovernor::Decision LoadGovernor::restoreStep()
+{
+    --m_level;
+    m_action = m_shedActions[m_level];
+    ++m_counters.restored[actionIndex(m_action)];
+    // No hold after a restore: if the step brought the load back, shed it again at once
+    m_sinceStep = kShedHoldSeconds;
+    return Decision::Restore;
+}
+
+const char* LoadGovernor::actionName(Action action)
+{
+    return kActionNames[actionIndex(action)];
+}
+
+bool LoadGovernor::actionFromString(const std::string& name, Action& action)
+{
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    for (std::size_t index = 0; index < kActions; ++index)
+    {
+        if (lower == kActionNames[index])
+        {
+            action = static_cast<Action>(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint32_t LoadGovernor::packOrder(const std::array<Action, kMaxSteps>& order, std::size_t steps)
+{
+    // Nibble n holds step n as action + 1; a zero nibble ends the ladder
+    std::uint32_t packed = 0U;
+    for (std::size_t step = 0; step < std::min(steps, kMaxSteps); ++step)
+    {
+        packed |= static_cast<std::uint32_t>(actionIndex(order[step]) + 1U) << (4U * step);
+    }
+    return packed;
+}
+
+std::size_t LoadGovernor::unpackOrder(std::uint32_t packed, std::array<Action, kMaxSteps>& order)
+{
+    std::size_t steps = 0;
+    for (; steps < kMaxSteps; ++steps)
+    {
+        const std::uint32_t nibble = (packed >> (4U * steps)) & 0xFU;
+        if (nibble == 0U || nibble > kActions)
+        {
+            break;
+        }
+        order[steps] = static_cast<Action>(nibble - 1U);
+    }
+    return steps;
+}
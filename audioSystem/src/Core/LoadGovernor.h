@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class LoadGovernor
+ * @brief Decides when the engine sheds or restores work to stay inside its deadline
+ *
+ * Fed the render time of every block as a fraction of the block duration.
+ * When a block comes close to its deadline (above the high-water load) the
+ * governor sheds the next step of a configured ladder; once the load has
+ * stayed below the low-water mark for the restore time it brings the most
+ * recently shed step back. Sheds are at least kShedHoldSeconds apart so
+ * the effect of one step is measured before the next; a restore that
+ * brings the load straight back is shed again on the next block.
+ *
+ * The governor only decides; AudioSystem carries out the actions. It counts
+ * every step either way, plus the blocks that overran their deadline.
+ * Audio thread only.
+ */
+class LoadGovernor
+{
+public:
+    /**
+     * @enum Action
+     * @brief Work that can be shed, from the config names in actionName()
+     */
+    enum class Action : std::uint8_t
+    {
+        StealGrains,    ///< Halve the granular grain limit, ending the quietest grains
+        DropUnison,     ///< Silence the detuned secondary oscillator
+        TruePeakOff,    ///< Skip the limiter's oversampled inter-sample peak check
+        BypassTail      ///< Bypass the most expensive effect still running
+    };
+
+    static constexpr std::size_t kActions = 4;
+    static constexpr std::size_t kMaxSteps = 8;            ///< Longest ladder
+    static constexpr double kShedHoldSeconds = 0.05;       ///< Minimum time between two sheds
+
+    /**
+     * @struct Settings
+     * @brief Thresholds and the order work is shed in
+     */
+    struct Settings
+    {
+        bool enabled = true;
+        float highLoad = 0.8f;          ///< Shed when a block uses more than this of its duration
+        float lowLoad = 0.5f;           ///< Restore when blocks stay below this
+        float restoreSeconds = 2.0f;    ///< How long blocks must stay below lowLoad
+        std::array<Action, kMaxSteps> order{{Action::StealGrains, Action::DropUnison,
+                                            Action::TruePeakOff, Action::BypassTail}};
+        std::size_t steps = 4;          ///< Entries of order in use; an action may repeat
+    };
+
+    /**
+     * @enum Decision
+     * @brief What update() asks the engine to do after a block
+     */
+    enum class Decision
+    {
+        None,
+        Shed,       ///< Apply action()
+        Restore     ///< Undo action()
+    };
+
+    /**
+     * @brief Counters reported with the engine telemetry
+     */
+    struct Counters
+    {
+        std::uint32_t shed[kActions] = {};         ///< Times each action was applied
+        std::uint32_t restored[kActions] = {};     ///< Times each action was undone
+        std::uint32_t overruns = 0;                ///< Blocks that took longer than their duration
+    };
+
+    /**
+     * @brief Replace the settings; a shorter ladder or disabling restores the extra steps one per block
+     */
+    void configure(const Settings& settings);
+
+    /**
+     * @brief Feed the load of a finished block
+     * @param load Render time divided by the block duration
+     * @param blockSeconds Duration of the block's audio
+     * @return What to do; action() names the step concerned
+     */
+    Decision update(float load, double blockSeconds);
+
+    /// Step shed or restored by the latest update()
+    Action action() const { return m_action; }
+
+    /// Steps currently shed
+    std::size_t level() const { return m_level; }
+
+    const Settings& settings() const { return m_settings; }
+    const Counters& counters() const { return m_counters; }
+
+    /// Config name of an action ("grains", "unison", "oversampling", "tails")
+    static const char* actionName(Action action);
+
+    /**
+     * @brief Parse a config name (case-insensitive)
+     * @return false for unknown names
+     */
+    static bool actionFromString(const std::string& name, Action& action);
+
+    /// Pack a ladder into one word, 4 bits per step, for the engine command queue
+    static std::uint32_t packOrder(const std::array<Action, kMaxSteps>& order, std::size_t steps);
+    static std::size_t unpackOrder(std::uint32_t packed, std::array<Action, kMaxSteps>& order);
+
+private:
+    Decision restoreStep();
+
+    Settings m_settings;
+    Counters m_counters;
+    std::array<Action, kMaxSteps> m_shedActions{};  ///< Actions applied, in order, so they are undone in reverse
+    std::size_t m_level = 0;
+    Action m_action = Action::StealGrains;
+    double m_sinceStep = kShedHoldSeconds;          ///< Time since the last shed
+    double m_calmSeconds = 0.0;                     ///< Time the load has been below lowLoad
+};
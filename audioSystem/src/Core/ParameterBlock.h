@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @file ParameterBlock.h
+ * @brief Shared-memory block of continuous controller values
+ */
+
+/**
+ * @class ParameterBlock
+ * @brief View over a block of 32-bit words that a UI writes and the audio thread polls
+ *
+ * Layout, in 32-bit words:
+ *   [0]             dirty bits, one per parameter
+ *   [1]             layout version (kVersion)
+ *   [2, 2 + Count)  parameter values as IEEE-754 float bits
+ *
+ * A writer stores the value bits and then sets the parameter's dirty bit;
+ * the audio thread swaps the dirty word to zero once per block and reads
+ * the values it flagged. Both sides only use single-word atomics, so the
+ * JavaScript side can write the same memory with Atomics on an Int32Array
+ * and no call ever crosses into native code or waits.
+ *
+ * The memory is owned elsewhere (for the Node addon, a V8 ArrayBuffer) and
+ * must outlive the view and stay 4-byte aligned.
+ */
+class ParameterBlock
+{
+public:
+    /**
+     * @enum Id
+     * @brief Parameters carried by the block, in word order
+     */
+    enum class Id : std::uint32_t
+    {
+        PitchBendCents,         ///< Pitch bend offset in cents, -100 to +100
+        LowPassCutoffHz,        ///< Cutoff of every low-pass effect in the chain
+        SecondaryMix,           ///< Secondary oscillator mix [0.0-1.0]
+        SecondaryDetuneCents,   ///< Secondary oscillator detune in cents (>= 0)
+        DriftRateHz,            ///< Drift LFO rate in Hz
+        DriftAmountCents,       ///< Drift LFO depth in cents
+        Count
+    };
+
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kCount = static_cast<std::size_t>(Id::Count);
+    static constexpr std::size_t kDirtyWord = 0;
+    static constexpr std::size_t kVersionWord = 1;
+    static constexpr std::size_t kFirstValueWord = 2;
+    static constexpr std::size_t kWords = kFirstValueWord + kCount;
+    static constexpr std::size_t kBytes = kWords * sizeof(std::uint32_t);
+
+    static_assert(kCount <= 32U, "One dirty bit per parameter");
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Words must be plain 32-bit cells");
+
+    /**
+     * @brief Wrap kBytes of memory and initialise the header
+     * @param memory Block storage; values are left as found and nothing is marked dirty
+     */
+    explicit ParameterBlock(void* memory)
+        : m_words(static_cast<std::atomic<std::uint32_t>*>(memory))
+    {
+        m_words[kVersionWord].store(kVersion, std::memory_order_relaxed);
+        m_words[kDirtyWord].store(0U, std::memory_order_release);
+    }
+
+    ParameterBlock(const ParameterBlock&) = delete;
+    ParameterBlock& operator=(const ParameterBlock&) = delete;
+
+    /**
+     * @brief Store a value and flag it for the audio thread (any writer)
+     */
+    void set(Id id, float value)
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        m_words[kFirstValueWord + index(id)].store(bits, std::memory_order_relaxed);
+        m_words[kDirtyWord].fetch_or(1U << index(id), std::memory_order_release);
+    }
+
+    /**
+     * @brief Take the set of parameters written since the last call (audio thread)
+     */
+    std::uint32_t takeDirty()
+    {
+        return m_words[kDirtyWord].exchange(0U, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Latest value written for a parameter
+     */
+    float value(Id id) const
+    {
+        const std::uint32_t bits = m_words[kFirstValueWord + index(id)].load(std::memory_order_relaxed);
+        float result = 0.0f;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    static std::size_t index(Id id) { return static_cast<std::size_t>(id); }
+
+private:
+    std::atomic<std::uint32_t>* m_words;
+};
@@ -46,6 +46,13 @@ public:
         m_totalFramesWritten.fetch_add(1U, std::memory_order_release);
     }
 
+    /**
+     * @return Frames pushed since construction; a change means there is something new to copy.
+     */
+    std::size_t totalFramesWritten() const noexcept {
+        return m_totalFramesWritten.load(std::memory_order_acquire);
+    }
+
     /**
      * @return Number of frames currently available to copy.
      */
@@ -91,6 +98,9 @@ public:
         return framesToCopy;
     }
 
+    /// Bytes of the sample storage
+    std::size_t bufferBytes() const { return m_buffer.capacity() * sizeof(float); }
+
 private:
     const std::size_t m_capacityFrames;
     std::vector<float> m_buffer;
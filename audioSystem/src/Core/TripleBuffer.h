@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file TripleBuffer.h
+ * @brief Wait-free hand-off of the latest value from one thread to another
+ */
+
+/**
+ * @class TripleBuffer
+ * @brief Single-producer, single-consumer latest-value exchange
+ *
+ * The writer fills its back slot and publishes it by swapping it with the
+ * middle slot; the reader swaps the middle slot into its front slot when a
+ * newer value is there. Each side only ever touches its own slot and one
+ * atomic byte, so neither waits and the reader always sees a complete
+ * value. Intermediate values are dropped when the writer is faster.
+ *
+ * @tparam T Trivially copyable value type
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : m_middle(1U)
+        , m_back(2U)
+        , m_front(0U)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Slot to fill before publish() (writer only)
+     */
+    T& back() { return m_slots[m_back]; }
+
+    /**
+     * @brief Make the back slot the latest value (writer only)
+     */
+    void publish()
+    {
+        const std::uint8_t previous = m_middle.exchange(static_cast<std::uint8_t>(m_back | kFresh), std::memory_order_acq_rel);
+        m_back = static_cast<std::uint8_t>(previous & kIndexMask);
+    }
+
+    /**
+     * @brief Latest published value (reader only)
+     *
+     * Returns the previous value again when nothing new was published.
+     */
+    const T& read()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & kFresh) != 0U)
+        {
+            const std::uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = static_cast<std::uint8_t>(previous & kIndexMask);
+        }
+        return m_slots[m_front];
+    }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x03U;
+    static constexpr std::uint8_t kFresh = 0x04U;   ///< Set while the middle slot holds an unread value
+
+    std::array<T, 3> m_slots{};
+    std::atomic<std::uint8_t> m_middle;   ///< Shared slot index plus the fresh flag
+    std::uint8_t m_back;                  ///< Writer's slot
+    std::uint8_t m_front;                 ///< Reader's slot
+};
@@ -1,11 +1,31 @@
 #include "audioDevice.h"
+#include <algorithm>
 #include "RtAudio.h"
+#include "AudioClock.h"
+#include "Dsp/SimdKernels.h"
+#include "Trace.h"
 
-AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames) :
+namespace {
+    RtAudioFormat rtAudioFormat(SampleFormat format) {
+        switch (format) {
+        case SampleFormat::Int16: return RTAUDIO_SINT16;
+        case SampleFormat::Int24: return RTAUDIO_SINT24;
+        case SampleFormat::Int32: return RTAUDIO_SINT32;
+        case SampleFormat::Float32:
+        default: return RTAUDIO_FLOAT32;
+        }
+    }
+}
+
+AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames, bool fullDuplex,
+                         const OutputFormat& outputFormat) :
                                                                     itsAudioSystem  (audioSystem),
                                                                     m_dac          (std::make_unique<RtAudio>()),
                                                                     m_sampleRate    (sampleRate),
-                                                                    m_bufferFrames  (bufferFrames) 
+                                                                    m_bufferFrames  (bufferFrames),
+                                                                    m_inputChannels (0U),
+                                                                    m_outputFormat  (outputFormat),
+                                                                    m_converter     (new SampleConverter())
 {
     if (m_dac->getDeviceCount() < 1) 
     {
@@ -15,11 +35,6 @@ AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned in
 
     m_dac->showWarnings(true);
 
-    RtAudio::StreamParameters parameters;
-    parameters.deviceId = m_dac->getDefaultOutputDevice();
-    parameters.nChannels = 2;  // Stereo output (2 channels)
-    parameters.firstChannel = 0;
-
     RtAudio::StreamOptions options;
     options.flags = RTAUDIO_SCHEDULE_REALTIME | RTAUDIO_MINIMIZE_LATENCY;
 #ifdef RTAUDIO_HOG_DEVICE
@@ -28,19 +43,112 @@ AudioDevice::AudioDevice(AudioSystem* audioSystem, float sampleRate, unsigned in
     options.numberOfBuffers = 2;
     options.priority = 60; // Request elevated realtime scheduling if available
 
+    if (fullDuplex && openStream(true, options))
+    {
+        return;
+    }
+
+    if (fullDuplex)
+    {
+        std::cerr << "Live input unavailable, continuing with output only" << std::endl;
+    }
+
+    if (!openStream(false, options))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+bool AudioDevice::openStream(bool withInput, RtAudio::StreamOptions& options)
+{
+    RtAudio::StreamParameters parameters;
+    parameters.deviceId = m_dac->getDefaultOutputDevice();
+    parameters.nChannels = 2;  // Stereo output (2 channels)
+    parameters.firstChannel = 0;
+
+    RtAudio::StreamParameters inputParameters;
+    if (withInput)
+    {
+        inputParameters.deviceId = m_dac->getDefaultInputDevice();
+        const unsigned int available = m_dac->getDeviceInfo(inputParameters.deviceId).inputChannels;
+        if (available == 0U)
+        {
+            return false;
+        }
+        inputParameters.nChannels = available >= 2U ? 2U : 1U;  // Stereo if possible, else mono
+        inputParameters.firstChannel = 0;
+    }
+
     unsigned int frames = m_bufferFrames;
 
     try {
-        m_dac->openStream(&parameters, nullptr, RTAUDIO_FLOAT32, 
-                         static_cast<unsigned int>(sampleRate), &frames, 
+        const SampleFormat format = chooseFormat(parameters.deviceId);
+        m_dac->openStream(&parameters, withInput ? &inputParameters : nullptr, rtAudioFormat(format),
+                         static_cast<unsigned int>(m_sampleRate), &frames, 
                          &AudioDevice::audioCallback, this, &options);
         m_bufferFrames = frames;
+        m_inputChannels = withInput ? inputParameters.nChannels : 0U;
+        m_flightRecorder.reset(new FlightRecorder(m_sampleRate, m_bufferFrames));
+        m_converter.reset(new SampleConverter(format, m_outputFormat.dither, m_outputFormat.noiseShaping));
+        m_renderBuffer.assign(format == SampleFormat::Float32 ? 0U : 2U * m_bufferFrames, 0.0f);
+        m_inputBuffer.assign(format == SampleFormat::Float32 ? 0U : m_inputChannels * m_bufferFrames, 0.0f);
         const double bufferMs = (static_cast<double>(m_bufferFrames) / m_sampleRate) * 1000.0;
-        std::cout << "Audio buffer configured: " << m_bufferFrames << " frames (~" << bufferMs << " ms)" << std::endl;
+        std::cout << "Audio buffer configured: " << m_bufferFrames << " frames (~" << bufferMs << " ms)";
+        if (withInput) {
+            std::cout << ", full duplex with " << m_inputChannels << " input channel(s)";
+        }
+        std::cout << std::endl;
+
+        const unsigned int masterFrames = itsAudioSystem->masterLatencyFrames();
+        std::cout << "Master bus latency: " << masterFrames << " frames (~"
+                  << (static_cast<double>(masterFrames) / m_sampleRate) * 1000.0 << " ms)" << std::endl;
+        std::cout << "Engine quantum: " << AudioSystem::kQuantumFrames << " frames";
+        if (m_bufferFrames % AudioSystem::kQuantumFrames != 0U) {
+            std::cout << " (buffer is not a multiple; live input may be delayed by up to "
+                      << AudioSystem::kQuantumFrames - 1U << " frames)";
+        }
+        std::cout << std::endl;
+        std::cout << "DSP kernels: " << simdLevelName(simdKernels().level) << std::endl;
+        std::cout << "Stream format: " << sampleFormatName(format);
+        if (m_converter->noiseShaping()) {
+            std::cout << " (TPDF dither, noise shaped)";
+        } else if (m_converter->dithers()) {
+            std::cout << " (TPDF dither)";
+        }
+        std::cout << std::endl;
     } catch (RtAudioError& error) {
         std::cerr << "Failed to open audio stream: " << error.getMessage() << std::endl;
-        exit(EXIT_FAILURE);
+        if (m_dac->isStreamOpen()) m_dac->closeStream();
+        return false;
+    }
+
+    return true;
+}
+
+SampleFormat AudioDevice::chooseFormat(unsigned int deviceId) const
+{
+    if (!m_outputFormat.native)
+    {
+        return m_outputFormat.format;
     }
+
+    const RtAudioFormat nativeFormats = m_dac->getDeviceInfo(deviceId).nativeFormats;
+    if (nativeFormats == 0U || (nativeFormats & rtAudioFormat(m_outputFormat.format)) != 0U)
+    {
+        return m_outputFormat.format;
+    }
+
+    // Otherwise the most precise format the device takes: float first since the engine renders in
+    // float, then integers from widest to narrowest, so the driver does not convert again
+    const SampleFormat fallbacks[] = {SampleFormat::Float32, SampleFormat::Int32, SampleFormat::Int24, SampleFormat::Int16};
+    for (SampleFormat format : fallbacks)
+    {
+        if ((nativeFormats & rtAudioFormat(format)) != 0U)
+        {
+            return format;
+        }
+    }
+    return m_outputFormat.format;
 }
 
 void AudioDevice::start() 
@@ -63,21 +171,71 @@ AudioDevice::~AudioDevice()
     if (m_dac->isStreamOpen()) m_dac->closeStream();
 }
 
-int AudioDevice::audioCallback(void* outputBuffer, void* /*inputBuffer*/, unsigned int nBufferFrames,
-                                double /*streamTime*/, RtAudioStreamStatus /*status*/, void* userData) 
+int AudioDevice::audioCallback(void* outputBuffer, void* inputBuffer, unsigned int nBufferFrames,
+                                double /*streamTime*/, RtAudioStreamStatus status, void* userData) 
 {
+    TRACE_THREAD_NAME("audio");
+    TRACE_ZONE("audioCallback");
     auto* device = static_cast<AudioDevice*>(userData);
-    float* buffer = static_cast<float*>(outputBuffer);
+    const std::int64_t startNanos = AudioClock::hostTimeNanos();
+
+    if (device->m_converter->format() == SampleFormat::Float32)
+    {
+        // Render the whole buffer; live input (if any) is consumed frame by frame
+        float* buffer = static_cast<float*>(outputBuffer);
+        const float* input = device->m_inputChannels > 0U ? static_cast<const float*>(inputBuffer) : nullptr;
+        device->itsAudioSystem->renderBlock(input, device->m_inputChannels, buffer, nBufferFrames);
+    }
+    else
+    {
+        device->renderConverted(outputBuffer, inputBuffer, nBufferFrames);
+    }
 
-    for (unsigned int i = 0; i < nBufferFrames; i++) 
+    const AudioSystem::BlockStats& stats = device->itsAudioSystem->blockStats();
+    FlightRecorder::Entry entry;
+    entry.startNanos = startNanos;
+    entry.durationNanos = AudioClock::hostTimeNanos() - startNanos;
+    entry.frames = nBufferFrames;
+    entry.voices = static_cast<std::uint16_t>(std::min<std::uint32_t>(stats.voices, 0xFFFFU));
+    entry.grains = static_cast<std::uint16_t>(std::min<std::uint32_t>(stats.grains, 0xFFFFU));
+    entry.commands = static_cast<std::uint16_t>(std::min<std::uint32_t>(stats.commands, 0xFFFFU));
+    entry.midiEvents = static_cast<std::uint16_t>(std::min<std::uint32_t>(stats.midiEvents, 0xFFFFU));
+    entry.governorLevel = static_cast<std::uint8_t>(std::min<std::uint32_t>(stats.governorLevel, 0xFFU));
+    if ((status & RTAUDIO_OUTPUT_UNDERFLOW) != 0U)
     {
-        // Get the next stereo sample from the AudioSystem
-        std::pair<float, float> stereoSample = device->itsAudioSystem->getNextSample();
-    
-        // Write the processed stereo sample to the buffer
-        buffer[2 * i] = stereoSample.first;  // Left channel
-        buffer[2 * i + 1] = stereoSample.second;  // Right channel
+        entry.flags |= FlightRecorder::OutputUnderflow;
     }
+    if ((status & RTAUDIO_INPUT_OVERFLOW) != 0U)
+    {
+        entry.flags |= FlightRecorder::InputOverflow;
+    }
+    device->m_flightRecorder->record(entry);
 
     return 0;
 }
+
+void AudioDevice::renderConverted(void* outputBuffer, const void* inputBuffer, unsigned int frames)
+{
+    const SampleFormat format = m_converter->format();
+    const std::size_t sampleBytes = sampleFormatBytes(format);
+    unsigned char* output = static_cast<unsigned char*>(outputBuffer);
+    const unsigned char* input = static_cast<const unsigned char*>(inputBuffer);
+
+    // The float buffers hold the opened buffer size; a longer callback is rendered in pieces
+    for (unsigned int offset = 0; offset < frames; offset += m_bufferFrames)
+    {
+        const unsigned int count = std::min(m_bufferFrames, frames - offset);
+        const float* liveInput = nullptr;
+        if (m_inputChannels > 0U && input != nullptr)
+        {
+            SampleConverter::toFloat(input + static_cast<std::size_t>(offset) * m_inputChannels * sampleBytes, format,
+                                     m_inputBuffer.data(), static_cast<std::size_t>(count) * m_inputChannels);
+            liveInput = m_inputBuffer.data();
+        }
+
+        itsAudioSystem->renderBlock(liveInput, m_inputChannels, m_renderBuffer.data(), count);
+
+        TRACE_ZONE("outputConvert");
+        m_converter->fromFloat(m_renderBuffer.data(), output + 2U * static_cast<std::size_t>(offset) * sampleBytes, count);
+    }
+}
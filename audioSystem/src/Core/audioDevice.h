@@ -4,6 +4,8 @@
 #include <vector>
 #include <memory>
 #include "audioSystem.h"
+#include "FlightRecorder.h"
+#include "Dsp/SampleConverter.h"
 #include "Effects/IEffect.h"
 #include "RtAudio.h"
 
@@ -20,13 +22,39 @@ class AudioDevice
 
 public:
 
+    /**
+     * @struct OutputFormat
+     * @brief Sample format requested for the stream
+     *
+     * The engine renders float. When the stream runs in an integer format
+     * the device converts with SampleConverter instead of leaving it to the
+     * driver. Input, when open, is delivered in the same format and
+     * converted back to float.
+     */
+    struct OutputFormat
+    {
+        SampleFormat format;        ///< Preferred format
+        bool native;                ///< Use the device's best native format when it lacks the preferred one
+        bool dither;                ///< TPDF dither for 16- and 24-bit output
+        bool noiseShaping;          ///< Shape the dither noise toward Nyquist
+
+        OutputFormat() : format(SampleFormat::Float32), native(true), dither(true), noiseShaping(false) {}
+    };
+
     /**
      * @brief Constructor for AudioDevice
      * @param audioSystem Pointer to the AudioSystem that will process audio data
      * @param sampleRate The sample rate to use for audio processing (e.g., 44100, 48000)
      * @param bufferFrames The number of frames per audio buffer
+     * @param fullDuplex Also open the default input device so live input reaches the AudioSystem
+     * @param outputFormat Sample format to open the stream with
+     *
+     * Input and output share one stream, so live input is processed at the same
+     * buffer size as the synth. If the input side cannot be opened the device
+     * falls back to output only.
      */
-    AudioDevice                 (AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames);
+    AudioDevice                 (AudioSystem* audioSystem, float sampleRate, unsigned int bufferFrames,
+                                 bool fullDuplex = false, const OutputFormat& outputFormat = OutputFormat());
 
     /**
      * @brief Destructor - ensures proper cleanup of audio resources
@@ -48,6 +76,34 @@ public:
      */
     void stop                   ();
 
+    /**
+     * @brief Whether the stream was opened with an input side
+     */
+    bool isFullDuplex           () const { return m_inputChannels > 0U; }
+
+    /**
+     * @brief Number of interleaved input channels delivered per frame (0 when output only)
+     */
+    unsigned int inputChannels  () const { return m_inputChannels; }
+
+    /**
+     * @brief Frames per callback, as opened (the device may not grant the size requested)
+     */
+    unsigned int bufferFrames   () const { return m_bufferFrames; }
+
+    /**
+     * @brief Sample format the stream was opened with
+     */
+    SampleFormat sampleFormat   () const { return m_converter->format(); }
+
+    /**
+     * @brief Record of the latest callbacks, filled while the stream runs
+     *
+     * Attach a FlightRecorderDumper to write it out when a callback
+     * underflows or misses its deadline.
+     */
+    const FlightRecorder& flightRecorder () const { return *m_flightRecorder; }
+
 private:
 
     /**
@@ -95,4 +151,46 @@ private:
      * and risk of audio dropouts.
      */
     unsigned int        m_bufferFrames;
+
+    /**
+     * @brief Interleaved input channels per frame (0 for an output-only stream)
+     */
+    unsigned int        m_inputChannels;
+
+    /**
+     * @brief Per-callback history, sized once the stream is open (written by the audio thread only)
+     */
+    std::unique_ptr<FlightRecorder> m_flightRecorder;
+
+    /**
+     * @brief Format asked for at construction
+     */
+    OutputFormat        m_outputFormat;
+
+    /**
+     * @brief Converts rendered float to the stream format (audio thread only once open)
+     */
+    std::unique_ptr<SampleConverter> m_converter;
+
+    /**
+     * @brief Float render and input buffers for integer streams, one buffer of frames each
+     */
+    std::vector<float>  m_renderBuffer;
+    std::vector<float>  m_inputBuffer;
+
+    /**
+     * @brief Pick the stream format from the request and the formats the device takes natively
+     */
+    SampleFormat chooseFormat   (unsigned int deviceId) const;
+
+    /**
+     * @brief Render into the float buffers and convert to and from an integer stream format
+     */
+    void renderConverted        (void* outputBuffer, const void* inputBuffer, unsigned int frames);
+
+    /**
+     * @brief Open the stream, optionally with an input side
+     * @return true if the stream was opened
+     */
+    bool openStream             (bool withInput, RtAudio::StreamOptions& options);
 };
@@ -1,9 +1,11 @@
 #include <cmath>
 #include <algorithm> // For std::find and std::transform
 #include <cctype>    // For std::tolower
+#include <iostream>
 #include <iterator>
 #include <limits>
 #include <random>
+#include <cstring>
 #include "audioSystem.h"
 #include "StereoSampleRingBuffer.h"
 #include "Waves/SquareWave.h" // Include the square wave implementation
@@ -13,7 +15,15 @@
 #include "Effects/OctaveEffect.h"
 #include "Effects/DelayEffect.h"
 #include "Effects/LowPassEffect.h"
+#include "Effects/SpectralFreezeEffect.h"
+#include "Effects/SpectralSmearEffect.h"
+#include "Effects/TimeStretchEffect.h"
+#include "Effects/VocoderEffect.h"
 #include "Effects/EffectParameters.h"
+#include "Granular/GranularSource.h"
+#include "Dsp/FFT.h"
+#include "Common/notes.h"
+#include "Trace.h"
 
 namespace {
     /**
@@ -26,17 +36,73 @@ namespace {
         return result;
     }
 
+    /**
+     * @brief Check an effect against the (lowercase) names configure() accepts
+     */
+    bool effectMatchesName(const IEffect* effect, const std::string& nameLower) {
+        if (nameLower == "octave") {
+            return dynamic_cast<const OctaveEffect*>(effect) != nullptr;
+        } else if (nameLower == "delay" || nameLower == "echo") {
+            return dynamic_cast<const DelayEffect*>(effect) != nullptr;
+        } else if (nameLower == "lowpass" || nameLower == "lpf" || nameLower == "filter") {
+            return dynamic_cast<const LowPassEffect*>(effect) != nullptr;
+        } else if (nameLower == "freeze" || nameLower == "spectralfreeze") {
+            return dynamic_cast<const SpectralFreezeEffect*>(effect) != nullptr;
+        } else if (nameLower == "smear" || nameLower == "spectralsmear") {
+            return dynamic_cast<const SpectralSmearEffect*>(effect) != nullptr;
+        } else if (nameLower == "timestretch" || nameLower == "stretch") {
+            return dynamic_cast<const TimeStretchEffect*>(effect) != nullptr;
+        } else if (nameLower == "vocoder") {
+            return dynamic_cast<const VocoderEffect*>(effect) != nullptr;
+        }
+        return false;
+    }
+
+    constexpr double kCostAverageSeconds = 0.5;     ///< Time constant of the per-stage average cost
+    constexpr double kCostPeakSeconds = 2.0;        ///< Decay time constant of the per-stage peak cost
+    constexpr std::size_t kMinGrainLimit = 8;       ///< Fewest grains the load governor cuts the cloud to
+
+    /**
+     * @brief Copy a stage's meter into its telemetry entry
+     */
+    void publishCost(StageCost& cost, const char* name, const CpuMeter& meter) {
+        std::strncpy(cost.name, name, StageCost::kNameLength - 1U);
+        cost.name[StageCost::kNameLength - 1U] = '\0';
+        cost.last = meter.last();
+        cost.average = meter.average();
+        cost.peak = meter.peak();
+    }
+
+    thread_local bool t_midiInput = false;      ///< Inside a MidiInputScope on this thread
+
     inline std::mt19937& randomEngine() {
-        static std::mt19937 engine{std::random_device{}()};
+        // One engine per control thread; notes may be triggered from several at once
+        thread_local std::mt19937 engine{std::random_device{}()};
         return engine;
     }
 }
 
+static_assert(EngineTelemetry::kMaxEffects == AudioSystem::kMaxEffects, "Telemetry has a cost entry per chain slot");
+static_assert(MemoryTelemetry::kMaxEffects == AudioSystem::kMaxEffects, "Telemetry has a memory entry per chain slot");
+static_assert(GovernorTelemetry::kActions == LoadGovernor::kActions, "Telemetry counts every governor action");
+
+constexpr std::size_t AudioSystem::kMaxEffects;
+constexpr unsigned int AudioSystem::kQuantumFrames;
+constexpr int AudioSystem::kMidiNotes;
+constexpr int AudioSystem::kMidiChannels;
+constexpr std::size_t AudioSystem::kCommandCapacity;
+
 AudioSystem::AudioSystem(float sampleRate) : m_frequency(0.0f),
                                              m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f),
                                              m_primaryPhase(0.0f),
                                              m_secondaryPhase(0.0f),
                                              m_noteOn(false),
+                                             m_heldNotes(static_cast<std::size_t>(kMidiChannels * kMidiNotes)),
+                                             m_heldHead(-1),
+                                             m_heldTail(-1),
+                                             m_heldCount(0),
+                                             m_noteVelocity(1.0f),
+                                             m_tuning(std::make_shared<const TuningTable>(MIDI_NOTE_FREQUENCIES)),
                                              m_lfoPhase(0.0f),
                                              m_lfoRateHz(0.35f),
                                              m_lfoAmountCents(4.0f),
@@ -49,7 +115,30 @@ AudioSystem::AudioSystem(float sampleRate) : m_frequency(0.0f),
                                              m_secondaryOctaveOffset(0),
                                              m_pitchBendCents(0.0f),
                                              m_lowPassActive(false),
-                                             m_lastLowPassCutoff(0.0f)
+                                             m_lastLowPassCutoff(0.0f),
+                                             m_liveInputMode(LiveInputMode::Off),
+                                             m_requestedLiveInputMode(LiveInputMode::Off),
+                                             m_liveInputGain(1.0f),
+                                             m_parameterBlock(nullptr),
+                                             m_parameterGliding(0U),
+                                             m_compressor(m_sampleRate),
+                                             m_limiter(m_sampleRate),
+                                             m_commands(new ControlCommandQueue()),
+                                             m_retired(new RetiredQueue()),
+                                             m_chainMutex(new std::mutex()),
+                                             m_clock(new AudioClock(m_sampleRate)),
+                                             m_renderedFrames(0U),
+                                             m_deliveredFrames(0U),
+                                             m_telemetry(new TripleBuffer<EngineTelemetry>()),
+                                             m_telemetryMutex(new std::mutex()),
+                                             m_quantumOutputFill(0U),
+                                             m_quantumInputFill(0U),
+                                             m_quantumInputChannels(0U),
+                                             m_inputDelayFrames(0U),
+                                             m_meterAverageDecay(0.0f),
+                                             m_meterPeakDecay(0.0f),
+                                             m_shedSequence(0U),
+                                             m_memoryLimit(new MemoryLimit())
 {
     // Validate sample rate
     if (sampleRate <= 0.0f) {
@@ -63,42 +152,75 @@ AudioSystem::AudioSystem(float sampleRate) : m_frequency(0.0f),
     
     // Initialize ADSR envelope with default values
     m_envelope = std::make_unique<ADSREnvelope>(0.1f, 0.2f, 0.7f, 0.3f);
+
+    // The audio thread only ever appends within this capacity
+    m_effects.reserve(kMaxEffects);
+    m_chain.reserve(kMaxEffects);
+    m_liveModulated.reserve(kMaxEffects);
+    m_lowPassFilters.reserve(kMaxEffects);
+    m_scheduled.reserve(kCommandCapacity);
+    m_deferredLoads.reserve(kMaxEffects);
+    m_chunkLeft.assign(kQuantumFrames, 0.0f);
+    m_chunkRight.assign(kQuantumFrames, 0.0f);
+    m_chunkLive.assign(kQuantumFrames, 0.0f);
+    m_quantumOutput.assign(2U * kQuantumFrames, 0.0f);
+    m_quantumInput.assign(2U * kQuantumFrames, 0.0f);
+
+    // Every quantum lasts as long, so the meter weights are fixed
+    const double quantumSeconds = static_cast<double>(kQuantumFrames) / static_cast<double>(m_sampleRate);
+    m_meterAverageDecay = static_cast<float>(std::exp(-quantumSeconds / kCostAverageSeconds));
+    m_meterPeakDecay = static_cast<float>(std::exp(-quantumSeconds / kCostPeakSeconds));
 }
 
 void AudioSystem::setWaveform(std::shared_ptr<IWave> waveform)
 {
     if (waveform) {
-        m_primaryWaveform = waveform;
-        m_secondaryWaveform = waveform;
+        ControlCommand command;
+        command.type = ControlCommand::Type::Waveform;
+        command.waveform = waveform;
+        command.secondaryWaveform = std::move(waveform);
+        if (!postCommand(std::move(command))) {
+            std::cerr << "Warning: too many pending control changes, waveform not changed" << std::endl;
+        }
     }
 }
 
 // Configure the oscillator and effects based on the provided AudioConfig
 void AudioSystem::configure(const AudioConfig& config)
+{
+    // Master bus; the lookahead is fixed here since resizing it allocates
+    m_limiter.configure(m_sampleRate, config.limiterLookahead);
+
+    // Before the preset, so its effects count against the budget
+    setMemoryBudget(static_cast<std::size_t>(std::max(config.memoryBudgetMB, 0.0f) * 1024.0f * 1024.0f));
+
+    applyPreset(config);
+}
+
+void AudioSystem::applyPreset(const AudioConfig& config)
 {
     // Select waveform (case-insensitive)
     std::string waveformLower = toLowercase(config.waveform);
-    
+    std::shared_ptr<IWave> waveform;
+
     if (waveformLower == "sine") {
-        m_primaryWaveform = std::make_shared<SineWave>();
+        waveform = std::make_shared<SineWave>();
     } else if (waveformLower == "sawtooth" || waveformLower == "saw") {
-        m_primaryWaveform = std::make_shared<SawtoothWave>();
+        waveform = std::make_shared<SawtoothWave>();
     } else if (waveformLower == "triangle" || waveformLower == "tri") {
-        m_primaryWaveform = std::make_shared<TriangleWave>();
+        waveform = std::make_shared<TriangleWave>();
     } else if (waveformLower == "square" || waveformLower.empty()) {
         // Default to square wave for empty or unrecognized waveforms
-        m_primaryWaveform = std::make_shared<SquareWave>();
+        waveform = std::make_shared<SquareWave>();
     } else {
         // Fallback to square wave for unrecognized waveforms
-        m_primaryWaveform = std::make_shared<SquareWave>();
+        waveform = std::make_shared<SquareWave>();
     }
 
-    m_secondaryWaveform = m_primaryWaveform;
+    setWaveform(std::move(waveform));
 
-    // Clear existing effects
-    m_effects.clear();
-    m_lowPassActive = false;
-    m_lastLowPassCutoff = 0.0f;
+    // Replace existing effects; the chain changes are applied by the next rendered block
+    clearEffects();
 
     // Instantiate effects listed in the configuration (case-insensitive)
     for (const auto& name : config.effects)
@@ -106,29 +228,68 @@ void AudioSystem::configure(const AudioConfig& config)
         std::string effectLower = toLowercase(name);
         
         if (effectLower == "octave") {
-            auto eff = std::make_shared<OctaveEffect>();
-            m_effects.push_back(eff);
+            addEffect(std::make_shared<OctaveEffect>());
         } else if (effectLower == "delay" || effectLower == "echo") {
-            auto eff = std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, m_sampleRate);
-            m_effects.push_back(eff);
+            addEffect(std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, m_sampleRate));
         } else if (effectLower == "lowpass" || effectLower == "lpf" || effectLower == "filter") {
-            auto eff = std::make_shared<LowPassEffect>(1000.0f, m_sampleRate);
-            m_effects.push_back(eff);
-            m_lowPassActive = true;
-            m_lastLowPassCutoff = eff->getCutoff();
+            addEffect(std::make_shared<LowPassEffect>(1000.0f, m_sampleRate));
+        } else if (effectLower == "freeze" || effectLower == "spectralfreeze") {
+            addEffect(std::make_shared<SpectralFreezeEffect>(1.0f, m_sampleRate));
+        } else if (effectLower == "smear" || effectLower == "spectralsmear") {
+            addEffect(std::make_shared<SpectralSmearEffect>(0.5f, 1.0f, m_sampleRate));
+        } else if (effectLower == "vocoder") {
+            addEffect(std::make_shared<VocoderEffect>(24, 1.0f, m_sampleRate));
         }
         // Silently ignore unrecognized effect names
     }
+
+    setLiveInputMode(liveInputModeFromString(config.liveInput), config.liveInputGain);
+
+    configureLimiter(config.limiterEnabled, config.limiterCeiling, config.limiterRelease * 1000.0f);
+    configureGovernor(governorSettingsFromConfig(config));
+    configureCompressor(config.compressorEnabled, config.compressorThreshold, config.compressorRatio,
+                        config.compressorAttack * 1000.0f, config.compressorRelease * 1000.0f,
+                        config.compressorMakeup);
     
     // Update ADSR envelope parameters
-    if (m_envelope) {
-        m_envelope = std::make_unique<ADSREnvelope>(
-            config.attackTime,
-            config.decayTime,
-            config.sustainLevel,
-            config.releaseTime
-        );
+    updateADSRParameters(config.attackTime, config.decayTime, config.sustainLevel, config.releaseTime);
+}
+
+void AudioSystem::noteOn(int note, float velocity, int channel)
+{
+    noteOnAt(0U, note, velocity, channel);
+}
+
+void AudioSystem::noteOff(int note, int channel)
+{
+    noteOffAt(0U, note, channel);
+}
+
+void AudioSystem::noteOnAt(std::uint64_t frame, int note, float velocity, int channel)
+{
+    if (note < 0 || note >= kMidiNotes || channel < 0 || channel >= kMidiChannels) {
+        return;
+    }
+    if (velocity <= 0.0f) {
+        noteOffAt(frame, note, channel);
+        return;
+    }
+
+    const std::shared_ptr<const TuningTable> tuning = std::atomic_load(&m_tuning);
+    postNoteOn(frame, channel * kMidiNotes + note, (*tuning)[static_cast<std::size_t>(note)], std::min(velocity, 1.0f));
+}
+
+void AudioSystem::noteOffAt(std::uint64_t frame, int note, int channel)
+{
+    if (note < 0 || note >= kMidiNotes || channel < 0 || channel >= kMidiChannels) {
+        return;
     }
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::NoteOff;
+    command.key = channel * kMidiNotes + note;
+    command.frame = frame;
+    postCommand(std::move(command));
 }
 
 void AudioSystem::triggerNote(float newFrequency)
@@ -137,32 +298,119 @@ void AudioSystem::triggerNote(float newFrequency)
     if (newFrequency <= 0.0f || newFrequency > 20000.0f) {
         return; // Ignore invalid frequencies
     }
-    
-    bool hadActiveNotes = !m_activeNotes.empty();
 
-    const float detune = std::uniform_real_distribution<float>(-m_noteJitterAmountCents, m_noteJitterAmountCents)(randomEngine());
+    postNoteOn(0U, nearestMidiNote(newFrequency), newFrequency, 1.0f);
+}
+
+void AudioSystem::triggerNoteOff(float frequency) 
+{
+    if (std::isnan(frequency))
+    {
+        ControlCommand command;
+        command.type = ControlCommand::Type::AllNotesOff;
+        postCommand(std::move(command));
+    }
+    else if (frequency > 0.0f)
+    {
+        noteOff(nearestMidiNote(frequency));
+    }
+}
+
+int AudioSystem::nearestMidiNote(float frequency)
+{
+    const float note = 69.0f + 12.0f * std::log2(frequency / 440.0f);
+    return static_cast<int>(std::min(127.0f, std::max(0.0f, std::round(note))));
+}
+
+void AudioSystem::setTuningTable(const std::array<float, kMidiNotes>& frequencies)
+{
+    auto tuning = std::make_shared<TuningTable>(MIDI_NOTE_FREQUENCIES);
+    for (std::size_t i = 0; i < tuning->size(); ++i)
+    {
+        if (frequencies[i] > 0.0f && frequencies[i] <= 20000.0f) {
+            (*tuning)[i] = frequencies[i];
+        }
+    }
+    std::atomic_store(&m_tuning, std::shared_ptr<const TuningTable>(std::move(tuning)));
+}
+
+void AudioSystem::resetTuning()
+{
+    std::atomic_store(&m_tuning, std::make_shared<const TuningTable>(MIDI_NOTE_FREQUENCIES));
+}
+
+float AudioSystem::noteFrequency(int note) const
+{
+    if (note < 0 || note >= kMidiNotes) {
+        return 0.0f;
+    }
+    return (*std::atomic_load(&m_tuning))[static_cast<std::size_t>(note)];
+}
+
+void AudioSystem::postNoteOn(std::uint64_t frame, int key, float frequency, float velocity)
+{
+    // Random values are drawn here so the audio thread never touches the generator
+    ControlCommand command;
+    command.type = ControlCommand::Type::NoteOn;
+    command.key = key;
+    command.frame = frame;
+    command.values[0] = frequency;
+    float jitterCents = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(*m_chainMutex);
+        jitterCents = m_noteJitterAmountCents;
+    }
+    command.values[1] = std::uniform_real_distribution<float>(-jitterCents, jitterCents)(randomEngine());
+    command.values[2] = std::uniform_real_distribution<float>(0.0f, 1.0f)(randomEngine());
+    command.values[3] = velocity;
+    postCommand(std::move(command));
+}
+
+void AudioSystem::applyNoteOn(int key, float frequency, float detuneCents, float lfoPhase, float velocity)
+{
+    const bool hadActiveNotes = m_heldTail >= 0;
+
+    // A retriggered key moves to the end of the list as the newest note
+    unlinkHeldNote(key);
+    HeldNote& entry = m_heldNotes[static_cast<std::size_t>(key)];
+    entry.frequency = frequency;
+    entry.detuneCents = detuneCents;
+    entry.held = true;
+    entry.prev = m_heldTail;
+    entry.next = -1;
+    if (m_heldTail >= 0) {
+        m_heldNotes[static_cast<std::size_t>(m_heldTail)].next = key;
+    } else {
+        m_heldHead = key;
+    }
+    m_heldTail = key;
+    ++m_heldCount;
 
-    m_activeNotes.push_back({newFrequency, detune});
-    m_frequency = newFrequency;
-    m_noteDetuneCents = detune;
+    m_frequency = frequency;
+    m_noteDetuneCents = detuneCents;
     m_noteOn = true;
 
     if (!hadActiveNotes)
     {
         m_primaryPhase = 0.0f;
         m_secondaryPhase = 0.0f;
-        m_lfoPhase = std::uniform_real_distribution<float>(0.0f, 1.0f)(randomEngine());
+        m_lfoPhase = lfoPhase;
+        m_noteVelocity = velocity;
         if (m_envelope) {
             m_envelope->reset();
         }
+        if (m_granularSource) {
+            m_granularSource->reset();
+        }
     }
 
     // Configure any effects that need the note frequency or sample rate
-    for (auto& effect : m_effects)
+    for (const auto& slot : m_effects)
     {
+        const auto& effect = slot->effect();
         if (auto octave = std::dynamic_pointer_cast<OctaveEffect>(effect))
         {
-            octave->setFrequency(newFrequency);
+            octave->setFrequency(frequency);
             octave->setSampleRate(m_sampleRate);
         }
         else if (auto delay = std::dynamic_pointer_cast<DelayEffect>(effect))
@@ -173,46 +421,81 @@ void AudioSystem::triggerNote(float newFrequency)
         {
             lp->setSampleRate(m_sampleRate);
         }
+        else if (auto vocoder = std::dynamic_pointer_cast<VocoderEffect>(effect))
+        {
+            vocoder->setSampleRate(m_sampleRate);
+        }
     }
     
     // Don't reset effects here - we want to maintain state across notes
     // (e.g., delay buffer should keep echoing from previous notes)
 }
 
-void AudioSystem::triggerNoteOff(float frequency) 
+void AudioSystem::applyNoteOff(int key)
 {
-    if (std::isnan(frequency))
-    {
-        m_activeNotes.clear();
-        m_noteOn = false;
-        return;
-    }
-
-    auto isMatch = [frequency](const ActiveNote& active)
-    {
-        return std::fabs(active.frequency - frequency) < 1e-3f;
-    };
+    unlinkHeldNote(key);
 
-    auto revIt = std::find_if(m_activeNotes.rbegin(), m_activeNotes.rend(), isMatch);
-    if (revIt != m_activeNotes.rend())
-    {
-        m_activeNotes.erase(std::next(revIt).base());
-    }
-
-    if (m_activeNotes.empty())
+    if (m_heldTail < 0)
     {
         m_noteOn = false;
     }
     else
     {
-        const auto& active = m_activeNotes.back();
+        const HeldNote& active = m_heldNotes[static_cast<std::size_t>(m_heldTail)];
         m_frequency = active.frequency;
         m_noteDetuneCents = active.detuneCents;
         m_noteOn = true;
     }
 }
 
+void AudioSystem::applyAllNotesOff()
+{
+    while (m_heldHead >= 0) {
+        unlinkHeldNote(m_heldHead);
+    }
+    m_noteOn = false;
+
+    // A panic also cancels notes scheduled for later
+    m_scheduled.erase(std::remove_if(m_scheduled.begin(), m_scheduled.end(),
+                                     [](const ControlCommand& command)
+                                     {
+                                         return command.type == ControlCommand::Type::NoteOn ||
+                                                command.type == ControlCommand::Type::NoteOff;
+                                     }),
+                      m_scheduled.end());
+}
+
+void AudioSystem::unlinkHeldNote(int key)
+{
+    HeldNote& entry = m_heldNotes[static_cast<std::size_t>(key)];
+    if (!entry.held) {
+        return;
+    }
+
+    if (entry.prev >= 0) {
+        m_heldNotes[static_cast<std::size_t>(entry.prev)].next = entry.next;
+    } else {
+        m_heldHead = entry.next;
+    }
+    if (entry.next >= 0) {
+        m_heldNotes[static_cast<std::size_t>(entry.next)].prev = entry.prev;
+    } else {
+        m_heldTail = entry.prev;
+    }
+    entry.prev = -1;
+    entry.next = -1;
+    entry.held = false;
+    --m_heldCount;
+}
+
 std::pair<float, float> AudioSystem::getNextSample() 
+{
+    float frame[2];
+    renderBlock(nullptr, 0U, frame, 1U);
+    return {frame[0], frame[1]};
+}
+
+std::pair<float, float> AudioSystem::renderVoice()
 {
     if (!m_primaryWaveform)
     {
@@ -222,10 +505,11 @@ std::pair<float, float> AudioSystem::getNextSample()
     // Get envelope amplitude (this handles all ADSR phases including release)
     float envelopeLevel = 0.0f;
     if (m_envelope) {
-        envelopeLevel = m_envelope->process(m_noteOn, m_sampleRate);
+        envelopeLevel = m_envelope->process(m_noteOn, m_sampleRate) * m_noteVelocity;
     }
     
-    float sample = 0.0f;
+    // Create a stereo sample (oscillator output is identical in both channels)
+    std::pair<float, float> stereoSample{0.0f, 0.0f};
 
     if (envelopeLevel > 0.0f)
     {
@@ -246,213 +530,1421 @@ std::pair<float, float> AudioSystem::getNextSample()
             }
         }
 
-        float primarySample = m_primaryWaveform->generate(modulatedFrequency, m_sampleRate, m_primaryPhase);
-
-        float secondarySample = 0.0f;
-        if (m_secondaryEnabled && m_secondaryMix > 0.0f && m_secondaryWaveform)
+        if (m_granularSource)
         {
-            const float detuneRatio = std::pow(2.0f, std::max(m_secondaryDetuneCents, 0.0f) / 1200.0f);
-            const float octaveRatio = std::pow(2.0f, static_cast<float>(m_secondaryOctaveOffset));
-            const float secondaryFrequency = modulatedFrequency * detuneRatio * octaveRatio;
-            secondarySample = m_secondaryWaveform->generate(secondaryFrequency, m_sampleRate, m_secondaryPhase);
+            const std::pair<float, float> grains = m_granularSource->process(modulatedFrequency);
+            stereoSample = {grains.first * envelopeLevel, grains.second * envelopeLevel};
         }
+        else
+        {
+            float primarySample = m_primaryWaveform->generate(modulatedFrequency, m_sampleRate, m_primaryPhase);
 
-    const float dryAmount = std::max(0.0f, 1.0f - m_secondaryMix);
-        sample = (primarySample * dryAmount) + (secondarySample * m_secondaryMix);
-        sample *= envelopeLevel;
-    }
-
-    // Create a stereo sample (initially identical in both channels)
-    std::pair<float, float> stereoSample{sample, sample};
+            // The load governor can drop the secondary layer; the primary then plays alone
+            const bool unisonShed = m_shedDepth[static_cast<std::size_t>(LoadGovernor::Action::DropUnison)] > 0U;
+            const float secondaryMix = unisonShed ? 0.0f : m_secondaryMix;
 
-    // Apply effects to the stereo sample
-    stereoSample = applyEffects(stereoSample);
+            float secondarySample = 0.0f;
+            if (m_secondaryEnabled && secondaryMix > 0.0f && m_secondaryWaveform)
+            {
+                const float detuneRatio = std::pow(2.0f, std::max(m_secondaryDetuneCents, 0.0f) / 1200.0f);
+                const float octaveRatio = std::pow(2.0f, static_cast<float>(m_secondaryOctaveOffset));
+                const float secondaryFrequency = modulatedFrequency * detuneRatio * octaveRatio;
+                secondarySample = m_secondaryWaveform->generate(secondaryFrequency, m_sampleRate, m_secondaryPhase);
+            }
 
-    if (m_waveformTap) {
-        m_waveformTap->push(stereoSample.first, stereoSample.second);
+            const float dryAmount = std::max(0.0f, 1.0f - secondaryMix);
+            float sample = (primarySample * dryAmount) + (secondarySample * secondaryMix);
+            sample *= envelopeLevel;
+            stereoSample = {sample, sample};
+        }
     }
 
     return stereoSample;
 }
 
-std::pair<float, float> AudioSystem::applyEffects(std::pair<float, float> stereoSample) 
+void AudioSystem::processMasterBus(float* output, unsigned int frames)
 {
-    // Apply each effect in the chain to the stereo sample
-    for (const auto& effect : m_effects) 
-    {
-        if (effect) { // Null check for safety
-            stereoSample = effect->process(stereoSample);
+    m_compressor.process(output, frames);
+    m_limiter.process(output, frames);
+
+    if (m_waveformTap) {
+        for (unsigned int i = 0; i < frames; ++i)
+        {
+            m_waveformTap->push(output[2 * i], output[2 * i + 1]);
         }
     }
-
-    return stereoSample;
 }
 
-void AudioSystem::addEffect(std::shared_ptr<IEffect> effect) 
+void AudioSystem::renderBlock(const float* input, unsigned int inputChannels, float* output, unsigned int frames)
 {
-    if (!effect) {
-        return; // Don't add null effects
+    TRACE_ZONE("renderBlock");
+    const std::uint64_t blockStart = m_deliveredFrames;
+    const std::uint64_t renderStart = m_renderedFrames;
+    const std::int64_t startNanos = AudioClock::hostTimeNanos();
+    m_clock->publish(blockStart, startNanos);
+    m_blockStats.commands = 0U;
+    m_blockStats.midiEvents = 0U;
+
+    // Gathered whatever the mode, since a queued mode change may switch input on
+    // within this block; renderQuantum() drops it while the mode is Off
+    const bool hasInput = input != nullptr && inputChannels > 0U;
+    const unsigned int channels = hasInput ? std::min(inputChannels, 2U) : 0U;
+    if (channels != m_quantumInputChannels)
+    {
+        // Input appeared, went away or changed shape: start gathering afresh
+        m_quantumInputChannels = channels;
+        m_quantumInputFill = 0U;
+        m_inputDelayFrames = 0U;
     }
-    
-    // Check if the effect already exists in the vector
-    auto it = std::find(m_effects.begin(), m_effects.end(), effect);
-    
-    if (it == m_effects.end()) 
+
+    unsigned int played = 0U;
+    unsigned int consumed = 0U;
+    while (played < frames)
     {
-        // Effect not found, so add it to the vector
-        m_effects.push_back(effect);
-        if (auto lowPass = std::dynamic_pointer_cast<LowPassEffect>(effect))
+        // The rest of the quantum a previous block could not take comes first
+        if (m_quantumOutputFill > 0U)
         {
-            m_lowPassActive = true;
-            m_lastLowPassCutoff = lowPass->getCutoff();
+            const unsigned int count = std::min(m_quantumOutputFill, frames - played);
+            const float* kept = m_quantumOutput.data() + 2U * static_cast<std::size_t>(kQuantumFrames - m_quantumOutputFill);
+            std::copy(kept, kept + 2U * count, output + 2U * static_cast<std::size_t>(played));
+            m_quantumOutputFill -= count;
+            played += count;
+            continue;
+        }
+
+        const float* quantumInput = nullptr;
+        if (hasInput)
+        {
+            consumed += gatherInput(input + static_cast<std::size_t>(consumed) * inputChannels, inputChannels,
+                                    frames - consumed);
+            if (m_quantumInputFill < kQuantumFrames)
+            {
+                // The block's input ran out first: hold live input back by the missing frames from now on
+                const unsigned int missing = kQuantumFrames - m_quantumInputFill;
+                float* gathered = m_quantumInput.data();
+                std::copy_backward(gathered, gathered + static_cast<std::size_t>(m_quantumInputFill) * channels,
+                                   gathered + static_cast<std::size_t>(kQuantumFrames) * channels);
+                std::fill(gathered, gathered + static_cast<std::size_t>(missing) * channels, 0.0f);
+                m_inputDelayFrames += missing;
+            }
+            quantumInput = m_quantumInput.data();
+            m_quantumInputFill = 0U;
         }
-    } 
-}
 
+        // Whole quanta go straight to the device buffer; a partial one is kept for the next block
+        if (frames - played >= kQuantumFrames)
+        {
+            renderQuantum(quantumInput, channels, output + 2U * static_cast<std::size_t>(played));
+            played += kQuantumFrames;
+        }
+        else
+        {
+            renderQuantum(quantumInput, channels, m_quantumOutput.data());
+            m_quantumOutputFill = kQuantumFrames;
+        }
+    }
 
-void AudioSystem::resetEffects() 
-{
-    // Reset internal state of all effects (clear buffers, reset phase, etc.)
-    for (const auto& effect : m_effects) 
+    if (hasInput && consumed < frames)
     {
-        if (effect) { // Null check for safety
-            effect->reset();
-        }
+        gatherInput(input + static_cast<std::size_t>(consumed) * inputChannels, inputChannels, frames - consumed);
     }
-}
 
-void AudioSystem::clearEffects()
-{
-    // First reset all effects
-    resetEffects();
-    
-    // Then clear the effects vector completely
-    m_effects.clear();
-    m_lowPassActive = false;
-    m_lastLowPassCutoff = 0.0f;
+    m_deliveredFrames = blockStart + frames;
+    // The governor judges the audio actually rendered: a short block may render a whole quantum, or none
+    governLoad(static_cast<unsigned int>(m_renderedFrames - renderStart), startNanos);
+    publishTelemetry(output, frames, blockStart, startNanos);
 }
 
-bool AudioSystem::updateEffectParameters(const std::string& effectName, const IEffectParameters& parameters)
+unsigned int AudioSystem::gatherInput(const float* input, unsigned int inputChannels, unsigned int frames)
 {
-    std::string effectLower = toLowercase(effectName);
-    
-    for (auto& effect : m_effects)
+    const unsigned int count = std::min(frames, kQuantumFrames - m_quantumInputFill);
+    float* gathered = m_quantumInput.data() + static_cast<std::size_t>(m_quantumInputFill) * m_quantumInputChannels;
+    for (unsigned int i = 0; i < count; ++i)
     {
-        if (effectLower == "delay" || effectLower == "echo") {
-            if (auto delayEffect = std::dynamic_pointer_cast<DelayEffect>(effect)) {
-                if (auto delayParams = dynamic_cast<const DelayParameters*>(&parameters)) {
-                    delayEffect->setDelayTime(delayParams->delayTime);
-                    delayEffect->setFeedback(delayParams->feedback);
-                    delayEffect->setMix(delayParams->mix);
-                    return true;
-                }
-            }
-        }
-        else if (effectLower == "lowpass" || effectLower == "lpf" || effectLower == "filter") {
-            if (auto lowPassEffect = std::dynamic_pointer_cast<LowPassEffect>(effect)) {
-                if (auto lowPassParams = dynamic_cast<const LowPassParameters*>(&parameters)) {
-                    lowPassEffect->setCutoff(lowPassParams->cutoffFreq);
-                    lowPassEffect->setResonance(lowPassParams->resonance);
-                    m_lowPassActive = true;
-                    m_lastLowPassCutoff = lowPassParams->cutoffFreq;
-                    return true;
-                }
-            }
-        }
-        else if (effectLower == "octave") {
-            if (auto octaveEffect = std::dynamic_pointer_cast<OctaveEffect>(effect)) {
-                if (auto octaveParams = dynamic_cast<const OctaveParameters*>(&parameters)) {
-                    // Convert octave shift to boolean (higher/lower)
-                    bool higher = octaveParams->octaveShift > 1.0f;
-                    octaveEffect->setHigher(higher);
-                    octaveEffect->setBlend(octaveParams->mix);
-                    return true;
-                }
-            }
+        for (unsigned int channel = 0; channel < m_quantumInputChannels; ++channel)
+        {
+            gathered[i * m_quantumInputChannels + channel] = input[static_cast<std::size_t>(i) * inputChannels + channel];
         }
     }
-    
-    return false; // Effect not found or parameters don't match
-}
-
-void AudioSystem::updateADSRParameters(float attackTime, float decayTime, float sustainLevel, float releaseTime)
-{
-    // Create new envelope with updated parameters
-    m_envelope = std::make_unique<ADSREnvelope>(attackTime, decayTime, sustainLevel, releaseTime);
+    m_quantumInputFill += count;
+    return count;
 }
 
-void AudioSystem::setDriftParameters(float rateHz, float amountCents, float jitterCents)
+void AudioSystem::renderQuantum(const float* input, unsigned int inputChannels, float* output)
 {
-    m_lfoRateHz = std::max(rateHz, 0.0f);
-    m_lfoAmountCents = std::max(amountCents, 0.0f);
-    m_noteJitterAmountCents = std::max(jitterCents, 0.0f);
-}
+    {
+        TRACE_ZONE("commands");
+        applyCommands();
+        pollParameterBlock(kQuantumFrames);
+    }
+    if (m_liveInputMode == LiveInputMode::Off)
+    {
+        input = nullptr;    // Switched off by a command just applied
+    }
 
-void AudioSystem::setWaveformTapBuffer(StereoSampleRingBuffer* tap)
-{
-    m_waveformTap = tap;
-}
+    const std::int64_t voiceStart = AudioClock::hostTimeNanos();
+    renderVoiceStage(input, inputChannels, m_renderedFrames);
+    m_voiceMeter.add(AudioClock::hostTimeNanos() - voiceStart);
+    // The voice is mono unless grains are panned or stereo input is mixed in
+    const bool mono = !m_granularSource
+                   && (input == nullptr || inputChannels == 1U || m_liveInputMode == LiveInputMode::Sidechain);
+    renderEffectStage(input != nullptr, mono);
 
-void AudioSystem::setLowPassCutoff(float cutoffHz)
-{
-    bool updated = false;
-    for (const auto& effect : m_effects)
+    for (unsigned int i = 0; i < kQuantumFrames; ++i)
     {
-        if (auto lowPass = std::dynamic_pointer_cast<LowPassEffect>(effect))
-        {
-            lowPass->setCutoff(cutoffHz);
-            updated = true;
-        }
+        output[2 * i] = m_chunkLeft[i];        // Left channel
+        output[2 * i + 1] = m_chunkRight[i];   // Right channel
     }
+    m_renderedFrames += kQuantumFrames;
 
-    if (updated)
     {
-        m_lowPassActive = true;
-        m_lastLowPassCutoff = cutoffHz;
+        TRACE_ZONE("masterBus");
+        const std::int64_t masterStart = AudioClock::hostTimeNanos();
+        processMasterBus(output, kQuantumFrames);
+        m_masterMeter.add(AudioClock::hostTimeNanos() - masterStart);
     }
-    else
+
+    const double quantumNanos = 1.0e9 * static_cast<double>(kQuantumFrames) / static_cast<double>(m_sampleRate);
+    m_voiceMeter.endBlock(quantumNanos, m_meterAverageDecay, m_meterPeakDecay);
+    m_masterMeter.endBlock(quantumNanos, m_meterAverageDecay, m_meterPeakDecay);
+    for (const auto& slot : m_effects)
     {
-        m_lowPassActive = false;
-        m_lastLowPassCutoff = 0.0f;
+        slot->meter().endBlock(quantumNanos, m_meterAverageDecay, m_meterPeakDecay);
     }
 }
 
-float AudioSystem::getLowPassCutoff() const
+void AudioSystem::renderVoiceStage(const float* input, unsigned int inputChannels, std::uint64_t firstFrame)
 {
-    return m_lowPassActive ? m_lastLowPassCutoff : 0.0f;
-}
+    TRACE_ZONE("voice");
 
-bool AudioSystem::hasLowPassEffect() const
-{
-    return m_lowPassActive;
+    for (unsigned int i = 0; i < kQuantumFrames; ++i)
+    {
+        if (!m_scheduled.empty())
+        {
+            applyScheduledCommands(firstFrame + i);
+        }
+
+        std::pair<float, float> voice{0.0f, 0.0f};
+
+        if (input == nullptr)
+        {
+            voice = renderVoice();
+        }
+        else
+        {
+            // Mono inputs feed both channels
+            const float* frame = input + static_cast<std::size_t>(i) * inputChannels;
+            const float inLeft = frame[0];
+            const float inRight = inputChannels > 1U ? frame[1] : frame[0];
+
+            m_chunkLive[i] = 0.5f * (inLeft + inRight);
+            feedLiveInput(m_chunkLive[i]);
+
+            if (m_liveInputMode != LiveInputMode::Through)
+            {
+                voice = renderVoice();
+            }
+            if (m_liveInputMode != LiveInputMode::Sidechain)
+            {
+                voice.first += inLeft * m_liveInputGain;
+                voice.second += inRight * m_liveInputGain;
+            }
+        }
+
+        m_chunkLeft[i] = voice.first;
+        m_chunkRight[i] = voice.second;
+    }
 }
 
-void AudioSystem::configureSecondaryOscillator(bool enabled, float mix, float detuneCents, int octaveOffset)
+void AudioSystem::renderEffectStage(bool liveInput, bool mono)
 {
-    m_secondaryEnabled = enabled;
-    if (!enabled)
+    // Effects are independent per-sample processors in series, so running
+    // each over the whole quantum gives the same output as frame-major order
+    std::size_t index = 0;
+    if (mono)
     {
-        m_secondaryMix = 0.0f;
-        m_secondaryDetuneCents = 0.0f;
-        m_secondaryOctaveOffset = 0;
-        m_secondaryPhase = 0.0f;
-        return;
+        // A mono voice stays in m_chunkLeft until the first effect that can make it
+        // stereo, or whose channels still differ from earlier stereo input
+        for (; index < m_effects.size() && m_effects[index]->canProcessMono(); ++index)
+        {
+            EffectSlot& slot = *m_effects[index];
+            TRACE_ZONE(slot.effect()->name());
+
+            const std::int64_t start = AudioClock::hostTimeNanos();
+            slot.setMono(true);
+            slot.processMonoBlock(m_chunkLeft.data(), kQuantumFrames);
+            slot.meter().add(AudioClock::hostTimeNanos() - start);
+        }
+        std::copy(m_chunkLeft.begin(), m_chunkLeft.end(), m_chunkRight.begin());
     }
 
-    m_secondaryMix = std::max(0.0f, std::min(1.0f, mix));
-    m_secondaryDetuneCents = std::max(detuneCents, 0.0f);
-    m_secondaryOctaveOffset = std::max(-2, std::min(2, octaveOffset));
+    for (; index < m_effects.size(); ++index)
+    {
+        EffectSlot& slot = *m_effects[index];
+        TRACE_ZONE(slot.effect()->name());
+
+        VocoderEffect* vocoder = liveInput ? m_liveModulated[index] : nullptr;
+        if (vocoder != nullptr && vocoder->modulatorSource() != VocoderEffect::ModulatorSource::Live)
+        {
+            vocoder = nullptr;
+        }
+
+        const std::int64_t start = AudioClock::hostTimeNanos();
+        slot.setMono(false);
+        if (vocoder == nullptr)
+        {
+            slot.processBlock(m_chunkLeft.data(), m_chunkRight.data(), kQuantumFrames);
+        }
+        else
+        {
+            // The live modulator has to be fed sample by sample alongside the carrier
+            for (unsigned int i = 0; i < kQuantumFrames; ++i)
+            {
+                vocoder->feedModulator(m_chunkLive[i]);
+                const std::pair<float, float> sample = slot.process({m_chunkLeft[i], m_chunkRight[i]});
+                m_chunkLeft[i] = sample.first;
+                m_chunkRight[i] = sample.second;
+            }
+        }
+        slot.meter().add(AudioClock::hostTimeNanos() - start);
+    }
+}
+
+void AudioSystem::governLoad(unsigned int frames, std::int64_t startNanos)
+{
+    if (frames == 0U)
+    {
+        return;
+    }
+    const double blockSeconds = static_cast<double>(frames) / static_cast<double>(m_sampleRate);
+    const double renderSeconds = static_cast<double>(AudioClock::hostTimeNanos() - startNanos) * 1.0e-9;
+    const float load = blockSeconds > 0.0 ? static_cast<float>(renderSeconds / blockSeconds) : 0.0f;
+
+    switch (m_governor.update(load, blockSeconds))
+    {
+    case LoadGovernor::Decision::Shed:
+        shedWork(m_governor.action(), true);
+        break;
+    case LoadGovernor::Decision::Restore:
+        shedWork(m_governor.action(), false);
+        break;
+    case LoadGovernor::Decision::None:
+        break;
+    }
+}
+
+void AudioSystem::shedWork(LoadGovernor::Action action, bool shed)
+{
+    // An action may appear more than once in the ladder; each step goes one level deeper
+    std::uint32_t& depth = m_shedDepth[static_cast<std::size_t>(action)];
+    if (shed)
+    {
+        ++depth;
+    }
+    else if (depth > 0U)
+    {
+        --depth;
+    }
+
+    switch (action)
+    {
+    case LoadGovernor::Action::StealGrains:
+        if (m_granularSource)
+        {
+            // Each step halves the grains allowed, from what is actually playing
+            const std::size_t current = std::min(m_granularSource->grainLimit(), m_granularSource->activeGrainCount());
+            const std::size_t limit = depth == 0U ? GranularSource::kMaxGrains
+                                    : shed ? std::max<std::size_t>(kMinGrainLimit, current / 2U)
+                                    : 2U * m_granularSource->grainLimit();
+            m_granularSource->setGrainLimit(limit);
+        }
+        break;
+
+    case LoadGovernor::Action::DropUnison:
+        // renderVoice() reads the depth
+        break;
+
+    case LoadGovernor::Action::TruePeakOff:
+        m_limiter.setTruePeakSuspended(depth > 0U);
+        break;
+
+    case LoadGovernor::Action::BypassTail:
+        if (shed)
+        {
+            // The most expensive effect still running, by average cost
+            EffectSlot* costliest = nullptr;
+            for (const auto& slot : m_effects)
+            {
+                if (slot->shedSequence() == 0U && !slot->isBypassed() &&
+                    (costliest == nullptr || slot->meter().average() > costliest->meter().average()))
+                {
+                    costliest = slot.get();
+                }
+            }
+            if (costliest != nullptr)
+            {
+                costliest->setShed(++m_shedSequence);
+            }
+        }
+        else
+        {
+            // The most recently shed effect comes back first
+            EffectSlot* newest = nullptr;
+            for (const auto& slot : m_effects)
+            {
+                if (slot->shedSequence() != 0U &&
+                    (newest == nullptr || slot->shedSequence() > newest->shedSequence()))
+                {
+                    newest = slot.get();
+                }
+            }
+            if (newest != nullptr)
+            {
+                newest->setShed(0U);
+            }
+        }
+        break;
+    }
+}
+
+void AudioSystem::publishTelemetry(const float* output, unsigned int frames, std::uint64_t blockStart, std::int64_t startNanos)
+{
+    EngineTelemetry& state = m_telemetry->back();
+    state.frame = blockStart;
+    state.blockFrames = frames;
+    state.heldNotes = m_heldCount;
+
+    VoiceTelemetry& voice = state.voices[0];
+    voice.note = m_heldTail >= 0 ? m_heldTail % kMidiNotes : -1;
+    voice.channel = m_heldTail >= 0 ? m_heldTail / kMidiNotes : -1;
+    voice.frequency = m_frequency;
+    voice.velocity = m_noteVelocity;
+    voice.stage = EnvelopeStage::Idle;
+    voice.envelopeLevel = 0.0f;
+    if (m_envelope)
+    {
+        switch (m_envelope->stage())
+        {
+        case ADSREnvelope::Stage::Attack:  voice.stage = EnvelopeStage::Attack; break;
+        case ADSREnvelope::Stage::Decay:   voice.stage = EnvelopeStage::Decay; break;
+        case ADSREnvelope::Stage::Sustain: voice.stage = EnvelopeStage::Sustain; break;
+        case ADSREnvelope::Stage::Release: voice.stage = EnvelopeStage::Release; break;
+        case ADSREnvelope::Stage::Idle:    voice.stage = EnvelopeStage::Idle; break;
+        }
+        voice.envelopeLevel = m_envelope->level();
+    }
+    state.activeVoices = voice.stage == EnvelopeStage::Idle ? 0U : 1U;
+
+    state.pitchBendCents = m_pitchBendCents;
+    state.lowPassCutoffHz = m_lowPassFilters.empty() ? 0.0f : m_lowPassFilters.front()->getCutoff();
+    state.effects = static_cast<std::uint32_t>(m_effects.size());
+
+    float peak[2] = {0.0f, 0.0f};
+    float energy[2] = {0.0f, 0.0f};
+    for (unsigned int i = 0; i < frames; ++i)
+    {
+        for (unsigned int channel = 0; channel < 2U; ++channel)
+        {
+            const float sample = output[2U * i + channel];
+            peak[channel] = std::max(peak[channel], std::fabs(sample));
+            energy[channel] += sample * sample;
+        }
+    }
+    for (unsigned int channel = 0; channel < 2U; ++channel)
+    {
+        state.peak[channel] = peak[channel];
+        state.rms[channel] = frames > 0U ? std::sqrt(energy[channel] / static_cast<float>(frames)) : 0.0f;
+    }
+    state.gainReductionDb = masterGainReductionDb();
+
+    const double blockNanos = 1.0e9 * static_cast<double>(frames) / static_cast<double>(m_sampleRate);
+    const double renderNanos = static_cast<double>(AudioClock::hostTimeNanos() - startNanos);
+    state.cpuLoad = blockNanos > 0.0 ? static_cast<float>(renderNanos / blockNanos) : 0.0f;
+
+    publishCost(state.voiceCost, "voice", m_voiceMeter);
+    publishCost(state.masterCost, "masterBus", m_masterMeter);
+    for (std::size_t index = 0; index < m_effects.size(); ++index)
+    {
+        EffectSlot& slot = *m_effects[index];
+        publishCost(state.effectCosts[index], slot.effect()->name(), slot.meter());
+    }
+    GovernorTelemetry& governor = state.governor;
+    const LoadGovernor::Counters& counters = m_governor.counters();
+    governor.level = static_cast<std::uint32_t>(m_governor.level());
+    governor.steps = m_governor.settings().enabled ? static_cast<std::uint32_t>(m_governor.settings().steps) : 0U;
+    governor.overruns = counters.overruns;
+    std::copy(std::begin(counters.shed), std::end(counters.shed), std::begin(governor.shed));
+    std::copy(std::begin(counters.restored), std::end(counters.restored), std::begin(governor.restored));
+    governor.stolenGrains = m_granularSource ? m_granularSource->stolenGrainCount() : 0U;
+
+    state.memory = measureMemory(m_effects, m_granularSource.get());
+
+    m_blockStats.voices = state.activeVoices;
+    m_blockStats.grains = m_granularSource ? static_cast<std::uint32_t>(m_granularSource->activeGrainCount()) : 0U;
+    m_blockStats.governorLevel = governor.level;
+
+    state.pendingEvents = static_cast<std::uint32_t>(m_scheduled.size());
+    state.droppedCommands = m_commands->rejectedCount();
+
+    m_telemetry->publish();
+}
+
+void AudioSystem::setLiveInputMode(LiveInputMode mode, float gain)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::LiveInput;
+    command.key = static_cast<int>(mode);
+    command.values = {std::max(0.0f, std::min(gain, 4.0f))};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, live input mode not changed" << std::endl;
+        return;
+    }
+    m_requestedLiveInputMode = mode;
+}
+
+AudioSystem::LiveInputMode AudioSystem::liveInputMode() const
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+    return m_requestedLiveInputMode;
+}
+
+AudioSystem::LiveInputMode AudioSystem::liveInputModeFromString(const std::string& name)
+{
+    const std::string modeLower = toLowercase(name);
+    if (modeLower == "through" || modeLower == "thru") {
+        return LiveInputMode::Through;
+    } else if (modeLower == "mix") {
+        return LiveInputMode::Mix;
+    } else if (modeLower == "sidechain") {
+        return LiveInputMode::Sidechain;
+    }
+    return LiveInputMode::Off;
+}
+
+void AudioSystem::feedLiveInput(float sample)
+{
+    if (m_granularSource && m_granularSource->bufferMode() == GranularSource::BufferMode::Live)
+    {
+        m_granularSource->writeLiveSample(sample);
+    }
+}
+
+void AudioSystem::refreshEffectRoutes()
+{
+    m_liveModulated.clear();
+    m_lowPassFilters.clear();
+    for (const auto& slot : m_effects)
+    {
+        const auto& effect = slot->effect();
+        m_liveModulated.push_back(dynamic_cast<VocoderEffect*>(effect.get()));  // One entry per slot
+        if (auto lowPass = std::dynamic_pointer_cast<LowPassEffect>(effect))
+        {
+            m_lowPassFilters.push_back(lowPass.get());
+        }
+    }
+}
+
+std::pair<float, float> AudioSystem::applyEffects(std::pair<float, float> stereoSample) 
+{
+    // Apply each effect in the chain to the stereo sample; bypassed slots pass it through
+    for (const auto& slot : m_effects)
+    {
+        stereoSample = slot->process(stereoSample);
+    }
+
+    return stereoSample;
+}
+
+bool AudioSystem::addEffect(std::shared_ptr<IEffect> effect) 
+{
+    if (!effect) {
+        return false; // Don't add null effects
+    }
+
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    
+    // Check if the effect already exists in the chain
+    auto it = std::find_if(m_chain.begin(), m_chain.end(),
+                           [&effect](const std::shared_ptr<EffectSlot>& slot) { return slot->effect() == effect; });
+    if (it != m_chain.end())
+    {
+        return false;
+    }
+
+    if (m_chain.size() >= kMaxEffects)
+    {
+        std::cerr << "Warning: effect chain is full (" << kMaxEffects << " effects), effect not added" << std::endl;
+        return false;
+    }
+
+    const std::uint64_t budget = m_memoryLimit->budget.load(std::memory_order_relaxed);
+    if (budget > 0U)
+    {
+        const std::uint64_t needed = measureMemory(m_chain, m_granularChain.get()).total + sizeof(EffectSlot) + effect->memoryBytes();
+        if (needed > budget)
+        {
+            m_memoryLimit->rejected.fetch_add(1U, std::memory_order_relaxed);
+            std::cerr << "Warning: " << effect->name() << " needs the engine to hold " << needed
+                      << " bytes, over the memory budget of " << budget << ", effect not added" << std::endl;
+            return false;
+        }
+    }
+
+    // The slot is allocated here so the audio thread only links it in
+    ControlCommand command;
+    command.type = ControlCommand::Type::AddEffect;
+    command.slot = std::make_shared<EffectSlot>(effect, m_sampleRate);
+    std::shared_ptr<EffectSlot> slot = command.slot;
+
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, effect not added" << std::endl;
+        return false;
+    }
+
+    m_chain.push_back(std::move(slot));
+    if (auto lowPass = std::dynamic_pointer_cast<LowPassEffect>(effect))
+    {
+        m_lowPassActive = true;
+        m_lastLowPassCutoff = lowPass->getCutoff();
+    }
+    return true;
+}
+
+void AudioSystem::resetEffects() 
+{
+    // Reset internal state of all effects (clear buffers, reset phase, etc.)
+    ControlCommand command;
+    command.type = ControlCommand::Type::ResetEffects;
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, reset dropped" << std::endl;
+    }
+}
+
+void AudioSystem::clearEffects()
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::ClearEffects;
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, clear dropped" << std::endl;
+        return;
+    }
+
+    m_chain.clear();
+    m_lowPassActive = false;
+    m_lastLowPassCutoff = 0.0f;
+}
+
+bool AudioSystem::postCommand(ControlCommand command)
+{
+    releaseRetired();
+    command.fromMidi = t_midiInput;
+    return m_commands->tryPush(std::move(command));
+}
+
+AudioSystem::MidiInputScope::MidiInputScope() : m_previous(t_midiInput)
+{
+    t_midiInput = true;
+}
+
+AudioSystem::MidiInputScope::~MidiInputScope()
+{
+    t_midiInput = m_previous;
+}
+
+void AudioSystem::applyCommands()
+{
+    ControlCommand command;
+    bool chainChanged = false;
+
+    applyDeferredLoads();
+
+    while (m_commands->tryPop(command))
+    {
+        if (command.frame > m_renderedFrames && m_scheduled.size() < m_scheduled.capacity())
+        {
+            scheduleCommand(command);
+        }
+        else
+        {
+            chainChanged = applyCommand(command) || chainChanged;
+        }
+
+        // Never keep a reference in the local either; what is left is released off the audio thread
+        retire(std::move(command.slot));
+        retire(std::move(command.granular));
+        retire(std::move(command.effect));
+        retire(std::move(command.waveform));
+        retire(std::move(command.secondaryWaveform));
+        retire(std::move(command.sample));
+    }
+
+    if (chainChanged)
+    {
+        refreshEffectRoutes();
+    }
+}
+
+bool AudioSystem::applyCommand(ControlCommand& command)
+{
+    ++m_blockStats.commands;
+    if (command.fromMidi)
+    {
+        ++m_blockStats.midiEvents;
+    }
+
+    switch (command.type)
+    {
+    case ControlCommand::Type::NoteOn:
+        applyNoteOn(command.key, command.values[0], command.values[1], command.values[2], command.values[3]);
+        break;
+
+    case ControlCommand::Type::NoteOff:
+        applyNoteOff(command.key);
+        break;
+
+    case ControlCommand::Type::AllNotesOff:
+        applyAllNotesOff();
+        break;
+
+    case ControlCommand::Type::PitchBend:
+        m_pitchBendCents = command.values[0];
+        break;
+
+    case ControlCommand::Type::EnvelopeParameters:
+        if (m_envelope) {
+            m_envelope->setParameters(command.values[0], command.values[1], command.values[2], command.values[3]);
+        }
+        break;
+
+    case ControlCommand::Type::AddEffect:
+        // Capacity was reserved in the constructor, so this never allocates
+        if (m_effects.size() < kMaxEffects)
+        {
+            m_effects.push_back(std::move(command.slot));
+            return true;
+        }
+        break;
+
+    case ControlCommand::Type::ClearEffects:
+        m_liveModulated.clear();
+        m_lowPassFilters.clear();
+        for (auto& slot : m_effects)
+        {
+            retire(std::move(slot));
+        }
+        m_effects.clear();
+        return true;
+
+    case ControlCommand::Type::ResetEffects:
+        for (const auto& slot : m_effects)
+        {
+            slot->reset();
+        }
+        break;
+
+    case ControlCommand::Type::GovernorSettings:
+    {
+        LoadGovernor::Settings settings;
+        settings.enabled = command.values[0] != 0.0f;
+        settings.highLoad = command.values[1];
+        settings.lowLoad = command.values[2];
+        settings.restoreSeconds = command.values[3];
+        settings.steps = LoadGovernor::unpackOrder(static_cast<std::uint32_t>(command.key), settings.order);
+        m_governor.configure(settings);
+        break;
+    }
+
+    case ControlCommand::Type::GranularSource:
+        if (command.granular)
+        {
+            command.granular->setSampleRate(m_sampleRate);
+            command.granular->reset();
+        }
+        // The replaced source and buffers stay in the command, which applyCommands() retires
+        m_granularSource.swap(command.granular);
+        break;
+
+    case ControlCommand::Type::GranularSample:
+        command.granular->adoptSample(*command.sample, command.values[0], command.values[1]);
+        break;
+
+    case ControlCommand::Type::TimeStretchSample:
+        // Loads wait behind earlier deferred ones so they land in posting order
+        if (!m_deferredLoads.empty() ||
+            !static_cast<TimeStretchEffect&>(*command.effect).adoptSample(*command.sample))
+        {
+            // With no room left the load is dropped and its buffer retired with the command
+            if (m_deferredLoads.size() < m_deferredLoads.capacity())
+            {
+                m_deferredLoads.push_back(std::move(command));
+            }
+        }
+        break;
+
+    case ControlCommand::Type::VocoderModulator:
+        static_cast<VocoderEffect&>(*command.effect).adoptModulator(*command.sample);
+        break;
+
+    case ControlCommand::Type::VocoderBands:
+        static_cast<VocoderEffect&>(*command.effect).setBandCount(static_cast<std::size_t>(command.key));
+        break;
+
+    case ControlCommand::Type::Waveform:
+        // The replaced waveforms stay in the command, which applyCommands() retires
+        if (command.waveform)
+        {
+            m_primaryWaveform.swap(command.waveform);
+        }
+        if (command.secondaryWaveform)
+        {
+            m_secondaryWaveform.swap(command.secondaryWaveform);
+        }
+        break;
+
+    case ControlCommand::Type::SecondaryOscillator:
+        m_secondaryEnabled = command.key != 0;
+        if (m_secondaryEnabled)
+        {
+            m_secondaryMix = command.values[0];
+            m_secondaryDetuneCents = command.values[1];
+            m_secondaryOctaveOffset = static_cast<int>(command.values[2]);
+        }
+        else
+        {
+            m_secondaryMix = 0.0f;
+            m_secondaryDetuneCents = 0.0f;
+            m_secondaryOctaveOffset = 0;
+            m_secondaryPhase = 0.0f;
+        }
+        break;
+
+    case ControlCommand::Type::Drift:
+        m_lfoRateHz = command.values[0];
+        m_lfoAmountCents = command.values[1];
+        break;
+
+    case ControlCommand::Type::Compressor:
+        m_compressor.setThreshold(command.values[0]);
+        m_compressor.setRatio(command.values[1]);
+        m_compressor.setTimes(command.values[2] / 1000.0f, command.values[3] / 1000.0f);
+        m_compressor.setMakeupGain(command.values[4]);
+        if (command.key != 0 && !m_compressor.enabled())
+        {
+            m_compressor.reset();
+        }
+        m_compressor.setEnabled(command.key != 0);
+        break;
+
+    case ControlCommand::Type::Limiter:
+        m_limiter.setCeiling(command.values[0]);
+        m_limiter.setRelease(command.values[1] / 1000.0f);
+        m_limiter.setEnabled(command.key != 0);
+        break;
+
+    case ControlCommand::Type::LiveInput:
+        m_liveInputMode = static_cast<LiveInputMode>(command.key);
+        m_liveInputGain = command.values[0];
+        break;
+    }
+    return false;
+}
+
+void AudioSystem::applyDeferredLoads()
+{
+    std::size_t applied = 0;
+    while (applied < m_deferredLoads.size())
+    {
+        ControlCommand& load = m_deferredLoads[applied];
+        if (!static_cast<TimeStretchEffect&>(*load.effect).adoptSample(*load.sample))
+        {
+            break;
+        }
+        retire(std::move(load.effect));
+        retire(std::move(load.sample));
+        ++applied;
+    }
+
+    // Only emptied commands are destroyed here; the rest move down without allocating
+    m_deferredLoads.erase(m_deferredLoads.begin(), m_deferredLoads.begin() + static_cast<std::ptrdiff_t>(applied));
+}
+
+void AudioSystem::scheduleCommand(ControlCommand& command)
+{
+    // Sorted latest first so due commands pop off the back; equal frames
+    // keep their posting order. Capacity is reserved, so this never allocates.
+    const auto position = std::lower_bound(m_scheduled.begin(), m_scheduled.end(), command.frame,
+                                           [](const ControlCommand& scheduled, std::uint64_t frame)
+                                           { return scheduled.frame > frame; });
+    m_scheduled.insert(position, std::move(command));
+}
+
+void AudioSystem::applyScheduledCommands(std::uint64_t frame)
+{
+    // Timed commands are notes and pitch bend only, which never change the chain
+    while (!m_scheduled.empty() && m_scheduled.back().frame <= frame)
+    {
+        applyCommand(m_scheduled.back());
+        m_scheduled.pop_back();
+    }
+}
+
+void AudioSystem::retire(std::shared_ptr<void> object)
+{
+    // If the queue is somehow full the object is released here as a last resort
+    if (object)
+    {
+        m_retired->tryPush(std::move(object));
+    }
+}
+
+void AudioSystem::releaseRetired()
+{
+    std::shared_ptr<void> object;
+    while (m_retired->tryPop(object))
+    {
+        object.reset();
+    }
+}
+
+bool AudioSystem::updateEffectParameters(const std::string& effectName, const IEffectParameters& parameters)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    std::string effectLower = toLowercase(effectName);
+    
+    for (const auto& slot : m_chain)
+    {
+        const auto& effect = slot->effect();
+        if (effectLower == "delay" || effectLower == "echo") {
+            if (auto delayEffect = std::dynamic_pointer_cast<DelayEffect>(effect)) {
+                if (auto delayParams = dynamic_cast<const DelayParameters*>(&parameters)) {
+                    delayEffect->setDelayTime(delayParams->delayTime);
+                    delayEffect->setFeedback(delayParams->feedback);
+                    delayEffect->setMix(delayParams->mix);
+                    return true;
+                }
+            }
+        }
+        else if (effectLower == "lowpass" || effectLower == "lpf" || effectLower == "filter") {
+            if (auto lowPassEffect = std::dynamic_pointer_cast<LowPassEffect>(effect)) {
+                if (auto lowPassParams = dynamic_cast<const LowPassParameters*>(&parameters)) {
+                    lowPassEffect->setCutoff(lowPassParams->cutoffFreq);
+                    lowPassEffect->setResonance(lowPassParams->resonance);
+                    m_lowPassActive = true;
+                    m_lastLowPassCutoff = lowPassParams->cutoffFreq;
+                    return true;
+                }
+            }
+        }
+        else if (effectLower == "octave") {
+            if (auto octaveEffect = std::dynamic_pointer_cast<OctaveEffect>(effect)) {
+                if (auto octaveParams = dynamic_cast<const OctaveParameters*>(&parameters)) {
+                    // Convert octave shift to boolean (higher/lower)
+                    bool higher = octaveParams->octaveShift > 1.0f;
+                    octaveEffect->setHigher(higher);
+                    octaveEffect->setBlend(octaveParams->mix);
+                    return true;
+                }
+            }
+        }
+    }
+    
+    return false; // Effect not found or parameters don't match
+}
+
+bool AudioSystem::setEffectBypass(const std::string& effectName, bool bypassed, bool keepWarm)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    const std::string effectLower = toLowercase(effectName);
+    bool found = false;
+
+    for (const auto& slot : m_chain)
+    {
+        if (effectMatchesName(slot->effect().get(), effectLower))
+        {
+            slot->setKeepWarm(keepWarm);
+            slot->setBypassed(bypassed);
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool AudioSystem::isEffectBypassed(const std::string& effectName) const
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    const std::string effectLower = toLowercase(effectName);
+
+    for (const auto& slot : m_chain)
+    {
+        if (effectMatchesName(slot->effect().get(), effectLower))
+        {
+            return slot->isBypassed();
+        }
+    }
+    return false;
+}
+
+void AudioSystem::updateADSRParameters(float attackTime, float decayTime, float sustainLevel, float releaseTime)
+{
+    // The envelope keeps its stage and level, so a held note is not retriggered
+    ControlCommand command;
+    command.type = ControlCommand::Type::EnvelopeParameters;
+    command.values = {attackTime, decayTime, sustainLevel, releaseTime};
+    postCommand(std::move(command));
+}
+
+void AudioSystem::setDriftParameters(float rateHz, float amountCents, float jitterCents)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    // The jitter is drawn when a note is posted, so it stays on the control side
+    m_noteJitterAmountCents = std::max(jitterCents, 0.0f);
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::Drift;
+    command.values = {std::max(rateHz, 0.0f), std::max(amountCents, 0.0f)};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, drift parameters dropped" << std::endl;
+    }
+}
+
+void AudioSystem::setWaveformTapBuffer(StereoSampleRingBuffer* tap)
+{
+    m_waveformTap = tap;
+}
+
+void AudioSystem::setParameterBlock(ParameterBlock* block)
+{
+    m_parameterBlock = block;
+    m_parameterGliding = 0U;
+}
+
+void AudioSystem::pollParameterBlock(unsigned int frames)
+{
+    ParameterBlock* block = m_parameterBlock;
+    if (block == nullptr)
+    {
+        return;
+    }
+
+    // Newly flagged parameters start gliding from wherever the engine is now
+    std::uint32_t dirty = block->takeDirty();
+    for (std::size_t i = 0; dirty != 0U; ++i, dirty >>= 1U)
+    {
+        if ((dirty & 1U) == 0U)
+        {
+            continue;
+        }
+        const auto id = static_cast<ParameterBlock::Id>(i);
+        const float target = block->value(id);
+        if (std::isfinite(target))
+        {
+            m_parameterTargets[i] = target;
+            m_parameterGliding |= 1U << i;
+        }
+    }
+
+    if (m_parameterGliding == 0U)
+    {
+        return;
+    }
+
+    constexpr float kGlideSeconds = 0.02f;
+    const float coefficient = 1.0f - std::exp(-static_cast<float>(frames) / (kGlideSeconds * m_sampleRate));
+
+    for (std::size_t i = 0; i < ParameterBlock::kCount; ++i)
+    {
+        if ((m_parameterGliding & (1U << i)) == 0U)
+        {
+            continue;
+        }
+        const auto id = static_cast<ParameterBlock::Id>(i);
+        const float target = m_parameterTargets[i];
+        const float current = parameterValue(id);
+        const float tolerance = 1.0e-4f * std::max(1.0f, std::fabs(target));
+        float next = current + coefficient * (target - current);
+        if (std::fabs(target - next) <= tolerance)
+        {
+            next = target;
+        }
+        applyParameter(id, next);
+
+        // Stop once there, or when the engine clamps the value (out of range,
+        // secondary oscillator off, no filter in the chain)
+        if (next == target || std::fabs(parameterValue(id) - next) > tolerance)
+        {
+            m_parameterGliding &= ~(1U << i);
+        }
+    }
+}
+
+float AudioSystem::parameterValue(ParameterBlock::Id id) const
+{
+    switch (id)
+    {
+    case ParameterBlock::Id::PitchBendCents:
+        return m_pitchBendCents;
+    case ParameterBlock::Id::LowPassCutoffHz:
+        return m_lowPassFilters.empty() ? 0.0f : m_lowPassFilters.front()->getCutoff();
+    case ParameterBlock::Id::SecondaryMix:
+        return m_secondaryMix;
+    case ParameterBlock::Id::SecondaryDetuneCents:
+        return m_secondaryDetuneCents;
+    case ParameterBlock::Id::DriftRateHz:
+        return m_lfoRateHz;
+    case ParameterBlock::Id::DriftAmountCents:
+        return m_lfoAmountCents;
+    case ParameterBlock::Id::Count:
+        break;
+    }
+    return 0.0f;
+}
+
+void AudioSystem::applyParameter(ParameterBlock::Id id, float value)
+{
+    switch (id)
+    {
+    case ParameterBlock::Id::PitchBendCents:
+        m_pitchBendCents = std::max(-100.0f, std::min(100.0f, value));
+        break;
+    case ParameterBlock::Id::LowPassCutoffHz:
+        for (LowPassEffect* filter : m_lowPassFilters)
+        {
+            filter->setCutoff(value);
+        }
+        break;
+    case ParameterBlock::Id::SecondaryMix:
+        m_secondaryMix = m_secondaryEnabled ? std::max(0.0f, std::min(1.0f, value)) : 0.0f;
+        break;
+    case ParameterBlock::Id::SecondaryDetuneCents:
+        m_secondaryDetuneCents = m_secondaryEnabled ? std::max(0.0f, value) : 0.0f;
+        break;
+    case ParameterBlock::Id::DriftRateHz:
+        m_lfoRateHz = std::max(0.0f, value);
+        break;
+    case ParameterBlock::Id::DriftAmountCents:
+        m_lfoAmountCents = std::max(0.0f, value);
+        break;
+    case ParameterBlock::Id::Count:
+        break;
+    }
+}
+
+void AudioSystem::setLowPassCutoff(float cutoffHz)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    bool updated = false;
+    for (const auto& slot : m_chain)
+    {
+        const auto& effect = slot->effect();
+        if (auto lowPass = std::dynamic_pointer_cast<LowPassEffect>(effect))
+        {
+            lowPass->setCutoff(cutoffHz);
+            updated = true;
+        }
+    }
+
+    if (updated)
+    {
+        m_lowPassActive = true;
+        m_lastLowPassCutoff = cutoffHz;
+    }
+    else
+    {
+        m_lowPassActive = false;
+        m_lastLowPassCutoff = 0.0f;
+    }
+}
+
+float AudioSystem::getLowPassCutoff() const
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    return m_lowPassActive ? m_lastLowPassCutoff : 0.0f;
+}
+
+bool AudioSystem::hasLowPassEffect() const
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    return m_lowPassActive;
+}
+
+bool AudioSystem::setSpectralFreeze(bool frozen)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    bool found = false;
+    for (const auto& slot : m_chain)
+    {
+        const auto& effect = slot->effect();
+        if (auto freeze = std::dynamic_pointer_cast<SpectralFreezeEffect>(effect))
+        {
+            freeze->setFrozen(frozen);
+            found = true;
+        }
+    }
+    return found;
+}
+
+void AudioSystem::configureCompressor(bool enabled, float thresholdDb, float ratio, float attackMs, float releaseMs, float makeupDb)
+{
+    ControlCommand command;
+    command.type = ControlCommand::Type::Compressor;
+    command.key = enabled ? 1 : 0;
+    command.values = {thresholdDb, ratio, attackMs, releaseMs, makeupDb};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, compressor settings dropped" << std::endl;
+    }
+}
+
+void AudioSystem::configureLimiter(bool enabled, float ceilingDb, float releaseMs)
+{
+    ControlCommand command;
+    command.type = ControlCommand::Type::Limiter;
+    command.key = enabled ? 1 : 0;
+    command.values = {ceilingDb, releaseMs};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, limiter settings dropped" << std::endl;
+    }
+}
+
+bool AudioSystem::configureGovernor(const LoadGovernor::Settings& settings)
+{
+    ControlCommand command;
+    command.type = ControlCommand::Type::GovernorSettings;
+    command.key = static_cast<int>(LoadGovernor::packOrder(settings.order, settings.steps));
+    command.values = {settings.enabled ? 1.0f : 0.0f, settings.highLoad, settings.lowLoad, settings.restoreSeconds};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, governor settings dropped" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+LoadGovernor::Settings AudioSystem::governorSettingsFromConfig(const AudioConfig& config)
+{
+    LoadGovernor::Settings settings;
+    settings.enabled = config.governorEnabled;
+    settings.highLoad = config.governorHighLoad;
+    settings.lowLoad = config.governorLowLoad;
+    settings.restoreSeconds = config.governorRestoreSeconds;
+    settings.steps = 0;
+    for (const auto& name : config.governorOrder)
+    {
+        LoadGovernor::Action action;
+        if (settings.steps < LoadGovernor::kMaxSteps && LoadGovernor::actionFromString(name, action))
+        {
+            settings.order[settings.steps++] = action;
+        }
+    }
+    return settings;
+}
+
+void AudioSystem::setMemoryBudget(std::size_t bytes)
+{
+    m_memoryLimit->budget.store(bytes, std::memory_order_relaxed);
+}
+
+std::size_t AudioSystem::memoryBudget() const
+{
+    return static_cast<std::size_t>(m_memoryLimit->budget.load(std::memory_order_relaxed));
+}
+
+MemoryTelemetry AudioSystem::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+    return measureMemory(m_chain, m_granularChain.get());
+}
+
+MemoryTelemetry AudioSystem::measureMemory(const std::vector<std::shared_ptr<EffectSlot>>& chain,
+                                           const GranularSource* granular) const
+{
+    MemoryTelemetry memory;
+    for (std::size_t index = 0; index < chain.size(); ++index)
+    {
+        const std::uint64_t bytes = sizeof(EffectSlot) + chain[index]->effect()->memoryBytes();
+        if (index < MemoryTelemetry::kMaxEffects)
+        {
+            memory.effectBytes[index] = bytes;
+        }
+        memory.effects += bytes;
+    }
+
+    memory.voices = (m_envelope ? sizeof(ADSREnvelope) : 0U)
+                  + (granular != nullptr ? granular->memoryBytes() : 0U);
+    memory.rings = sizeof(ControlCommandQueue) + sizeof(RetiredQueue) + sizeof(TripleBuffer<EngineTelemetry>)
+                 + m_scheduled.capacity() * sizeof(ControlCommand)
+                 + (m_chunkLeft.capacity() + m_chunkRight.capacity() + m_chunkLive.capacity()
+                    + m_quantumOutput.capacity() + m_quantumInput.capacity()) * sizeof(float)
+                 + (m_waveformTap ? m_waveformTap->bufferBytes() : 0U);
+    // Grain windows and FFT plans are shared process-wide; counted once, as this engine's
+    memory.tables = sizeof(TuningTable) + FFTPlan::cachedBytes()
+                  + (granular != nullptr ? GranularSource::windowTableBytes() : 0U);
+    memory.master = sizeof(m_compressor) + sizeof(m_limiter) + m_limiter.bufferBytes();
+    memory.total = memory.effects + memory.voices + memory.rings + memory.tables + memory.master;
+    memory.budget = m_memoryLimit->budget.load(std::memory_order_relaxed);
+    memory.rejectedEffects = m_memoryLimit->rejected.load(std::memory_order_relaxed);
+    return memory;
+}
+
+unsigned int AudioSystem::masterLatencyFrames() const
+{
+    return static_cast<unsigned int>(m_limiter.latencyFrames());
+}
+
+float AudioSystem::masterGainReductionDb() const
+{
+    return m_compressor.gainReductionDb() + m_limiter.gainReductionDb();
+}
+
+void AudioSystem::configureSecondaryOscillator(bool enabled, float mix, float detuneCents, int octaveOffset)
+{
+    ControlCommand command;
+    command.type = ControlCommand::Type::SecondaryOscillator;
+    command.key = enabled ? 1 : 0;
+    command.values = {std::max(0.0f, std::min(1.0f, mix)), std::max(detuneCents, 0.0f),
+                      static_cast<float>(std::max(-2, std::min(2, octaveOffset)))};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, secondary oscillator settings dropped" << std::endl;
+    }
 }
 
 void AudioSystem::setSecondaryWaveform(std::shared_ptr<IWave> waveform)
 {
     if (waveform)
     {
-        m_secondaryWaveform = waveform;
+        ControlCommand command;
+        command.type = ControlCommand::Type::Waveform;
+        command.secondaryWaveform = std::move(waveform);
+        if (!postCommand(std::move(command)))
+        {
+            std::cerr << "Warning: too many pending control changes, secondary waveform not changed" << std::endl;
+        }
+    }
+}
+
+bool AudioSystem::setGranularSource(std::shared_ptr<GranularSource> source)
+{
+    std::lock_guard<std::mutex> lock(*m_chainMutex);
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::GranularSource;
+    command.granular = source;
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, granular source not changed" << std::endl;
+        return false;
+    }
+
+    m_granularChain = std::move(source);
+    return true;
+}
+
+bool AudioSystem::loadGranularSample(std::shared_ptr<GranularSource> source, const std::vector<float>& samples,
+                                     float sourceSampleRate, float rootFrequency)
+{
+    if (!source)
+    {
+        return false;
+    }
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::GranularSample;
+    command.granular = std::move(source);
+    command.sample = std::make_shared<std::vector<float>>(GranularSource::prepareSample(samples));
+    command.values = {sourceSampleRate, rootFrequency};
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, granular sample not loaded" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool AudioSystem::loadTimeStretchSample(std::shared_ptr<TimeStretchEffect> effect, const std::vector<float>& samples,
+                                        float sourceSampleRate)
+{
+    if (!effect)
+    {
+        return false;
+    }
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::TimeStretchSample;
+    command.sample = std::make_shared<std::vector<float>>(effect->prepareSample(samples, sourceSampleRate));
+    command.effect = std::move(effect);
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, time-stretch sample not loaded" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool AudioSystem::loadVocoderModulator(std::shared_ptr<VocoderEffect> effect, const std::vector<float>& samples,
+                                       float sourceSampleRate)
+{
+    if (!effect)
+    {
+        return false;
+    }
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::VocoderModulator;
+    command.sample = std::make_shared<std::vector<float>>(effect->prepareModulator(samples, sourceSampleRate));
+    command.effect = std::move(effect);
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, vocoder modulator not loaded" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool AudioSystem::configureVocoder(std::shared_ptr<VocoderEffect> effect, std::size_t bandCount)
+{
+    if (!effect)
+    {
+        return false;
+    }
+
+    ControlCommand command;
+    command.type = ControlCommand::Type::VocoderBands;
+    command.key = static_cast<int>(std::min(bandCount, VocoderEffect::kMaxBands));
+    command.effect = std::move(effect);
+    if (!postCommand(std::move(command)))
+    {
+        std::cerr << "Warning: too many pending control changes, vocoder bands not changed" << std::endl;
+        return false;
     }
+    return true;
 }
 
 void AudioSystem::setPitchBend(int value)
+{
+    setPitchBendAt(0U, value);
+}
+
+void AudioSystem::setPitchBendAt(std::uint64_t frame, int value)
 {
     const int clamped = std::max(-8192, std::min(8191, value));
 
@@ -467,5 +1959,9 @@ void AudioSystem::setPitchBend(int value)
     }
 
     constexpr float semitoneRange = 1.0f; // +/- one semitone
-    m_pitchBendCents = normalized * (semitoneRange * 100.0f);
+    ControlCommand command;
+    command.type = ControlCommand::Type::PitchBend;
+    command.values[0] = normalized * (semitoneRange * 100.0f);
+    command.frame = frame;
+    postCommand(std::move(command));
 }
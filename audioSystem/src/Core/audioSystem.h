@@ -5,11 +5,25 @@
 #include <utility>
 #include <string>
 #include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <mutex>
 #include "Effects/IEffect.h"
+#include "Effects/EffectSlot.h"
 #include "Effects/EffectParameters.h"
 #include "Waves/IWave.h"
 #include "AudioConfig.h"
 #include "Envelope/ADSREnvelope.h"
+#include "Dsp/Dynamics.h"
+#include "CommandQueue.h"
+#include "AudioClock.h"
+#include "ParameterBlock.h"
+#include "TripleBuffer.h"
+#include "EngineTelemetry.h"
+#include "CpuMeter.h"
+#include "LoadGovernor.h"
 
 /**
  * @file audioSystem.h
@@ -29,39 +43,227 @@
  * processed audio samples.
  */
 class StereoSampleRingBuffer;
+class GranularSource;
+class TimeStretchEffect;
+class VocoderEffect;
+class LowPassEffect;
 
 class AudioSystem
 {
 public:
+    /**
+     * @enum LiveInputMode
+     * @brief How device input delivered to renderBlock() is used
+     */
+    enum class LiveInputMode
+    {
+        Off,        ///< Input is ignored
+        Through,    ///< Input replaces the synth voice and runs through the effect chain
+        Mix,        ///< Input is mixed with the synth voice before the effect chain
+        Sidechain   ///< Input only feeds the granular live buffer and live vocoder modulators
+    };
+
+    static constexpr std::size_t kMaxEffects = 32;           ///< Longest effect chain; storage is reserved up front
+    static constexpr int kMidiNotes = 128;                   ///< Note numbers 0-127
+    static constexpr int kMidiChannels = 16;                 ///< Channels 0-15
+    static constexpr std::size_t kCommandCapacity = 256;     ///< Control changes that can wait for the next block
+    static constexpr unsigned int kQuantumFrames = 64;       ///< Frames the engine renders at a time, whatever the device block
+
     /**
      * @brief Constructs an AudioSystem with the specified sample rate
      * @param sampleRate The number of samples per second (Hz)
      */
     explicit AudioSystem(float sampleRate);
 
+    /**
+     * @brief Start a MIDI note
+     * @param note Note number (0-127); the pitch comes from the tuning table
+     * @param velocity Note velocity (0.0-1.0); 0 releases the note as MIDI does
+     * @param channel MIDI channel (0-15)
+     *
+     * Notes, pitch bend, envelope changes and chain edits are queued and
+     * applied by the audio thread at the start of the next block, so they may
+     * be called from any number of control threads (MIDI, UI, sequencer).
+     *
+     * The voice is monophonic with last-note priority: held notes are kept in
+     * a list indexed by note and channel, so note off is a constant-time
+     * lookup and releasing the newest note falls back to the previous one.
+     * Velocity scales the voice when it starts from silence; legato notes
+     * keep the level of the phrase.
+     */
+    void noteOn(int note, float velocity = 1.0f, int channel = 0);
+
+    /**
+     * @brief Release a MIDI note started with noteOn()
+     * @param note Note number (0-127)
+     * @param channel MIDI channel (0-15)
+     */
+    void noteOff(int note, int channel = 0);
+
+    /**
+     * @brief Start a MIDI note at an exact render frame
+     * @param frame Frame on the audioClock() timeline; frames already rendered
+     *        play at the start of the next block
+     *
+     * Timed events are held by the audio thread and applied at their frame
+     * offset inside the block, so notes played from a thread with uneven
+     * scheduling (the Node event loop) keep their relative timing. Schedule
+     * at least one device buffer ahead of audioClock() for exact placement.
+     * Up to kCommandCapacity events can be pending; beyond that they are
+     * applied as soon as they arrive.
+     */
+    void noteOnAt(std::uint64_t frame, int note, float velocity = 1.0f, int channel = 0);
+
+    /**
+     * @brief Release a MIDI note at an exact render frame (see noteOnAt())
+     */
+    void noteOffAt(std::uint64_t frame, int note, int channel = 0);
+
+    /**
+     * @brief Set the pitch bend at an exact render frame (see noteOnAt())
+     */
+    void setPitchBendAt(std::uint64_t frame, int value);
+
+    /**
+     * @brief Position of the latest rendered block and the host time it started
+     *
+     * Use AudioClockSnapshot::frameAt() with AudioClock::hostTimeNanos() to
+     * find the frame being rendered now and schedule timed events ahead of it.
+     */
+    AudioClockSnapshot audioClock() const { return m_clock->snapshot(); }
+
+    /**
+     * @brief Control changes waiting for the next block (approximate)
+     *
+     * Lets a producer that can wait, like the control server, hold back and
+     * leave room for MIDI and other threads instead of having changes dropped.
+     */
+    std::size_t pendingCommands() const { return m_commands->sizeApprox(); }
+
+    /**
+     * @brief Engine state at the end of the latest rendered block
+     *
+     * The audio thread publishes a snapshot after every block through a
+     * triple buffer, so reading never blocks rendering and never sees a
+     * half-written snapshot. Readers (the UI poller, a status display, the
+     * control server) take turns on a mutex the audio thread never touches;
+     * they get the same snapshot again until a new block is rendered.
+     */
+    EngineTelemetry telemetry()
+    {
+        std::lock_guard<std::mutex> lock(*m_telemetryMutex);
+        return m_telemetry->read();
+    }
+
     /**
      * @brief Triggers a note with the specified frequency
      * @param newFrequency The frequency in Hz of the note to play
+     *
+     * Tracked under the nearest MIDI note on channel 0, so it is released by
+     * triggerNoteOff() with the same frequency or by noteOff() on that note.
      */
     void triggerNote(float newFrequency);
 
     /**
      * @brief Releases a note, optionally targeting a specific frequency
      * @param frequency Frequency to release, or NaN to release all active notes
+     *        and cancel timed notes that have not played yet
      */
     void triggerNoteOff(float frequency = std::numeric_limits<float>::quiet_NaN());
 
+    /**
+     * @brief MIDI note a triggerNote() frequency is tracked under, clamped to 0-127
+     */
+    static int nearestMidiNote(float frequency);
+
+    /**
+     * @brief Replace the note-to-frequency table used by noteOn()
+     * @param frequencies Frequency in Hz for every MIDI note; entries outside
+     *        (0, 20000] keep their equal-tempered value
+     *
+     * Takes effect for notes started afterwards.
+     */
+    void setTuningTable(const std::array<float, kMidiNotes>& frequencies);
+
+    /**
+     * @brief Return to 12-tone equal temperament at A4 = 440 Hz
+     */
+    void resetTuning();
+
+    /**
+     * @brief Frequency noteOn() uses for a note, or 0 if the note is out of range
+     */
+    float noteFrequency(int note) const;
+
+    /**
+     * @brief Control changes dropped because the command queue was full
+     */
+    std::size_t droppedCommands() const { return m_commands->rejectedCount(); }
+
     /**
      * @brief Calculates and returns the next stereo audio sample
      * @return A pair of floats representing the left and right channel values
+     *
+     * Equivalent to rendering a one-frame block, including the master bus.
      */
     std::pair<float, float> getNextSample();
 
+    /**
+     * @brief Render a block of interleaved stereo output, consuming live input
+     * @param input Interleaved device input, or nullptr when there is none
+     * @param inputChannels Channels per input frame (1 or 2; 0 when input is nullptr)
+     * @param output Interleaved stereo output, 2 * frames floats
+     * @param frames Number of frames to render
+     *
+     * Live input is routed according to the current LiveInputMode. In every
+     * mode except Off it also feeds the granular live buffer (when the granular
+     * source is in live mode) and vocoders using a live modulator.
+     *
+     * The engine works in quanta of kQuantumFrames whatever the device
+     * block size: per quantum, pending control commands are applied, the
+     * voice renders, each effect processes it in chain order, the master
+     * compressor and limiter run and the stage costs are metered. Device
+     * blocks are cut into whole quanta; the rest of a quantum that does not
+     * fit is kept and played at the start of the next block, so the output
+     * gains no latency. Live input has to arrive before it is rendered, so
+     * when block sizes are not multiples of the quantum it is delayed by up
+     * to kQuantumFrames - 1 frames (see inputDelayFrames()).
+     *
+     * Each stage is a trace zone (see Trace.h). The load governor and the
+     * telemetry see whole device blocks.
+     */
+    void renderBlock(const float* input, unsigned int inputChannels, float* output, unsigned int frames);
+
+    /**
+     * @brief Choose how live input is used
+     * @param mode Routing mode
+     * @param gain Gain applied to the input in Through and Mix modes
+     */
+    void setLiveInputMode(LiveInputMode mode, float gain = 1.0f);
+
+    /// The mode last set, including a change the audio thread has not applied yet
+    LiveInputMode liveInputMode() const;
+
+    /**
+     * @brief Parse a live input mode name ("off", "through", "mix", "sidechain")
+     * @return The matching mode, or LiveInputMode::Off for unknown names
+     */
+    static LiveInputMode liveInputModeFromString(const std::string& name);
+
     /**
      * @brief Adds an audio effect to the processing chain
      * @param effect Shared pointer to an effect implementing the IEffect interface
+     * @return false if the effect is null, already in the chain, the chain is
+     *         full, inserting it would exceed the memory budget, or too many
+     *         chain changes are pending
+     *
+     * The change is queued and applied by the audio thread at the start of the
+     * next block, so the caller never waits on rendering. Lookups such as
+     * setEffectBypass() and updateEffectParameters() see the effect at once.
+     * The chain only holds shared references; construct (or claim from an
+     * EffectPool) effects up front so nothing is allocated per insertion.
      */
-    void addEffect(std::shared_ptr<IEffect> effect);
+    bool addEffect(std::shared_ptr<IEffect> effect);
 
     /**
      * @brief Processes a stereo sample through all added effects
@@ -72,23 +274,101 @@ public:
 
     /**
      * @brief Resets all effects to their initial state (clears buffers)
+     *
+     * Queued like addEffect(); the reset happens on the audio thread.
      */
     void resetEffects();
 
     /**
      * @brief Removes all effects from the processing chain
+     *
+     * Queued like addEffect(). Removed effects are handed back to the calling
+     * side and released by the next chain change, so the audio thread never
+     * drops the last reference to an effect.
      */
     void clearEffects();
 
     /**
      * @brief Sets the waveform generator
      * @param waveform Shared pointer to a waveform generator implementing the IWave interface
+     *
+     * Used by both oscillators. This and the other voice and master bus
+     * setters below are queued like addEffect(); replaced waveforms are
+     * released on a control thread.
      */
     void setWaveform(std::shared_ptr<IWave> waveform);
     void configureSecondaryOscillator(bool enabled, float mix, float detuneCents, int octaveOffset);
     void setSecondaryWaveform(std::shared_ptr<IWave> waveform);
     void setPitchBend(int value);
 
+    /**
+     * @brief Replace the oscillators with a granular voice source
+     * @param source Granular source to render notes with. Pass nullptr to return to the oscillators.
+     * @return false if too many control changes are pending
+     *
+     * The source is gated by the ADSR envelope and receives the modulated note
+     * frequency, so drift, jitter and pitch bend apply to newly spawned grains.
+     * Queued like addEffect(); the audio thread sets the source's sample rate
+     * and resets it as it takes over, and the source it replaces is released
+     * on a control thread.
+     */
+    bool setGranularSource(std::shared_ptr<GranularSource> source);
+
+    /**
+     * @brief Give a granular source a new sample and switch it to BufferMode::Sample
+     * @param source Source to load; it need not be the one rendering
+     * @param samples Mono sample data
+     * @param sourceSampleRate Sample rate the data was recorded at
+     * @param rootFrequency Pitch of the material in Hz
+     * @return false if the source is null or too many control changes are pending
+     *
+     * The buffer is built on the calling thread and swapped in by the audio
+     * thread at the start of a quantum (see GranularSource::adoptSample());
+     * the sample it replaces is released on a control thread.
+     */
+    bool loadGranularSample(std::shared_ptr<GranularSource> source, const std::vector<float>& samples,
+                            float sourceSampleRate, float rootFrequency = 261.625565f);
+
+    /**
+     * @brief Give a time-stretch player a new sample and stop its playback
+     * @param effect Player to load; it need not be in the chain
+     * @param samples Mono sample data
+     * @param sourceSampleRate Sample rate the data was recorded at
+     * @return false if the effect is null or too many control changes are pending
+     *
+     * The sample is resampled on the calling thread and swapped in by the
+     * audio thread (see TimeStretchEffect::adoptSample()). If the player's
+     * worker is computing a frame at that moment, the swap waits for a later
+     * quantum. The sample it replaces is released on a control thread.
+     */
+    bool loadTimeStretchSample(std::shared_ptr<TimeStretchEffect> effect, const std::vector<float>& samples,
+                               float sourceSampleRate);
+
+    /**
+     * @brief Give a vocoder a new modulator sample and switch it to ModulatorSource::Sample
+     * @param effect Vocoder to load; it need not be in the chain
+     * @param samples Mono sample data
+     * @param sourceSampleRate Sample rate the data was recorded at
+     * @return false if the effect is null or too many control changes are pending
+     *
+     * Resampled on the calling thread and swapped in by the audio thread (see
+     * VocoderEffect::adoptModulator()); the modulator it replaces is released
+     * on a control thread.
+     */
+    bool loadVocoderModulator(std::shared_ptr<VocoderEffect> effect, const std::vector<float>& samples,
+                              float sourceSampleRate);
+
+    /**
+     * @brief Change a vocoder's band count and clear its state
+     * @param effect Vocoder to configure; it need not be in the chain
+     * @param bandCount Bands, clamped to the vocoder's range
+     * @return false if the effect is null or too many control changes are pending
+     *
+     * Applied by the audio thread (see VocoderEffect::setBandCount()), so the
+     * banks are never rewritten while the chain is processing them.
+     */
+    bool configureVocoder(std::shared_ptr<VocoderEffect> effect, std::size_t bandCount);
+
     /**
      * @brief Apply a configuration to choose waveform and effect chain
      *
@@ -98,6 +378,17 @@ public:
      */
     void configure(const AudioConfig& config);
 
+    /**
+     * @brief Switch to another configuration while audio is running
+     *
+     * Same as configure(), except that the limiter lookahead is kept
+     * (resizing its delay line allocates on the audio thread's state);
+     * sample rate, buffer size and device settings are ignored. Waveforms
+     * and effects are built on the calling thread; every change reaches the
+     * audio thread as a queued command, like the setters it calls.
+     */
+    void applyPreset(const AudioConfig& config);
+
     /**
      * @brief Update effect parameters without recreating the effects chain
      * @param effectName Name of the effect to update
@@ -106,6 +397,25 @@ public:
      */
     bool updateEffectParameters(const std::string& effectName, const IEffectParameters& parameters);
 
+    /**
+     * @brief Bypass or re-enable every effect in the chain matching a name
+     * @param effectName Effect name as accepted by configure() (case-insensitive)
+     * @param bypassed true to take the effect out of the signal path
+     * @param keepWarm Keep running the effect while bypassed so its state stays current
+     * @return true if at least one effect matched
+     *
+     * The switch crossfades over about 10 ms. The effect keeps its buffers and
+     * settings, so toggling never reallocates; a bypassed effect that is not
+     * kept warm costs nothing and is reset when it comes back.
+     */
+    bool setEffectBypass(const std::string& effectName, bool bypassed, bool keepWarm = false);
+
+    /**
+     * @brief Check whether the first effect matching a name is bypassed
+     * @return true if a matching effect exists and is bypassed
+     */
+    bool isEffectBypassed(const std::string& effectName) const;
+
     /**
      * @brief Update ADSR envelope parameters
      * @param attackTime Attack time in seconds
@@ -129,6 +439,17 @@ public:
      */
     void setWaveformTapBuffer(StereoSampleRingBuffer* tap);
 
+    /**
+     * @brief Attach a shared parameter block the audio thread polls once per quantum
+     * @param block Block owned elsewhere. Pass nullptr to detach. Attach or
+     *        detach only while no block is being rendered.
+     *
+     * Parameters flagged in the block glide to their new value with a 20 ms
+     * time constant, updated at block rate, so a UI can move continuous
+     * controls without any native call per value.
+     */
+    void setParameterBlock(ParameterBlock* block);
+
     /**
      * @brief Update the cutoff of any active low-pass filter effect
      * @param cutoffHz New cutoff frequency in Hertz
@@ -146,29 +467,170 @@ public:
      */
     bool hasLowPassEffect() const;
 
+    /**
+     * @brief Engage or release every spectral freeze effect in the chain
+     * @param frozen true to capture and hold the current spectrum
+     * @return true if at least one freeze effect was found
+     */
+    bool setSpectralFreeze(bool frozen);
+
+    /**
+     * @brief Configure the master bus compressor
+     * @param enabled Whether the compressor processes the output
+     * @param thresholdDb Threshold in dBFS
+     * @param ratio Ratio above the threshold
+     * @param attackMs Attack time in milliseconds
+     * @param releaseMs Release time in milliseconds
+     * @param makeupDb Makeup gain in dB
+     */
+    void configureCompressor(bool enabled, float thresholdDb, float ratio, float attackMs, float releaseMs, float makeupDb);
+
+    /**
+     * @brief Configure the master bus lookahead limiter
+     * @param enabled Whether the limiter reduces gain (its delay stays in the path)
+     * @param ceilingDb Maximum true-peak output level in dBFS
+     * @param releaseMs Release time in milliseconds
+     */
+    void configureLimiter(bool enabled, float ceilingDb, float releaseMs);
+
+    /**
+     * @brief Delay added by the master bus in frames
+     *
+     * The limiter lookahead delays everything the engine outputs. Report it
+     * alongside the device latency when aligning against the output.
+     */
+    unsigned int masterLatencyFrames() const;
+
+    /**
+     * @brief Frames live input is held back to fill whole quanta
+     *
+     * 0 while device blocks are multiples of kQuantumFrames; otherwise it
+     * settles below kQuantumFrames within the first few blocks (audio thread).
+     */
+    unsigned int inputDelayFrames() const { return m_inputDelayFrames; }
+
+    /**
+     * @brief Combined compressor and limiter gain reduction over the last block, in dB
+     */
+    float masterGainReductionDb() const;
+
+    /**
+     * @brief Configure the load governor (see LoadGovernor)
+     *
+     * Queued like addEffect(). While enabled, blocks that come close to
+     * their deadline make the engine shed work in the configured order
+     * instead of running late; the work comes back once the load drops.
+     * Shed and restore counts are reported in the telemetry.
+     * @return false if the change could not be queued
+     */
+    bool configureGovernor(const LoadGovernor::Settings& settings);
+
+    /**
+     * @brief Governor settings from the configuration's <governor> section
+     *
+     * Unknown action names are skipped.
+     */
+    static LoadGovernor::Settings governorSettingsFromConfig(const AudioConfig& config);
+
+    /**
+     * @brief Limit the bytes the engine may hold (see MemoryTelemetry)
+     * @param bytes Budget; 0 removes the limit
+     *
+     * Checked by addEffect(): an effect that would take the engine over the
+     * budget is refused and counted instead of inserted. Lowering the budget
+     * below current use removes nothing.
+     */
+    void setMemoryBudget(std::size_t bytes);
+
+    std::size_t memoryBudget() const;
+
+    /**
+     * @brief Bytes the engine holds by component, counting queued chain changes (control threads)
+     *
+     * The telemetry carries the same figures for the chain the audio thread
+     * last rendered.
+     */
+    MemoryTelemetry memoryUsage() const;
+
+    /**
+     * @brief What the latest block did, for the device's flight recorder
+     */
+    struct BlockStats
+    {
+        std::uint32_t commands = 0;         ///< Control commands applied, timed ones included
+        std::uint32_t midiEvents = 0;       ///< Of those, the ones posted under a MidiInputScope
+        std::uint32_t voices = 0;           ///< Voices sounding at the end of the block
+        std::uint32_t grains = 0;           ///< Granular grains sounding at the end of the block
+        std::uint32_t governorLevel = 0;    ///< Load governor steps shed
+    };
+
+    /**
+     * @brief Stats of the latest block (audio thread, after renderBlock())
+     */
+    const BlockStats& blockStats() const { return m_blockStats; }
+
+    /**
+     * @class MidiInputScope
+     * @brief Marks the commands the calling thread posts while in scope as MIDI input
+     *
+     * Used by the MIDI adapter so BlockStats can tell MIDI events apart
+     * from other control changes. Scopes nest.
+     */
+    class MidiInputScope
+    {
+    public:
+        MidiInputScope();
+        ~MidiInputScope();
+        MidiInputScope(const MidiInputScope&) = delete;
+        MidiInputScope& operator=(const MidiInputScope&) = delete;
+
+    private:
+        bool m_previous;
+    };
+
 private:
     float m_frequency;                                ///< Current note frequency in Hz
     float m_sampleRate;                               ///< Audio sample rate in Hz
     float m_primaryPhase;                             ///< Current phase of the primary oscillator (0.0 to 1.0)
     float m_secondaryPhase;                           ///< Current phase of the secondary oscillator (0.0 to 1.0)
     bool m_noteOn;                                    ///< Flag indicating whether a note is currently playing
-    std::vector<std::shared_ptr<IEffect>> m_effects;  ///< Chain of audio effects to apply
+    std::vector<std::shared_ptr<EffectSlot>> m_effects; ///< Chain the audio thread renders, each effect with its bypass state
+    std::vector<std::shared_ptr<EffectSlot>> m_chain;   ///< Control-side copy of the chain, including queued changes
     std::shared_ptr<IWave> m_primaryWaveform;         ///< Primary waveform generator
     std::shared_ptr<IWave> m_secondaryWaveform;       ///< Secondary waveform generator
     std::unique_ptr<ADSREnvelope> m_envelope;         ///< ADSR envelope for amplitude modulation
+    std::shared_ptr<GranularSource> m_granularSource; ///< Optional granular voice source replacing the oscillators (audio thread)
+    std::shared_ptr<GranularSource> m_granularChain;  ///< Control-side copy of m_granularSource, including queued changes
 
-    struct ActiveNote {
-        float frequency;
-        float detuneCents;
+    /**
+     * @brief Held-note entry, one per (channel, note) key
+     *
+     * Held notes form a doubly linked list in press order through prev/next,
+     * so any note can be released in constant time and the newest held note
+     * is always the tail.
+     */
+    struct HeldNote {
+        float frequency = 0.0f;
+        float detuneCents = 0.0f;
+        int prev = -1;
+        int next = -1;
+        bool held = false;
     };
 
-    std::vector<ActiveNote> m_activeNotes;            ///< Stack of active note metadata for legato handling
+    using TuningTable = std::array<float, kMidiNotes>;
+
+    std::vector<HeldNote> m_heldNotes;                ///< Indexed by channel * kMidiNotes + note, sized once
+    int m_heldHead;                                   ///< Oldest held key, or -1
+    int m_heldTail;                                   ///< Newest held key (the sounding note), or -1
+    int m_heldCount;                                  ///< Keys in the held-note list
+    float m_noteVelocity;                             ///< Gain of the current phrase, from the velocity that started it
+    std::shared_ptr<const TuningTable> m_tuning;      ///< Control side; swapped atomically by setTuningTable()
 
     // Drift / LFO parameters for subtle analog-style modulation
     float m_lfoPhase;                 ///< Normalized [0,1) phase of the drift LFO
     float m_lfoRateHz;                ///< Drift LFO frequency in Hz
     float m_lfoAmountCents;           ///< Peak drift amount in cents
-    float m_noteJitterAmountCents;    ///< Random detune range applied per note in cents
+    float m_noteJitterAmountCents;    ///< Random detune range applied per note in cents (drawn by control threads, under the chain mutex)
     float m_noteDetuneCents;          ///< Random detune assigned to the current note
 
     StereoSampleRingBuffer* m_waveformTap;            ///< Optional capture buffer for visualization
@@ -177,8 +639,261 @@ private:
     float m_secondaryMix;                             ///< Mix amount for the secondary oscillator [0.0-1.0]
     float m_secondaryDetuneCents;                     ///< Positive detune amount applied to the secondary oscillator
     int m_secondaryOctaveOffset;                      ///< Octave shift applied to the secondary oscillator (-2 to +2)
-    float m_pitchBendCents;                           ///< Pitch bend offset in cents (-50 to +50)
+    float m_pitchBendCents;                           ///< Pitch bend offset in cents (-100 to +100, one semitone)
 
     bool m_lowPassActive;                             ///< Whether a low-pass effect is present in the chain
     float m_lastLowPassCutoff;                        ///< Last applied low-pass cutoff frequency
+
+    LiveInputMode m_liveInputMode;                    ///< Routing of device input in renderBlock()
+    LiveInputMode m_requestedLiveInputMode;           ///< Control-side copy of m_liveInputMode, including queued changes (under the chain mutex)
+    float m_liveInputGain;                            ///< Gain applied to live input when it is heard
+    std::vector<VocoderEffect*> m_liveModulated;      ///< Per chain slot: its vocoder, or nullptr; refreshed on chain changes
+
+    ParameterBlock* m_parameterBlock;                 ///< Optional shared controller values
+    std::array<float, ParameterBlock::kCount> m_parameterTargets{};  ///< Latest values read from the block
+    std::uint32_t m_parameterGliding;                 ///< Bits of parameters still moving toward their target
+    std::vector<LowPassEffect*> m_lowPassFilters;     ///< Low-pass effects in the chain, refreshed on chain changes
+
+    Compressor m_compressor;                          ///< Master bus compressor
+    LookaheadLimiter m_limiter;                       ///< Master bus limiter, last stage before the device
+
+    /**
+     * @brief Voice or effect chain change posted by a control thread
+     */
+    struct ControlCommand
+    {
+        enum class Type
+        {
+            NoteOn,              ///< key; values: frequency, detune cents, LFO start phase, velocity
+            NoteOff,             ///< key
+            AllNotesOff,
+            PitchBend,           ///< values: bend in cents
+            EnvelopeParameters,  ///< values: attack, decay, sustain, release
+            AddEffect,
+            ClearEffects,
+            ResetEffects,
+            GovernorSettings,    ///< key: packed order; values: enabled, high load, low load, restore seconds
+            GranularSource,      ///< granular: source to render with, or null for the oscillators
+            GranularSample,      ///< granular, sample; values: source sample rate, root frequency
+            TimeStretchSample,   ///< effect (a TimeStretchEffect), sample
+            VocoderModulator,    ///< effect (a VocoderEffect), sample
+            VocoderBands,        ///< effect (a VocoderEffect); key: band count
+            Waveform,            ///< waveform, secondaryWaveform: replacements, or null to keep the current one
+            SecondaryOscillator, ///< key: enabled; values: mix, detune cents, octave offset
+            Drift,               ///< values: LFO rate, LFO amount cents
+            Compressor,          ///< key: enabled; values: threshold dB, ratio, attack ms, release ms, makeup dB
+            Limiter,             ///< key: enabled; values: ceiling dB, release ms
+            LiveInput            ///< key: LiveInputMode; values: gain
+        };
+
+        Type type = Type::ResetEffects;
+        int key = -1;                       ///< Held-note key (NoteOn/NoteOff)
+        std::uint64_t frame = 0;            ///< Render frame to apply at; 0 applies at the next block
+        std::array<float, 5> values{};
+        std::shared_ptr<EffectSlot> slot;   ///< Slot to append (AddEffect only)
+        std::shared_ptr<GranularSource> granular;
+        std::shared_ptr<IEffect> effect;                ///< Effect a sample is loaded into
+        std::shared_ptr<IWave> waveform;
+        std::shared_ptr<IWave> secondaryWaveform;
+        std::shared_ptr<std::vector<float>> sample;     ///< Prepared buffer; carries the replaced one back
+        bool fromMidi = false;              ///< Posted under a MidiInputScope
+    };
+
+    using ControlCommandQueue = CommandQueue<ControlCommand, kCommandCapacity>;
+    using RetiredQueue = CommandQueue<std::shared_ptr<void>, 2 * kCommandCapacity>;
+
+    std::unique_ptr<ControlCommandQueue> m_commands;     ///< Control threads -> audio thread
+    std::unique_ptr<RetiredQueue> m_retired;             ///< Slots, sources and buffers the audio thread let go, released off it
+    std::unique_ptr<std::mutex> m_chainMutex;            ///< Serializes control threads editing m_chain (never taken by the audio thread)
+    std::unique_ptr<AudioClock> m_clock;                 ///< Published at the start of every block
+    std::uint64_t m_renderedFrames;                      ///< Frames rendered so far, including the kept part of a quantum (audio thread)
+    std::uint64_t m_deliveredFrames;                     ///< Frames handed to the device so far (audio thread)
+    std::unique_ptr<TripleBuffer<EngineTelemetry>> m_telemetry;  ///< Audio thread -> one reader at a time
+    std::unique_ptr<std::mutex> m_telemetryMutex;        ///< Serializes telemetry() readers (never taken by the audio thread)
+    std::vector<ControlCommand> m_scheduled;             ///< Timed commands not yet due, latest first (audio thread)
+    std::vector<ControlCommand> m_deferredLoads;         ///< Sample loads waiting for a spectral worker's frame, oldest first (audio thread)
+
+    std::vector<float> m_chunkLeft;                      ///< Stage buffer, left channel, one quantum (audio thread)
+    std::vector<float> m_chunkRight;                     ///< Stage buffer, right channel, one quantum (audio thread)
+    std::vector<float> m_chunkLive;                      ///< Mono live input of the quantum, for live-modulated vocoders
+    std::vector<float> m_quantumOutput;                  ///< Last quantum rendered, interleaved, when the device took only part of it
+    unsigned int m_quantumOutputFill;                    ///< Frames at the end of m_quantumOutput not yet played
+    std::vector<float> m_quantumInput;                   ///< Live input gathered for the next quantum, interleaved
+    unsigned int m_quantumInputFill;                     ///< Frames in m_quantumInput
+    unsigned int m_quantumInputChannels;                 ///< Channels per frame in m_quantumInput
+    unsigned int m_inputDelayFrames;                     ///< Silence inserted ahead of live input so quanta fill
+    CpuMeter m_voiceMeter;                               ///< Render time of renderVoiceStage() (audio thread)
+    CpuMeter m_masterMeter;                              ///< Render time of processMasterBus() (audio thread)
+    float m_meterAverageDecay;                           ///< CpuMeter weights for one quantum
+    float m_meterPeakDecay;
+
+    LoadGovernor m_governor;                             ///< Sheds work under load (audio thread)
+    std::array<std::uint32_t, LoadGovernor::kActions> m_shedDepth{};  ///< Steps of each action currently shed
+    std::uint32_t m_shedSequence;                        ///< Last sequence given to a shed effect slot
+
+    /**
+     * @brief Memory budget shared by control threads and the telemetry
+     */
+    struct MemoryLimit
+    {
+        std::atomic<std::uint64_t> budget{0};           ///< 0 = unlimited
+        std::atomic<std::uint32_t> rejected{0};         ///< Insertions refused
+    };
+    std::unique_ptr<MemoryLimit> m_memoryLimit;
+    BlockStats m_blockStats;                             ///< Stats of the latest block (audio thread)
+
+    /**
+     * @brief Render the synth voice (oscillators or granular source) before effects
+     */
+    std::pair<float, float> renderVoice();
+
+    /**
+     * @brief Render one quantum: commands, voice, effects, master bus and meters
+     * @param input kQuantumFrames frames of interleaved live input, or nullptr
+     * @param output Receives kQuantumFrames interleaved stereo frames
+     */
+    void renderQuantum(const float* input, unsigned int inputChannels, float* output);
+
+    /**
+     * @brief Render a quantum of voice and live input into the stage buffers
+     * @param firstFrame Clock frame of the quantum's first frame, for timed commands
+     */
+    void renderVoiceStage(const float* input, unsigned int inputChannels, std::uint64_t firstFrame);
+
+    /**
+     * @brief Run the stage buffers through each effect in chain order
+     * @param liveInput Whether m_chunkLive holds input for live-modulated vocoders
+     * @param mono Whether both stage buffers hold the same signal; the
+     *             leading effects that preserve mono then only process m_chunkLeft
+     */
+    void renderEffectStage(bool liveInput, bool mono);
+
+    /**
+     * @brief Add a device block's live input to m_quantumInput
+     * @return Frames taken, at most what completes the quantum
+     */
+    unsigned int gatherInput(const float* input, unsigned int inputChannels, unsigned int frames);
+
+    /**
+     * @brief Run a rendered block through the master dynamics and the waveform tap
+     */
+    void processMasterBus(float* output, unsigned int frames);
+
+    /**
+     * @brief Feed the load of the frames a block rendered to the governor and carry out its decision (audio thread)
+     */
+    void governLoad(unsigned int frames, std::int64_t startNanos);
+
+    /**
+     * @brief Apply or undo one governor action (audio thread)
+     */
+    void shedWork(LoadGovernor::Action action, bool shed);
+
+    /**
+     * @brief Hand one mono live input sample to the granular live buffer
+     *
+     * Vocoders using a live modulator are fed from m_chunkLive by renderEffectStage().
+     */
+    void feedLiveInput(float sample);
+
+    /**
+     * @brief Rebuild cached effect lookups after the chain changes
+     */
+    void refreshEffectRoutes();
+
+    /**
+     * @brief Queue a control change, releasing retired slots first
+     * @return false if the queue is full
+     */
+    bool postCommand(ControlCommand command);
+
+    /**
+     * @brief Apply queued control changes (audio thread, start of each block)
+     */
+    void applyCommands();
+
+    /**
+     * @brief Apply one control change (audio thread)
+     * @return true if the effect chain changed
+     */
+    bool applyCommand(ControlCommand& command);
+
+    /**
+     * @brief Swap in deferred sample loads whose worker has finished its frame (audio thread)
+     */
+    void applyDeferredLoads();
+
+    /**
+     * @brief Hold a timed command until its frame comes up (audio thread)
+     */
+    void scheduleCommand(ControlCommand& command);
+
+    /**
+     * @brief Apply held timed commands due at or before a frame (audio thread)
+     */
+    void applyScheduledCommands(std::uint64_t frame);
+
+    /**
+     * @brief Publish the state after a block (audio thread)
+     */
+    void publishTelemetry(const float* output, unsigned int frames, std::uint64_t blockStart, std::int64_t startNanos);
+
+    /**
+     * @brief Count the bytes held with a given chain and granular source
+     *
+     * m_effects and m_granularSource on the audio thread, m_chain and
+     * m_granularChain under the chain mutex. Reads sizes only; never
+     * allocates or locks.
+     */
+    MemoryTelemetry measureMemory(const std::vector<std::shared_ptr<EffectSlot>>& chain, const GranularSource* granular) const;
+
+    /**
+     * @brief Read flagged parameters and advance their glide (audio thread, once per quantum)
+     */
+    void pollParameterBlock(unsigned int frames);
+
+    /**
+     * @brief Current engine value of a block parameter (audio thread)
+     */
+    float parameterValue(ParameterBlock::Id id) const;
+
+    /**
+     * @brief Apply a block parameter to the engine (audio thread)
+     */
+    void applyParameter(ParameterBlock::Id id, float value);
+
+    /**
+     * @brief Queue a note on for a held-note key with a resolved frequency
+     */
+    void postNoteOn(std::uint64_t frame, int key, float frequency, float velocity);
+
+    /**
+     * @brief Start or retrigger a note (audio thread)
+     */
+    void applyNoteOn(int key, float frequency, float detuneCents, float lfoPhase, float velocity);
+
+    /**
+     * @brief Release a note and fall back to the previous held one (audio thread)
+     */
+    void applyNoteOff(int key);
+
+    /**
+     * @brief Release every held note and drop pending timed notes (audio thread)
+     */
+    void applyAllNotesOff();
+
+    /**
+     * @brief Remove a key from the held-note list (audio thread)
+     */
+    void unlinkHeldNote(int key);
+
+    /**
+     * @brief Hand an object the audio thread no longer uses to the control threads for release (audio thread)
+     */
+    void retire(std::shared_ptr<void> object);
+
+    /**
+     * @brief Drop the objects the audio thread has retired (control threads)
+     */
+    void releaseRetired();
 };
@@ -0,0 +1,89 @@
+#include "CpuFeatures.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace
+{
+CpuFeatures detectFeatures()
+{
+    CpuFeatures features{false, false, false, false, false};
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    // __builtin_cpu_supports also checks that the OS saves the wider registers
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2") != 0;
+    features.avx = __builtin_cpu_supports("avx") != 0;
+    features.avx2 = __builtin_cpu_supports("avx2") != 0;
+    features.fma = __builtin_cpu_supports("fma") != 0;
+    features.avx512f = __builtin_cpu_supports("avx512f") != 0;
+#endif
+
+    return features;
+}
+}
+
+const CpuFeatures& cpuFeatures()
+{
+    static const CpuFeatures features = detectFeatures();
+    return features;
+}
+
+SimdLevel detectedSimdLevel()
+{
+    const CpuFeatures& features = cpuFeatures();
+    if (features.avx512f && features.avx2 && features.fma)
+    {
+        return SimdLevel::Avx512;
+    }
+    if (features.avx2 && features.fma)
+    {
+        return SimdLevel::Avx2;
+    }
+    if (features.sse2)
+    {
+        return SimdLevel::Sse2;
+    }
+    return SimdLevel::Scalar;
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Sse2:
+        return "sse2";
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Avx512:
+        return "avx512";
+    case SimdLevel::Scalar:
+    default:
+        return "scalar";
+    }
+}
+
+bool simdLevelFromName(const char* name, SimdLevel& level)
+{
+    if (name == nullptr)
+    {
+        return false;
+    }
+
+    char lower[16] = {};
+    for (std::size_t i = 0; i + 1U < sizeof(lower) && name[i] != '\0'; ++i)
+    {
+        lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+    }
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2, SimdLevel::Avx512};
+    for (SimdLevel candidate : levels)
+    {
+        if (std::strcmp(lower, simdLevelName(candidate)) == 0)
+        {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
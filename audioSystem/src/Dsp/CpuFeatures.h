@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * @file CpuFeatures.h
+ * @brief Runtime detection of the SIMD extensions the host CPU supports
+ *
+ * Release builds target the baseline x86-64 instruction set so one binary
+ * runs everywhere. Kernels that can use wider registers are compiled for
+ * several levels (see SimdKernels.h) and the best supported one is chosen
+ * once at startup from the values reported here.
+ */
+
+/**
+ * @enum SimdLevel
+ * @brief Instruction set tiers the DSP kernels are built for, in increasing order
+ */
+enum class SimdLevel
+{
+    Scalar,   ///< Portable C++ (non-x86 hosts)
+    Sse2,     ///< 4-wide, x86-64 baseline
+    Avx2,     ///< 8-wide with FMA
+    Avx512    ///< 16-wide (AVX-512F)
+};
+
+/**
+ * @struct CpuFeatures
+ * @brief Extensions usable on this machine (CPU and operating system support)
+ */
+struct CpuFeatures
+{
+    bool sse2;
+    bool avx;
+    bool avx2;
+    bool fma;
+    bool avx512f;
+};
+
+/**
+ * @brief Features of the host CPU, detected on first call
+ */
+const CpuFeatures& cpuFeatures();
+
+/**
+ * @brief Highest SimdLevel the host supports
+ */
+SimdLevel detectedSimdLevel();
+
+/**
+ * @brief Lowercase name of a level ("scalar", "sse2", "avx2", "avx512")
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief Parse a level name as printed by simdLevelName()
+ * @param name Level name (case-insensitive)
+ * @param level Receives the parsed level
+ * @return false if the name is not recognised
+ */
+bool simdLevelFromName(const char* name, SimdLevel& level);
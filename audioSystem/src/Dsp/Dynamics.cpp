@@ -0,0 +1,416 @@
+#include "Dynamics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+constexpr float kDbToLog = 0.11512925464970229f;   // ln(10) / 20
+
+template <typename T>
+inline T clampValue(T value, T low, T high)
+{
+    return (value < low) ? low : (value > high ? high : value);
+}
+
+inline float dbToGain(float db)
+{
+    return std::exp(db * kDbToLog);
+}
+
+inline float gainToDb(float gain)
+{
+    return 20.0f * std::log10(std::max(gain, 1e-9f));
+}
+
+float smoothingCoefficient(float seconds, float sampleRate)
+{
+    const float samples = std::max(seconds * sampleRate, 1.0f);
+    return 1.0f - std::exp(-1.0f / samples);
+}
+}
+
+constexpr std::size_t Compressor::kBlockFrames;
+constexpr std::size_t LookaheadLimiter::kBlockFrames;
+constexpr std::size_t LookaheadLimiter::kOversample;
+constexpr std::size_t LookaheadLimiter::kInterpolatorTaps;
+constexpr std::size_t LookaheadLimiter::kInterpolatorDelay;
+
+// -----------------------------------------------------------------------------
+// Compressor implementation
+// -----------------------------------------------------------------------------
+
+Compressor::Compressor(float sampleRate)
+    : m_kernels(&simdKernels())
+    , m_enabled(false)
+    , m_sampleRate(std::max(sampleRate, 100.0f))
+    , m_thresholdDb(-18.0f)
+    , m_ratio(3.0f)
+    , m_kneeDb(6.0f)
+    , m_attackSeconds(0.01f)
+    , m_releaseSeconds(0.12f)
+    , m_makeupDb(0.0f)
+    , m_attackCoeff(1.0f)
+    , m_releaseCoeff(1.0f)
+    , m_reductionDb(0.0f)
+    , m_lastReductionDb(0.0f)
+    , m_detector()
+    , m_gain()
+{
+    updateCoefficients();
+}
+
+void Compressor::process(float* interleaved, std::size_t frames)
+{
+    m_lastReductionDb = 0.0f;
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    while (frames > 0U)
+    {
+        const std::size_t chunk = std::min(frames, kBlockFrames);
+        processChunk(interleaved, chunk);
+        interleaved += 2U * chunk;
+        frames -= chunk;
+    }
+}
+
+void Compressor::processChunk(float* interleaved, std::size_t frames)
+{
+    m_kernels->linkedPeaks(interleaved, m_detector.data(), frames);
+
+    // Levels below the knee never reduce gain, so skip the log for them
+    const float kneeStart = dbToGain(m_thresholdDb - 0.5f * m_kneeDb);
+    const float makeup = dbToGain(m_makeupDb);
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        const float level = m_detector[i];
+        const float target = level > kneeStart ? computeReduction(gainToDb(level)) : 0.0f;
+        const float coeff = target > m_reductionDb ? m_attackCoeff : m_releaseCoeff;
+        m_reductionDb += coeff * (target - m_reductionDb);
+
+        m_gain[i] = m_reductionDb > 1e-4f ? dbToGain(m_makeupDb - m_reductionDb) : makeup;
+        m_lastReductionDb = std::max(m_lastReductionDb, m_reductionDb);
+    }
+
+    m_kernels->applyStereoGain(interleaved, m_gain.data(), frames);
+}
+
+float Compressor::computeReduction(float levelDb) const
+{
+    const float over = levelDb - m_thresholdDb;
+    const float slope = 1.0f - 1.0f / m_ratio;
+
+    if (2.0f * over <= -m_kneeDb)
+    {
+        return 0.0f;
+    }
+
+    if (2.0f * std::fabs(over) < m_kneeDb)
+    {
+        const float kneeOver = over + 0.5f * m_kneeDb;
+        return slope * kneeOver * kneeOver / (2.0f * m_kneeDb);
+    }
+
+    return slope * over;
+}
+
+void Compressor::reset()
+{
+    m_reductionDb = 0.0f;
+    m_lastReductionDb = 0.0f;
+}
+
+void Compressor::setSampleRate(float sampleRate)
+{
+    m_sampleRate = std::max(sampleRate, 100.0f);
+    updateCoefficients();
+}
+
+void Compressor::setThreshold(float thresholdDb)
+{
+    m_thresholdDb = clampValue(thresholdDb, -60.0f, 0.0f);
+}
+
+void Compressor::setRatio(float ratio)
+{
+    m_ratio = clampValue(ratio, 1.0f, 20.0f);
+}
+
+void Compressor::setKnee(float kneeDb)
+{
+    m_kneeDb = clampValue(kneeDb, 0.0f, 24.0f);
+}
+
+void Compressor::setTimes(float attackSeconds, float releaseSeconds)
+{
+    m_attackSeconds = clampValue(attackSeconds, 0.0001f, 0.5f);
+    m_releaseSeconds = clampValue(releaseSeconds, 0.005f, 5.0f);
+    updateCoefficients();
+}
+
+void Compressor::setMakeupGain(float makeupDb)
+{
+    m_makeupDb = clampValue(makeupDb, 0.0f, 24.0f);
+}
+
+void Compressor::updateCoefficients()
+{
+    m_attackCoeff = smoothingCoefficient(m_attackSeconds, m_sampleRate);
+    m_releaseCoeff = smoothingCoefficient(m_releaseSeconds, m_sampleRate);
+}
+
+// -----------------------------------------------------------------------------
+// LookaheadLimiter implementation
+// -----------------------------------------------------------------------------
+
+LookaheadLimiter::LookaheadLimiter(float sampleRate, float lookaheadSeconds)
+    : m_kernels(&simdKernels())
+    , m_enabled(true)
+    , m_truePeak(true)
+    , m_truePeakSuspended(false)
+    , m_sampleRate(44100.0f)
+    , m_ceilingDb(-1.0f)
+    , m_ceiling(dbToGain(-1.0f))
+    , m_releaseSeconds(0.05f)
+    , m_releaseCoeff(1.0f)
+    , m_lastReductionDb(0.0f)
+    , m_lookahead(1U)
+    , m_delayFrames(0U)
+    , m_historyPosition(0U)
+    , m_previousInterSample(0.0f)
+    , m_dequeHead(0U)
+    , m_dequeSize(0U)
+    , m_frameIndex(0U)
+    , m_releasedGain(1.0f)
+    , m_boxPosition(0U)
+    , m_boxSum(0.0)
+    , m_delayPosition(0U)
+    , m_gain()
+{
+    buildInterpolator();
+    configure(sampleRate, lookaheadSeconds);
+}
+
+void LookaheadLimiter::configure(float sampleRate, float lookaheadSeconds)
+{
+    m_sampleRate = std::max(sampleRate, 100.0f);
+    const float seconds = clampValue(lookaheadSeconds, 0.0005f, 0.02f);
+    m_lookahead = std::max<std::size_t>(1U, static_cast<std::size_t>(std::lround(seconds * m_sampleRate)));
+
+    // The box filter lands on the peak after m_lookahead - 1 frames, and the
+    // interpolator looks kInterpolatorDelay frames past the frame it reports
+    m_delayFrames = m_lookahead - 1U + kInterpolatorDelay;
+
+    m_dequeIndex.assign(m_lookahead, 0U);
+    m_dequeGain.assign(m_lookahead, 1.0f);
+    m_boxHistory.assign(m_lookahead, 1.0f);
+    m_delayLine.assign(2U * m_delayFrames, 0.0f);
+    m_releaseCoeff = smoothingCoefficient(m_releaseSeconds, m_sampleRate);
+
+    reset();
+}
+
+void LookaheadLimiter::reset()
+{
+    std::fill(std::begin(m_historyLeft), std::end(m_historyLeft), 0.0f);
+    std::fill(std::begin(m_historyRight), std::end(m_historyRight), 0.0f);
+    m_historyPosition = 0U;
+    m_previousInterSample = 0.0f;
+
+    m_dequeHead = 0U;
+    m_dequeSize = 0U;
+    m_frameIndex = 0U;
+
+    m_releasedGain = 1.0f;
+    std::fill(m_boxHistory.begin(), m_boxHistory.end(), 1.0f);
+    m_boxPosition = 0U;
+    m_boxSum = static_cast<double>(m_lookahead);
+
+    std::fill(m_delayLine.begin(), m_delayLine.end(), 0.0f);
+    m_delayPosition = 0U;
+    m_lastReductionDb = 0.0f;
+}
+
+void LookaheadLimiter::setCeiling(float ceilingDb)
+{
+    m_ceilingDb = clampValue(ceilingDb, -24.0f, 0.0f);
+    m_ceiling = dbToGain(m_ceilingDb);
+}
+
+void LookaheadLimiter::setRelease(float releaseSeconds)
+{
+    m_releaseSeconds = clampValue(releaseSeconds, 0.001f, 2.0f);
+    m_releaseCoeff = smoothingCoefficient(m_releaseSeconds, m_sampleRate);
+}
+
+void LookaheadLimiter::process(float* interleaved, std::size_t frames)
+{
+    m_lastReductionDb = 0.0f;
+
+    while (frames > 0U)
+    {
+        const std::size_t chunk = std::min(frames, kBlockFrames);
+        processChunk(interleaved, chunk);
+        interleaved += 2U * chunk;
+        frames -= chunk;
+    }
+}
+
+void LookaheadLimiter::processChunk(float* interleaved, std::size_t frames)
+{
+    float lowestGain = 1.0f;
+
+    if (m_enabled)
+    {
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const float peak = detectPeak(interleaved[2U * i], interleaved[2U * i + 1U]);
+            const float required = peak > m_ceiling ? m_ceiling / peak : 1.0f;
+            m_gain[i] = smoothGain(required);
+            lowestGain = std::min(lowestGain, m_gain[i]);
+        }
+    }
+
+    // Swap the block through the delay line so the gains line up with their peaks
+    const std::size_t delaySamples = m_delayLine.size();
+    for (std::size_t i = 0; i < 2U * frames && delaySamples > 0U; ++i)
+    {
+        std::swap(interleaved[i], m_delayLine[m_delayPosition]);
+        if (++m_delayPosition >= delaySamples)
+        {
+            m_delayPosition = 0U;
+        }
+    }
+
+    if (m_enabled)
+    {
+        m_kernels->applyStereoGain(interleaved, m_gain.data(), frames);
+        // Catches rounding in the gain ramp; a no-op for correctly limited audio
+        m_kernels->clampSamples(interleaved, 2U * frames, m_ceiling);
+        m_lastReductionDb = std::max(m_lastReductionDb, -gainToDb(lowestGain));
+    }
+}
+
+float LookaheadLimiter::detectPeak(float left, float right)
+{
+    // Mirrored history: the newest kInterpolatorTaps samples are always contiguous
+    m_historyLeft[m_historyPosition] = left;
+    m_historyLeft[m_historyPosition + kInterpolatorTaps] = left;
+    m_historyRight[m_historyPosition] = right;
+    m_historyRight[m_historyPosition + kInterpolatorTaps] = right;
+    if (++m_historyPosition >= kInterpolatorTaps)
+    {
+        m_historyPosition = 0U;
+    }
+
+    const float* windowLeft = m_historyLeft + m_historyPosition;
+    const float* windowRight = m_historyRight + m_historyPosition;
+
+    // The reported frame sits kInterpolatorDelay frames behind the newest one
+    const std::size_t centre = kInterpolatorTaps - 1U - kInterpolatorDelay;
+    const float samplePeak = std::max(std::fabs(windowLeft[centre]), std::fabs(windowRight[centre]));
+
+    if (!m_truePeak || m_truePeakSuspended)
+    {
+        m_previousInterSample = 0.0f;
+        return samplePeak;
+    }
+
+    // Interpolated values between the reported frame and the next one
+    float interSample = 0.0f;
+    for (std::size_t phase = 0; phase < kOversample - 1U; ++phase)
+    {
+        float sumLeft = 0.0f;
+        float sumRight = 0.0f;
+        m_kernels->dualDotProduct(m_phases[phase], windowLeft, windowRight, kInterpolatorTaps, &sumLeft, &sumRight);
+        interSample = std::max(interSample, std::max(std::fabs(sumLeft), std::fabs(sumRight)));
+    }
+
+    // Guard each inter-sample peak on the frames either side of it
+    const float peak = std::max(samplePeak, std::max(interSample, m_previousInterSample));
+    m_previousInterSample = interSample;
+    return peak;
+}
+
+float LookaheadLimiter::smoothGain(float required)
+{
+    // Sliding minimum over the last m_lookahead frames (monotonic deque).
+    // Expire first so the push below always has a free slot.
+    if (m_dequeSize > 0U && m_dequeIndex[m_dequeHead] + m_lookahead <= m_frameIndex)
+    {
+        m_dequeHead = m_dequeHead + 1U < m_lookahead ? m_dequeHead + 1U : 0U;
+        --m_dequeSize;
+    }
+
+    while (m_dequeSize > 0U)
+    {
+        std::size_t back = m_dequeHead + m_dequeSize - 1U;
+        back -= back >= m_lookahead ? m_lookahead : 0U;
+        if (m_dequeGain[back] < required)
+        {
+            break;
+        }
+        --m_dequeSize;
+    }
+
+    std::size_t slot = m_dequeHead + m_dequeSize;
+    slot -= slot >= m_lookahead ? m_lookahead : 0U;
+    m_dequeIndex[slot] = m_frameIndex;
+    m_dequeGain[slot] = required;
+    ++m_dequeSize;
+    ++m_frameIndex;
+
+    const float held = m_dequeGain[m_dequeHead];
+
+    // Instant attack, smoothed release; never above the held value
+    if (held < m_releasedGain)
+    {
+        m_releasedGain = held;
+    }
+    else
+    {
+        m_releasedGain += m_releaseCoeff * (held - m_releasedGain);
+    }
+
+    // Box filter: every frame in the window is at or below the peak's gain
+    m_boxSum += static_cast<double>(m_releasedGain) - static_cast<double>(m_boxHistory[m_boxPosition]);
+    m_boxHistory[m_boxPosition] = m_releasedGain;
+    if (++m_boxPosition >= m_lookahead)
+    {
+        m_boxPosition = 0U;
+    }
+
+    return std::min(1.0f, static_cast<float>(m_boxSum / static_cast<double>(m_lookahead)));
+}
+
+void LookaheadLimiter::buildInterpolator()
+{
+    // Windowed-sinc polyphase filters for the fractional positions 1/4, 2/4, 3/4
+    const double centre = static_cast<double>(kInterpolatorTaps - 1U - kInterpolatorDelay);
+    const double halfWidth = 0.5 * static_cast<double>(kInterpolatorTaps) + 0.5;
+
+    for (std::size_t phase = 0; phase < kOversample - 1U; ++phase)
+    {
+        const double fraction = static_cast<double>(phase + 1U) / static_cast<double>(kOversample);
+        double sum = 0.0;
+
+        for (std::size_t k = 0; k < kInterpolatorTaps; ++k)
+        {
+            const double t = static_cast<double>(k) - centre - fraction;
+            const double sinc = std::sin(kPi * t) / (kPi * t);
+            const double window = 0.5 * (1.0 + std::cos(kPi * t / halfWidth));
+            m_phases[phase][k] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+
+        for (std::size_t k = 0; k < kInterpolatorTaps; ++k)
+        {
+            m_phases[phase][k] = static_cast<float>(static_cast<double>(m_phases[phase][k]) / sum);
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "SimdKernels.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file Dynamics.h
+ * @brief Master bus dynamics: a stereo-linked compressor and a true-peak lookahead limiter
+ *
+ * Both processors work on interleaved stereo blocks. Each block is handled in
+ * two passes: a detector pass computes one gain per frame into a scratch
+ * array, then a SIMD pass multiplies the audio by those gains. Blocks longer
+ * than kBlockFrames are split internally, so neither class allocates while
+ * processing.
+ */
+
+/**
+ * @class Compressor
+ * @brief Feed-forward peak compressor with a soft knee, linked across both channels
+ */
+class Compressor
+{
+public:
+    static constexpr std::size_t kBlockFrames = 256;   ///< Frames per internal detector pass
+
+    explicit Compressor(float sampleRate = 44100.0f);
+
+    /**
+     * @brief Process interleaved stereo audio in place
+     * @param interleaved 2 * frames samples
+     * @param frames Number of frames
+     */
+    void process(float* interleaved, std::size_t frames);
+
+    /// Clear the detector state
+    void reset();
+
+    void setSampleRate(float sampleRate);
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    /// Level above which gain reduction starts, in dBFS [-60 - 0]
+    void setThreshold(float thresholdDb);
+    /// Input/output slope above the threshold [1 - 20]
+    void setRatio(float ratio);
+    /// Width of the soft knee in dB [0 - 24]
+    void setKnee(float kneeDb);
+    /// Detector attack and release times in seconds
+    void setTimes(float attackSeconds, float releaseSeconds);
+    /// Gain applied after compression in dB [0 - 24]
+    void setMakeupGain(float makeupDb);
+
+    bool enabled() const { return m_enabled; }
+    float threshold() const { return m_thresholdDb; }
+    float ratio() const { return m_ratio; }
+    /// Largest gain reduction applied during the last processed block, in dB
+    float gainReductionDb() const { return m_lastReductionDb; }
+
+private:
+    void processChunk(float* interleaved, std::size_t frames);
+    /// Static curve: gain reduction in dB for a detector level in dB
+    float computeReduction(float levelDb) const;
+    void updateCoefficients();
+
+    const SimdKernels* m_kernels;   ///< Selected at construction
+    bool m_enabled;
+    float m_sampleRate;
+    float m_thresholdDb;
+    float m_ratio;
+    float m_kneeDb;
+    float m_attackSeconds;
+    float m_releaseSeconds;
+    float m_makeupDb;
+    float m_attackCoeff;
+    float m_releaseCoeff;
+    float m_reductionDb;            ///< Smoothed gain reduction carried across blocks
+    float m_lastReductionDb;
+
+    alignas(16) std::array<float, kBlockFrames> m_detector;   ///< Linked peak per frame
+    alignas(16) std::array<float, kBlockFrames> m_gain;       ///< Linear gain per frame
+};
+
+/**
+ * @class LookaheadLimiter
+ * @brief Brick-wall limiter that keeps the (inter-sample) peak under a ceiling
+ *
+ * The detector estimates inter-sample peaks with a 4x polyphase interpolator,
+ * takes the gain each frame needs to stay under the ceiling, and runs a
+ * sliding-window minimum over the lookahead using a monotonic deque. A box
+ * filter of the same length then turns the held minimum into a ramp that
+ * reaches the required gain exactly when the peak leaves the delay line, so
+ * attacks never overshoot and never click. The audio is delayed by
+ * latencyFrames(), which callers should report to anything that aligns
+ * against the output.
+ */
+class LookaheadLimiter
+{
+public:
+    static constexpr std::size_t kBlockFrames = 256;   ///< Frames per internal detector pass
+    static constexpr std::size_t kOversample = 4;      ///< Inter-sample positions checked per frame
+    static constexpr std::size_t kInterpolatorTaps = 24;
+
+    /**
+     * @brief Construct a limiter
+     * @param sampleRate Sampling rate in Hz
+     * @param lookaheadSeconds Time the gain ramp has to reach a peak [0.0005 - 0.02]
+     */
+    explicit LookaheadLimiter(float sampleRate = 44100.0f, float lookaheadSeconds = 0.0015f);
+
+    /// Resize the lookahead and delay lines. Allocates; call while not rendering.
+    void configure(float sampleRate, float lookaheadSeconds);
+
+    /**
+     * @brief Process interleaved stereo audio in place
+     * @param interleaved 2 * frames samples
+     * @param frames Number of frames
+     */
+    void process(float* interleaved, std::size_t frames);
+
+    /// Clear the delay line and detector state
+    void reset();
+
+    /**
+     * @brief Enable or bypass the gain stage
+     *
+     * The delay line stays in the path when bypassed so the reported latency
+     * does not change while audio is running.
+     */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    /// Maximum output level in dBFS [-24 - 0]
+    void setCeiling(float ceilingDb);
+    /// Time for the gain to recover after a peak, in seconds
+    void setRelease(float releaseSeconds);
+    /// Check inter-sample peaks as well as sample peaks
+    void setTruePeak(bool enabled) { m_truePeak = enabled; }
+    /// Skip the inter-sample check regardless of setTruePeak(), to save CPU (audio thread)
+    void setTruePeakSuspended(bool suspended) { m_truePeakSuspended = suspended; }
+
+    bool enabled() const { return m_enabled; }
+    float ceiling() const { return m_ceilingDb; }
+    /// Delay added to the signal, in frames
+    std::size_t latencyFrames() const { return m_delayFrames; }
+    /// Largest gain reduction applied during the last processed block, in dB
+    float gainReductionDb() const { return m_lastReductionDb; }
+
+    /// Bytes of the lookahead delay line and gain smoothing history
+    std::size_t bufferBytes() const
+    {
+        return m_dequeIndex.capacity() * sizeof(std::uint64_t)
+             + (m_dequeGain.capacity() + m_boxHistory.capacity() + m_delayLine.capacity()) * sizeof(float);
+    }
+
+private:
+    static constexpr std::size_t kInterpolatorDelay = kInterpolatorTaps / 2;
+
+    void processChunk(float* interleaved, std::size_t frames);
+    /// Peak estimate for the frame kInterpolatorDelay frames behind the newest input
+    float detectPeak(float left, float right);
+    /// Sliding minimum, release and box filter for one required-gain value
+    float smoothGain(float required);
+    void buildInterpolator();
+
+    const SimdKernels* m_kernels;   ///< Selected at construction
+    bool m_enabled;
+    bool m_truePeak;
+    bool m_truePeakSuspended;       ///< Set by the load governor
+    float m_sampleRate;
+    float m_ceilingDb;
+    float m_ceiling;
+    float m_releaseSeconds;
+    float m_releaseCoeff;
+    float m_lastReductionDb;
+
+    std::size_t m_lookahead;        ///< Window length of the sliding minimum and box filter
+    std::size_t m_delayFrames;      ///< Audio delay: lookahead plus interpolator delay
+
+    // Inter-sample peak detector
+    alignas(16) float m_phases[kOversample - 1][kInterpolatorTaps];
+    alignas(16) float m_historyLeft[2 * kInterpolatorTaps];   ///< Mirrored so a window is always contiguous
+    alignas(16) float m_historyRight[2 * kInterpolatorTaps];
+    std::size_t m_historyPosition;
+    float m_previousInterSample;    ///< Peak between the previous frame and the current one
+
+    // Monotonic deque of (frame index, required gain), increasing in gain
+    std::vector<std::uint64_t> m_dequeIndex;
+    std::vector<float> m_dequeGain;
+    std::size_t m_dequeHead;
+    std::size_t m_dequeSize;
+    std::uint64_t m_frameIndex;
+
+    float m_releasedGain;           ///< Held minimum after release smoothing
+    std::vector<float> m_boxHistory;
+    std::size_t m_boxPosition;
+    double m_boxSum;
+
+    std::vector<float> m_delayLine; ///< Interleaved stereo, m_delayFrames frames
+    std::size_t m_delayPosition;
+
+    alignas(16) std::array<float, kBlockFrames> m_gain;
+};
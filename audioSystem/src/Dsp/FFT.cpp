@@ -0,0 +1,210 @@
+#include "FFT.h"
+#include "SimdKernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+bool isPowerOfTwo(std::size_t value)
+{
+    return value != 0U && (value & (value - 1U)) == 0U;
+}
+
+std::atomic<std::size_t> g_planBytes{0};   ///< Twiddle bytes of every cached plan
+}
+
+constexpr std::size_t FFTPlan::kMinSize;
+constexpr std::size_t FFTPlan::kMaxSize;
+constexpr std::size_t RealFFT::kMinSize;
+constexpr std::size_t RealFFT::kMaxSize;
+
+// -----------------------------------------------------------------------------
+// FFTPlan implementation
+// -----------------------------------------------------------------------------
+
+bool FFTPlan::isSupportedSize(std::size_t size)
+{
+    return isPowerOfTwo(size) && size >= kMinSize && size <= kMaxSize;
+}
+
+std::size_t FFTPlan::cachedBytes()
+{
+    return g_planBytes.load(std::memory_order_relaxed);
+}
+
+const FFTPlan& FFTPlan::get(std::size_t size)
+{
+    if (!isSupportedSize(size))
+    {
+        throw std::invalid_argument("Unsupported FFT size: " + std::to_string(size));
+    }
+
+    static std::mutex cacheMutex;
+    static std::map<std::size_t, std::unique_ptr<FFTPlan>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(size);
+    if (it == cache.end())
+    {
+        it = cache.emplace(size, std::unique_ptr<FFTPlan>(new FFTPlan(size))).first;
+        const FFTPlan& plan = *it->second;
+        g_planBytes.fetch_add(sizeof(plan) + (plan.m_twiddles.capacity() + plan.m_realTwiddles.capacity()) * sizeof(float),
+                              std::memory_order_relaxed);
+    }
+    return *it->second;
+}
+
+FFTPlan::FFTPlan(std::size_t size)
+    : m_size(size)
+    , m_stages(0U)
+    , m_kernels(&simdKernels())
+    , m_twiddles(size, 0.0f)
+    , m_realTwiddles(2U * size, 0.0f)
+{
+    while ((static_cast<std::size_t>(1U) << m_stages) < m_size)
+    {
+        ++m_stages;
+    }
+
+    // Computed in double precision so large sizes keep full float accuracy
+    for (std::size_t k = 0; k < m_size / 2U; ++k)
+    {
+        const double angle = -kTwoPi * static_cast<double>(k) / static_cast<double>(m_size);
+        m_twiddles[2U * k] = static_cast<float>(std::cos(angle));
+        m_twiddles[2U * k + 1U] = static_cast<float>(std::sin(angle));
+    }
+
+    for (std::size_t k = 0; k < m_size; ++k)
+    {
+        const double angle = -kTwoPi * static_cast<double>(k) / static_cast<double>(2U * m_size);
+        m_realTwiddles[2U * k] = static_cast<float>(std::cos(angle));
+        m_realTwiddles[2U * k + 1U] = static_cast<float>(std::sin(angle));
+    }
+}
+
+void FFTPlan::forward(const float* input, float* output, float* work) const
+{
+    transform(input, output, work, 1.0f);
+}
+
+void FFTPlan::inverse(const float* input, float* output, float* work) const
+{
+    transform(input, output, work, -1.0f);
+
+    const float scale = 1.0f / static_cast<float>(m_size);
+    for (std::size_t i = 0; i < 2U * m_size; ++i)
+    {
+        output[i] *= scale;
+    }
+}
+
+void FFTPlan::transform(const float* input, float* output, float* work, float sign) const
+{
+    // Ping-pong between output and work, choosing the first destination so
+    // that the final stage always lands in output.
+    const float* source = input;
+    float* destination = (m_stages % 2U == 1U) ? output : work;
+
+    std::size_t n = m_size;
+    std::size_t s = 1U;
+    for (std::size_t stage = 0; stage < m_stages; ++stage)
+    {
+        m_kernels->fftStage(n, s, source, destination, m_twiddles.data(), sign);
+        source = destination;
+        destination = (destination == output) ? work : output;
+        n /= 2U;
+        s *= 2U;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// RealFFT implementation
+// -----------------------------------------------------------------------------
+
+RealFFT::RealFFT(std::size_t size)
+    : m_size(size)
+    , m_plan(FFTPlan::get((isPowerOfTwo(size) && size >= kMinSize && size <= kMaxSize) ? size / 2U : 0U))
+    , m_workA(size, 0.0f)
+    , m_workB(size, 0.0f)
+{
+}
+
+void RealFFT::forward(const float* input, float* spectrum)
+{
+    // Even/odd samples packed as one half-length complex sequence; the real
+    // input array already has exactly that interleaved layout.
+    const std::size_t half = m_size / 2U;
+    float* z = m_workA.data();
+    m_plan.forward(input, z, m_workB.data());
+
+    const float* w = m_plan.realTwiddles();
+
+    spectrum[0] = z[0] + z[1];
+    spectrum[1] = 0.0f;
+    spectrum[2U * half] = z[0] - z[1];
+    spectrum[2U * half + 1U] = 0.0f;
+
+    for (std::size_t k = 1; k < half; ++k)
+    {
+        const float ar = z[2U * k];
+        const float ai = z[2U * k + 1U];
+        const float br = z[2U * (half - k)];
+        const float bi = -z[2U * (half - k) + 1U];   // conj(Z[half - k])
+
+        // Even part E = (A + B) / 2, odd part O = (A - B) / 2i
+        const float er = 0.5f * (ar + br);
+        const float ei = 0.5f * (ai + bi);
+        const float or_ = 0.5f * (ai - bi);
+        const float oi = -0.5f * (ar - br);
+
+        const float wr = w[2U * k];
+        const float wi = w[2U * k + 1U];
+        spectrum[2U * k] = er + (or_ * wr - oi * wi);
+        spectrum[2U * k + 1U] = ei + (or_ * wi + oi * wr);
+    }
+}
+
+void RealFFT::inverse(const float* spectrum, float* output)
+{
+    const std::size_t half = m_size / 2U;
+    float* z = m_workA.data();
+    const float* w = m_plan.realTwiddles();
+
+    // Rebuild Z = E + iO from the half spectrum. The 1/2 factors of E and O
+    // are folded into the inverse transform's 1 / half scaling.
+    z[0] = 0.5f * (spectrum[0] + spectrum[2U * half]);
+    z[1] = 0.5f * (spectrum[0] - spectrum[2U * half]);
+
+    for (std::size_t k = 1; k < half; ++k)
+    {
+        const float ar = spectrum[2U * k];
+        const float ai = spectrum[2U * k + 1U];
+        const float br = spectrum[2U * (half - k)];
+        const float bi = -spectrum[2U * (half - k) + 1U];   // conj(X[half - k])
+
+        const float er = 0.5f * (ar + br);
+        const float ei = 0.5f * (ai + bi);
+        const float dr = 0.5f * (ar - br);
+        const float di = 0.5f * (ai - bi);
+
+        // O = D * conj(W), then Z = E + iO
+        const float wr = w[2U * k];
+        const float wi = w[2U * k + 1U];
+        const float or_ = dr * wr + di * wi;
+        const float oi = di * wr - dr * wi;
+
+        z[2U * k] = er - oi;
+        z[2U * k + 1U] = ei + or_;
+    }
+
+    // Interleaved complex output is exactly the real sample layout
+    m_plan.inverse(z, output, m_workB.data());
+}
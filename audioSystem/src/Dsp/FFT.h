@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct SimdKernels;
+
+/**
+ * @file FFT.h
+ * @brief In-tree complex and real FFT with cached plans
+ *
+ * Transforms use a radix-2 Stockham autosort algorithm, so no bit-reversal
+ * pass is needed and every stage streams through memory contiguously. The
+ * stages run through simdKernels(), so they use the widest instruction set
+ * the host supports.
+ *
+ * Complex data is stored interleaved: element k occupies floats [2k, 2k + 1]
+ * as (real, imaginary).
+ */
+
+/**
+ * @class FFTPlan
+ * @brief Immutable twiddle tables for one power-of-two transform size
+ *
+ * Plans are created on first request and cached for the lifetime of the
+ * process; get() is thread-safe. Creating a plan allocates, so acquire plans
+ * (or construct RealFFT objects) during setup, never on the audio thread.
+ * Transforms themselves are const and allocation-free, so one plan can be
+ * shared by any number of threads.
+ */
+class FFTPlan
+{
+public:
+    static constexpr std::size_t kMinSize = 16;      ///< Smallest complex size (real transforms use size / 2)
+    static constexpr std::size_t kMaxSize = 65536;   ///< Largest complex size
+
+    /**
+     * @brief Fetch the cached plan for a complex transform size
+     * @param size Power-of-two size between kMinSize and kMaxSize
+     * @throws std::invalid_argument if size is not supported
+     */
+    static const FFTPlan& get(std::size_t size);
+
+    /// @return true if size is a power of two in [kMinSize, kMaxSize]
+    static bool isSupportedSize(std::size_t size);
+
+    /// Bytes held by every plan created so far (lock-free, safe on the audio thread)
+    static std::size_t cachedBytes();
+
+    std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Forward complex transform (unnormalized), out-of-place
+     * @param input size() interleaved complex values, left untouched
+     * @param output size() interleaved complex values
+     * @param work Scratch space for size() complex values
+     */
+    void forward(const float* input, float* output, float* work) const;
+
+    /**
+     * @brief Inverse complex transform scaled by 1 / size(), out-of-place
+     *
+     * forward() followed by inverse() reproduces the input.
+     */
+    void inverse(const float* input, float* output, float* work) const;
+
+    /// Twiddles exp(-2*pi*i*k / (2 * size())) for k in [0, size()), used by RealFFT
+    const float* realTwiddles() const { return m_realTwiddles.data(); }
+
+private:
+    explicit FFTPlan(std::size_t size);
+
+    void transform(const float* input, float* output, float* work, float sign) const;
+
+    std::size_t m_size;                  ///< Complex transform length
+    std::size_t m_stages;                ///< log2(m_size)
+    const SimdKernels* m_kernels;        ///< Stage kernel for the host, fetched when the plan is built
+    std::vector<float> m_twiddles;       ///< exp(-2*pi*i*k / size) for k in [0, size / 2)
+    std::vector<float> m_realTwiddles;   ///< Half-step twiddles for real-input post-processing
+};
+
+/**
+ * @class RealFFT
+ * @brief Real-input FFT of a fixed power-of-two size
+ *
+ * Computes the N-point transform of real data through an N/2-point complex
+ * transform plus a split pass. Work buffers are allocated by the constructor,
+ * so forward() and inverse() never allocate and are safe on the audio thread.
+ * An instance is not re-entrant; give each thread its own.
+ */
+class RealFFT
+{
+public:
+    static constexpr std::size_t kMinSize = 64;      ///< Smallest supported real size
+    static constexpr std::size_t kMaxSize = 65536;   ///< Largest supported real size
+
+    /**
+     * @brief Construct a real FFT
+     * @param size Power-of-two size between kMinSize and kMaxSize
+     * @throws std::invalid_argument if size is not supported
+     */
+    explicit RealFFT(std::size_t size);
+
+    std::size_t size() const { return m_size; }
+
+    /// Number of complex bins produced by forward(): size() / 2 + 1
+    std::size_t binCount() const { return m_size / 2U + 1U; }
+
+    /**
+     * @brief Forward transform (unnormalized)
+     * @param input size() real samples, left untouched
+     * @param spectrum binCount() interleaved complex bins (DC to Nyquist)
+     */
+    void forward(const float* input, float* spectrum);
+
+    /**
+     * @brief Inverse transform scaled by 1 / size()
+     * @param spectrum binCount() interleaved complex bins, left untouched
+     * @param output size() real samples
+     */
+    void inverse(const float* spectrum, float* output);
+
+    /// Bytes of the work buffers (the shared plan is counted by FFTPlan::cachedBytes())
+    std::size_t bufferBytes() const { return (m_workA.capacity() + m_workB.capacity()) * sizeof(float); }
+
+private:
+    std::size_t m_size;           ///< Real transform length
+    const FFTPlan& m_plan;        ///< Shared complex plan of size m_size / 2
+    std::vector<float> m_workA;   ///< Complex scratch, m_size / 2 elements
+    std::vector<float> m_workB;   ///< Complex scratch, m_size / 2 elements
+};
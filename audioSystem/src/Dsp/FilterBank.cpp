@@ -0,0 +1,131 @@
+#include "FilterBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+std::size_t padToLanes(std::size_t count)
+{
+    return (count + BiquadBank::kLaneWidth - 1U) / BiquadBank::kLaneWidth * BiquadBank::kLaneWidth;
+}
+}
+
+constexpr std::size_t BiquadBank::kLaneWidth;
+
+// -----------------------------------------------------------------------------
+// BiquadBank implementation
+// -----------------------------------------------------------------------------
+
+BiquadBank::BiquadBank(std::size_t bandCount)
+    : m_kernels(&simdKernels())
+    , m_bandCount(0U)
+{
+    resize(bandCount);
+}
+
+void BiquadBank::resize(std::size_t bandCount)
+{
+    const std::size_t padded = padToLanes(bandCount);
+    m_bandCount = bandCount;
+
+    // Zero coefficients make the padding lanes output silence
+    m_b0.assign(padded, 0.0f);
+    m_b1.assign(padded, 0.0f);
+    m_b2.assign(padded, 0.0f);
+    m_a1.assign(padded, 0.0f);
+    m_a2.assign(padded, 0.0f);
+    m_z1.assign(padded, 0.0f);
+    m_z2.assign(padded, 0.0f);
+}
+
+void BiquadBank::reserve(std::size_t bandCount)
+{
+    const std::size_t padded = padToLanes(bandCount);
+    m_b0.reserve(padded);
+    m_b1.reserve(padded);
+    m_b2.reserve(padded);
+    m_a1.reserve(padded);
+    m_a2.reserve(padded);
+    m_z1.reserve(padded);
+    m_z2.reserve(padded);
+}
+
+void BiquadBank::setBandPass(std::size_t band, float centerHz, float q, float sampleRate)
+{
+    if (band >= m_bandCount || sampleRate <= 0.0f)
+    {
+        return;
+    }
+
+    const double nyquistGuard = 0.49 * static_cast<double>(sampleRate);
+    const double frequency = std::min(std::max(static_cast<double>(centerHz), 10.0), nyquistGuard);
+    const double w0 = 2.0 * kPi * frequency / static_cast<double>(sampleRate);
+    const double alpha = std::sin(w0) / (2.0 * std::max(static_cast<double>(q), 0.1));
+    const double a0 = 1.0 + alpha;
+
+    m_b0[band] = static_cast<float>(alpha / a0);
+    m_b1[band] = 0.0f;
+    m_b2[band] = static_cast<float>(-alpha / a0);
+    m_a1[band] = static_cast<float>(-2.0 * std::cos(w0) / a0);
+    m_a2[band] = static_cast<float>((1.0 - alpha) / a0);
+}
+
+void BiquadBank::process(float input, float* output)
+{
+    const BiquadLanes lanes = {m_b0.data(), m_b1.data(), m_b2.data(), m_a1.data(), m_a2.data(), m_z1.data(), m_z2.data()};
+    m_kernels->biquadBank(lanes, input, output, m_b0.size());
+}
+
+void BiquadBank::reset()
+{
+    std::fill(m_z1.begin(), m_z1.end(), 0.0f);
+    std::fill(m_z2.begin(), m_z2.end(), 0.0f);
+}
+
+// -----------------------------------------------------------------------------
+// EnvelopeBank implementation
+// -----------------------------------------------------------------------------
+
+EnvelopeBank::EnvelopeBank(std::size_t paddedCount)
+    : m_kernels(&simdKernels())
+    , m_attackCoeff(1.0f)
+    , m_releaseCoeff(1.0f)
+    , m_envelope(padToLanes(paddedCount), 0.0f)
+{
+}
+
+void EnvelopeBank::resize(std::size_t paddedCount)
+{
+    m_envelope.assign(padToLanes(paddedCount), 0.0f);
+}
+
+void EnvelopeBank::reserve(std::size_t paddedCount)
+{
+    m_envelope.reserve(padToLanes(paddedCount));
+}
+
+void EnvelopeBank::setTimes(float attackSeconds, float releaseSeconds, float sampleRate)
+{
+    auto coefficient = [sampleRate](float seconds)
+    {
+        const float samples = std::max(seconds * sampleRate, 1.0f);
+        return 1.0f - std::exp(-1.0f / samples);
+    };
+
+    m_attackCoeff = coefficient(attackSeconds);
+    m_releaseCoeff = coefficient(releaseSeconds);
+}
+
+const float* EnvelopeBank::process(const float* input)
+{
+    m_kernels->envelopeFollow(input, m_envelope.data(), m_envelope.size(), m_attackCoeff, m_releaseCoeff);
+    return m_envelope.data();
+}
+
+void EnvelopeBank::reset()
+{
+    std::fill(m_envelope.begin(), m_envelope.end(), 0.0f);
+}
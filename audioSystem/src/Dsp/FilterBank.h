@@ -0,0 +1,125 @@
+#pragma once
+
+#include "SimdKernels.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file FilterBank.h
+ * @brief Banks of parallel biquads and envelope followers processed as SIMD lanes
+ *
+ * Both banks keep their coefficients and state in structure-of-arrays form
+ * padded to a multiple of kLaneWidth, so each SSE register holds the same
+ * quantity for four neighbouring bands. Every band sees the same input sample,
+ * which is the layout filter-bank effects such as vocoders need. The loops
+ * run through simdKernels(), so wider registers are used when the host has
+ * them.
+ */
+
+/**
+ * @class BiquadBank
+ * @brief Parallel transposed direct form II biquads fed by one input
+ */
+class BiquadBank
+{
+public:
+    static constexpr std::size_t kLaneWidth = 4;   ///< Bands per SIMD register
+
+    /**
+     * @brief Construct a bank
+     * @param bandCount Number of bands; storage is padded to a multiple of kLaneWidth
+     */
+    explicit BiquadBank(std::size_t bandCount = 0);
+
+    /// Resize the bank; padding lanes are configured as silent. Allocates beyond the reserved size.
+    void resize(std::size_t bandCount);
+
+    /// Make room for bandCount bands, so resizing up to it never allocates
+    void reserve(std::size_t bandCount);
+
+    std::size_t bandCount() const { return m_bandCount; }
+    /// Band count rounded up to a multiple of kLaneWidth (length of output arrays)
+    std::size_t paddedCount() const { return m_b0.size(); }
+
+    /**
+     * @brief Configure one band as a constant 0 dB peak-gain band-pass (RBJ)
+     * @param band Band index
+     * @param centerHz Centre frequency in Hz
+     * @param q Quality factor
+     * @param sampleRate Sampling rate in Hz
+     */
+    void setBandPass(std::size_t band, float centerHz, float q, float sampleRate);
+
+    /**
+     * @brief Run one input sample through every band
+     * @param input Sample fed to all bands
+     * @param output paddedCount() band outputs
+     */
+    void process(float input, float* output);
+
+    /// Clear the filter state
+    void reset();
+
+    /// Bytes of the coefficient and state arrays
+    std::size_t bufferBytes() const
+    {
+        return (m_b0.capacity() + m_b1.capacity() + m_b2.capacity() + m_a1.capacity() + m_a2.capacity()
+                + m_z1.capacity() + m_z2.capacity()) * sizeof(float);
+    }
+
+private:
+    const SimdKernels* m_kernels;   ///< Selected at construction
+    std::size_t m_bandCount;
+    std::vector<float> m_b0;
+    std::vector<float> m_b1;
+    std::vector<float> m_b2;
+    std::vector<float> m_a1;
+    std::vector<float> m_a2;
+    std::vector<float> m_z1;
+    std::vector<float> m_z2;
+};
+
+/**
+ * @class EnvelopeBank
+ * @brief Parallel peak envelope followers with separate attack and release
+ */
+class EnvelopeBank
+{
+public:
+    explicit EnvelopeBank(std::size_t paddedCount = 0);
+
+    /// Resize the bank to paddedCount followers (multiple of BiquadBank::kLaneWidth). Allocates beyond the reserved size.
+    void resize(std::size_t paddedCount);
+
+    /// Make room for paddedCount followers, so resizing up to it never allocates
+    void reserve(std::size_t paddedCount);
+
+    /**
+     * @brief Set the time constants for all followers
+     * @param attackSeconds Time to rise about 63% towards a louder input
+     * @param releaseSeconds Time to fall about 63% towards a quieter input
+     * @param sampleRate Sampling rate in Hz
+     */
+    void setTimes(float attackSeconds, float releaseSeconds, float sampleRate);
+
+    /**
+     * @brief Track the rectified inputs
+     * @param input One sample per follower
+     * @return Pointer to the current envelopes (one per follower)
+     */
+    const float* process(const float* input);
+
+    const float* envelopes() const { return m_envelope.data(); }
+
+    void reset();
+
+    /// Bytes of the follower states
+    std::size_t bufferBytes() const { return m_envelope.capacity() * sizeof(float); }
+
+private:
+    const SimdKernels* m_kernels;   ///< Selected at construction
+    float m_attackCoeff;
+    float m_releaseCoeff;
+    std::vector<float> m_envelope;
+};
@@ -0,0 +1,249 @@
+#include "SampleConverter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+const char* const kFormatNames[] = {"float32", "s32", "s24", "s16"};
+
+constexpr float kNoiseScale = 1.0f / 65536.0f;
+constexpr float kMaxShapedError = 2.0f;     ///< LSB; larger errors only come from clipping
+
+/// Advance an xorshift32 generator and return TPDF noise in LSB
+inline float triangularNoise(std::uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    // Two 16-bit uniforms from one draw; their difference is triangular over +/-1 LSB
+    const std::int32_t first = static_cast<std::int32_t>(state & 0xFFFFU);
+    const std::int32_t second = static_cast<std::int32_t>(state >> 16);
+    return static_cast<float>(first - second) * kNoiseScale;
+}
+
+/// Full scale of an integer format, in LSB
+float fullScale(SampleFormat format)
+{
+    switch (format)
+    {
+    case SampleFormat::Int16:
+        return 32768.0f;
+    case SampleFormat::Int24:
+        return 8388608.0f;
+    case SampleFormat::Int32:
+        return 2147483648.0f;
+    case SampleFormat::Float32:
+    default:
+        return 1.0f;
+    }
+}
+
+void storeCodes(const std::int32_t* codes, SampleFormat format, unsigned char* output, std::size_t count)
+{
+    switch (format)
+    {
+    case SampleFormat::Int16:
+    {
+        std::int16_t* samples = reinterpret_cast<std::int16_t*>(output);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            samples[i] = static_cast<std::int16_t>(codes[i]);
+        }
+        break;
+    }
+    case SampleFormat::Int24:
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint32_t code = static_cast<std::uint32_t>(codes[i]);
+            output[3U * i] = static_cast<unsigned char>(code);
+            output[3U * i + 1U] = static_cast<unsigned char>(code >> 8);
+            output[3U * i + 2U] = static_cast<unsigned char>(code >> 16);
+        }
+        break;
+    case SampleFormat::Int32:
+    case SampleFormat::Float32:
+    default:
+        std::memcpy(output, codes, count * sizeof(std::int32_t));
+        break;
+    }
+}
+}
+
+constexpr std::size_t SampleConverter::kChunkSamples;
+constexpr std::size_t SampleConverter::kChannels;
+constexpr std::size_t SampleConverter::kNoiseLanes;
+
+const char* sampleFormatName(SampleFormat format)
+{
+    return kFormatNames[static_cast<std::size_t>(format)];
+}
+
+bool sampleFormatFromName(const std::string& name, SampleFormat& format)
+{
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+
+    for (std::size_t index = 0; index < sizeof(kFormatNames) / sizeof(kFormatNames[0]); ++index)
+    {
+        if (lower == kFormatNames[index])
+        {
+            format = static_cast<SampleFormat>(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t sampleFormatBytes(SampleFormat format)
+{
+    switch (format)
+    {
+    case SampleFormat::Int16:
+        return 2U;
+    case SampleFormat::Int24:
+        return 3U;
+    case SampleFormat::Int32:
+    case SampleFormat::Float32:
+    default:
+        return 4U;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// SampleConverter implementation
+// -----------------------------------------------------------------------------
+
+SampleConverter::SampleConverter(SampleFormat format, bool dither, bool noiseShaping)
+    : m_kernels(&simdKernels()),
+      m_format(format),
+      m_dither((dither || noiseShaping) && (format == SampleFormat::Int16 || format == SampleFormat::Int24)),
+      m_noiseShaping(noiseShaping && m_dither),
+      m_scale(fullScale(format)),
+      m_ceiling(fullScale(format) - 1.0f),
+      m_random{{0x9E3779B9U, 0x7F4A7C15U, 0x85EBCA6BU, 0xC2B2AE35U}},
+      m_error{},
+      m_noise{},
+      m_codes{}
+{
+    // 2^31 - 1 rounds up to 2^31 as a float, which does not fit in an int32
+    if (m_ceiling >= m_scale)
+    {
+        m_ceiling = std::nextafter(m_scale, 0.0f);
+    }
+}
+
+void SampleConverter::fromFloat(const float* samples, void* output, std::size_t frames)
+{
+    const std::size_t count = kChannels * frames;
+    if (m_format == SampleFormat::Float32)
+    {
+        std::memcpy(output, samples, count * sizeof(float));
+        return;
+    }
+
+    // 32-bit output needs no narrowing, so the kernel writes the device buffer directly
+    if (m_format == SampleFormat::Int32)
+    {
+        m_kernels->quantizeSamples(samples, nullptr, static_cast<std::int32_t*>(output), count, m_scale, m_ceiling);
+        return;
+    }
+
+    unsigned char* bytes = static_cast<unsigned char*>(output);
+    const std::size_t sampleBytes = sampleFormatBytes(m_format);
+    for (std::size_t offset = 0; offset < count; offset += kChunkSamples)
+    {
+        const std::size_t chunk = std::min(kChunkSamples, count - offset);
+        if (m_noiseShaping)
+        {
+            quantizeShaped(samples + offset, m_codes.data(), chunk);
+        }
+        else if (m_dither)
+        {
+            fillDither(m_noise.data(), chunk);
+            m_kernels->quantizeSamples(samples + offset, m_noise.data(), m_codes.data(), chunk, m_scale, m_ceiling);
+        }
+        else
+        {
+            m_kernels->quantizeSamples(samples + offset, nullptr, m_codes.data(), chunk, m_scale, m_ceiling);
+        }
+        storeCodes(m_codes.data(), m_format, bytes + offset * sampleBytes, chunk);
+    }
+}
+
+void SampleConverter::toFloat(const void* input, SampleFormat format, float* output, std::size_t count)
+{
+    const float gain = 1.0f / fullScale(format);
+    switch (format)
+    {
+    case SampleFormat::Int16:
+    {
+        const std::int16_t* samples = static_cast<const std::int16_t*>(input);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            output[i] = static_cast<float>(samples[i]) * gain;
+        }
+        break;
+    }
+    case SampleFormat::Int24:
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(input);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Assemble in the top three bytes so the shift back sign-extends
+            const std::uint32_t code = (static_cast<std::uint32_t>(bytes[3U * i]) << 8)
+                                     | (static_cast<std::uint32_t>(bytes[3U * i + 1U]) << 16)
+                                     | (static_cast<std::uint32_t>(bytes[3U * i + 2U]) << 24);
+            output[i] = static_cast<float>(static_cast<std::int32_t>(code) >> 8) * gain;
+        }
+        break;
+    }
+    case SampleFormat::Int32:
+    {
+        const std::int32_t* samples = static_cast<const std::int32_t*>(input);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            output[i] = static_cast<float>(samples[i]) * gain;
+        }
+        break;
+    }
+    case SampleFormat::Float32:
+    default:
+        std::memcpy(output, input, count * sizeof(float));
+        break;
+    }
+}
+
+void SampleConverter::fillDither(float* noise, std::size_t count)
+{
+    // Sample i comes from lane i % kNoiseLanes; the lanes are independent, so the full groups vectorize
+    std::size_t i = 0;
+    for (; i + kNoiseLanes <= count; i += kNoiseLanes)
+    {
+        for (std::size_t lane = 0; lane < kNoiseLanes; ++lane)
+        {
+            noise[i + lane] = triangularNoise(m_random[lane]);
+        }
+    }
+    for (std::size_t lane = 0; i < count; ++i, ++lane)
+    {
+        noise[i] = triangularNoise(m_random[lane]);
+    }
+}
+
+void SampleConverter::quantizeShaped(const float* samples, std::int32_t* output, std::size_t count)
+{
+    fillDither(m_noise.data(), count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float& error = m_error[i % kChannels];
+        const float wanted = samples[i] * m_scale - error;
+        const float value = std::max(-m_scale, std::min(m_ceiling, wanted + m_noise[i]));
+        const std::int32_t code = static_cast<std::int32_t>(std::lrint(value));
+        error = std::max(-kMaxShapedError, std::min(kMaxShapedError, static_cast<float>(code) - wanted));
+        output[i] = code;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "SimdKernels.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file SampleConverter.h
+ * @brief Conversion between the engine's float samples and integer device formats
+ *
+ * The engine renders interleaved stereo float. Devices that only take
+ * integer samples natively are fed through SampleConverter rather than the
+ * driver's own conversion, which is usually a scalar loop on the audio path
+ * and truncates instead of dithering.
+ */
+
+/**
+ * @enum SampleFormat
+ * @brief Interleaved sample formats a device stream can be opened with
+ */
+enum class SampleFormat
+{
+    Float32,    ///< The engine's own format; no conversion
+    Int32,      ///< Signed 32-bit
+    Int24,      ///< Signed 24-bit packed in 3 bytes, little endian
+    Int16       ///< Signed 16-bit
+};
+
+/// Config name of a format ("float32", "s32", "s24", "s16")
+const char* sampleFormatName(SampleFormat format);
+
+/**
+ * @brief Parse a format name as printed by sampleFormatName() (case-insensitive)
+ * @return false if the name is not recognised
+ */
+bool sampleFormatFromName(const std::string& name, SampleFormat& format);
+
+/// Bytes per sample
+std::size_t sampleFormatBytes(SampleFormat format);
+
+/**
+ * @class SampleConverter
+ * @brief Quantizes interleaved stereo float output to a device format
+ *
+ * Samples are scaled, dithered and rounded through the quantizeSamples
+ * kernel in chunks of kChunkSamples, then narrowed to the sample width.
+ * Dither is TPDF (the difference of two uniform values, +/-1 LSB), which
+ * removes the correlation between the signal and the quantization error.
+ * Noise shaping feeds each channel's error back through (1 - z^-1), moving
+ * the dither noise toward Nyquist where it is least audible; that loop
+ * depends on the previous sample so it runs one frame at a time.
+ *
+ * Dither and shaping only apply to 16- and 24-bit output; 32-bit output is
+ * already finer than the float mantissa. Never allocates after construction.
+ */
+class SampleConverter
+{
+public:
+    static constexpr std::size_t kChunkSamples = 512;   ///< Samples quantized per kernel call
+    static constexpr std::size_t kChannels = 2;         ///< The engine renders stereo
+    static constexpr std::size_t kNoiseLanes = 4;       ///< Independent generators, so the noise loop vectorizes
+
+    /**
+     * @brief Construct a converter
+     * @param format Device format
+     * @param dither Add TPDF dither before rounding
+     * @param noiseShaping Shape the requantization noise (implies dither)
+     */
+    explicit SampleConverter(SampleFormat format = SampleFormat::Float32, bool dither = true,
+                             bool noiseShaping = false);
+
+    SampleFormat format() const { return m_format; }
+    /// Dither in effect (false for float and 32-bit output)
+    bool dithers() const { return m_dither; }
+    bool noiseShaping() const { return m_noiseShaping; }
+
+    /**
+     * @brief Convert interleaved stereo float to the device format (audio thread)
+     * @param samples 2 * frames samples in [-1, 1]; louder samples clip
+     * @param output Device buffer receiving 2 * frames samples
+     * @param frames Number of frames
+     */
+    void fromFloat(const float* samples, void* output, std::size_t frames);
+
+    /**
+     * @brief Convert device samples to float in [-1, 1) (input side)
+     * @param input count samples in format
+     * @param format Format of input
+     * @param output Receives count samples
+     * @param count Number of samples (frames * channels)
+     */
+    static void toFloat(const void* input, SampleFormat format, float* output, std::size_t count);
+
+private:
+    /// TPDF noise in LSB
+    void fillDither(float* noise, std::size_t count);
+    /// Dither, shape and round one chunk, frame by frame
+    void quantizeShaped(const float* samples, std::int32_t* output, std::size_t count);
+
+    const SimdKernels* m_kernels;   ///< Selected at construction
+    SampleFormat m_format;
+    bool m_dither;
+    bool m_noiseShaping;
+    float m_scale;                  ///< Full scale in LSB
+    float m_ceiling;                ///< Largest code, as a float
+    std::array<std::uint32_t, kNoiseLanes> m_random;   ///< xorshift32 state per lane
+    std::array<float, kChannels> m_error;      ///< Previous quantization error per channel, in LSB
+
+    alignas(16) std::array<float, kChunkSamples> m_noise;
+    alignas(16) std::array<std::int32_t, kChunkSamples> m_codes;
+};
@@ -0,0 +1,1063 @@
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define AUDIO_SIMD_X86 1
+#include <immintrin.h>
+#define AUDIO_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define AUDIO_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+// GCC fuses a multiply intrinsic into the following add once FMA is enabled;
+// kernels that must round like the scalar code opt out
+#if defined(__clang__)
+#define AUDIO_NO_FP_CONTRACT
+#else
+#define AUDIO_NO_FP_CONTRACT __attribute__((optimize("fp-contract=off")))
+#endif
+#endif
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Scalar kernels
+// -----------------------------------------------------------------------------
+
+/// Biquad lanes [first, count); lets a wider kernel hand its tail on without rebuilding the lane pointers
+void biquadRangeScalar(const BiquadLanes& lanes, float input, float* output, std::size_t first, std::size_t count)
+{
+    for (std::size_t i = first; i < count; ++i)
+    {
+        const float y = lanes.b0[i] * input + lanes.z1[i];
+        lanes.z1[i] = lanes.b1[i] * input + lanes.z2[i] - lanes.a1[i] * y;
+        lanes.z2[i] = lanes.b2[i] * input - lanes.a2[i] * y;
+        output[i] = y;
+    }
+}
+
+void biquadBankScalar(const BiquadLanes& lanes, float input, float* output, std::size_t count)
+{
+    biquadRangeScalar(lanes, input, output, 0U, count);
+}
+
+void envelopeFollowScalar(const float* input, float* envelope, std::size_t count, float attackCoeff, float releaseCoeff)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float rectified = std::fabs(input[i]);
+        const float coeff = rectified > envelope[i] ? attackCoeff : releaseCoeff;
+        envelope[i] += coeff * (rectified - envelope[i]);
+    }
+}
+
+void dualDotProductScalar(const float* weights, const float* left, const float* right, std::size_t count,
+                          float* sumLeft, float* sumRight)
+{
+    float accLeft = 0.0f;
+    float accRight = 0.0f;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        accLeft += weights[i] * left[i];
+        accRight += weights[i] * right[i];
+    }
+    *sumLeft = accLeft;
+    *sumRight = accRight;
+}
+
+void linkedPeaksScalar(const float* interleaved, float* peaks, std::size_t frames)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        peaks[i] = std::max(std::fabs(interleaved[2U * i]), std::fabs(interleaved[2U * i + 1U]));
+    }
+}
+
+void applyStereoGainScalar(float* interleaved, const float* gains, std::size_t frames)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        interleaved[2U * i] *= gains[i];
+        interleaved[2U * i + 1U] *= gains[i];
+    }
+}
+
+void clampSamplesScalar(float* samples, std::size_t count, float limit)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        samples[i] = std::max(-limit, std::min(limit, samples[i]));
+    }
+}
+
+void quantizeSamplesScalar(const float* samples, const float* dither, std::int32_t* output, std::size_t count,
+                           float scale, float ceiling)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float value = samples[i] * scale + (dither != nullptr ? dither[i] : 0.0f);
+        output[i] = static_cast<std::int32_t>(std::lrint(std::max(-scale, std::min(ceiling, value))));
+    }
+}
+
+void grainMixScalar(const float* samples, const float* windows, const float* gainLeft, const float* gainRight,
+                    std::size_t count, float* sumLeft, float* sumRight)
+{
+    float left = 0.0f;
+    float right = 0.0f;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float grain = samples[i] * windows[i];
+        left += grain * gainLeft[i];
+        right += grain * gainRight[i];
+    }
+    *sumLeft = left;
+    *sumRight = right;
+}
+
+void addInPlaceScalar(float* values, const float* increments, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        values[i] += increments[i];
+    }
+}
+
+void feedbackDelayScalar(const float* input, const float* delayed, float* line, float* output, std::size_t count,
+                         float feedback, float dry, float wet, float limit)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float x = input[i];
+        const float d = delayed[i];
+        const float recirculated = x + d * feedback;
+        line[i] = recirculated < -limit ? -limit : (recirculated > limit ? limit : recirculated);
+        output[i] = dry * x + wet * d;
+    }
+}
+
+/// Butterflies [first, count) sharing one twiddle; lets a wider kernel hand its tail on
+void fftButterflyRangeScalar(const float* xa, const float* xb, float* ya, float* yb, std::size_t first,
+                             std::size_t count, float wr, float wi)
+{
+    for (std::size_t q = first; q < count; ++q)
+    {
+        const float ar = xa[2U * q];
+        const float ai = xa[2U * q + 1U];
+        const float br = xb[2U * q];
+        const float bi = xb[2U * q + 1U];
+        const float dr = ar - br;
+        const float di = ai - bi;
+        ya[2U * q] = ar + br;
+        ya[2U * q + 1U] = ai + bi;
+        yb[2U * q] = dr * wr - di * wi;
+        yb[2U * q + 1U] = dr * wi + di * wr;
+    }
+}
+
+void fftStageScalar(std::size_t n, std::size_t s, const float* x, float* y, const float* twiddles, float sign)
+{
+    const std::size_t m = n / 2U;
+    for (std::size_t p = 0; p < m; ++p)
+    {
+        fftButterflyRangeScalar(x + 2U * (s * p), x + 2U * (s * (p + m)), y + 2U * (s * (2U * p)),
+                                y + 2U * (s * (2U * p + 1U)), 0U, s,
+                                twiddles[2U * p * s], sign * twiddles[2U * p * s + 1U]);
+    }
+}
+
+const SimdKernels kScalarKernels = {
+    SimdLevel::Scalar,
+    biquadBankScalar,
+    envelopeFollowScalar,
+    dualDotProductScalar,
+    linkedPeaksScalar,
+    applyStereoGainScalar,
+    clampSamplesScalar,
+    quantizeSamplesScalar,
+    grainMixScalar,
+    addInPlaceScalar,
+    feedbackDelayScalar,
+    fftStageScalar,
+};
+
+#if defined(AUDIO_SIMD_X86)
+
+// -----------------------------------------------------------------------------
+// SSE2 kernels (x86-64 baseline, always compiled in)
+// -----------------------------------------------------------------------------
+
+void biquadRangeSse2(const BiquadLanes& lanes, float input, float* output, std::size_t first, std::size_t count)
+{
+    std::size_t i = first;
+    const __m128 x = _mm_set1_ps(input);
+    for (; i + 4U <= count; i += 4U)
+    {
+        const __m128 z1 = _mm_loadu_ps(lanes.z1 + i);
+        const __m128 z2 = _mm_loadu_ps(lanes.z2 + i);
+        const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.b0 + i), x), z1);
+        const __m128 nextZ1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(lanes.b1 + i), x), z2),
+                                         _mm_mul_ps(_mm_loadu_ps(lanes.a1 + i), y));
+        const __m128 nextZ2 = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(lanes.b2 + i), x),
+                                         _mm_mul_ps(_mm_loadu_ps(lanes.a2 + i), y));
+        _mm_storeu_ps(lanes.z1 + i, nextZ1);
+        _mm_storeu_ps(lanes.z2 + i, nextZ2);
+        _mm_storeu_ps(output + i, y);
+    }
+    biquadRangeScalar(lanes, input, output, i, count);
+}
+
+void biquadBankSse2(const BiquadLanes& lanes, float input, float* output, std::size_t count)
+{
+    biquadRangeSse2(lanes, input, output, 0U, count);
+}
+
+void envelopeFollowSse2(const float* input, float* envelope, std::size_t count, float attackCoeff, float releaseCoeff)
+{
+    std::size_t i = 0;
+    const __m128 attack = _mm_set1_ps(attackCoeff);
+    const __m128 release = _mm_set1_ps(releaseCoeff);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (; i + 4U <= count; i += 4U)
+    {
+        const __m128 rectified = _mm_and_ps(_mm_loadu_ps(input + i), absMask);
+        const __m128 current = _mm_loadu_ps(envelope + i);
+
+        // Branch-free attack/release selection per lane
+        const __m128 rising = _mm_cmpgt_ps(rectified, current);
+        const __m128 coeff = _mm_or_ps(_mm_and_ps(rising, attack), _mm_andnot_ps(rising, release));
+        _mm_storeu_ps(envelope + i, _mm_add_ps(current, _mm_mul_ps(coeff, _mm_sub_ps(rectified, current))));
+    }
+    envelopeFollowScalar(input + i, envelope + i, count - i, attackCoeff, releaseCoeff);
+}
+
+float horizontalSum(__m128 value)
+{
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, value);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+void dualDotProductSse2(const float* weights, const float* left, const float* right, std::size_t count,
+                        float* sumLeft, float* sumRight)
+{
+    std::size_t i = 0;
+    __m128 accLeft = _mm_setzero_ps();
+    __m128 accRight = _mm_setzero_ps();
+    for (; i + 4U <= count; i += 4U)
+    {
+        const __m128 w = _mm_loadu_ps(weights + i);
+        accLeft = _mm_add_ps(accLeft, _mm_mul_ps(w, _mm_loadu_ps(left + i)));
+        accRight = _mm_add_ps(accRight, _mm_mul_ps(w, _mm_loadu_ps(right + i)));
+    }
+
+    float tailLeft = 0.0f;
+    float tailRight = 0.0f;
+    dualDotProductScalar(weights + i, left + i, right + i, count - i, &tailLeft, &tailRight);
+    *sumLeft = horizontalSum(accLeft) + tailLeft;
+    *sumRight = horizontalSum(accRight) + tailRight;
+}
+
+void linkedPeaksSse2(const float* interleaved, float* peaks, std::size_t frames)
+{
+    std::size_t i = 0;
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (; i + 4U <= frames; i += 4U)
+    {
+        const __m128 a = _mm_and_ps(_mm_loadu_ps(interleaved + 2U * i), absMask);
+        const __m128 b = _mm_and_ps(_mm_loadu_ps(interleaved + 2U * i + 4U), absMask);
+        const __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(peaks + i, _mm_max_ps(left, right));
+    }
+    linkedPeaksScalar(interleaved + 2U * i, peaks + i, frames - i);
+}
+
+void applyStereoGainSse2(float* interleaved, const float* gains, std::size_t frames)
+{
+    std::size_t i = 0;
+    for (; i + 4U <= frames; i += 4U)
+    {
+        const __m128 gain = _mm_loadu_ps(gains + i);
+        const __m128 low = _mm_unpacklo_ps(gain, gain);    // g0 g0 g1 g1
+        const __m128 high = _mm_unpackhi_ps(gain, gain);   // g2 g2 g3 g3
+        float* frame = interleaved + 2U * i;
+        _mm_storeu_ps(frame, _mm_mul_ps(_mm_loadu_ps(frame), low));
+        _mm_storeu_ps(frame + 4U, _mm_mul_ps(_mm_loadu_ps(frame + 4U), high));
+    }
+    applyStereoGainScalar(interleaved + 2U * i, gains + i, frames - i);
+}
+
+void clampSamplesSse2(float* samples, std::size_t count, float limit)
+{
+    std::size_t i = 0;
+    const __m128 high = _mm_set1_ps(limit);
+    const __m128 low = _mm_set1_ps(-limit);
+    for (; i + 4U <= count; i += 4U)
+    {
+        _mm_storeu_ps(samples + i, _mm_max_ps(low, _mm_min_ps(high, _mm_loadu_ps(samples + i))));
+    }
+    clampSamplesScalar(samples + i, count - i, limit);
+}
+
+void quantizeSamplesSse2(const float* samples, const float* dither, std::int32_t* output, std::size_t count,
+                         float scale, float ceiling)
+{
+    std::size_t i = 0;
+    const __m128 factor = _mm_set1_ps(scale);
+    const __m128 high = _mm_set1_ps(ceiling);
+    const __m128 low = _mm_set1_ps(-scale);
+    for (; i + 4U <= count; i += 4U)
+    {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(samples + i), factor);
+        if (dither != nullptr)
+        {
+            value = _mm_add_ps(value, _mm_loadu_ps(dither + i));
+        }
+        // Value first, so a NaN clamps to the ceiling as in the scalar version
+        value = _mm_max_ps(_mm_min_ps(value, high), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_cvtps_epi32(value));
+    }
+    quantizeSamplesScalar(samples + i, dither != nullptr ? dither + i : nullptr, output + i, count - i, scale, ceiling);
+}
+
+void grainMixSse2(const float* samples, const float* windows, const float* gainLeft, const float* gainRight,
+                  std::size_t count, float* sumLeft, float* sumRight)
+{
+    std::size_t i = 0;
+    __m128 accLeft = _mm_setzero_ps();
+    __m128 accRight = _mm_setzero_ps();
+    for (; i + 4U <= count; i += 4U)
+    {
+        const __m128 grain = _mm_mul_ps(_mm_loadu_ps(samples + i), _mm_loadu_ps(windows + i));
+        accLeft = _mm_add_ps(accLeft, _mm_mul_ps(grain, _mm_loadu_ps(gainLeft + i)));
+        accRight = _mm_add_ps(accRight, _mm_mul_ps(grain, _mm_loadu_ps(gainRight + i)));
+    }
+
+    // Tail grains are added one by one after the lanes, as the scalar loop would continue
+    float left = horizontalSum(accLeft);
+    float right = horizontalSum(accRight);
+    for (; i < count; ++i)
+    {
+        const float grain = samples[i] * windows[i];
+        left += grain * gainLeft[i];
+        right += grain * gainRight[i];
+    }
+    *sumLeft = left;
+    *sumRight = right;
+}
+
+void addInPlaceSse2(float* values, const float* increments, std::size_t count)
+{
+    std::size_t i = 0;
+    for (; i + 4U <= count; i += 4U)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), _mm_loadu_ps(increments + i)));
+    }
+    addInPlaceScalar(values + i, increments + i, count - i);
+}
+
+void feedbackDelaySse2(const float* input, const float* delayed, float* line, float* output, std::size_t count,
+                       float feedback, float dry, float wet, float limit)
+{
+    std::size_t i = 0;
+    const __m128 gain = _mm_set1_ps(feedback);
+    const __m128 dryGain = _mm_set1_ps(dry);
+    const __m128 wetGain = _mm_set1_ps(wet);
+    const __m128 high = _mm_set1_ps(limit);
+    const __m128 low = _mm_set1_ps(-limit);
+    for (; i + 4U <= count; i += 4U)
+    {
+        const __m128 x = _mm_loadu_ps(input + i);
+        const __m128 d = _mm_loadu_ps(delayed + i);
+        const __m128 recirculated = _mm_add_ps(x, _mm_mul_ps(d, gain));
+        _mm_storeu_ps(line + i, _mm_min_ps(_mm_max_ps(recirculated, low), high));
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_mul_ps(dryGain, x), _mm_mul_ps(wetGain, d)));
+    }
+    feedbackDelayScalar(input + i, delayed + i, line + i, output + i, count - i, feedback, dry, wet, limit);
+}
+
+/**
+ * @brief Multiply two interleaved complex values by a twiddle
+ * @param d Two complex values (re0, im0, re1, im1)
+ * @param wr Real parts of the twiddles, one per lane pair
+ * @param wiSigned Imaginary parts as (-wi, wi) per lane pair
+ */
+__m128 complexMulSse2(__m128 d, __m128 wr, __m128 wiSigned)
+{
+    const __m128 swapped = _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_add_ps(_mm_mul_ps(d, wr), _mm_mul_ps(swapped, wiSigned));
+}
+
+void fftStageSse2(std::size_t n, std::size_t s, const float* x, float* y, const float* twiddles, float sign)
+{
+    const std::size_t m = n / 2U;
+    std::size_t p = 0;
+    if (s == 1U)
+    {
+        // Stride one: vectorize across p, two butterflies per register
+        const __m128 signMask = _mm_set_ps(sign, -sign, sign, -sign);
+        for (; p + 2U <= m; p += 2U)
+        {
+            const __m128 a = _mm_loadu_ps(x + 2U * p);
+            const __m128 b = _mm_loadu_ps(x + 2U * (p + m));
+            const __m128 w = _mm_loadu_ps(twiddles + 2U * p);
+            const __m128 wr = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+            const __m128 wi = _mm_mul_ps(_mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1)), signMask);
+
+            const __m128 sum = _mm_add_ps(a, b);
+            const __m128 diff = complexMulSse2(_mm_sub_ps(a, b), wr, wi);
+
+            _mm_storeu_ps(y + 4U * p, _mm_movelh_ps(sum, diff));
+            _mm_storeu_ps(y + 4U * p + 4U, _mm_movehl_ps(diff, sum));
+        }
+    }
+
+    for (; p < m; ++p)
+    {
+        const float wr = twiddles[2U * p * s];
+        const float wi = sign * twiddles[2U * p * s + 1U];
+        const float* xa = x + 2U * (s * p);
+        const float* xb = x + 2U * (s * (p + m));
+        float* ya = y + 2U * (s * (2U * p));
+        float* yb = y + 2U * (s * (2U * p + 1U));
+
+        std::size_t q = 0;
+        const __m128 wrv = _mm_set1_ps(wr);
+        const __m128 wiv = _mm_set_ps(wi, -wi, wi, -wi);
+        for (; q + 2U <= s; q += 2U)
+        {
+            const __m128 a = _mm_loadu_ps(xa + 2U * q);
+            const __m128 b = _mm_loadu_ps(xb + 2U * q);
+            _mm_storeu_ps(ya + 2U * q, _mm_add_ps(a, b));
+            _mm_storeu_ps(yb + 2U * q, complexMulSse2(_mm_sub_ps(a, b), wrv, wiv));
+        }
+        fftButterflyRangeScalar(xa, xb, ya, yb, q, s, wr, wi);
+    }
+}
+
+const SimdKernels kSse2Kernels = {
+    SimdLevel::Sse2,
+    biquadBankSse2,
+    envelopeFollowSse2,
+    dualDotProductSse2,
+    linkedPeaksSse2,
+    applyStereoGainSse2,
+    clampSamplesSse2,
+    quantizeSamplesSse2,
+    grainMixSse2,
+    addInPlaceSse2,
+    feedbackDelaySse2,
+    fftStageSse2,
+};
+
+// -----------------------------------------------------------------------------
+// AVX2 + FMA kernels
+//
+// Tails are finished inline rather than by the SSE2 kernels: those are
+// legacy-encoded, and GCC does not reliably clear the upper register halves
+// before a tail call, which costs far more than the tail itself.
+// -----------------------------------------------------------------------------
+
+AUDIO_TARGET_AVX2 void biquadRangeAvx2(const BiquadLanes& lanes, float input, float* output, std::size_t first, std::size_t count)
+{
+    std::size_t i = first;
+    const __m256 x = _mm256_set1_ps(input);
+    for (; i + 8U <= count; i += 8U)
+    {
+        const __m256 y = _mm256_fmadd_ps(_mm256_loadu_ps(lanes.b0 + i), x, _mm256_loadu_ps(lanes.z1 + i));
+        const __m256 nextZ1 = _mm256_fnmadd_ps(_mm256_loadu_ps(lanes.a1 + i), y,
+                                               _mm256_fmadd_ps(_mm256_loadu_ps(lanes.b1 + i), x, _mm256_loadu_ps(lanes.z2 + i)));
+        const __m256 nextZ2 = _mm256_fnmadd_ps(_mm256_loadu_ps(lanes.a2 + i), y,
+                                               _mm256_mul_ps(_mm256_loadu_ps(lanes.b2 + i), x));
+        _mm256_storeu_ps(lanes.z1 + i, nextZ1);
+        _mm256_storeu_ps(lanes.z2 + i, nextZ2);
+        _mm256_storeu_ps(output + i, y);
+    }
+    for (; i < count; ++i)
+    {
+        const float y = lanes.b0[i] * input + lanes.z1[i];
+        lanes.z1[i] = lanes.b1[i] * input + lanes.z2[i] - lanes.a1[i] * y;
+        lanes.z2[i] = lanes.b2[i] * input - lanes.a2[i] * y;
+        output[i] = y;
+    }
+}
+
+AUDIO_TARGET_AVX2 void biquadBankAvx2(const BiquadLanes& lanes, float input, float* output, std::size_t count)
+{
+    biquadRangeAvx2(lanes, input, output, 0U, count);
+}
+
+AUDIO_TARGET_AVX2 void envelopeFollowAvx2(const float* input, float* envelope, std::size_t count,
+                                          float attackCoeff, float releaseCoeff)
+{
+    std::size_t i = 0;
+    const __m256 attack = _mm256_set1_ps(attackCoeff);
+    const __m256 release = _mm256_set1_ps(releaseCoeff);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    for (; i + 8U <= count; i += 8U)
+    {
+        const __m256 rectified = _mm256_and_ps(_mm256_loadu_ps(input + i), absMask);
+        const __m256 current = _mm256_loadu_ps(envelope + i);
+        const __m256 rising = _mm256_cmp_ps(rectified, current, _CMP_GT_OQ);
+        const __m256 coeff = _mm256_blendv_ps(release, attack, rising);
+        _mm256_storeu_ps(envelope + i, _mm256_fmadd_ps(coeff, _mm256_sub_ps(rectified, current), current));
+    }
+    for (; i < count; ++i)
+    {
+        const float rectified = std::fabs(input[i]);
+        envelope[i] += (rectified > envelope[i] ? attackCoeff : releaseCoeff) * (rectified - envelope[i]);
+    }
+}
+
+AUDIO_TARGET_AVX2 float horizontalSum256(__m256 value)
+{
+    const __m128 sum = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    const __m128 pairs = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+}
+
+AUDIO_TARGET_AVX2 void dualDotProductAvx2(const float* weights, const float* left, const float* right, std::size_t count,
+                                          float* sumLeft, float* sumRight)
+{
+    std::size_t i = 0;
+    __m256 accLeft = _mm256_setzero_ps();
+    __m256 accRight = _mm256_setzero_ps();
+    for (; i + 8U <= count; i += 8U)
+    {
+        const __m256 w = _mm256_loadu_ps(weights + i);
+        accLeft = _mm256_fmadd_ps(w, _mm256_loadu_ps(left + i), accLeft);
+        accRight = _mm256_fmadd_ps(w, _mm256_loadu_ps(right + i), accRight);
+    }
+
+    float totalLeft = horizontalSum256(accLeft);
+    float totalRight = horizontalSum256(accRight);
+    for (; i < count; ++i)
+    {
+        totalLeft += weights[i] * left[i];
+        totalRight += weights[i] * right[i];
+    }
+    *sumLeft = totalLeft;
+    *sumRight = totalRight;
+}
+
+AUDIO_TARGET_AVX2 void linkedPeaksAvx2(const float* interleaved, float* peaks, std::size_t frames)
+{
+    std::size_t i = 0;
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    for (; i + 8U <= frames; i += 8U)
+    {
+        const __m256 a = _mm256_and_ps(_mm256_loadu_ps(interleaved + 2U * i), absMask);
+        const __m256 b = _mm256_and_ps(_mm256_loadu_ps(interleaved + 2U * i + 8U), absMask);
+
+        // In-lane shuffles give frames 0 1 4 5 2 3 6 7; one 64-bit permute restores the order
+        const __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        const __m256 peak = _mm256_max_ps(left, right);
+        _mm256_storeu_ps(peaks + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(peak), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    for (; i < frames; ++i)
+    {
+        peaks[i] = std::max(std::fabs(interleaved[2U * i]), std::fabs(interleaved[2U * i + 1U]));
+    }
+}
+
+AUDIO_TARGET_AVX2 void applyStereoGainAvx2(float* interleaved, const float* gains, std::size_t frames)
+{
+    std::size_t i = 0;
+    const __m256i lowIndex = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i highIndex = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+    for (; i + 8U <= frames; i += 8U)
+    {
+        const __m256 gain = _mm256_loadu_ps(gains + i);
+        float* frame = interleaved + 2U * i;
+        _mm256_storeu_ps(frame, _mm256_mul_ps(_mm256_loadu_ps(frame), _mm256_permutevar8x32_ps(gain, lowIndex)));
+        _mm256_storeu_ps(frame + 8U, _mm256_mul_ps(_mm256_loadu_ps(frame + 8U), _mm256_permutevar8x32_ps(gain, highIndex)));
+    }
+    for (; i < frames; ++i)
+    {
+        interleaved[2U * i] *= gains[i];
+        interleaved[2U * i + 1U] *= gains[i];
+    }
+}
+
+AUDIO_TARGET_AVX2 void clampSamplesAvx2(float* samples, std::size_t count, float limit)
+{
+    std::size_t i = 0;
+    const __m256 high = _mm256_set1_ps(limit);
+    const __m256 low = _mm256_set1_ps(-limit);
+    for (; i + 8U <= count; i += 8U)
+    {
+        _mm256_storeu_ps(samples + i, _mm256_max_ps(low, _mm256_min_ps(high, _mm256_loadu_ps(samples + i))));
+    }
+    for (; i < count; ++i)
+    {
+        samples[i] = std::max(-limit, std::min(limit, samples[i]));
+    }
+}
+
+AUDIO_TARGET_AVX2 void quantizeSamplesAvx2(const float* samples, const float* dither, std::int32_t* output,
+                                             std::size_t count, float scale, float ceiling)
+{
+    std::size_t i = 0;
+    const __m256 factor = _mm256_set1_ps(scale);
+    const __m256 high = _mm256_set1_ps(ceiling);
+    const __m256 low = _mm256_set1_ps(-scale);
+    for (; i + 8U <= count; i += 8U)
+    {
+        const __m256 noise = dither != nullptr ? _mm256_loadu_ps(dither + i) : _mm256_setzero_ps();
+        __m256 value = _mm256_fmadd_ps(_mm256_loadu_ps(samples + i), factor, noise);
+        value = _mm256_max_ps(_mm256_min_ps(value, high), low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_cvtps_epi32(value));
+    }
+    for (; i < count; ++i)
+    {
+        const float value = samples[i] * scale + (dither != nullptr ? dither[i] : 0.0f);
+        output[i] = static_cast<std::int32_t>(std::lrint(std::max(-scale, std::min(ceiling, value))));
+    }
+}
+
+AUDIO_TARGET_AVX2 void grainMixAvx2(const float* samples, const float* windows, const float* gainLeft,
+                                    const float* gainRight, std::size_t count, float* sumLeft, float* sumRight)
+{
+    std::size_t i = 0;
+    __m256 accLeft = _mm256_setzero_ps();
+    __m256 accRight = _mm256_setzero_ps();
+    for (; i + 8U <= count; i += 8U)
+    {
+        const __m256 grain = _mm256_mul_ps(_mm256_loadu_ps(samples + i), _mm256_loadu_ps(windows + i));
+        accLeft = _mm256_fmadd_ps(grain, _mm256_loadu_ps(gainLeft + i), accLeft);
+        accRight = _mm256_fmadd_ps(grain, _mm256_loadu_ps(gainRight + i), accRight);
+    }
+
+    float left = horizontalSum256(accLeft);
+    float right = horizontalSum256(accRight);
+    for (; i < count; ++i)
+    {
+        const float grain = samples[i] * windows[i];
+        left += grain * gainLeft[i];
+        right += grain * gainRight[i];
+    }
+    *sumLeft = left;
+    *sumRight = right;
+}
+
+AUDIO_TARGET_AVX2 void addInPlaceAvx2(float* values, const float* increments, std::size_t count)
+{
+    std::size_t i = 0;
+    for (; i + 8U <= count; i += 8U)
+    {
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), _mm256_loadu_ps(increments + i)));
+    }
+    for (; i < count; ++i)
+    {
+        values[i] += increments[i];
+    }
+}
+
+AUDIO_TARGET_AVX2 AUDIO_NO_FP_CONTRACT void feedbackDelayAvx2(const float* input, const float* delayed, float* line,
+                                                              float* output, std::size_t count, float feedback,
+                                                              float dry, float wet, float limit)
+{
+    std::size_t i = 0;
+    const __m256 gain = _mm256_set1_ps(feedback);
+    const __m256 dryGain = _mm256_set1_ps(dry);
+    const __m256 wetGain = _mm256_set1_ps(wet);
+    const __m256 high = _mm256_set1_ps(limit);
+    const __m256 low = _mm256_set1_ps(-limit);
+    for (; i + 8U <= count; i += 8U)
+    {
+        const __m256 x = _mm256_loadu_ps(input + i);
+        const __m256 d = _mm256_loadu_ps(delayed + i);
+        const __m256 recirculated = _mm256_add_ps(x, _mm256_mul_ps(d, gain));
+        _mm256_storeu_ps(line + i, _mm256_min_ps(_mm256_max_ps(recirculated, low), high));
+        _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_mul_ps(dryGain, x), _mm256_mul_ps(wetGain, d)));
+    }
+    feedbackDelayScalar(input + i, delayed + i, line + i, output + i, count - i, feedback, dry, wet, limit);
+}
+
+/// complexMulSse2() on four complex values
+AUDIO_TARGET_AVX2 __m256 complexMulAvx2(__m256 d, __m256 wr, __m256 wiSigned)
+{
+    const __m256 swapped = _mm256_permute_ps(d, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm256_add_ps(_mm256_mul_ps(d, wr), _mm256_mul_ps(swapped, wiSigned));
+}
+
+AUDIO_TARGET_AVX2 void fftStageAvx2(std::size_t n, std::size_t s, const float* x, float* y, const float* twiddles,
+                                    float sign)
+{
+    const std::size_t m = n / 2U;
+    std::size_t p = 0;
+    if (s == 1U)
+    {
+        // Stride one: four butterflies per register. Sums and differences
+        // are paired per 128-bit half, then the halves are put back in order.
+        const __m256 signMask = _mm256_set_ps(sign, -sign, sign, -sign, sign, -sign, sign, -sign);
+        for (; p + 4U <= m; p += 4U)
+        {
+            const __m256 a = _mm256_loadu_ps(x + 2U * p);
+            const __m256 b = _mm256_loadu_ps(x + 2U * (p + m));
+            const __m256 w = _mm256_loadu_ps(twiddles + 2U * p);
+            const __m256 wr = _mm256_moveldup_ps(w);
+            const __m256 wi = _mm256_mul_ps(_mm256_movehdup_ps(w), signMask);
+
+            const __m256d sum = _mm256_castps_pd(_mm256_add_ps(a, b));
+            const __m256d diff = _mm256_castps_pd(complexMulAvx2(_mm256_sub_ps(a, b), wr, wi));
+            const __m256 even = _mm256_castpd_ps(_mm256_unpacklo_pd(sum, diff));   // p, p + 2
+            const __m256 odd = _mm256_castpd_ps(_mm256_unpackhi_pd(sum, diff));    // p + 1, p + 3
+
+            _mm256_storeu_ps(y + 4U * p, _mm256_permute2f128_ps(even, odd, 0x20));
+            _mm256_storeu_ps(y + 4U * p + 8U, _mm256_permute2f128_ps(even, odd, 0x31));
+        }
+    }
+
+    for (; p < m; ++p)
+    {
+        const float wr = twiddles[2U * p * s];
+        const float wi = sign * twiddles[2U * p * s + 1U];
+        const float* xa = x + 2U * (s * p);
+        const float* xb = x + 2U * (s * (p + m));
+        float* ya = y + 2U * (s * (2U * p));
+        float* yb = y + 2U * (s * (2U * p + 1U));
+
+        std::size_t q = 0;
+        const __m256 wrv = _mm256_set1_ps(wr);
+        const __m256 wiv = _mm256_set_ps(wi, -wi, wi, -wi, wi, -wi, wi, -wi);
+        for (; q + 4U <= s; q += 4U)
+        {
+            const __m256 a = _mm256_loadu_ps(xa + 2U * q);
+            const __m256 b = _mm256_loadu_ps(xb + 2U * q);
+            _mm256_storeu_ps(ya + 2U * q, _mm256_add_ps(a, b));
+            _mm256_storeu_ps(yb + 2U * q, complexMulAvx2(_mm256_sub_ps(a, b), wrv, wiv));
+        }
+        // Stride two (the second stage) and stride one past the last full register
+        for (; q + 2U <= s; q += 2U)
+        {
+            const __m128 a = _mm_loadu_ps(xa + 2U * q);
+            const __m128 b = _mm_loadu_ps(xb + 2U * q);
+            const __m128 d = _mm_sub_ps(a, b);
+            const __m128 swapped = _mm_permute_ps(d, _MM_SHUFFLE(2, 3, 0, 1));
+            _mm_storeu_ps(ya + 2U * q, _mm_add_ps(a, b));
+            _mm_storeu_ps(yb + 2U * q, _mm_add_ps(_mm_mul_ps(d, _mm256_castps256_ps128(wrv)),
+                                                  _mm_mul_ps(swapped, _mm256_castps256_ps128(wiv))));
+        }
+        for (; q < s; ++q)
+        {
+            const float dr = xa[2U * q] - xb[2U * q];
+            const float di = xa[2U * q + 1U] - xb[2U * q + 1U];
+            ya[2U * q] = xa[2U * q] + xb[2U * q];
+            ya[2U * q + 1U] = xa[2U * q + 1U] + xb[2U * q + 1U];
+            yb[2U * q] = dr * wr - di * wi;
+            yb[2U * q + 1U] = dr * wi + di * wr;
+        }
+    }
+}
+
+const SimdKernels kAvx2Kernels = {
+    SimdLevel::Avx2,
+    biquadBankAvx2,
+    envelopeFollowAvx2,
+    dualDotProductAvx2,
+    linkedPeaksAvx2,
+    applyStereoGainAvx2,
+    clampSamplesAvx2,
+    quantizeSamplesAvx2,
+    grainMixAvx2,
+    addInPlaceAvx2,
+    feedbackDelayAvx2,
+    fftStageAvx2,
+};
+
+// -----------------------------------------------------------------------------
+// AVX-512F kernels
+// -----------------------------------------------------------------------------
+
+// GCC's AVX-512 intrinsics build their pass-through operand from a
+// self-initialised _mm512_undefined_ps(), which trips -Wuninitialized at -O2
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+AUDIO_TARGET_AVX512 __m512 absolute512(__m512 value)
+{
+    // _mm512_and_ps needs AVX-512DQ; the integer form only needs AVX-512F
+    return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(value), _mm512_set1_epi32(0x7fffffff)));
+}
+
+AUDIO_TARGET_AVX512 void biquadRangeAvx512(const BiquadLanes& lanes, float input, float* output, std::size_t first, std::size_t count)
+{
+    std::size_t i = first;
+    const __m512 x = _mm512_set1_ps(input);
+    for (; i + 16U <= count; i += 16U)
+    {
+        const __m512 y = _mm512_fmadd_ps(_mm512_loadu_ps(lanes.b0 + i), x, _mm512_loadu_ps(lanes.z1 + i));
+        const __m512 nextZ1 = _mm512_fnmadd_ps(_mm512_loadu_ps(lanes.a1 + i), y,
+                                               _mm512_fmadd_ps(_mm512_loadu_ps(lanes.b1 + i), x, _mm512_loadu_ps(lanes.z2 + i)));
+        const __m512 nextZ2 = _mm512_fnmadd_ps(_mm512_loadu_ps(lanes.a2 + i), y,
+                                               _mm512_mul_ps(_mm512_loadu_ps(lanes.b2 + i), x));
+        _mm512_storeu_ps(lanes.z1 + i, nextZ1);
+        _mm512_storeu_ps(lanes.z2 + i, nextZ2);
+        _mm512_storeu_ps(output + i, y);
+    }
+    biquadRangeAvx2(lanes, input, output, i, count);
+}
+
+AUDIO_TARGET_AVX512 void biquadBankAvx512(const BiquadLanes& lanes, float input, float* output, std::size_t count)
+{
+    biquadRangeAvx512(lanes, input, output, 0U, count);
+}
+
+AUDIO_TARGET_AVX512 void envelopeFollowAvx512(const float* input, float* envelope, std::size_t count,
+                                              float attackCoeff, float releaseCoeff)
+{
+    std::size_t i = 0;
+    const __m512 attack = _mm512_set1_ps(attackCoeff);
+    const __m512 release = _mm512_set1_ps(releaseCoeff);
+    for (; i + 16U <= count; i += 16U)
+    {
+        const __m512 rectified = absolute512(_mm512_loadu_ps(input + i));
+        const __m512 current = _mm512_loadu_ps(envelope + i);
+        const __mmask16 rising = _mm512_cmp_ps_mask(rectified, current, _CMP_GT_OQ);
+        const __m512 coeff = _mm512_mask_blend_ps(rising, release, attack);
+        _mm512_storeu_ps(envelope + i, _mm512_fmadd_ps(coeff, _mm512_sub_ps(rectified, current), current));
+    }
+    envelopeFollowAvx2(input + i, envelope + i, count - i, attackCoeff, releaseCoeff);
+}
+
+AUDIO_TARGET_AVX512 void dualDotProductAvx512(const float* weights, const float* left, const float* right, std::size_t count,
+                                              float* sumLeft, float* sumRight)
+{
+    std::size_t i = 0;
+    __m512 accLeft = _mm512_setzero_ps();
+    __m512 accRight = _mm512_setzero_ps();
+    for (; i + 16U <= count; i += 16U)
+    {
+        const __m512 w = _mm512_loadu_ps(weights + i);
+        accLeft = _mm512_fmadd_ps(w, _mm512_loadu_ps(left + i), accLeft);
+        accRight = _mm512_fmadd_ps(w, _mm512_loadu_ps(right + i), accRight);
+    }
+
+    float tailLeft = 0.0f;
+    float tailRight = 0.0f;
+    dualDotProductAvx2(weights + i, left + i, right + i, count - i, &tailLeft, &tailRight);
+    *sumLeft = _mm512_reduce_add_ps(accLeft) + tailLeft;
+    *sumRight = _mm512_reduce_add_ps(accRight) + tailRight;
+}
+
+AUDIO_TARGET_AVX512 void linkedPeaksAvx512(const float* interleaved, float* peaks, std::size_t frames)
+{
+    std::size_t i = 0;
+    const __m512i evenIndex = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i oddIndex = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    for (; i + 16U <= frames; i += 16U)
+    {
+        const __m512 a = absolute512(_mm512_loadu_ps(interleaved + 2U * i));
+        const __m512 b = absolute512(_mm512_loadu_ps(interleaved + 2U * i + 16U));
+        const __m512 left = _mm512_permutex2var_ps(a, evenIndex, b);
+        const __m512 right = _mm512_permutex2var_ps(a, oddIndex, b);
+        _mm512_storeu_ps(peaks + i, _mm512_max_ps(left, right));
+    }
+    linkedPeaksAvx2(interleaved + 2U * i, peaks + i, frames - i);
+}
+
+AUDIO_TARGET_AVX512 void applyStereoGainAvx512(float* interleaved, const float* gains, std::size_t frames)
+{
+    std::size_t i = 0;
+    const __m512i lowIndex = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    const __m512i highIndex = _mm512_setr_epi32(8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15);
+    for (; i + 16U <= frames; i += 16U)
+    {
+        const __m512 gain = _mm512_loadu_ps(gains + i);
+        float* frame = interleaved + 2U * i;
+        _mm512_storeu_ps(frame, _mm512_mul_ps(_mm512_loadu_ps(frame), _mm512_permutexvar_ps(lowIndex, gain)));
+        _mm512_storeu_ps(frame + 16U, _mm512_mul_ps(_mm512_loadu_ps(frame + 16U), _mm512_permutexvar_ps(highIndex, gain)));
+    }
+    applyStereoGainAvx2(interleaved + 2U * i, gains + i, frames - i);
+}
+
+AUDIO_TARGET_AVX512 void clampSamplesAvx512(float* samples, std::size_t count, float limit)
+{
+    std::size_t i = 0;
+    const __m512 high = _mm512_set1_ps(limit);
+    const __m512 low = _mm512_set1_ps(-limit);
+    for (; i + 16U <= count; i += 16U)
+    {
+        _mm512_storeu_ps(samples + i, _mm512_max_ps(low, _mm512_min_ps(high, _mm512_loadu_ps(samples + i))));
+    }
+    clampSamplesAvx2(samples + i, count - i, limit);
+}
+
+AUDIO_TARGET_AVX512 void quantizeSamplesAvx512(const float* samples, const float* dither, std::int32_t* output,
+                                                 std::size_t count, float scale, float ceiling)
+{
+    std::size_t i = 0;
+    const __m512 factor = _mm512_set1_ps(scale);
+    const __m512 high = _mm512_set1_ps(ceiling);
+    const __m512 low = _mm512_set1_ps(-scale);
+    for (; i + 16U <= count; i += 16U)
+    {
+        const __m512 noise = dither != nullptr ? _mm512_loadu_ps(dither + i) : _mm512_setzero_ps();
+        __m512 value = _mm512_fmadd_ps(_mm512_loadu_ps(samples + i), factor, noise);
+        value = _mm512_max_ps(_mm512_min_ps(value, high), low);
+        _mm512_storeu_si512(output + i, _mm512_cvtps_epi32(value));
+    }
+    quantizeSamplesAvx2(samples + i, dither != nullptr ? dither + i : nullptr, output + i, count - i, scale, ceiling);
+}
+
+AUDIO_TARGET_AVX512 void grainMixAvx512(const float* samples, const float* windows, const float* gainLeft,
+                                        const float* gainRight, std::size_t count, float* sumLeft, float* sumRight)
+{
+    std::size_t i = 0;
+    __m512 accLeft = _mm512_setzero_ps();
+    __m512 accRight = _mm512_setzero_ps();
+    for (; i + 16U <= count; i += 16U)
+    {
+        const __m512 grain = _mm512_mul_ps(_mm512_loadu_ps(samples + i), _mm512_loadu_ps(windows + i));
+        accLeft = _mm512_fmadd_ps(grain, _mm512_loadu_ps(gainLeft + i), accLeft);
+        accRight = _mm512_fmadd_ps(grain, _mm512_loadu_ps(gainRight + i), accRight);
+    }
+
+    float tailLeft = 0.0f;
+    float tailRight = 0.0f;
+    grainMixAvx2(samples + i, windows + i, gainLeft + i, gainRight + i, count - i, &tailLeft, &tailRight);
+    *sumLeft = _mm512_reduce_add_ps(accLeft) + tailLeft;
+    *sumRight = _mm512_reduce_add_ps(accRight) + tailRight;
+}
+
+AUDIO_TARGET_AVX512 void addInPlaceAvx512(float* values, const float* increments, std::size_t count)
+{
+    std::size_t i = 0;
+    for (; i + 16U <= count; i += 16U)
+    {
+        _mm512_storeu_ps(values + i, _mm512_add_ps(_mm512_loadu_ps(values + i), _mm512_loadu_ps(increments + i)));
+    }
+    addInPlaceAvx2(values + i, increments + i, count - i);
+}
+
+AUDIO_TARGET_AVX512 AUDIO_NO_FP_CONTRACT void feedbackDelayAvx512(const float* input, const float* delayed,
+                                                                  float* line, float* output, std::size_t count,
+                                                                  float feedback, float dry, float wet, float limit)
+{
+    std::size_t i = 0;
+    const __m512 gain = _mm512_set1_ps(feedback);
+    const __m512 dryGain = _mm512_set1_ps(dry);
+    const __m512 wetGain = _mm512_set1_ps(wet);
+    const __m512 high = _mm512_set1_ps(limit);
+    const __m512 low = _mm512_set1_ps(-limit);
+    for (; i + 16U <= count; i += 16U)
+    {
+        const __m512 x = _mm512_loadu_ps(input + i);
+        const __m512 d = _mm512_loadu_ps(delayed + i);
+        const __m512 recirculated = _mm512_add_ps(x, _mm512_mul_ps(d, gain));
+        _mm512_storeu_ps(line + i, _mm512_min_ps(_mm512_max_ps(recirculated, low), high));
+        _mm512_storeu_ps(output + i, _mm512_add_ps(_mm512_mul_ps(dryGain, x), _mm512_mul_ps(wetGain, d)));
+    }
+    feedbackDelayAvx2(input + i, delayed + i, line + i, output + i, count - i, feedback, dry, wet, limit);
+}
+
+AUDIO_TARGET_AVX512 void fftStageAvx512(std::size_t n, std::size_t s, const float* x, float* y,
+                                        const float* twiddles, float sign)
+{
+    // Early stages have too few butterflies per twiddle to fill a register
+    if (s < 8U)
+    {
+        fftStageAvx2(n, s, x, y, twiddles, sign);
+        return;
+    }
+
+    const std::size_t m = n / 2U;
+    for (std::size_t p = 0; p < m; ++p)
+    {
+        const float wr = twiddles[2U * p * s];
+        const float wi = sign * twiddles[2U * p * s + 1U];
+        const float* xa = x + 2U * (s * p);
+        const float* xb = x + 2U * (s * (p + m));
+        float* ya = y + 2U * (s * (2U * p));
+        float* yb = y + 2U * (s * (2U * p + 1U));
+
+        std::size_t q = 0;
+        const __m512 wrv = _mm512_set1_ps(wr);
+        const __m512 wiv = _mm512_broadcast_f32x4(_mm_set_ps(wi, -wi, wi, -wi));
+        for (; q + 8U <= s; q += 8U)
+        {
+            const __m512 a = _mm512_loadu_ps(xa + 2U * q);
+            const __m512 b = _mm512_loadu_ps(xb + 2U * q);
+            const __m512 d = _mm512_sub_ps(a, b);
+            const __m512 swapped = _mm512_permute_ps(d, _MM_SHUFFLE(2, 3, 0, 1));
+            _mm512_storeu_ps(ya + 2U * q, _mm512_add_ps(a, b));
+            _mm512_storeu_ps(yb + 2U * q, _mm512_add_ps(_mm512_mul_ps(d, wrv), _mm512_mul_ps(swapped, wiv)));
+        }
+        for (; q < s; ++q)
+        {
+            const float dr = xa[2U * q] - xb[2U * q];
+            const float di = xa[2U * q + 1U] - xb[2U * q + 1U];
+            ya[2U * q] = xa[2U * q] + xb[2U * q];
+            ya[2U * q + 1U] = xa[2U * q + 1U] + xb[2U * q + 1U];
+            yb[2U * q] = dr * wr - di * wi;
+            yb[2U * q + 1U] = dr * wi + di * wr;
+        }
+    }
+}
+
+const SimdKernels kAvx512Kernels = {
+    SimdLevel::Avx512,
+    biquadBankAvx512,
+    envelopeFollowAvx512,
+    dualDotProductAvx512,
+    linkedPeaksAvx512,
+    applyStereoGainAvx512,
+    clampSamplesAvx512,
+    quantizeSamplesAvx512,
+    grainMixAvx512,
+    addInPlaceAvx512,
+    feedbackDelayAvx512,
+    fftStageAvx512,
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // AUDIO_SIMD_X86
+
+SimdLevel selectLevel()
+{
+    SimdLevel level = detectedSimdLevel();
+    SimdLevel requested = level;
+    if (simdLevelFromName(std::getenv("AUDIO_SIMD"), requested) && requested < level)
+    {
+        level = requested;
+    }
+    return level;
+}
+}
+
+const SimdKernels& simdKernelsFor(SimdLevel level)
+{
+    level = std::min(level, detectedSimdLevel());
+
+#if defined(AUDIO_SIMD_X86)
+    switch (level)
+    {
+    case SimdLevel::Avx512:
+        return kAvx512Kernels;
+    case SimdLevel::Avx2:
+        return kAvx2Kernels;
+    case SimdLevel::Sse2:
+        return kSse2Kernels;
+    case SimdLevel::Scalar:
+    default:
+        break;
+    }
+#endif
+
+    return kScalarKernels;
+}
+
+const SimdKernels& simdKernels()
+{
+    static const SimdKernels& kernels = simdKernelsFor(selectLevel());
+    return kernels;
+}
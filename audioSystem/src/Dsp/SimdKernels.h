@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CpuFeatures.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file SimdKernels.h
+ * @brief Block DSP kernels compiled for several instruction sets, picked at runtime
+ *
+ * Every kernel exists in scalar, SSE2, AVX2+FMA and AVX-512F versions. The
+ * wider versions are compiled with per-function target attributes, so the
+ * build needs no extra flags and the binary still runs on baseline x86-64
+ * hosts. simdKernels() returns the table for the best level the host
+ * supports; callers fetch it once during construction and call through the
+ * function pointers on the audio thread.
+ *
+ * Kernels accept any count and finish ragged tails without leaving their
+ * instruction set. Results can differ from the scalar version in the last
+ * bits because FMA and summation order change the rounding.
+ */
+
+/**
+ * @struct BiquadLanes
+ * @brief Structure-of-arrays coefficients and state for parallel biquads
+ */
+struct BiquadLanes
+{
+    const float* b0;
+    const float* b1;
+    const float* b2;
+    const float* a1;
+    const float* a2;
+    float* z1;
+    float* z2;
+};
+
+/**
+ * @struct SimdKernels
+ * @brief Dispatch table for one SimdLevel
+ */
+struct SimdKernels
+{
+    SimdLevel level;
+
+    /// Run one input sample through count transposed direct form II biquads
+    void (*biquadBank)(const BiquadLanes& lanes, float input, float* output, std::size_t count);
+
+    /// Peak envelope followers: envelope += coeff * (|input| - envelope), attack coeff when rising
+    void (*envelopeFollow)(const float* input, float* envelope, std::size_t count, float attackCoeff, float releaseCoeff);
+
+    /// Two dot products sharing one weight vector (band summing, interpolation filters)
+    void (*dualDotProduct)(const float* weights, const float* left, const float* right, std::size_t count,
+                           float* sumLeft, float* sumRight);
+
+    /// Largest absolute value of the two channels of every interleaved stereo frame
+    void (*linkedPeaks)(const float* interleaved, float* peaks, std::size_t frames);
+
+    /// Multiply every interleaved stereo frame by its own gain
+    void (*applyStereoGain)(float* interleaved, const float* gains, std::size_t frames);
+
+    /// Clamp samples to [-limit, limit]
+    void (*clampSamples)(float* samples, std::size_t count, float limit);
+
+    /**
+     * Scale samples to integers for an output device: round to nearest of
+     * sample * scale + dither, clamped to [-scale, ceiling]. dither may be
+     * null; ceiling must be representable in an int32.
+     */
+    void (*quantizeSamples)(const float* samples, const float* dither, std::int32_t* output, std::size_t count,
+                            float scale, float ceiling);
+
+    /// Sum of windowed, panned grains: sample * window * gain for each channel
+    void (*grainMix)(const float* samples, const float* windows, const float* gainLeft, const float* gainRight,
+                     std::size_t count, float* sumLeft, float* sumRight);
+
+    /// values[i] += increments[i]
+    void (*addInPlace)(float* values, const float* increments, std::size_t count);
+
+    /**
+     * One stretch of a feedback delay line: line = clamp(input + delayed *
+     * feedback, [-limit, limit]) and output = dry * input + wet * delayed.
+     * output may alias input; line must not overlap delayed. No level fuses
+     * the multiply-adds, so every level rounds like the per-sample code.
+     */
+    void (*feedbackDelay)(const float* input, const float* delayed, float* line, float* output, std::size_t count,
+                          float feedback, float dry, float wet, float limit);
+
+    /**
+     * One radix-2 Stockham stage of an FFTPlan: for sub-transform length n
+     * and stride s, y[q + s*2p] = a + b and y[q + s*(2p + 1)] = (a - b) * W^(p*s)
+     * with a = x[q + s*p], b = x[q + s*(p + n/2)], on interleaved complex
+     * values. twiddles holds W^k = exp(-2*pi*i*k / (n * s)); sign -1 conjugates
+     * them for the inverse. x and y must not overlap.
+     */
+    void (*fftStage)(std::size_t n, std::size_t s, const float* x, float* y, const float* twiddles, float sign);
+};
+
+/**
+ * @brief Kernels for the best level this host supports
+ *
+ * Chosen on first call. Setting the AUDIO_SIMD environment variable to
+ * scalar, sse2, avx2 or avx512 caps the level, which is useful to compare
+ * results or reproduce an issue seen on older machines.
+ */
+const SimdKernels& simdKernels();
+
+/**
+ * @brief Kernels for a specific level, lowered to what the host supports
+ */
+const SimdKernels& simdKernelsFor(SimdLevel level);
@@ -20,11 +20,13 @@ DelayEffect::DelayEffect(float delayTime, float feedback, float mix, float sampl
     : m_bufferLeft{}
     , m_bufferRight{}
     , m_writeIndex(0)
+    , m_matchedWrites(0)
     , m_delaySamples(1)
     , m_delayTime(clampValue(delayTime, kMinDelaySeconds, kMaxDelaySeconds))
     , m_feedback(clampValue(feedback, 0.0f, kMaxFeedback))
     , m_mix(clampValue(mix, 0.0f, 1.0f))
     , m_sampleRate(std::max(sampleRate, 100.0f))
+    , m_kernels(&simdKernels())
 {
     allocateBuffers();
     updateDelaySamples();
@@ -49,6 +51,16 @@ std::pair<float, float> DelayEffect::process(std::pair<float, float> stereoSampl
     m_bufferLeft[m_writeIndex] = clampValue(feedbackLeft, -2.0f, 2.0f);
     m_bufferRight[m_writeIndex] = clampValue(feedbackRight, -2.0f, 2.0f);
 
+    // The lines are equal once a full buffer of writes has matched
+    if (m_bufferLeft[m_writeIndex] != m_bufferRight[m_writeIndex])
+    {
+        m_matchedWrites = 0U;
+    }
+    else if (m_matchedWrites < length)
+    {
+        ++m_matchedWrites;
+    }
+
     const float dryCoeff = 1.0f - m_mix;
     const float wetCoeff = m_mix;
 
@@ -60,11 +72,97 @@ std::pair<float, float> DelayEffect::process(std::pair<float, float> stereoSampl
     return {outLeft, outRight};
 }
 
+float DelayEffect::processMono(float sample)
+{
+    const std::size_t length = bufferLength();
+    if (length == 0U)
+    {
+        return sample;
+    }
+
+    const std::size_t readIndex = (m_writeIndex + length - m_delaySamples) % length;
+    const float delayed = m_bufferLeft[readIndex];
+    // Keeping the right line current costs one store here instead of a full copy on the way back to stereo
+    const float written = clampValue(sample + delayed * m_feedback, -2.0f, 2.0f);
+    m_bufferLeft[m_writeIndex] = written;
+    m_bufferRight[m_writeIndex] = written;
+    m_writeIndex = (m_writeIndex + 1U) % length;
+
+    return (1.0f - m_mix) * sample + m_mix * delayed;
+}
+
+void DelayEffect::processBlock(float* left, float* right, std::size_t frames)
+{
+    const std::size_t length = bufferLength();
+    if (length == 0U)
+    {
+        return;
+    }
+
+    const float dryCoeff = 1.0f - m_mix;
+    std::size_t done = 0U;
+    while (done < frames)
+    {
+        const std::size_t readIndex = (m_writeIndex + length - m_delaySamples) % length;
+        const std::size_t count = blockSegment(readIndex, frames - done);
+        float* writtenLeft = &m_bufferLeft[m_writeIndex];
+        float* writtenRight = &m_bufferRight[m_writeIndex];
+        m_kernels->feedbackDelay(left + done, &m_bufferLeft[readIndex], writtenLeft, left + done, count,
+                                 m_feedback, dryCoeff, m_mix, 2.0f);
+        m_kernels->feedbackDelay(right + done, &m_bufferRight[readIndex], writtenRight, right + done, count,
+                                 m_feedback, dryCoeff, m_mix, 2.0f);
+
+        // Same bookkeeping as process(): the run of matching writes restarts after the last mismatch
+        std::size_t matched = 0U;
+        while (matched < count && writtenLeft[count - 1U - matched] == writtenRight[count - 1U - matched])
+        {
+            ++matched;
+        }
+        m_matchedWrites = matched < count ? matched : std::min(m_matchedWrites + count, length);
+
+        m_writeIndex = (m_writeIndex + count) % length;
+        done += count;
+    }
+}
+
+void DelayEffect::processMonoBlock(float* samples, std::size_t frames)
+{
+    const std::size_t length = bufferLength();
+    if (length == 0U)
+    {
+        return;
+    }
+
+    const float dryCoeff = 1.0f - m_mix;
+    std::size_t done = 0U;
+    while (done < frames)
+    {
+        const std::size_t readIndex = (m_writeIndex + length - m_delaySamples) % length;
+        const std::size_t count = blockSegment(readIndex, frames - done);
+        float* written = &m_bufferLeft[m_writeIndex];
+        m_kernels->feedbackDelay(samples + done, &m_bufferLeft[readIndex], written, samples + done, count,
+                                 m_feedback, dryCoeff, m_mix, 2.0f);
+        std::copy(written, written + count, m_bufferRight.begin() + static_cast<std::ptrdiff_t>(m_writeIndex));
+
+        m_writeIndex = (m_writeIndex + count) % length;
+        done += count;
+    }
+}
+
+std::size_t DelayEffect::blockSegment(std::size_t readIndex, std::size_t frames) const
+{
+    const std::size_t length = bufferLength();
+    const std::size_t toWrap = std::min(length - m_writeIndex, length - readIndex);
+    const std::size_t apart = std::min(m_delaySamples, length - m_delaySamples);
+    return std::min(frames, std::min(toWrap, apart));
+}
+
 void DelayEffect::reset()
 {
     std::fill(m_bufferLeft.begin(), m_bufferLeft.end(), 0.0f);
     std::fill(m_bufferRight.begin(), m_bufferRight.end(), 0.0f);
     m_writeIndex = 0U;
+    m_matchedWrites = bufferLength();
 }
 
 void DelayEffect::setSampleRate(float sampleRate)
@@ -115,6 +213,7 @@ void DelayEffect::allocateBuffers()
     {
         m_bufferLeft.assign(targetSize, 0.0f);
         m_bufferRight.assign(targetSize, 0.0f);
+        m_matchedWrites = targetSize;
     }
 
     if (m_writeIndex >= targetSize)
@@ -139,3 +238,9 @@ void DelayEffect::updateDelaySamples()
     const std::size_t samples = static_cast<std::size_t>(std::round(m_delayTime * m_sampleRate));
     m_delaySamples = clampValue<std::size_t>(samples, 1U, length - 1U);
 }
+
+std::size_t DelayEffect::memoryBytes() const
+{
+    // Both channels are sized for kMaxDelaySeconds whatever the delay time
+    return sizeof(*this) + (m_bufferLeft.capacity() + m_bufferRight.capacity()) * sizeof(float);
+}
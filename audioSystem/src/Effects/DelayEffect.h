@@ -1,5 +1,6 @@
 #pragma once
 #include "IEffect.h"
+#include "Dsp/SimdKernels.h"
 #include <vector>
 #include <cstddef>
 
@@ -25,8 +26,20 @@ public:
 
     /** Process a stereo sample and return the delayed result */
     std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    /** Both channels are delayed alike, so mono stays mono */
+    bool preservesMono() const override { return true; }
+    /** Whether both delay lines hold the same samples */
+    bool channelsMatch() const override { return m_matchedWrites >= bufferLength(); }
+    /** Process a mono sample, writing the same value to both delay lines */
+    float processMono(float sample) override;
+    /** Process a stereo block through the dispatched feedback-delay kernel */
+    void processBlock(float* left, float* right, std::size_t frames) override;
+    /** Process a mono block, writing the same values to both delay lines */
+    void processMonoBlock(float* samples, std::size_t frames) override;
     /** Reset the internal delay buffer */
     void reset() override;
+    const char* name() const override { return "delay"; }
+    std::size_t memoryBytes() const override;
 
     /// Change the sampling rate and resize the buffer accordingly
     void setSampleRate(float sampleRate);
@@ -50,11 +63,13 @@ private:
     std::vector<float> m_bufferLeft;   ///< Circular buffer for left channel
     std::vector<float> m_bufferRight;  ///< Circular buffer for right channel
     std::size_t m_writeIndex;          ///< Current write index in buffers
+    std::size_t m_matchedWrites;       ///< Consecutive writes equal in both lines, up to bufferLength()
     std::size_t m_delaySamples;        ///< Delay offset in samples
     float m_delayTime;                 ///< Delay time in seconds
     float m_feedback;                  ///< Feedback amount
     float m_mix;                       ///< Wet/dry mix
     float m_sampleRate;                ///< Current sampling rate
+    const SimdKernels* m_kernels;      ///< Selected at construction
 
     /** Ensure internal buffers are sized for the configured sample rate */
     void allocateBuffers();
@@ -62,6 +77,13 @@ private:
     /** Update sample offset after delay time/sample rate changes */
     void updateDelaySamples();
 
+    /**
+     * Frames the block path can run from readIndex in one kernel call: up
+     * to a wrap of either index, and short enough that the stretch written
+     * is never read back within it
+     */
+    std::size_t blockSegment(std::size_t readIndex, std::size_t frames) const;
+
     /** Convenience accessor */
     std::size_t bufferLength() const { return m_bufferLeft.size(); }
 };
@@ -0,0 +1,144 @@
+#include "EffectPool.h"
+
+#include <algorithm>
+
+constexpr std::size_t EffectPool::kSpectralFrameSize;
+constexpr std::size_t EffectPool::kMaxInstances;
+
+// -----------------------------------------------------------------------------
+// EffectPool implementation
+// -----------------------------------------------------------------------------
+
+EffectPool::Limits EffectPool::defaultLimits()
+{
+    Limits limits;
+    limits.delay = 2U;
+    limits.lowPass = 2U;
+    limits.octave = 2U;
+    limits.spectralFreeze = 2U;
+    limits.spectralSmear = 2U;
+    return limits;
+}
+
+EffectPool::EffectPool(float sampleRate, bool spectralWorker)
+    : EffectPool(sampleRate, spectralWorker, defaultLimits())
+{
+}
+
+EffectPool::EffectPool(float sampleRate, bool spectralWorker, const Limits& limits)
+    : m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f)
+    , m_spectralWorker(spectralWorker)
+{
+    for (std::size_t i = 0; i < std::min(limits.delay, kMaxInstances); ++i)
+    {
+        m_delays.push_back(std::make_shared<DelayEffect>(0.3f, 0.5f, 0.5f, m_sampleRate));
+    }
+    for (std::size_t i = 0; i < std::min(limits.lowPass, kMaxInstances); ++i)
+    {
+        m_lowPasses.push_back(std::make_shared<LowPassEffect>(1200.0f, m_sampleRate));
+    }
+    for (std::size_t i = 0; i < std::min(limits.octave, kMaxInstances); ++i)
+    {
+        auto octave = std::make_shared<OctaveEffect>();
+        octave->setSampleRate(m_sampleRate);
+        m_octaves.push_back(octave);
+    }
+
+    // Workers start in acquire*(), so idle spectral instances hold no thread
+    for (std::size_t i = 0; i < std::min(limits.spectralFreeze, kMaxInstances); ++i)
+    {
+        m_freezes.push_back(std::make_shared<SpectralFreezeEffect>(1.0f, m_sampleRate, kSpectralFrameSize, false));
+    }
+    for (std::size_t i = 0; i < std::min(limits.spectralSmear, kMaxInstances); ++i)
+    {
+        m_smears.push_back(std::make_shared<SpectralSmearEffect>(0.5f, 1.0f, m_sampleRate, kSpectralFrameSize, false));
+    }
+}
+
+template <typename T>
+std::shared_ptr<T> EffectPool::findIdle(const std::vector<std::shared_ptr<T>>& instances)
+{
+    for (const auto& instance : instances)
+    {
+        // Only the pool holds it, so no chain can be processing it
+        if (instance.use_count() == 1)
+        {
+            return instance;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<DelayEffect> EffectPool::acquireDelay(float delayTime, float feedback, float mix)
+{
+    auto delay = findIdle(m_delays);
+    if (delay)
+    {
+        delay->setDelayTime(delayTime);
+        delay->setFeedback(feedback);
+        delay->setMix(mix);
+        delay->reset();
+    }
+    return delay;
+}
+
+std::shared_ptr<LowPassEffect> EffectPool::acquireLowPass(float cutoff, float resonance, float mix)
+{
+    auto lowPass = findIdle(m_lowPasses);
+    if (lowPass)
+    {
+        lowPass->setCutoff(cutoff);
+        lowPass->setResonance(resonance);
+        lowPass->setMix(mix);
+        lowPass->reset();
+    }
+    return lowPass;
+}
+
+std::shared_ptr<OctaveEffect> EffectPool::acquireOctave(bool higher, float blend, float frequency)
+{
+    auto octave = findIdle(m_octaves);
+    if (octave)
+    {
+        octave->setHigher(higher);
+        octave->setBlend(blend);
+        if (frequency > 0.0f)
+        {
+            octave->setFrequency(frequency);
+        }
+        octave->reset();
+    }
+    return octave;
+}
+
+std::shared_ptr<SpectralFreezeEffect> EffectPool::acquireSpectralFreeze(float mix)
+{
+    auto freeze = findIdle(m_freezes);
+    if (freeze)
+    {
+        if (m_spectralWorker)
+        {
+            freeze->startWorker();
+        }
+        freeze->setFrozen(false);
+        freeze->setMix(mix);
+        freeze->reset();
+    }
+    return freeze;
+}
+
+std::shared_ptr<SpectralSmearEffect> EffectPool::acquireSpectralSmear(float amount, float mix)
+{
+    auto smear = findIdle(m_smears);
+    if (smear)
+    {
+        if (m_spectralWorker)
+        {
+            smear->startWorker();
+        }
+        smear->setAmount(amount);
+        smear->setMix(mix);
+        smear->reset();
+    }
+    return smear;
+}
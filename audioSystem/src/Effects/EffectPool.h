@@ -0,0 +1,89 @@
+#pragma once
+
+#include "DelayEffect.h"
+#include "LowPassEffect.h"
+#include "OctaveEffect.h"
+#include "SpectralFreezeEffect.h"
+#include "SpectralSmearEffect.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @file EffectPool.h
+ * @brief Effect instances built at startup and reused for every chain insertion
+ */
+
+/**
+ * @class EffectPool
+ * @brief Hands out ready-to-use effects without allocating
+ *
+ * All instances, including the delay lines and FFT buffers, are constructed
+ * up front. Spectral instances only start their worker thread the first
+ * time they are acquired, so unused ones cost no thread.
+ *
+ * An instance is free when the pool holds its only reference, i.e. once the
+ * effect chain has let go of it. acquire*() resets a free instance, applies
+ * the requested parameters and returns it, or returns nullptr when every
+ * instance of that type is still in use.
+ *
+ * Rebuilding the chain claims new instances before the audio thread has
+ * released the old ones, so keep at least two of each type that is toggled.
+ * The pool is not thread safe; use it from the thread that edits the chain.
+ */
+class EffectPool
+{
+public:
+    static constexpr std::size_t kSpectralFrameSize = 2048;
+    static constexpr std::size_t kMaxInstances = 16;   ///< Most instances built per type
+
+    /**
+     * @brief Number of instances created per effect type, each at most kMaxInstances
+     */
+    struct Limits
+    {
+        std::size_t delay;
+        std::size_t lowPass;
+        std::size_t octave;
+        std::size_t spectralFreeze;
+        std::size_t spectralSmear;
+    };
+
+    /// Default limits: two of each type, enough for one rebuild in flight
+    static Limits defaultLimits();
+
+    /**
+     * @brief Create every pooled instance
+     * @param sampleRate Sampling rate in Hz
+     * @param spectralWorker Run spectral effects on a worker thread, started on first acquisition
+     * @param limits Instances per type
+     */
+    EffectPool(float sampleRate, bool spectralWorker, const Limits& limits);
+    EffectPool(float sampleRate, bool spectralWorker);
+
+    EffectPool(const EffectPool&) = delete;
+    EffectPool& operator=(const EffectPool&) = delete;
+
+    std::shared_ptr<DelayEffect> acquireDelay(float delayTime, float feedback, float mix);
+    std::shared_ptr<LowPassEffect> acquireLowPass(float cutoff, float resonance, float mix);
+    /// @param frequency Current note frequency, or 0 if no note is playing
+    std::shared_ptr<OctaveEffect> acquireOctave(bool higher, float blend, float frequency);
+    std::shared_ptr<SpectralFreezeEffect> acquireSpectralFreeze(float mix);
+    std::shared_ptr<SpectralSmearEffect> acquireSpectralSmear(float amount, float mix);
+
+    float sampleRate() const { return m_sampleRate; }
+
+private:
+    /// First instance nobody outside the pool references, or nullptr
+    template <typename T>
+    static std::shared_ptr<T> findIdle(const std::vector<std::shared_ptr<T>>& instances);
+
+    float m_sampleRate;
+    bool m_spectralWorker;
+    std::vector<std::shared_ptr<DelayEffect>> m_delays;
+    std::vector<std::shared_ptr<LowPassEffect>> m_lowPasses;
+    std::vector<std::shared_ptr<OctaveEffect>> m_octaves;
+    std::vector<std::shared_ptr<SpectralFreezeEffect>> m_freezes;
+    std::vector<std::shared_ptr<SpectralSmearEffect>> m_smears;
+};
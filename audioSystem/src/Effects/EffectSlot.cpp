@@ -0,0 +1,114 @@
+#include "EffectSlot.h"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr float EffectSlot::kDefaultCrossfadeSeconds;
+
+// -----------------------------------------------------------------------------
+// EffectSlot implementation
+// -----------------------------------------------------------------------------
+
+EffectSlot::EffectSlot(std::shared_ptr<IEffect> effect, float sampleRate)
+    : m_effect(std::move(effect))
+    , m_bypassRequested(false)
+    , m_keepWarm(false)
+    , m_settledBypassed(false)
+    , m_fadeFrames(1U)
+    , m_fadeRemaining(0U)
+    , m_wet(1.0f)
+    , m_shedSequence(0U)
+    , m_stale(false)
+    , m_mono(false)
+{
+    setCrossfadeTime(kDefaultCrossfadeSeconds, sampleRate);
+}
+
+EffectSlot::EffectSlot(EffectSlot&& other) noexcept
+    : m_effect(std::move(other.m_effect))
+    , m_bypassRequested(other.m_bypassRequested.load(std::memory_order_relaxed))
+    , m_keepWarm(other.m_keepWarm.load(std::memory_order_relaxed))
+    , m_settledBypassed(other.m_settledBypassed)
+    , m_fadeFrames(other.m_fadeFrames)
+    , m_fadeRemaining(other.m_fadeRemaining)
+    , m_wet(other.m_wet)
+    , m_meter(other.m_meter)
+    , m_shedSequence(other.m_shedSequence)
+    , m_stale(other.m_stale)
+    , m_mono(other.m_mono)
+{
+}
+
+EffectSlot& EffectSlot::operator=(EffectSlot&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_effect = std::move(other.m_effect);
+        m_bypassRequested.store(other.m_bypassRequested.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_keepWarm.store(other.m_keepWarm.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_settledBypassed = other.m_settledBypassed;
+        m_fadeFrames = other.m_fadeFrames;
+        m_fadeRemaining = other.m_fadeRemaining;
+        m_wet = other.m_wet;
+        m_meter = other.m_meter;
+        m_shedSequence = other.m_shedSequence;
+        m_stale = other.m_stale;
+        m_mono = other.m_mono;
+    }
+    return *this;
+}
+
+std::pair<float, float> EffectSlot::processTransition(std::pair<float, float> stereoSample, bool bypassed)
+{
+    advanceFade(bypassed);
+    const std::pair<float, float> wet = m_effect->process(stereoSample);
+    return {stereoSample.first + m_wet * (wet.first - stereoSample.first),
+            stereoSample.second + m_wet * (wet.second - stereoSample.second)};
+}
+
+float EffectSlot::processTransitionMono(float sample, bool bypassed)
+{
+    advanceFade(bypassed);
+    const float wet = m_effect->processMono(sample);
+    return sample + m_wet * (wet - sample);
+}
+
+void EffectSlot::advanceFade(bool bypassed)
+{
+    if (bypassed != m_settledBypassed)
+    {
+        // A cold effect comes back from silence: drop whatever it held when bypassed
+        if (!bypassed && m_wet <= 0.0f && m_stale)
+        {
+            m_effect->reset();
+        }
+        m_stale = false;
+
+        // Reversing mid-fade continues from the current level
+        m_settledBypassed = bypassed;
+        const float distance = bypassed ? m_wet : 1.0f - m_wet;
+        m_fadeRemaining = std::max(1U, static_cast<unsigned int>(std::lround(distance * static_cast<float>(m_fadeFrames))));
+    }
+
+    const float target = m_settledBypassed ? 0.0f : 1.0f;
+    m_wet += (target - m_wet) / static_cast<float>(m_fadeRemaining);
+    if (--m_fadeRemaining == 0U)
+    {
+        m_wet = target;
+    }
+}
+
+void EffectSlot::setCrossfadeTime(float seconds, float sampleRate)
+{
+    const float frames = std::max(seconds, 0.0f) * std::max(sampleRate, 1.0f);
+    m_fadeFrames = std::max(1U, static_cast<unsigned int>(std::lround(frames)));
+}
+
+void EffectSlot::reset()
+{
+    m_effect->reset();
+    m_settledBypassed = m_bypassRequested.load(std::memory_order_relaxed) || m_shedSequence != 0U;
+    m_fadeRemaining = 0U;
+    m_stale = false;
+    m_wet = m_settledBypassed ? 0.0f : 1.0f;
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "IEffect.h"
+#include "CpuMeter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @file EffectSlot.h
+ * @brief Position in the effect chain with a click-free bypass switch
+ */
+
+/**
+ * @class EffectSlot
+ * @brief Owns one effect in the chain and handles bypassing it
+ *
+ * A settled, bypassed slot returns its input without calling the effect, so
+ * an idle effect costs one atomic load per sample. Switching either way runs
+ * a short linear crossfade between the dry input and the effect output. A
+ * slot can optionally keep its effect "warm" while bypassed: the effect still
+ * processes the input and its output is discarded, so delay tails and filter
+ * states are current when it comes back. A cold effect is reset as it is
+ * re-enabled so stale state is never heard. The load governor bypasses
+ * slots the same way through setShed(), independently of setBypassed().
+ *
+ * While the chain carries a mono signal the engine calls processMono()
+ * instead on the leading slots where canProcessMono() holds, after
+ * setMono(true); setMono(false) splits the effect's state back to stereo
+ * before the next process(). The block variants process a whole quantum
+ * at once and give the same output.
+ *
+ * setBypassed() and setKeepWarm() may be called from any thread; everything
+ * else belongs to the audio thread.
+ */
+class EffectSlot
+{
+public:
+    static constexpr float kDefaultCrossfadeSeconds = 0.01f;
+
+    /**
+     * @brief Wrap an effect
+     * @param effect Effect to process (must not be null)
+     * @param sampleRate Sampling rate used to size the crossfade
+     */
+    explicit EffectSlot(std::shared_ptr<IEffect> effect, float sampleRate = 44100.0f);
+
+    EffectSlot(EffectSlot&& other) noexcept;
+    EffectSlot& operator=(EffectSlot&& other) noexcept;
+    EffectSlot(const EffectSlot&) = delete;
+    EffectSlot& operator=(const EffectSlot&) = delete;
+
+    /**
+     * @brief Process one stereo sample through the slot
+     */
+    std::pair<float, float> process(std::pair<float, float> stereoSample)
+    {
+        const bool bypassed = m_bypassRequested.load(std::memory_order_relaxed) || m_shedSequence != 0U;
+        if (bypassed == m_settledBypassed && m_fadeRemaining == 0U)
+        {
+            if (!bypassed)
+            {
+                return m_effect->process(stereoSample);
+            }
+            if (m_keepWarm.load(std::memory_order_relaxed) && m_shedSequence == 0U)
+            {
+                m_effect->process(stereoSample);
+            }
+            else
+            {
+                m_stale = true;
+            }
+            return stereoSample;
+        }
+        return processTransition(stereoSample, bypassed);
+    }
+
+    /**
+     * @brief Process one sample of a mono chain (the effect must preserve mono)
+     */
+    float processMono(float sample)
+    {
+        const bool bypassed = m_bypassRequested.load(std::memory_order_relaxed) || m_shedSequence != 0U;
+        if (bypassed == m_settledBypassed && m_fadeRemaining == 0U)
+        {
+            if (!bypassed)
+            {
+                return m_effect->processMono(sample);
+            }
+            if (m_keepWarm.load(std::memory_order_relaxed) && m_shedSequence == 0U)
+            {
+                m_effect->processMono(sample);
+            }
+            else
+            {
+                m_stale = true;
+            }
+            return sample;
+        }
+        return processTransitionMono(sample, bypassed);
+    }
+
+    /**
+     * @brief Process a block of stereo samples in place
+     *
+     * A settled, active slot hands the whole block to the effect; bypassed
+     * or fading slots go frame by frame exactly as process() does.
+     */
+    void processBlock(float* left, float* right, std::size_t frames)
+    {
+        if (isSettledActive())
+        {
+            m_effect->processBlock(left, right, frames);
+            return;
+        }
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const std::pair<float, float> output = process({left[i], right[i]});
+            left[i] = output.first;
+            right[i] = output.second;
+        }
+    }
+
+    /**
+     * @brief Process a block of a mono chain in place (see processMono())
+     */
+    void processMonoBlock(float* samples, std::size_t frames)
+    {
+        if (isSettledActive())
+        {
+            m_effect->processMonoBlock(samples, frames);
+            return;
+        }
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            samples[i] = processMono(samples[i]);
+        }
+    }
+
+    /**
+     * @brief Whether a mono chain may run through processMono() here (audio thread)
+     *
+     * The effect must preserve mono and have matching channels; a stale
+     * effect qualifies too, since it is reset before it is heard again.
+     */
+    bool canProcessMono() const
+    {
+        return m_effect->preservesMono() && (m_stale || m_effect->channelsMatch());
+    }
+
+    /**
+     * @brief Say whether the next samples come through processMono() (audio thread, per quantum)
+     *
+     * Going from mono to stereo calls the effect's splitMono().
+     */
+    void setMono(bool mono)
+    {
+        if (m_mono && !mono)
+        {
+            m_effect->splitMono();
+        }
+        m_mono = mono;
+    }
+
+    /**
+     * @brief Request bypass on or off; takes effect with a crossfade
+     * @param bypassed true to take the effect out of the signal path
+     */
+    void setBypassed(bool bypassed) { m_bypassRequested.store(bypassed, std::memory_order_relaxed); }
+
+    /// Keep processing (and discarding) while bypassed so state stays current
+    void setKeepWarm(bool keepWarm) { m_keepWarm.store(keepWarm, std::memory_order_relaxed); }
+
+    /// Change the crossfade length used by later switches
+    void setCrossfadeTime(float seconds, float sampleRate);
+
+    /// Reset the effect and finish any crossfade immediately
+    void reset();
+
+    bool isBypassed() const { return m_bypassRequested.load(std::memory_order_relaxed); }
+    bool keepsWarm() const { return m_keepWarm.load(std::memory_order_relaxed); }
+    const std::shared_ptr<IEffect>& effect() const { return m_effect; }
+
+    /**
+     * @brief Bypass the slot to save CPU, on top of setBypassed() (audio thread)
+     * @param sequence Non-zero order of the shed, so the newest can be restored first; 0 restores
+     *
+     * A shed slot does not keep warm: it exists to stop the effect's work.
+     */
+    void setShed(std::uint32_t sequence) { m_shedSequence = sequence; }
+    std::uint32_t shedSequence() const { return m_shedSequence; }
+
+    /// Render time of this slot (audio thread)
+    CpuMeter& meter() { return m_meter; }
+    const CpuMeter& meter() const { return m_meter; }
+
+private:
+    /// Not bypassed, not shed and not fading, so the effect's output is heard as is
+    bool isSettledActive() const
+    {
+        const bool bypassed = m_bypassRequested.load(std::memory_order_relaxed) || m_shedSequence != 0U;
+        return !bypassed && !m_settledBypassed && m_fadeRemaining == 0U;
+    }
+
+    std::pair<float, float> processTransition(std::pair<float, float> stereoSample, bool bypassed);
+    float processTransitionMono(float sample, bool bypassed);
+    /// Start a fade if the bypass state changed and advance m_wet by one frame
+    void advanceFade(bool bypassed);
+
+    std::shared_ptr<IEffect> m_effect;
+    std::atomic<bool> m_bypassRequested;   ///< Written by control threads
+    std::atomic<bool> m_keepWarm;
+    bool m_settledBypassed;                ///< State the current fade is heading to (audio thread)
+    unsigned int m_fadeFrames;             ///< Crossfade length in frames
+    unsigned int m_fadeRemaining;          ///< Frames left in the current fade
+    float m_wet;                           ///< Current effect level, 0 = bypassed, 1 = active
+    CpuMeter m_meter;                      ///< Follows the effect when the chain is edited
+    std::uint32_t m_shedSequence;          ///< Non-zero while shed by the load governor (audio thread)
+    bool m_stale;                          ///< Settled bypass skipped the effect, so it resets on return
+    bool m_mono;                           ///< The effect's last samples came through processMono()
+};
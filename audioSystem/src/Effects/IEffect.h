@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <utility> // For std::pair
 
 /**
@@ -42,6 +43,73 @@ public:
      */
     virtual std::pair<float, float> process(std::pair<float, float> stereoSample) = 0;
 
+    /**
+     * @brief Whether the effect treats both channels alike, so mono input gives mono output
+     *
+     * The engine carries a mono voice as one channel through the leading
+     * run of such effects, calling processMono(), and only splits it to
+     * stereo at the first effect that returns false.
+     */
+    virtual bool preservesMono() const { return false; }
+
+    /**
+     * @brief Whether both channels' state is the same, so processMono() gives what process() would
+     *
+     * Only asked of effects that preserve mono. Once stereo input has made
+     * the channels differ, the engine keeps the effect on the stereo path
+     * until this holds again, for example after reset() or once a delay
+     * tail has drained. Must not allocate or lock.
+     */
+    virtual bool channelsMatch() const { return true; }
+
+    /**
+     * @brief Process one sample of a mono signal (only called when preservesMono() and channelsMatch())
+     *
+     * Must return exactly what process({sample, sample}) returns in either
+     * channel. Only the left channel's state needs to advance; splitMono()
+     * is called before process() is used again.
+     *
+     * @param sample Input sample
+     * @return Processed sample
+     */
+    virtual float processMono(float sample) { return process({sample, sample}).first; }
+
+    /**
+     * @brief Bring the right channel's state up to date after a run of processMono() calls
+     */
+    virtual void splitMono() {}
+
+    /**
+     * @brief Process a block of stereo samples in place
+     *
+     * Must give exactly what calling process() on each frame in turn gives.
+     * The default does that; effects with a vectorised block path override it.
+     *
+     * @param left Left channel, overwritten with the output
+     * @param right Right channel, overwritten with the output
+     * @param frames Number of frames
+     */
+    virtual void processBlock(float* left, float* right, std::size_t frames)
+    {
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const std::pair<float, float> output = process({left[i], right[i]});
+            left[i] = output.first;
+            right[i] = output.second;
+        }
+    }
+
+    /**
+     * @brief Process a block of a mono signal in place (same conditions as processMono())
+     */
+    virtual void processMonoBlock(float* samples, std::size_t frames)
+    {
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            samples[i] = processMono(samples[i]);
+        }
+    }
+
     /**
      * @brief Reset the effect's internal state
      * 
@@ -54,4 +122,21 @@ public:
      * internal buffers and reset parameters to default states.
      */
     virtual void reset() {}
+
+    /**
+     * @brief Short, static name of the effect type (as accepted by configure())
+     *
+     * Used to label the effect in traces and statistics; the pointer must
+     * stay valid for the lifetime of the program.
+     */
+    virtual const char* name() const { return "effect"; }
+
+    /**
+     * @brief Bytes the effect holds: the object itself plus the buffers it allocated
+     *
+     * Counted by the engine's memory accounting and checked against its
+     * memory budget before the effect is inserted. Must not allocate or
+     * lock; the audio thread reads it when publishing telemetry.
+     */
+    virtual std::size_t memoryBytes() const = 0;
 };
\ No newline at end of file
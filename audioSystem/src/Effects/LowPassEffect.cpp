@@ -27,21 +27,33 @@ LowPassEffect::LowPassEffect(float cutoff, float sampleRate, float resonance, fl
 
 std::pair<float, float> LowPassEffect::process(std::pair<float, float> stereoSample)
 {
-    const float dryLeft = stereoSample.first;
-    float wetLeft = m_b0 * dryLeft + m_leftState.z1;
-    m_leftState.z1 = m_b1 * dryLeft + m_leftState.z2 - m_a1 * wetLeft;
-    m_leftState.z2 = m_b2 * dryLeft - m_a2 * wetLeft;
-    const float outLeft = (1.0f - m_mix) * dryLeft + m_mix * wetLeft;
-
-    const float dryRight = stereoSample.second;
-    float wetRight = m_b0 * dryRight + m_rightState.z1;
-    m_rightState.z1 = m_b1 * dryRight + m_rightState.z2 - m_a1 * wetRight;
-    m_rightState.z2 = m_b2 * dryRight - m_a2 * wetRight;
-    const float outRight = (1.0f - m_mix) * dryRight + m_mix * wetRight;
-
+    const float outLeft = filterSample(m_leftState, stereoSample.first);
+    const float outRight = filterSample(m_rightState, stereoSample.second);
     return {outLeft, outRight};
 }
 
+float LowPassEffect::processMono(float sample)
+{
+    return filterSample(m_leftState, sample);
+}
+
+void LowPassEffect::processBlock(float* left, float* right, std::size_t frames)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        left[i] = filterSample(m_leftState, left[i]);
+        right[i] = filterSample(m_rightState, right[i]);
+    }
+}
+
+void LowPassEffect::processMonoBlock(float* samples, std::size_t frames)
+{
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        samples[i] = filterSample(m_leftState, samples[i]);
+    }
+}
+
 void LowPassEffect::reset()
 {
     m_leftState = {0.0f, 0.0f};
@@ -11,6 +11,10 @@
  * cutoff frequency, resonance (Q), and dry/wet mix. The effect uses the
  * RBJ cookbook formula for coefficient calculation and processes samples
  * in Direct Form II Transposed for numerical stability.
+ *
+ * The block paths stay scalar rather than going through simdKernels():
+ * each output sample feeds the next, so the only independent lanes are the
+ * two channels, and biquadBank() runs many filters on one shared input.
  */
 class LowPassEffect : public IEffect
 {
@@ -21,7 +25,18 @@ public:
                   float mix = 1.0f);
 
     std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    bool preservesMono() const override { return true; }
+    float processMono(float sample) override;
+    void processBlock(float* left, float* right, std::size_t frames) override;
+    void processMonoBlock(float* samples, std::size_t frames) override;
+    void splitMono() override { m_rightState = m_leftState; }
+    bool channelsMatch() const override
+    {
+        return m_leftState.z1 == m_rightState.z1 && m_leftState.z2 == m_rightState.z2;
+    }
     void reset() override;
+    const char* name() const override { return "lowpass"; }
+    std::size_t memoryBytes() const override { return sizeof(*this); }
 
     void setSampleRate(float sampleRate);
     void setCutoff(float cutoff);
@@ -57,6 +72,15 @@ private:
     FilterState m_leftState;
     FilterState m_rightState;
 
+    /// Run one sample through the filter with a channel's state and mix it with the dry sample
+    float filterSample(FilterState& state, float dry)
+    {
+        const float wet = m_b0 * dry + state.z1;
+        state.z1 = m_b1 * dry + state.z2 - m_a1 * wet;
+        state.z2 = m_b2 * dry - m_a2 * wet;
+        return (1.0f - m_mix) * dry + m_mix * wet;
+    }
+
     static float clampValue(float value, float low, float high);
     void updateCoefficients();
 };
@@ -23,28 +23,31 @@ std::pair<float, float> OctaveEffect::process(std::pair<float, float> stereoSamp
         return stereoSample; // No effect
     }
     
-    // Simple processing for harmonic generation
-    float left = stereoSample.first;
-    float right = stereoSample.second;
-    
+    const float left = shapeSample(stereoSample.first, m_stateL);
+    const float right = shapeSample(stereoSample.second, m_stateR);
+    return {left, right};
+}
+
+float OctaveEffect::processMono(float sample) 
+{
+    if (m_blend <= 0.0f) {
+        return sample;
+    }
+    return shapeSample(sample, m_stateL);
+}
+
+float OctaveEffect::shapeSample(float sample, float& state) 
+{
     if (m_higher) {
         // Add upper harmonics by waveshaping (soft clipping adds odd harmonics)
-        float shapedLeft = std::tanh(left * 2.0f) * 0.8f;
-        float shapedRight = std::tanh(right * 2.0f) * 0.8f;
-        
-        left = (1.0f - m_blend) * left + m_blend * shapedLeft;
-        right = (1.0f - m_blend) * right + m_blend * shapedRight;
-    } else {
-        // For lower octave, apply simple low-pass filtering
-        // This is a very basic one-pole filter
-        m_stateL = m_stateL * 0.8f + left * 0.2f;
-        m_stateR = m_stateR * 0.8f + right * 0.2f;
-        
-        left = (1.0f - m_blend) * left + m_blend * m_stateL;
-        right = (1.0f - m_blend) * right + m_blend * m_stateR;
+        const float shaped = std::tanh(sample * 2.0f) * 0.8f;
+        return (1.0f - m_blend) * sample + m_blend * shaped;
     }
-    
-    return {left, right};
+
+    // For lower octave, apply simple low-pass filtering
+    // This is a very basic one-pole filter
+    state = state * 0.8f + sample * 0.2f;
+    return (1.0f - m_blend) * sample + m_blend * state;
 }
 
 void OctaveEffect::reset() 
@@ -38,12 +38,35 @@ public:
      * @return Processed sample with octave effect applied
      */
     std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+
+    /**
+     * @brief Both channels are shaped alike, so mono input stays mono
+     */
+    bool preservesMono() const override { return true; }
+
+    /**
+     * @brief Process a mono sample using the left channel's filter state
+     */
+    float processMono(float sample) override;
+
+    /**
+     * @brief Copy the left channel's filter state to the right channel
+     */
+    void splitMono() override { m_stateR = m_stateL; }
+
+    /**
+     * @brief Whether both channels' filter state is the same
+     */
+    bool channelsMatch() const override { return m_stateL == m_stateR; }
     
     /**
      * @brief Reset the internal phase and state
      */
     void reset() override;
 
+    const char* name() const override { return "octave"; }
+    std::size_t memoryBytes() const override { return sizeof(*this); }
+
     /**
      * @brief Set whether to generate higher or lower octave
      * @param higher true for higher octave, false for lower octave
@@ -69,6 +92,9 @@ public:
     void setSampleRate(float sampleRate);
 
 private:
+    /// Blend one channel's sample with its shaped or filtered version
+    float shapeSample(float sample, float& state);
+
     bool m_higher;          ///< Whether the effect generates higher or lower octave
     float m_blend;          ///< Blending factor between original and octave sample [0.0-1.0]
     float m_phase;          ///< Phase accumulator for generating the octave wave [0.0-1.0)
@@ -0,0 +1,296 @@
+#include "SpectralEffect.h"
+
+#include "threadBase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+/**
+ * @class SpectralWorker
+ * @brief Background thread that computes posted STFT frames
+ *
+ * The audio thread never blocks on the worker: it posts a job by flipping the
+ * owner's job state and collects the result one hop later. The worker polls
+ * at a fraction of the hop period, which keeps the audio side lock-free.
+ */
+class SpectralWorker : public ThreadBase
+{
+public:
+    SpectralWorker(SpectralEffect& owner, std::chrono::microseconds pollInterval)
+        : m_owner(owner)
+        , m_pollInterval(pollInterval)
+    {
+    }
+
+    ~SpectralWorker() override
+    {
+        stop();
+    }
+
+protected:
+    void thread() override
+    {
+        while (m_running)
+        {
+            if (m_owner.m_jobState.load(std::memory_order_acquire) == SpectralEffect::JobPending)
+            {
+                m_owner.computeFrames();
+                m_owner.m_jobState.store(SpectralEffect::JobDone, std::memory_order_release);
+            }
+            else
+            {
+                std::this_thread::sleep_for(m_pollInterval);
+            }
+        }
+    }
+
+private:
+    SpectralEffect& m_owner;
+    std::chrono::microseconds m_pollInterval;
+};
+
+namespace
+{
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+}
+
+constexpr std::size_t SpectralEffect::kChannels;
+constexpr std::size_t SpectralEffect::kOverlap;
+
+// -----------------------------------------------------------------------------
+// SpectralEffect implementation
+// -----------------------------------------------------------------------------
+
+SpectralEffect::SpectralEffect(std::size_t frameSize, float sampleRate, bool backgroundProcessing)
+    : m_frameSize(frameSize)
+    , m_hopSize(frameSize / kOverlap)
+    , m_mask(frameSize - 1U)
+    , m_sampleRate(std::max(sampleRate, 100.0f))
+    , m_analysisWindow(frameSize, 0.0f)
+    , m_synthesisWindow(frameSize, 0.0f)
+    , m_fft(frameSize)
+    , m_spectrum(2U * (frameSize / 2U + 1U), 0.0f)
+    , m_position(0U)
+    , m_hopCounter(0U)
+    , m_hopMissed(false)
+    , m_resetPending(false)
+    , m_jobState(JobIdle)
+    , m_lateFrames(0U)
+{
+    // Periodic sqrt-Hann for both analysis and synthesis; their product is a
+    // Hann window, which overlap-adds to a constant at a quarter-frame hop.
+    for (std::size_t i = 0; i < m_frameSize; ++i)
+    {
+        const double hann = 0.5 - 0.5 * std::cos(kTwoPi * static_cast<double>(i) / static_cast<double>(m_frameSize));
+        m_analysisWindow[i] = static_cast<float>(std::sqrt(hann));
+    }
+
+    double overlapGain = 0.0;
+    for (std::size_t i = 0; i < m_frameSize; i += m_hopSize)
+    {
+        overlapGain += static_cast<double>(m_analysisWindow[i]) * static_cast<double>(m_analysisWindow[i]);
+    }
+    const float normalization = overlapGain > 0.0 ? static_cast<float>(1.0 / overlapGain) : 1.0f;
+
+    for (std::size_t i = 0; i < m_frameSize; ++i)
+    {
+        m_synthesisWindow[i] = m_analysisWindow[i] * normalization;
+    }
+
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        m_input[channel].assign(m_frameSize, 0.0f);
+        m_output[channel].assign(m_frameSize, 0.0f);
+        m_frame[channel].assign(m_frameSize, 0.0f);
+    }
+
+    if (backgroundProcessing)
+    {
+        startWorker();
+    }
+}
+
+SpectralEffect::~SpectralEffect()
+{
+    stopWorker();
+}
+
+void SpectralEffect::startWorker()
+{
+    if (m_worker)
+    {
+        return;
+    }
+
+    const double hopMicros = 1.0e6 * static_cast<double>(m_hopSize) / static_cast<double>(m_sampleRate);
+    const auto pollInterval = std::chrono::microseconds(std::max<long long>(100, static_cast<long long>(hopMicros / 8.0)));
+    m_worker.reset(new SpectralWorker(*this, pollInterval));
+    m_worker->start();
+}
+
+void SpectralEffect::stopWorker()
+{
+    if (m_worker)
+    {
+        m_worker->stop();
+    }
+}
+
+std::size_t SpectralEffect::latencySamples() const
+{
+    return m_frameSize + (m_worker ? m_hopSize : 0U);
+}
+
+std::size_t SpectralEffect::spectralBufferBytes() const
+{
+    std::size_t floats = m_analysisWindow.capacity() + m_synthesisWindow.capacity() + m_spectrum.capacity();
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        floats += m_input[channel].capacity() + m_output[channel].capacity() + m_frame[channel].capacity();
+    }
+    return floats * sizeof(float) + m_fft.bufferBytes() + (m_worker ? sizeof(SpectralWorker) : 0U);
+}
+
+std::pair<float, float> SpectralEffect::process(std::pair<float, float> stereoSample)
+{
+    m_input[0][m_position] = stereoSample.first;
+    m_input[1][m_position] = stereoSample.second;
+
+    const std::pair<float, float> output{m_output[0][m_position], m_output[1][m_position]};
+    m_output[0][m_position] = 0.0f;
+    m_output[1][m_position] = 0.0f;
+
+    m_position = (m_position + 1U) & m_mask;
+
+    if (++m_hopCounter == m_hopSize)
+    {
+        m_hopCounter = 0U;
+        runHop();
+    }
+
+    return output;
+}
+
+void SpectralEffect::reset()
+{
+    // The rings are only touched here, so they can be cleared right away
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        std::fill(m_input[channel].begin(), m_input[channel].end(), 0.0f);
+        std::fill(m_output[channel].begin(), m_output[channel].end(), 0.0f);
+    }
+    m_position = 0U;
+    m_hopCounter = 0U;
+    m_hopMissed = false;
+
+    if (m_worker && m_jobState.load(std::memory_order_acquire) == JobPending)
+    {
+        // Never wait for the worker: drop its frame when it lands and clear
+        // the state it is using at the next hop instead
+        m_resetPending = true;
+        return;
+    }
+
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        std::fill(m_frame[channel].begin(), m_frame[channel].end(), 0.0f);
+    }
+    m_resetPending = false;
+    m_jobState.store(JobIdle, std::memory_order_release);
+
+    resetSpectralState();
+}
+
+void SpectralEffect::runHop()
+{
+    if (!m_worker)
+    {
+        captureFrames();
+        computeFrames();
+        overlapAdd();
+        return;
+    }
+
+    const int state = m_jobState.load(std::memory_order_acquire);
+    if (state == JobPending)
+    {
+        // Worker is still busy with the previous frame; skip this one
+        if (!m_resetPending)
+        {
+            m_lateFrames.fetch_add(1U, std::memory_order_relaxed);
+        }
+        m_hopMissed = true;
+        return;
+    }
+
+    if (m_resetPending)
+    {
+        // The finished frame predates reset(); discard it with the old state
+        m_resetPending = false;
+        m_hopMissed = false;
+        resetSpectralState();
+    }
+    else if (state == JobDone)
+    {
+        if (m_hopMissed)
+        {
+            // Its hop has passed; mixing it in now would place it a hop late
+            m_lateFrames.fetch_add(1U, std::memory_order_relaxed);
+            m_hopMissed = false;
+        }
+        else
+        {
+            overlapAdd();
+        }
+    }
+
+    captureFrames();
+    m_jobState.store(JobPending, std::memory_order_release);
+}
+
+void SpectralEffect::captureFrames()
+{
+    // m_position is the oldest sample in the input ring
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        const float* input = m_input[channel].data();
+        float* frame = m_frame[channel].data();
+        for (std::size_t i = 0; i < m_frameSize; ++i)
+        {
+            frame[i] = input[(m_position + i) & m_mask] * m_analysisWindow[i];
+        }
+    }
+}
+
+void SpectralEffect::computeFrames()
+{
+    beginFrame();
+
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        float* frame = m_frame[channel].data();
+        m_fft.forward(frame, m_spectrum.data());
+        processSpectrum(channel, m_spectrum.data());
+        m_fft.inverse(m_spectrum.data(), frame);
+
+        for (std::size_t i = 0; i < m_frameSize; ++i)
+        {
+            frame[i] *= m_synthesisWindow[i];
+        }
+    }
+}
+
+void SpectralEffect::overlapAdd()
+{
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        const float* frame = m_frame[channel].data();
+        float* output = m_output[channel].data();
+        for (std::size_t i = 0; i < m_frameSize; ++i)
+        {
+            output[(m_position + i) & m_mask] += frame[i];
+        }
+    }
+}
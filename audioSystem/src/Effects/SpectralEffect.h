@@ -0,0 +1,166 @@
+#pragma once
+
+#include "IEffect.h"
+#include "Dsp/FFT.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @file SpectralEffect.h
+ * @brief Base class for STFT (short-time Fourier transform) effects
+ */
+
+class SpectralWorker;
+
+/**
+ * @class SpectralEffect
+ * @brief Stereo STFT analysis / overlap-add resynthesis framework
+ *
+ * Input is collected into a frame of frameSize() samples. Every hop
+ * (frameSize() / 4 samples) the latest frame is windowed, transformed,
+ * handed to processSpectrum() per channel, transformed back and overlap-added
+ * into the output. The per-sample process() call only copies samples; the
+ * FFT work happens once per hop.
+ *
+ * Window and twiddle tables are precomputed at construction. When background
+ * processing is requested, frames are computed on a worker thread instead of
+ * inside process(): a frame posted at one hop boundary is collected at the next,
+ * adding one hop of latency but keeping FFT bursts out of the audio callback.
+ * If the worker is still busy at a hop, that hop's frame is skipped, and the
+ * frame it was busy with is discarded when it finishes rather than mixed in a
+ * hop late; both are counted in lateFrames().
+ * Since the audio callback renders a whole device buffer in one burst, the
+ * worker only helps when the hop is at least one device buffer long.
+ *
+ * Derived classes keep spectral state that is only touched from
+ * processSpectrum() / beginFrame(), which always run on the same thread.
+ * Parameters set from the control thread should be atomics. Because the worker
+ * calls into the derived class, derived destructors must call stopWorker().
+ */
+class SpectralEffect : public IEffect
+{
+public:
+    static constexpr std::size_t kChannels = 2;
+    static constexpr std::size_t kOverlap = 4;     ///< Frames overlapping each output sample
+
+    /**
+     * @brief Construct the STFT framework
+     * @param frameSize Power-of-two FFT length (see RealFFT limits)
+     * @param sampleRate Sampling rate in Hz
+     * @param backgroundProcessing Compute frames on a worker thread
+     * @throws std::invalid_argument if frameSize is not supported
+     */
+    SpectralEffect(std::size_t frameSize, float sampleRate, bool backgroundProcessing);
+    ~SpectralEffect() override;
+
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    void reset() override;
+
+    std::size_t frameSize() const { return m_frameSize; }
+    std::size_t hopSize() const { return m_hopSize; }
+    std::size_t binCount() const { return m_frameSize / 2U + 1U; }
+    float sampleRate() const { return m_sampleRate; }
+    bool backgroundProcessing() const { return m_worker != nullptr; }
+
+    /**
+     * @brief Compute frames on a worker thread from now on, starting it if needed
+     *
+     * Call from the control thread while no effect chain holds the effect,
+     * since the audio thread reads the worker without synchronisation. Does
+     * nothing if the worker already runs. Lets a pooled effect be built
+     * without one and only start its thread once it is first used.
+     */
+    void startWorker();
+
+    /// Delay from input to output in samples (one frame, plus one hop when threaded)
+    std::size_t latencySamples() const;
+
+    /// Frames left out of the output because the worker had not finished in time
+    std::size_t lateFrames() const { return m_lateFrames.load(std::memory_order_relaxed); }
+
+protected:
+    /**
+     * @brief Called once per frame before the channels are processed
+     */
+    virtual void beginFrame() {}
+
+    /**
+     * @brief Modify one channel's spectrum in place
+     * @param channel 0 for left, 1 for right
+     * @param bins binCount() interleaved complex bins, DC to Nyquist
+     */
+    virtual void processSpectrum(std::size_t channel, float* bins) = 0;
+
+    /**
+     * @brief Reset derived spectral state; called from reset(), or from the
+     *        next hop when reset() found a frame in flight
+     */
+    virtual void resetSpectralState() {}
+
+    /**
+     * @brief Join the background worker, if any
+     *
+     * Must be called from derived destructors so the worker never runs a
+     * frame against a partially destroyed object. Safe to call repeatedly.
+     */
+    void stopWorker();
+
+    /**
+     * @brief Whether the worker is computing a frame right now (audio thread)
+     *
+     * While true the worker may be inside beginFrame() / processSpectrum(),
+     * so state those read must not be replaced.
+     */
+    bool frameInFlight() const
+    {
+        return m_worker && m_jobState.load(std::memory_order_acquire) == JobPending;
+    }
+
+    /// Analysis window (sqrt-Hann), frameSize() entries
+    const float* analysisWindow() const { return m_analysisWindow.data(); }
+
+    /// Bytes of the windows, rings, FFT work buffers and worker; derived memoryBytes() add their own
+    std::size_t spectralBufferBytes() const;
+
+private:
+    friend class SpectralWorker;
+
+    /// Job states shared between the audio thread and the worker
+    enum JobState : int
+    {
+        JobIdle = 0,
+        JobPending = 1,
+        JobDone = 2
+    };
+
+    void runHop();
+    void captureFrames();
+    void computeFrames();
+    void overlapAdd();
+
+    std::size_t m_frameSize;
+    std::size_t m_hopSize;
+    std::size_t m_mask;                                 ///< frameSize - 1, for ring indexing
+    float m_sampleRate;
+
+    std::vector<float> m_analysisWindow;                ///< sqrt-Hann
+    std::vector<float> m_synthesisWindow;               ///< sqrt-Hann scaled for unity overlap-add gain
+    RealFFT m_fft;
+
+    std::array<std::vector<float>, kChannels> m_input;   ///< Input rings, frameSize samples
+    std::array<std::vector<float>, kChannels> m_output;  ///< Overlap-add accumulators, frameSize samples
+    std::array<std::vector<float>, kChannels> m_frame;   ///< Windowed frames in, resynthesized frames out
+    std::vector<float> m_spectrum;                       ///< Scratch spectrum, binCount complex values
+    std::size_t m_position;                              ///< Shared read/write index into the rings
+    std::size_t m_hopCounter;                            ///< Samples since the last hop
+    bool m_hopMissed;                                    ///< A hop was skipped while the pending frame was computed
+    bool m_resetPending;                                 ///< reset() ran mid-frame; drop the frame and clear derived state
+
+    std::atomic<int> m_jobState;
+    std::atomic<std::size_t> m_lateFrames;
+    std::unique_ptr<SpectralWorker> m_worker;
+};
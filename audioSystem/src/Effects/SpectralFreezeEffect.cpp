@@ -0,0 +1,122 @@
+#include "SpectralFreezeEffect.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+template <typename T>
+inline T clampValue(T value, T low, T high)
+{
+    return (value < low) ? low : (value > high ? high : value);
+}
+
+constexpr float kTwoPi = 6.28318530717958647692f;
+
+inline float wrapPhase(float phase)
+{
+    return phase - kTwoPi * std::floor(phase / kTwoPi);
+}
+}
+
+// -----------------------------------------------------------------------------
+// SpectralFreezeEffect implementation
+// -----------------------------------------------------------------------------
+
+SpectralFreezeEffect::SpectralFreezeEffect(float mix, float sampleRate, std::size_t frameSize, bool backgroundProcessing)
+    : SpectralEffect(frameSize, sampleRate, backgroundProcessing)
+    , m_frozenRequested(false)
+    , m_mix(clampValue(mix, 0.0f, 1.0f))
+    , m_captured{}
+{
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        m_lastPhase[channel].assign(binCount(), 0.0f);
+        m_frozenMagnitude[channel].assign(binCount(), 0.0f);
+        m_phaseAdvance[channel].assign(binCount(), 0.0f);
+        m_frozenPhase[channel].assign(binCount(), 0.0f);
+    }
+}
+
+SpectralFreezeEffect::~SpectralFreezeEffect()
+{
+    stopWorker();
+}
+
+void SpectralFreezeEffect::setFrozen(bool frozen)
+{
+    m_frozenRequested.store(frozen, std::memory_order_relaxed);
+}
+
+void SpectralFreezeEffect::setMix(float mix)
+{
+    m_mix.store(clampValue(mix, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void SpectralFreezeEffect::processSpectrum(std::size_t channel, float* bins)
+{
+    const std::size_t count = binCount();
+    float* lastPhase = m_lastPhase[channel].data();
+    const bool frozen = m_frozenRequested.load(std::memory_order_relaxed);
+
+    if (!frozen)
+    {
+        m_captured[channel] = false;
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            lastPhase[k] = std::atan2(bins[2U * k + 1U], bins[2U * k]);
+        }
+        return;
+    }
+
+    float* magnitude = m_frozenMagnitude[channel].data();
+    float* advance = m_phaseAdvance[channel].data();
+    float* phase = m_frozenPhase[channel].data();
+
+    if (!m_captured[channel])
+    {
+        // The phase change since the previous frame is the bin's true
+        // frequency expressed per hop (modulo 2*pi), which is all we need
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const float re = bins[2U * k];
+            const float im = bins[2U * k + 1U];
+            const float current = std::atan2(im, re);
+            magnitude[k] = std::sqrt(re * re + im * im);
+            advance[k] = wrapPhase(current - lastPhase[k]);
+            phase[k] = current;
+        }
+        m_captured[channel] = true;
+    }
+
+    const float wet = m_mix.load(std::memory_order_relaxed);
+    const float dry = 1.0f - wet;
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        phase[k] = wrapPhase(phase[k] + advance[k]);
+        bins[2U * k] = dry * bins[2U * k] + wet * magnitude[k] * std::cos(phase[k]);
+        bins[2U * k + 1U] = dry * bins[2U * k + 1U] + wet * magnitude[k] * std::sin(phase[k]);
+    }
+}
+
+void SpectralFreezeEffect::resetSpectralState()
+{
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        m_captured[channel] = false;
+        std::fill(m_lastPhase[channel].begin(), m_lastPhase[channel].end(), 0.0f);
+        std::fill(m_frozenPhase[channel].begin(), m_frozenPhase[channel].end(), 0.0f);
+    }
+}
+
+std::size_t SpectralFreezeEffect::memoryBytes() const
+{
+    std::size_t floats = 0;
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        floats += m_lastPhase[channel].capacity() + m_frozenMagnitude[channel].capacity()
+                + m_phaseAdvance[channel].capacity() + m_frozenPhase[channel].capacity();
+    }
+    return sizeof(*this) + spectralBufferBytes() + floats * sizeof(float);
+}
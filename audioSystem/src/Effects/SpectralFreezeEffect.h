@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SpectralEffect.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * @file SpectralFreezeEffect.h
+ * @brief Spectral freeze (infinite sustain) effect
+ */
+
+/**
+ * @class SpectralFreezeEffect
+ * @brief Captures one spectral frame and sustains it indefinitely
+ *
+ * While frozen, the captured magnitudes are resynthesized every hop with
+ * phases advanced by each bin's measured phase increment (phase vocoder), so
+ * the held sound keeps its pitch instead of buzzing at the hop rate. The
+ * frozen layer is blended over the live signal by the mix amount.
+ */
+class SpectralFreezeEffect : public SpectralEffect
+{
+public:
+    /**
+     * @brief Construct a freeze effect
+     * @param mix Level of the frozen layer [0.0 - 1.0]; the live signal gets 1 - mix
+     * @param sampleRate Sampling rate in Hz
+     * @param frameSize FFT length (power of two)
+     * @param backgroundProcessing Compute frames on a worker thread
+     */
+    SpectralFreezeEffect(float mix = 1.0f, float sampleRate = 44100.0f,
+                         std::size_t frameSize = 2048, bool backgroundProcessing = false);
+    ~SpectralFreezeEffect() override;
+
+    const char* name() const override { return "freeze"; }
+    std::size_t memoryBytes() const override;
+
+    /// Engage (capture the next frame) or release the freeze
+    void setFrozen(bool frozen);
+    /// Set the frozen layer level [0.0 - 1.0]
+    void setMix(float mix);
+
+    bool frozen() const { return m_frozenRequested.load(std::memory_order_relaxed); }
+    float mix() const { return m_mix.load(std::memory_order_relaxed); }
+
+protected:
+    void processSpectrum(std::size_t channel, float* bins) override;
+    void resetSpectralState() override;
+
+private:
+    std::atomic<bool> m_frozenRequested;
+    std::atomic<float> m_mix;
+
+    // Spectral state, touched only by the frame-processing thread
+    std::array<bool, kChannels> m_captured;
+    std::array<std::vector<float>, kChannels> m_lastPhase;      ///< Live phase of the previous frame
+    std::array<std::vector<float>, kChannels> m_frozenMagnitude;
+    std::array<std::vector<float>, kChannels> m_phaseAdvance;   ///< Per-hop phase increment at capture
+    std::array<std::vector<float>, kChannels> m_frozenPhase;    ///< Running resynthesis phase
+};
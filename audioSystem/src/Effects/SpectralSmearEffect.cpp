@@ -0,0 +1,114 @@
+#include "SpectralSmearEffect.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+template <typename T>
+inline T clampValue(T value, T low, T high)
+{
+    return (value < low) ? low : (value > high ? high : value);
+}
+}
+
+static_assert(SpectralEffect::kOverlap == 4, "Silent-bin phase rotation assumes a quarter-frame hop");
+
+constexpr float SpectralSmearEffect::kMaxRetention;
+
+// -----------------------------------------------------------------------------
+// SpectralSmearEffect implementation
+// -----------------------------------------------------------------------------
+
+SpectralSmearEffect::SpectralSmearEffect(float amount, float mix, float sampleRate, std::size_t frameSize,
+                                         bool backgroundProcessing)
+    : SpectralEffect(frameSize, sampleRate, backgroundProcessing)
+    , m_amount(clampValue(amount, 0.0f, 1.0f))
+    , m_mix(clampValue(mix, 0.0f, 1.0f))
+{
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        m_smoothedMagnitude[channel].assign(binCount(), 0.0f);
+        m_phasor[channel].assign(2U * binCount(), 0.0f);
+    }
+}
+
+SpectralSmearEffect::~SpectralSmearEffect()
+{
+    stopWorker();
+}
+
+void SpectralSmearEffect::setAmount(float amount)
+{
+    m_amount.store(clampValue(amount, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void SpectralSmearEffect::setMix(float mix)
+{
+    m_mix.store(clampValue(mix, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void SpectralSmearEffect::processSpectrum(std::size_t channel, float* bins)
+{
+    // Square-root curve so the lower half of the range is still audible
+    const float retention = kMaxRetention * std::sqrt(m_amount.load(std::memory_order_relaxed));
+    const float wet = m_mix.load(std::memory_order_relaxed);
+    const float dry = 1.0f - wet;
+
+    float* smoothed = m_smoothedMagnitude[channel].data();
+    float* phasor = m_phasor[channel].data();
+    const std::size_t count = binCount();
+
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const float re = bins[2U * k];
+        const float im = bins[2U * k + 1U];
+        const float magnitude = std::sqrt(re * re + im * im);
+
+        // Peak-hold attack keeps onsets intact; only the decay is smeared
+        smoothed[k] = std::max(magnitude, retention * smoothed[k] + (1.0f - retention) * magnitude);
+
+        if (magnitude > 1e-9f)
+        {
+            phasor[2U * k] = re / magnitude;
+            phasor[2U * k + 1U] = im / magnitude;
+        }
+        else
+        {
+            // Silent input: advance the stored phase by the bin's centre
+            // frequency over one hop, 2*pi*k / kOverlap, i.e. a multiply by i^k
+            const float pr = phasor[2U * k];
+            const float pi = phasor[2U * k + 1U];
+            switch (k & 3U)
+            {
+            case 1U: phasor[2U * k] = -pi; phasor[2U * k + 1U] = pr; break;
+            case 2U: phasor[2U * k] = -pr; phasor[2U * k + 1U] = -pi; break;
+            case 3U: phasor[2U * k] = pi; phasor[2U * k + 1U] = -pr; break;
+            default: break;
+            }
+        }
+
+        const float wetMagnitude = wet * smoothed[k];
+        bins[2U * k] = dry * re + wetMagnitude * phasor[2U * k];
+        bins[2U * k + 1U] = dry * im + wetMagnitude * phasor[2U * k + 1U];
+    }
+}
+
+void SpectralSmearEffect::resetSpectralState()
+{
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        std::fill(m_smoothedMagnitude[channel].begin(), m_smoothedMagnitude[channel].end(), 0.0f);
+        std::fill(m_phasor[channel].begin(), m_phasor[channel].end(), 0.0f);
+    }
+}
+
+std::size_t SpectralSmearEffect::memoryBytes() const
+{
+    std::size_t floats = 0;
+    for (std::size_t channel = 0; channel < kChannels; ++channel)
+    {
+        floats += m_smoothedMagnitude[channel].capacity() + m_phasor[channel].capacity();
+    }
+    return sizeof(*this) + spectralBufferBytes() + floats * sizeof(float);
+}
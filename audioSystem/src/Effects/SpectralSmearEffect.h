@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SpectralEffect.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+/**
+ * @file SpectralSmearEffect.h
+ * @brief Spectral smear (magnitude blur over time) effect
+ */
+
+/**
+ * @class SpectralSmearEffect
+ * @brief Smooths each bin's magnitude across frames
+ *
+ * Every bin's magnitude follows a one-pole average of its recent frames while
+ * the live phase is kept, which washes transients out into a pad-like tail.
+ * Larger amounts give longer tails. Once the input falls silent the tail keeps
+ * the last live phase of each bin, rotated at the bin's centre frequency.
+ */
+class SpectralSmearEffect : public SpectralEffect
+{
+public:
+    /**
+     * @brief Construct a smear effect
+     * @param amount Smear amount [0.0 = none, 1.0 = longest tail]
+     * @param mix Blend between dry (0.0) and smeared (1.0) spectrum
+     * @param sampleRate Sampling rate in Hz
+     * @param frameSize FFT length (power of two)
+     * @param backgroundProcessing Compute frames on a worker thread
+     */
+    SpectralSmearEffect(float amount = 0.5f, float mix = 1.0f, float sampleRate = 44100.0f,
+                        std::size_t frameSize = 2048, bool backgroundProcessing = false);
+    ~SpectralSmearEffect() override;
+
+    const char* name() const override { return "smear"; }
+    std::size_t memoryBytes() const override;
+
+    /// Set the smear amount [0.0 - 1.0]
+    void setAmount(float amount);
+    /// Set the wet/dry mix [0.0 - 1.0]
+    void setMix(float mix);
+
+    float amount() const { return m_amount.load(std::memory_order_relaxed); }
+    float mix() const { return m_mix.load(std::memory_order_relaxed); }
+
+protected:
+    void processSpectrum(std::size_t channel, float* bins) override;
+    void resetSpectralState() override;
+
+private:
+    static constexpr float kMaxRetention = 0.995f;   ///< Per-frame retention at amount 1.0
+
+    std::atomic<float> m_amount;
+    std::atomic<float> m_mix;
+
+    // Spectral state, touched only by the frame-processing thread
+    std::array<std::vector<float>, kChannels> m_smoothedMagnitude;
+    std::array<std::vector<float>, kChannels> m_phasor;   ///< Last unit phasor per bin (interleaved)
+};
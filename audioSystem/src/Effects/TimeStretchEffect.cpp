@@ -0,0 +1,241 @@
+#include "TimeStretchEffect.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+template <typename T>
+inline T clampValue(T value, T low, T high)
+{
+    return (value < low) ? low : (value > high ? high : value);
+}
+
+constexpr float kTwoPi = 6.28318530717958647692f;
+
+inline float wrapPhase(float phase)
+{
+    return phase - kTwoPi * std::floor(phase / kTwoPi);
+}
+}
+
+constexpr float TimeStretchEffect::kMinSpeed;
+constexpr float TimeStretchEffect::kMaxSpeed;
+
+// -----------------------------------------------------------------------------
+// TimeStretchEffect implementation
+// -----------------------------------------------------------------------------
+
+TimeStretchEffect::TimeStretchEffect(float speed, float gain, float sampleRate, std::size_t frameSize,
+                                     bool backgroundProcessing)
+    : SpectralEffect(frameSize, sampleRate, backgroundProcessing)
+    , m_sample{}
+    , m_sampleCapacity(0U)
+    , m_speed(clampValue(speed, kMinSpeed, kMaxSpeed))
+    , m_gain(std::max(gain, 0.0f))
+    , m_looping(false)
+    , m_playing(false)
+    , m_triggerRequested(false)
+    , m_stopRequested(false)
+    , m_analysis(frameSize)
+    , m_frameA(frameSize, 0.0f)
+    , m_frameB(frameSize, 0.0f)
+    , m_spectrumA(2U * binCount(), 0.0f)
+    , m_spectrumB(2U * binCount(), 0.0f)
+    , m_synthPhase(binCount(), 0.0f)
+    , m_stretched(2U * binCount(), 0.0f)
+    , m_readPosition(0.0)
+    , m_phaseInitialized(false)
+    , m_frameReady(false)
+{
+}
+
+TimeStretchEffect::~TimeStretchEffect()
+{
+    stopWorker();
+}
+
+std::vector<float> TimeStretchEffect::prepareSample(const std::vector<float>& samples, float sourceSampleRate) const
+{
+    std::vector<float> sample;
+    if (samples.empty() || sourceSampleRate <= 0.0f)
+    {
+        return sample;
+    }
+
+    // Resample once here so the time stretch only ever reads at the engine rate
+    const double ratio = static_cast<double>(sourceSampleRate) / static_cast<double>(sampleRate());
+    const std::size_t length = static_cast<std::size_t>(std::floor(static_cast<double>(samples.size() - 1U) / ratio)) + 1U;
+    sample.assign(length, 0.0f);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        const double source = static_cast<double>(i) * ratio;
+        const std::size_t index = static_cast<std::size_t>(source);
+        const float fraction = static_cast<float>(source - static_cast<double>(index));
+        const float a = samples[index];
+        const float b = samples[std::min(index + 1U, samples.size() - 1U)];
+        sample[i] = a + (b - a) * fraction;
+    }
+    return sample;
+}
+
+bool TimeStretchEffect::adoptSample(std::vector<float>& sample)
+{
+    // beginFrame() reads m_sample on the worker while a frame is pending
+    if (frameInFlight())
+    {
+        return false;
+    }
+
+    m_playing.store(false, std::memory_order_relaxed);
+    m_triggerRequested.store(false, std::memory_order_relaxed);
+    m_sample.swap(sample);
+    m_sampleCapacity.store(m_sample.capacity(), std::memory_order_relaxed);
+    return true;
+}
+
+void TimeStretchEffect::trigger()
+{
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    m_triggerRequested.store(true, std::memory_order_release);
+}
+
+void TimeStretchEffect::stopPlayback()
+{
+    m_stopRequested.store(true, std::memory_order_release);
+}
+
+void TimeStretchEffect::setSpeed(float speed)
+{
+    m_speed.store(clampValue(speed, kMinSpeed, kMaxSpeed), std::memory_order_relaxed);
+}
+
+void TimeStretchEffect::setGain(float gain)
+{
+    m_gain.store(std::max(gain, 0.0f), std::memory_order_relaxed);
+}
+
+void TimeStretchEffect::setLooping(bool looping)
+{
+    m_looping.store(looping, std::memory_order_relaxed);
+}
+
+void TimeStretchEffect::beginFrame()
+{
+    m_frameReady = false;
+
+    if (m_stopRequested.exchange(false, std::memory_order_acquire))
+    {
+        m_playing.store(false, std::memory_order_relaxed);
+    }
+
+    if (m_triggerRequested.exchange(false, std::memory_order_acquire))
+    {
+        m_readPosition = 0.0;
+        m_phaseInitialized = false;
+        m_playing.store(true, std::memory_order_relaxed);
+    }
+
+    if (!m_playing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const double span = static_cast<double>(frameSize() + hopSize() + 1U);
+    if (static_cast<double>(m_sample.size()) < span)
+    {
+        m_playing.store(false, std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_readPosition + span > static_cast<double>(m_sample.size()))
+    {
+        if (!m_looping.load(std::memory_order_relaxed))
+        {
+            m_playing.store(false, std::memory_order_relaxed);
+            return;
+        }
+        m_readPosition = 0.0;
+        m_phaseInitialized = false;
+    }
+
+    readFrame(m_readPosition, m_frameA.data());
+    readFrame(m_readPosition + static_cast<double>(hopSize()), m_frameB.data());
+    m_analysis.forward(m_frameA.data(), m_spectrumA.data());
+    m_analysis.forward(m_frameB.data(), m_spectrumB.data());
+
+    const std::size_t count = binCount();
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        const float aRe = m_spectrumA[2U * k];
+        const float aIm = m_spectrumA[2U * k + 1U];
+        const float bRe = m_spectrumB[2U * k];
+        const float bIm = m_spectrumB[2U * k + 1U];
+        const float phaseB = std::atan2(bIm, bRe);
+
+        if (m_phaseInitialized)
+        {
+            // Phase travelled over exactly one synthesis hop, whatever the speed
+            m_synthPhase[k] = wrapPhase(m_synthPhase[k] + (phaseB - std::atan2(aIm, aRe)));
+        }
+        else
+        {
+            m_synthPhase[k] = phaseB;
+        }
+
+        const float magnitude = std::sqrt(bRe * bRe + bIm * bIm);
+        m_stretched[2U * k] = magnitude * std::cos(m_synthPhase[k]);
+        m_stretched[2U * k + 1U] = magnitude * std::sin(m_synthPhase[k]);
+    }
+
+    m_phaseInitialized = true;
+    m_frameReady = true;
+    m_readPosition += static_cast<double>(hopSize()) * static_cast<double>(m_speed.load(std::memory_order_relaxed));
+}
+
+void TimeStretchEffect::processSpectrum(std::size_t /*channel*/, float* bins)
+{
+    if (!m_frameReady)
+    {
+        return;
+    }
+
+    const float gain = m_gain.load(std::memory_order_relaxed);
+    const std::size_t values = 2U * binCount();
+    for (std::size_t i = 0; i < values; ++i)
+    {
+        bins[i] += gain * m_stretched[i];
+    }
+}
+
+void TimeStretchEffect::resetSpectralState()
+{
+    m_readPosition = 0.0;
+    m_phaseInitialized = false;
+    m_frameReady = false;
+    m_playing.store(false, std::memory_order_relaxed);
+}
+
+void TimeStretchEffect::readFrame(double position, float* frame) const
+{
+    const float* window = analysisWindow();
+    const std::size_t base = static_cast<std::size_t>(position);
+    const float fraction = static_cast<float>(position - static_cast<double>(base));
+
+    for (std::size_t i = 0; i < frameSize(); ++i)
+    {
+        const float a = m_sample[base + i];
+        const float b = m_sample[base + i + 1U];
+        frame[i] = (a + (b - a) * fraction) * window[i];
+    }
+}
+
+std::size_t TimeStretchEffect::memoryBytes() const
+{
+    // The loaded sample dominates: it is held in full at the engine rate
+    const std::size_t floats = m_sampleCapacity.load(std::memory_order_relaxed) + m_frameA.capacity() + m_frameB.capacity()
+                             + m_spectrumA.capacity() + m_spectrumB.capacity() + m_synthPhase.capacity()
+                             + m_stretched.capacity();
+    return sizeof(*this) + spectralBufferBytes() + m_analysis.bufferBytes() + floats * sizeof(float);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "SpectralEffect.h"
+#include "Dsp/FFT.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+ * @file TimeStretchEffect.h
+ * @brief Phase-vocoder sample player with independent speed and pitch
+ */
+
+/**
+ * @class TimeStretchEffect
+ * @brief Plays a loaded sample at a variable speed without changing its pitch
+ *
+ * Each hop, two analysis frames one synthesis hop apart are taken at the
+ * current read position. Their phase difference gives every bin's true
+ * frequency, which is accumulated into the output phase while the read
+ * position advances by hop * speed. The stretched sample is added on top of
+ * the signal passing through the effect, so it can sit anywhere in the chain.
+ */
+class TimeStretchEffect : public SpectralEffect
+{
+public:
+    static constexpr float kMinSpeed = 0.125f;
+    static constexpr float kMaxSpeed = 4.0f;
+
+    /**
+     * @brief Construct a time-stretch player
+     * @param speed Playback speed [kMinSpeed - kMaxSpeed]; 1.0 is the original tempo
+     * @param gain Level of the stretched sample
+     * @param sampleRate Sampling rate in Hz
+     * @param frameSize FFT length (power of two)
+     * @param backgroundProcessing Compute frames on a worker thread
+     */
+    TimeStretchEffect(float speed = 1.0f, float gain = 1.0f, float sampleRate = 44100.0f,
+                      std::size_t frameSize = 2048, bool backgroundProcessing = false);
+    ~TimeStretchEffect() override;
+
+    const char* name() const override { return "timestretch"; }
+    std::size_t memoryBytes() const override;
+
+    /**
+     * @brief Resample mono sample data to the engine rate, ready for adoptSample()
+     * @param samples Mono sample data
+     * @param sourceSampleRate Sample rate the data was recorded at
+     * @return The material at sampleRate(); empty if there is nothing to play
+     *
+     * Allocates; call from a control thread.
+     */
+    std::vector<float> prepareSample(const std::vector<float>& samples, float sourceSampleRate) const;
+
+    /**
+     * @brief Swap in a buffer from prepareSample() and stop playback (audio thread)
+     * @param sample Prepared buffer; receives the replaced sample
+     * @return false, leaving sample untouched, while the worker is computing
+     *         a frame that may read the current sample
+     */
+    bool adoptSample(std::vector<float>& sample);
+
+    /// Start playback from the beginning at the next hop
+    void trigger();
+    /// Stop playback at the next hop
+    void stopPlayback();
+
+    void setSpeed(float speed);
+    void setGain(float gain);
+    void setLooping(bool looping);
+
+    float speed() const { return m_speed.load(std::memory_order_relaxed); }
+    float gain() const { return m_gain.load(std::memory_order_relaxed); }
+    bool looping() const { return m_looping.load(std::memory_order_relaxed); }
+    bool playing() const { return m_playing.load(std::memory_order_relaxed); }
+
+protected:
+    void beginFrame() override;
+    void processSpectrum(std::size_t channel, float* bins) override;
+    void resetSpectralState() override;
+
+private:
+    /// Windowed, linearly interpolated analysis frame starting at position
+    void readFrame(double position, float* frame) const;
+
+    std::vector<float> m_sample;            ///< Mono material at the engine sample rate
+    std::atomic<std::size_t> m_sampleCapacity;  ///< m_sample.capacity(), readable by memoryBytes()
+
+    std::atomic<float> m_speed;
+    std::atomic<float> m_gain;
+    std::atomic<bool> m_looping;
+    std::atomic<bool> m_playing;
+    std::atomic<bool> m_triggerRequested;
+    std::atomic<bool> m_stopRequested;
+
+    // Analysis state, touched only by the frame-processing thread
+    RealFFT m_analysis;
+    std::vector<float> m_frameA;            ///< Frame at the read position
+    std::vector<float> m_frameB;            ///< Frame one hop later
+    std::vector<float> m_spectrumA;
+    std::vector<float> m_spectrumB;
+    std::vector<float> m_synthPhase;        ///< Accumulated output phase per bin
+    std::vector<float> m_stretched;         ///< Resynthesized spectrum for this frame
+    double m_readPosition;                  ///< Read position in samples
+    bool m_phaseInitialized;
+    bool m_frameReady;
+};
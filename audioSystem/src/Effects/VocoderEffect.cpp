@@ -0,0 +1,211 @@
+#include "VocoderEffect.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+template <typename T>
+inline T clampValue(T value, T low, T high)
+{
+    return (value < low) ? low : (value > high ? high : value);
+}
+}
+
+constexpr std::size_t VocoderEffect::kMinBands;
+constexpr std::size_t VocoderEffect::kMaxBands;
+constexpr float VocoderEffect::kLowestBandHz;
+constexpr float VocoderEffect::kHighestBandHz;
+
+// -----------------------------------------------------------------------------
+// VocoderEffect implementation
+// -----------------------------------------------------------------------------
+
+VocoderEffect::VocoderEffect(std::size_t bandCount, float mix, float sampleRate)
+    : m_kernels(&simdKernels())
+    , m_bandCount(clampValue(bandCount, kMinBands, kMaxBands))
+    , m_sampleRate(std::max(sampleRate, 100.0f))
+    , m_mix(clampValue(mix, 0.0f, 1.0f))
+    , m_outputGain(8.0f)
+    , m_bandNormalization(1.0f)
+    , m_attackSeconds(0.005f)
+    , m_releaseSeconds(0.05f)
+    , m_source(ModulatorSource::Sample)
+    , m_modulatorCapacity(0U)
+    , m_modulatorPosition(0U)
+    , m_liveSample(0.0f)
+{
+    // Band count changes happen on the audio thread, so size everything for the largest bank now
+    const std::size_t padded = BiquadBank::kLaneWidth * ((kMaxBands + BiquadBank::kLaneWidth - 1U) / BiquadBank::kLaneWidth);
+    m_analysis.reserve(kMaxBands);
+    m_synthesisLeft.reserve(kMaxBands);
+    m_synthesisRight.reserve(kMaxBands);
+    m_envelopes.reserve(padded);
+    m_modulatorBands.reserve(padded);
+    m_carrierLeft.reserve(padded);
+    m_carrierRight.reserve(padded);
+
+    configureBands();
+}
+
+std::pair<float, float> VocoderEffect::process(std::pair<float, float> stereoSample)
+{
+    const float modulator = nextModulatorSample();
+
+    m_analysis.process(modulator, m_modulatorBands.data());
+    const float* envelope = m_envelopes.process(m_modulatorBands.data());
+
+    m_synthesisLeft.process(stereoSample.first, m_carrierLeft.data());
+    m_synthesisRight.process(stereoSample.second, m_carrierRight.data());
+
+    // Weight every carrier band by its modulator envelope and sum the bands
+    float wetLeft = 0.0f;
+    float wetRight = 0.0f;
+    m_kernels->dualDotProduct(envelope, m_carrierLeft.data(), m_carrierRight.data(), m_carrierLeft.size(),
+                              &wetLeft, &wetRight);
+
+    const float mix = m_mix.load(std::memory_order_relaxed);
+    const float dry = 1.0f - mix;
+    const float wet = mix * m_outputGain * m_bandNormalization;
+    return {dry * stereoSample.first + wet * wetLeft, dry * stereoSample.second + wet * wetRight};
+}
+
+void VocoderEffect::reset()
+{
+    m_analysis.reset();
+    m_synthesisLeft.reset();
+    m_synthesisRight.reset();
+    m_envelopes.reset();
+    m_modulatorPosition = 0U;
+    m_liveSample = 0.0f;
+}
+
+std::vector<float> VocoderEffect::prepareModulator(const std::vector<float>& samples, float sourceSampleRate) const
+{
+    std::vector<float> resampled;
+    if (samples.empty() || sourceSampleRate <= 0.0f)
+    {
+        return resampled;
+    }
+
+    const double ratio = static_cast<double>(sourceSampleRate) / static_cast<double>(m_sampleRate);
+    const std::size_t length = static_cast<std::size_t>(std::floor(static_cast<double>(samples.size() - 1U) / ratio)) + 1U;
+    resampled.assign(length, 0.0f);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        const double source = static_cast<double>(i) * ratio;
+        const std::size_t index = static_cast<std::size_t>(source);
+        const float fraction = static_cast<float>(source - static_cast<double>(index));
+        const float a = samples[index];
+        const float b = samples[std::min(index + 1U, samples.size() - 1U)];
+        resampled[i] = a + (b - a) * fraction;
+    }
+    return resampled;
+}
+
+void VocoderEffect::adoptModulator(std::vector<float>& modulator)
+{
+    m_modulatorSample.swap(modulator);
+    m_modulatorCapacity.store(m_modulatorSample.capacity(), std::memory_order_relaxed);
+    m_modulatorPosition = 0U;
+    m_source.store(ModulatorSource::Sample, std::memory_order_relaxed);
+}
+
+void VocoderEffect::setBandCount(std::size_t bandCount)
+{
+    const std::size_t clamped = clampValue(bandCount, kMinBands, kMaxBands);
+    if (clamped != m_bandCount)
+    {
+        m_bandCount = clamped;
+        configureBands();
+    }
+    reset();
+}
+
+void VocoderEffect::setSampleRate(float sampleRate)
+{
+    if (sampleRate <= 100.0f || std::abs(sampleRate - m_sampleRate) < 1e-3f)
+    {
+        return;
+    }
+
+    m_sampleRate = sampleRate;
+    configureBands();
+}
+
+void VocoderEffect::setMix(float mix)
+{
+    m_mix.store(clampValue(mix, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+void VocoderEffect::setOutputGain(float gain)
+{
+    m_outputGain = clampValue(gain, 0.0f, 64.0f);
+}
+
+void VocoderEffect::setEnvelopeTimes(float attackSeconds, float releaseSeconds)
+{
+    m_attackSeconds = clampValue(attackSeconds, 0.0005f, 0.5f);
+    m_releaseSeconds = clampValue(releaseSeconds, 0.001f, 2.0f);
+    m_envelopes.setTimes(m_attackSeconds, m_releaseSeconds, m_sampleRate);
+}
+
+void VocoderEffect::configureBands()
+{
+    m_analysis.resize(m_bandCount);
+    m_synthesisLeft.resize(m_bandCount);
+    m_synthesisRight.resize(m_bandCount);
+
+    const std::size_t padded = m_analysis.paddedCount();
+    m_envelopes.resize(padded);
+    m_envelopes.setTimes(m_attackSeconds, m_releaseSeconds, m_sampleRate);
+    m_modulatorBands.assign(padded, 0.0f);
+    m_carrierLeft.assign(padded, 0.0f);
+    m_carrierRight.assign(padded, 0.0f);
+
+    // Log-spaced centres; Q chosen so neighbouring bands cross at -3 dB
+    const float highest = std::min(kHighestBandHz, 0.45f * m_sampleRate);
+    const float ratio = std::pow(highest / kLowestBandHz, 1.0f / static_cast<float>(m_bandCount - 1U));
+    const float q = 1.0f / (std::sqrt(ratio) - 1.0f / std::sqrt(ratio));
+
+    // Band outputs shrink roughly with the square root of the band count
+    m_bandNormalization = std::sqrt(static_cast<float>(m_bandCount) / static_cast<float>(kMinBands));
+
+    float center = kLowestBandHz;
+    for (std::size_t band = 0; band < m_bandCount; ++band)
+    {
+        m_analysis.setBandPass(band, center, q, m_sampleRate);
+        m_synthesisLeft.setBandPass(band, center, q, m_sampleRate);
+        m_synthesisRight.setBandPass(band, center, q, m_sampleRate);
+        center *= ratio;
+    }
+}
+
+float VocoderEffect::nextModulatorSample()
+{
+    if (m_source.load(std::memory_order_relaxed) == ModulatorSource::Live)
+    {
+        return m_liveSample;
+    }
+
+    if (m_modulatorSample.empty())
+    {
+        return 0.0f;
+    }
+
+    const float sample = m_modulatorSample[m_modulatorPosition];
+    if (++m_modulatorPosition >= m_modulatorSample.size())
+    {
+        m_modulatorPosition = 0U;
+    }
+    return sample;
+}
+
+std::size_t VocoderEffect::memoryBytes() const
+{
+    const std::size_t floats = m_modulatorBands.capacity() + m_carrierLeft.capacity() + m_carrierRight.capacity()
+                             + m_modulatorCapacity.load(std::memory_order_relaxed);
+    return sizeof(*this) + m_analysis.bufferBytes() + m_synthesisLeft.bufferBytes()
+         + m_synthesisRight.bufferBytes() + m_envelopes.bufferBytes() + floats * sizeof(float);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "IEffect.h"
+#include "Dsp/FilterBank.h"
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file VocoderEffect.h
+ * @brief Channel vocoder using the synth signal as carrier
+ */
+
+/**
+ * @class VocoderEffect
+ * @brief Classic analysis/synthesis channel vocoder
+ *
+ * The modulator (a loaded sample or a live input feed) runs through an
+ * analysis band-pass bank whose envelope followers set the gain of the
+ * matching bands of a synthesis bank fed by the signal passing through the
+ * effect (the carrier). Both banks and the followers run through the
+ * simdKernels() table picked for the host CPU, several bands per register,
+ * which keeps a 32-band vocoder affordable per sample.
+ */
+class VocoderEffect : public IEffect
+{
+public:
+    /**
+     * @enum ModulatorSource
+     * @brief Where the modulator signal comes from
+     */
+    enum class ModulatorSource
+    {
+        Sample,     ///< Looping sample set through adoptModulator()
+        Live        ///< Samples pushed through feedModulator()
+    };
+
+    static constexpr std::size_t kMinBands = 16;
+    static constexpr std::size_t kMaxBands = 32;
+
+    /**
+     * @brief Construct a vocoder
+     * @param bandCount Number of bands [kMinBands - kMaxBands]
+     * @param mix Blend between dry carrier (0.0) and vocoded signal (1.0)
+     * @param sampleRate Sampling rate in Hz
+     */
+    VocoderEffect(std::size_t bandCount = 24, float mix = 1.0f, float sampleRate = 44100.0f);
+
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override;
+    void reset() override;
+    const char* name() const override { return "vocoder"; }
+    std::size_t memoryBytes() const override;
+
+    /**
+     * @brief Resample a mono modulator to the engine rate, ready for adoptModulator()
+     * @return The modulator at the engine rate; empty if there is nothing to play
+     *
+     * Allocates; call from a control thread.
+     */
+    std::vector<float> prepareModulator(const std::vector<float>& samples, float sourceSampleRate) const;
+
+    /**
+     * @brief Swap in a buffer from prepareModulator() and switch to ModulatorSource::Sample (audio thread)
+     * @param modulator Prepared buffer; receives the replaced modulator
+     */
+    void adoptModulator(std::vector<float>& modulator);
+
+    /**
+     * @brief Provide the next live modulator sample (audio thread)
+     *
+     * Used when the source is ModulatorSource::Live; the value is consumed by
+     * the next process() call.
+     */
+    void feedModulator(float sample) { m_liveSample = sample; }
+
+    void setModulatorSource(ModulatorSource source) { m_source.store(source, std::memory_order_relaxed); }
+    /**
+     * @brief Change the band count, redistribute the bands and clear their state
+     *
+     * Storage is reserved for kMaxBands at construction, so this never
+     * allocates, but it rewrites the banks process() reads: call it on the
+     * audio thread (AudioSystem::configureVocoder()) once the vocoder may be
+     * in a chain.
+     */
+    void setBandCount(std::size_t bandCount);
+    void setSampleRate(float sampleRate);
+    /// Set the wet/dry mix [0.0 - 1.0]; safe from any thread
+    void setMix(float mix);
+    /// Set the makeup gain applied to the vocoded signal
+    void setOutputGain(float gain);
+    /// Set the envelope follower attack and release times in seconds
+    void setEnvelopeTimes(float attackSeconds, float releaseSeconds);
+
+    std::size_t bandCount() const { return m_bandCount; }
+    ModulatorSource modulatorSource() const { return m_source.load(std::memory_order_relaxed); }
+    float mix() const { return m_mix.load(std::memory_order_relaxed); }
+    float outputGain() const { return m_outputGain; }
+    bool hasModulatorSample() const { return !m_modulatorSample.empty(); }
+
+private:
+    static constexpr float kLowestBandHz = 80.0f;
+    static constexpr float kHighestBandHz = 8000.0f;
+
+    /// Lay out log-spaced band centres and matching Q on all banks
+    void configureBands();
+    float nextModulatorSample();
+
+    const SimdKernels* m_kernels;   ///< Selected at construction
+    std::size_t m_bandCount;
+    float m_sampleRate;
+    std::atomic<float> m_mix;       ///< Set from control threads
+    float m_outputGain;
+    float m_bandNormalization;      ///< Compensates the narrower bands of larger banks
+    float m_attackSeconds;
+    float m_releaseSeconds;
+
+    BiquadBank m_analysis;          ///< Modulator band-pass bank
+    BiquadBank m_synthesisLeft;     ///< Carrier bank, left channel
+    BiquadBank m_synthesisRight;    ///< Carrier bank, right channel
+    EnvelopeBank m_envelopes;       ///< One follower per analysis band
+
+    std::vector<float> m_modulatorBands;   ///< Analysis outputs for the current sample
+    std::vector<float> m_carrierLeft;      ///< Synthesis outputs, left
+    std::vector<float> m_carrierRight;     ///< Synthesis outputs, right
+
+    std::atomic<ModulatorSource> m_source;  ///< Set from control threads
+    std::vector<float> m_modulatorSample;  ///< Loaded modulator at the engine rate
+    std::atomic<std::size_t> m_modulatorCapacity;  ///< m_modulatorSample.capacity(), readable by memoryBytes()
+    std::size_t m_modulatorPosition;
+    float m_liveSample;
+};
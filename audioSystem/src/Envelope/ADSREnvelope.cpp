@@ -114,4 +114,13 @@ void ADSREnvelope::reset()
     currentLevel = 0.0f;
     currentSample = 0.0f;
     releaseStartLevel = 0.0f;
+}
+
+void ADSREnvelope::setParameters(float attackTime, float decayTime, float sustainLevel, float releaseTime)
+{
+    // Same limits as the constructor
+    this->attackTime = std::max(0.001f, attackTime);
+    this->decayTime = std::max(0.001f, decayTime);
+    this->sustainLevel = std::min(std::max(sustainLevel, 0.0f), 1.0f);
+    this->releaseTime = std::max(0.001f, releaseTime);
 }
\ No newline at end of file
@@ -20,6 +20,18 @@
  */
 class ADSREnvelope {
 public:
+    /**
+     * @enum Stage
+     * @brief Current stage of the ADSR envelope
+     */
+    enum class Stage { 
+        Attack,     ///< Rising to peak amplitude
+        Decay,      ///< Falling to sustain level
+        Sustain,    ///< Holding at sustain level
+        Release,    ///< Fading to silence
+        Idle        ///< No sound output
+    };
+
     /**
      * @brief Constructs an ADSR envelope with specified parameters
      * 
@@ -43,20 +55,31 @@ public:
      * @brief Reset the envelope to initial state
      */
     void reset();
-    
-private:
+
     /**
-     * @enum Stage
-     * @brief Current stage of the ADSR envelope
+     * @brief Change the envelope times and sustain level in place
+     *
+     * The current stage and position are kept, so a sounding note carries on
+     * with the new shape instead of restarting from silence.
+     *
+     * @param attackTime Time in seconds for attack phase
+     * @param decayTime Time in seconds for decay phase
+     * @param sustainLevel Sustain amplitude level [0.0-1.0]
+     * @param releaseTime Time in seconds for release phase
      */
-    enum class Stage { 
-        Attack,     ///< Rising to peak amplitude
-        Decay,      ///< Falling to sustain level
-        Sustain,    ///< Holding at sustain level
-        Release,    ///< Fading to silence
-        Idle        ///< No sound output
-    };
+    void setParameters(float attackTime, float decayTime, float sustainLevel, float releaseTime);
+
+    /**
+     * @brief Stage the envelope is in
+     */
+    Stage stage() const { return currentStage; }
+
+    /**
+     * @brief Level returned by the last process() call
+     */
+    float level() const { return currentLevel; }
     
+private:
     Stage currentStage;         ///< Current envelope stage
     
     float attackTime;           ///< Attack time in seconds
@@ -0,0 +1,433 @@
+#include "GranularSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+constexpr float kPi = 3.14159265358979323846f;
+constexpr float kMinDensity = 0.5f;
+constexpr float kMaxDensity = 2000.0f;
+constexpr float kMinGrainSeconds = 0.005f;
+constexpr float kMaxGrainSeconds = 1.0f;
+constexpr float kMaxPitchSpreadCents = 2400.0f;
+
+template <typename T>
+inline T clampValue(T value, T low, T high)
+{
+    return (value < low) ? low : (value > high ? high : value);
+}
+
+std::size_t nextPowerOfTwo(std::size_t value)
+{
+    std::size_t result = 1U;
+    while (result < value)
+    {
+        result <<= 1U;
+    }
+    return result;
+}
+
+/**
+ * @brief Window tables built once and shared by every GranularSource
+ *
+ * Each table holds kWindowTableSize + 1 entries so that linear interpolation
+ * at the last index never reads past the end.
+ */
+struct WindowTables
+{
+    static constexpr std::size_t kShapes = 4;
+    std::vector<float> tables[kShapes];
+
+    WindowTables()
+    {
+        const std::size_t size = GranularSource::kWindowTableSize;
+        for (auto& table : tables)
+        {
+            table.assign(size + 1U, 0.0f);
+        }
+
+        for (std::size_t i = 0; i <= size; ++i)
+        {
+            const float x = static_cast<float>(i) / static_cast<float>(size);
+
+            // Hann
+            tables[0][i] = 0.5f - 0.5f * std::cos(2.0f * kPi * x);
+
+            // Gaussian (sigma = 0.15 of the grain length)
+            const float g = (x - 0.5f) / 0.15f;
+            tables[1][i] = std::exp(-0.5f * g * g);
+
+            // Tukey with 50% cosine tapers
+            constexpr float alpha = 0.5f;
+            if (x < alpha * 0.5f)
+            {
+                tables[2][i] = 0.5f - 0.5f * std::cos(2.0f * kPi * x / alpha);
+            }
+            else if (x > 1.0f - alpha * 0.5f)
+            {
+                tables[2][i] = 0.5f - 0.5f * std::cos(2.0f * kPi * (1.0f - x) / alpha);
+            }
+            else
+            {
+                tables[2][i] = 1.0f;
+            }
+
+            // Trapezoid with 25% linear ramps
+            tables[3][i] = std::min(1.0f, std::min(x, 1.0f - x) * 4.0f);
+        }
+    }
+};
+}
+
+constexpr std::size_t GranularSource::kMaxGrains;
+constexpr std::size_t GranularSource::kWindowTableSize;
+
+GranularSource::GranularSource(float sampleRate, float liveBufferSeconds)
+    : m_sampleRate(sampleRate > 0.0f ? sampleRate : 44100.0f)
+    , m_mode(BufferMode::Sample)
+    , m_windowShape(WindowShape::Hann)
+    , m_window(windowTable(WindowShape::Hann))
+    , m_sample{}
+    , m_sampleCapacity(0U)
+    , m_sampleSourceRate(m_sampleRate)
+    , m_rootFrequency(261.625565f)
+    , m_live{}
+    , m_liveMask(0U)
+    , m_liveWrite(0U)
+    , m_density(40.0f)
+    , m_grainSeconds(0.08f)
+    , m_position(0.0f)
+    , m_positionSpread(0.05f)
+    , m_pitchSpreadCents(0.0f)
+    , m_panSpread(0.5f)
+    , m_onsetJitter(0.2f)
+    , m_samplesToNextGrain(0.0f)
+    , m_activeGrains(0U)
+    , m_grainLimit(kMaxGrains)
+    , m_stolenGrains(0U)
+    , m_grainStart(kMaxGrains, 0)
+    , m_grainOffset(kMaxGrains, 0.0f)
+    , m_grainIncrement(kMaxGrains, 0.0f)
+    , m_grainWindowPos(kMaxGrains, 0.0f)
+    , m_grainWindowInc(kMaxGrains, 0.0f)
+    , m_grainGainL(kMaxGrains, 0.0f)
+    , m_grainGainR(kMaxGrains, 0.0f)
+    , m_scratchSample(kMaxGrains, 0.0f)
+    , m_scratchWindow(kMaxGrains, 0.0f)
+    , m_random(std::random_device{}())
+    , m_kernels(&simdKernels())
+{
+    const float seconds = clampValue(liveBufferSeconds, 0.5f, 30.0f);
+    const std::size_t liveLength = nextPowerOfTwo(static_cast<std::size_t>(seconds * m_sampleRate));
+    m_live.assign(liveLength, 0.0f);
+    m_liveMask = liveLength - 1U;
+}
+
+const float* GranularSource::windowTable(WindowShape shape)
+{
+    static const WindowTables tables;
+    return tables.tables[static_cast<std::size_t>(shape)].data();
+}
+
+std::vector<float> GranularSource::prepareSample(const std::vector<float>& samples)
+{
+    std::vector<float> sample;
+    sample.reserve(samples.size() + 1U);
+    sample.assign(samples.begin(), samples.end());
+    // Guard sample so interpolation at the last index stays in range
+    sample.push_back(samples.empty() ? 0.0f : samples.back());
+    return sample;
+}
+
+void GranularSource::adoptSample(std::vector<float>& sample, float sourceSampleRate, float rootFrequency)
+{
+    m_activeGrains = 0U;
+    m_sample.swap(sample);
+    m_sampleCapacity.store(m_sample.capacity(), std::memory_order_relaxed);
+    m_sampleSourceRate = sourceSampleRate > 0.0f ? sourceSampleRate : m_sampleRate;
+    m_rootFrequency = rootFrequency > 0.0f ? rootFrequency : 261.625565f;
+    m_mode = BufferMode::Sample;
+}
+
+void GranularSource::writeLiveSample(float sample)
+{
+    m_live[m_liveWrite] = sample;
+    m_liveWrite = (m_liveWrite + 1U) & m_liveMask;
+}
+
+void GranularSource::reset()
+{
+    m_activeGrains = 0U;
+    m_samplesToNextGrain = 0.0f;
+}
+
+void GranularSource::setGrainLimit(std::size_t limit)
+{
+    m_grainLimit = clampValue<std::size_t>(limit, 1U, kMaxGrains);
+    while (m_activeGrains > m_grainLimit)
+    {
+        stealQuietestGrain();
+    }
+}
+
+void GranularSource::setSampleRate(float sampleRate)
+{
+    if (sampleRate > 0.0f)
+    {
+        m_sampleRate = sampleRate;
+    }
+}
+
+void GranularSource::setBufferMode(BufferMode mode)
+{
+    if (mode != m_mode)
+    {
+        m_mode = mode;
+        m_activeGrains = 0U;
+    }
+}
+
+void GranularSource::setWindowShape(WindowShape shape)
+{
+    // Grains in flight continue on the new table; the shared tables never
+    // move, so swapping the pointer is safe.
+    m_windowShape = shape;
+    m_window = windowTable(shape);
+}
+
+void GranularSource::setDensity(float grainsPerSecond)
+{
+    m_density = clampValue(grainsPerSecond, kMinDensity, kMaxDensity);
+}
+
+void GranularSource::setGrainDuration(float seconds)
+{
+    m_grainSeconds = clampValue(seconds, kMinGrainSeconds, kMaxGrainSeconds);
+}
+
+void GranularSource::setPosition(float position)
+{
+    m_position = clampValue(position, 0.0f, 1.0f);
+}
+
+void GranularSource::setPositionSpread(float spread)
+{
+    m_positionSpread = clampValue(spread, 0.0f, 1.0f);
+}
+
+void GranularSource::setPitchSpread(float cents)
+{
+    m_pitchSpreadCents = clampValue(cents, 0.0f, kMaxPitchSpreadCents);
+}
+
+void GranularSource::setPanSpread(float spread)
+{
+    m_panSpread = clampValue(spread, 0.0f, 1.0f);
+}
+
+void GranularSource::setOnsetJitter(float jitter)
+{
+    m_onsetJitter = clampValue(jitter, 0.0f, 1.0f);
+}
+
+const std::vector<float>& GranularSource::activeBuffer() const
+{
+    return (m_mode == BufferMode::Live) ? m_live : m_sample;
+}
+
+float GranularSource::nextOnsetInterval()
+{
+    const float base = m_sampleRate / m_density;
+    if (m_onsetJitter <= 0.0f)
+    {
+        return base;
+    }
+
+    std::uniform_real_distribution<float> jitter(-m_onsetJitter, m_onsetJitter);
+    return std::max(1.0f, base * (1.0f + jitter(m_random)));
+}
+
+void GranularSource::spawnGrain(float frequency)
+{
+    if (m_activeGrains >= kMaxGrains)
+    {
+        return; // Pool exhausted: drop the onset rather than allocate
+    }
+    if (m_activeGrains >= m_grainLimit)
+    {
+        stealQuietestGrain();
+    }
+
+    std::uniform_real_distribution<float> bipolar(-1.0f, 1.0f);
+
+    // Pitch is fixed for the lifetime of the grain
+    const float noteRatio = (frequency > 0.0f) ? frequency / m_rootFrequency : 1.0f;
+    const float rateRatio = (m_mode == BufferMode::Sample) ? m_sampleSourceRate / m_sampleRate : 1.0f;
+    float increment = noteRatio * rateRatio;
+    if (m_pitchSpreadCents > 0.0f)
+    {
+        increment *= std::pow(2.0f, (bipolar(m_random) * m_pitchSpreadCents) / 1200.0f);
+    }
+    increment = clampValue(increment, 0.0625f, 16.0f);
+
+    const float grainSamples = std::max(2.0f, m_grainSeconds * m_sampleRate);
+    const float span = increment * grainSamples + 2.0f;
+    const float position = clampValue(m_position + bipolar(m_random) * m_positionSpread, 0.0f, 1.0f);
+
+    int32_t start = 0;
+    if (m_mode == BufferMode::Live)
+    {
+        // Keep the read head behind the write head for the whole grain, and
+        // ahead of the data that will be overwritten before the grain ends.
+        const float length = static_cast<float>(m_live.size());
+        const float minDistance = std::max(0.0f, (increment - 1.0f) * grainSamples) + 2.0f;
+        const float maxDistance = length - 2.0f - std::max(0.0f, (1.0f - increment) * grainSamples);
+        if (maxDistance <= minDistance)
+        {
+            return;
+        }
+
+        const float distance = minDistance + position * (maxDistance - minDistance);
+        const std::size_t back = static_cast<std::size_t>(distance);
+        start = static_cast<int32_t>((m_liveWrite + m_live.size() - back) & m_liveMask);
+    }
+    else
+    {
+        const float usable = static_cast<float>(m_sample.size()) - 1.0f - span;
+        if (usable < 0.0f)
+        {
+            return; // No sample loaded, or the grain is longer than the sample
+        }
+        start = static_cast<int32_t>(position * usable);
+    }
+
+    // Constant-power pan, normalised by the expected grain overlap so that
+    // dense clouds keep roughly the same loudness as sparse ones
+    const float pan = bipolar(m_random) * m_panSpread;
+    const float angle = (pan + 1.0f) * (kPi * 0.25f);
+    const float overlap = std::max(1.0f, m_density * m_grainSeconds);
+    const float level = 1.0f / std::sqrt(overlap);
+
+    const std::size_t slot = m_activeGrains++;
+    m_grainStart[slot] = start;
+    m_grainOffset[slot] = 0.0f;
+    m_grainIncrement[slot] = increment;
+    m_grainWindowPos[slot] = 0.0f;
+    m_grainWindowInc[slot] = static_cast<float>(kWindowTableSize) / grainSamples;
+    m_grainGainL[slot] = std::cos(angle) * level;
+    m_grainGainR[slot] = std::sin(angle) * level;
+}
+
+void GranularSource::retireGrain(std::size_t slot)
+{
+    const std::size_t last = m_activeGrains - 1U;
+    if (slot != last)
+    {
+        m_grainStart[slot] = m_grainStart[last];
+        m_grainOffset[slot] = m_grainOffset[last];
+        m_grainIncrement[slot] = m_grainIncrement[last];
+        m_grainWindowPos[slot] = m_grainWindowPos[last];
+        m_grainWindowInc[slot] = m_grainWindowInc[last];
+        m_grainGainL[slot] = m_grainGainL[last];
+        m_grainGainR[slot] = m_grainGainR[last];
+    }
+    m_activeGrains = last;
+}
+
+void GranularSource::stealQuietestGrain()
+{
+    // Level is the current window value times the louder pan gain; grains
+    // near either end of their window go first, which also keeps the cut quiet
+    std::size_t quietest = 0;
+    float quietestLevel = std::numeric_limits<float>::max();
+    for (std::size_t slot = 0; slot < m_activeGrains; ++slot)
+    {
+        const std::size_t windowIndex = std::min(static_cast<std::size_t>(m_grainWindowPos[slot]), kWindowTableSize - 1U);
+        const float level = m_window[windowIndex] * std::max(m_grainGainL[slot], m_grainGainR[slot]);
+        if (level < quietestLevel)
+        {
+            quietestLevel = level;
+            quietest = slot;
+        }
+    }
+    retireGrain(quietest);
+    ++m_stolenGrains;
+}
+
+std::pair<float, float> GranularSource::process(float frequency)
+{
+    // Sample-accurate onset scheduling: every onset due on this frame starts here
+    m_samplesToNextGrain -= 1.0f;
+    while (m_samplesToNextGrain <= 0.0f)
+    {
+        spawnGrain(frequency);
+        m_samplesToNextGrain += nextOnsetInterval();
+    }
+
+    const std::size_t count = m_activeGrains;
+    if (count == 0U)
+    {
+        return {0.0f, 0.0f};
+    }
+
+    // Gather pass: interpolated source and window values per grain
+    const std::vector<float>& buffer = activeBuffer();
+    const float* source = buffer.data();
+    const bool live = (m_mode == BufferMode::Live);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float offset = m_grainOffset[i];
+        const std::size_t whole = static_cast<std::size_t>(offset);
+        const float frac = offset - static_cast<float>(whole);
+
+        std::size_t index = static_cast<std::size_t>(m_grainStart[i]) + whole;
+        std::size_t next = index + 1U;
+        if (live)
+        {
+            index &= m_liveMask;
+            next &= m_liveMask;
+        }
+        m_scratchSample[i] = source[index] + (source[next] - source[index]) * frac;
+
+        const float windowPos = m_grainWindowPos[i];
+        const std::size_t windowIndex = std::min(static_cast<std::size_t>(windowPos), kWindowTableSize - 1U);
+        const float windowFrac = windowPos - static_cast<float>(windowIndex);
+        m_scratchWindow[i] = m_window[windowIndex] + (m_window[windowIndex + 1U] - m_window[windowIndex]) * windowFrac;
+    }
+
+    // Mix pass: window, pan and advance all grains together
+    float left = 0.0f;
+    float right = 0.0f;
+    m_kernels->grainMix(m_scratchSample.data(), m_scratchWindow.data(), m_grainGainL.data(), m_grainGainR.data(),
+                        count, &left, &right);
+    m_kernels->addInPlace(m_grainOffset.data(), m_grainIncrement.data(), count);
+    m_kernels->addInPlace(m_grainWindowPos.data(), m_grainWindowInc.data(), count);
+
+    // Retire finished grains; walking backwards keeps swapped-in slots valid
+    const float windowEnd = static_cast<float>(kWindowTableSize);
+    for (std::size_t slot = count; slot-- > 0U;)
+    {
+        if (m_grainWindowPos[slot] >= windowEnd)
+        {
+            retireGrain(slot);
+        }
+    }
+
+    return {left, right};
+}
+
+std::size_t GranularSource::memoryBytes() const
+{
+    const std::size_t floats = m_sampleCapacity.load(std::memory_order_relaxed) + m_live.capacity() + m_grainOffset.capacity()
+                             + m_grainIncrement.capacity() + m_grainWindowPos.capacity()
+                             + m_grainWindowInc.capacity() + m_grainGainL.capacity() + m_grainGainR.capacity()
+                             + m_scratchSample.capacity() + m_scratchWindow.capacity();
+    return sizeof(*this) + floats * sizeof(float) + m_grainStart.capacity() * sizeof(int32_t);
+}
+
+std::size_t GranularSource::windowTableBytes()
+{
+    return sizeof(WindowTables) + WindowTables::kShapes * (kWindowTableSize + 1U) * sizeof(float);
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Dsp/SimdKernels.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * @file GranularSource.h
+ * @brief Granular voice source playing clouds of short grains
+ */
+
+/**
+ * @class GranularSource
+ * @brief Voice source that renders overlapping grains from a sample or live buffer
+ *
+ * Grains are taken from a fixed-capacity pool allocated at construction, so
+ * spawning and retiring grains never touches the heap on the audio thread.
+ * Grain onsets are scheduled with sample accuracy from the configured density,
+ * while pitch, pan and window increment are computed once when a grain is
+ * spawned. Envelopes come from precomputed window tables shared by all sources.
+ *
+ * Active grains are kept in structure-of-arrays form and compacted to the front
+ * of the pool, so the per-sample mixing pass runs across all active grains with
+ * SIMD instead of walking individual grain objects.
+ */
+class GranularSource
+{
+public:
+    /**
+     * @enum WindowShape
+     * @brief Amplitude window applied to every grain
+     */
+    enum class WindowShape
+    {
+        Hann,       ///< Raised cosine, smooth and general purpose
+        Gaussian,   ///< Narrow bell, soft and airy clouds
+        Tukey,      ///< Flat top with cosine tapers, keeps transients
+        Trapezoid   ///< Linear ramps with a flat top
+    };
+
+    /**
+     * @enum BufferMode
+     * @brief Source material grains are read from
+     */
+    enum class BufferMode
+    {
+        Sample,     ///< Loaded sample set through adoptSample()
+        Live        ///< Circular buffer filled through writeLiveSample()
+    };
+
+    static constexpr std::size_t kMaxGrains = 256;         ///< Capacity of the grain pool
+    static constexpr std::size_t kWindowTableSize = 1024;  ///< Entries per window table
+
+    /**
+     * @brief Construct a granular source
+     * @param sampleRate Engine sample rate in Hz
+     * @param liveBufferSeconds Length of the live capture buffer in seconds
+     */
+    explicit GranularSource(float sampleRate = 44100.0f, float liveBufferSeconds = 4.0f);
+
+    /**
+     * @brief Build the buffer adoptSample() takes from mono sample data (any thread)
+     * @param samples Mono sample data
+     * @return The data with the guard sample interpolation needs appended
+     */
+    static std::vector<float> prepareSample(const std::vector<float>& samples);
+
+    /**
+     * @brief Swap in a buffer from prepareSample() and play it in BufferMode::Sample (audio thread)
+     * @param sample Prepared buffer; receives the sample it replaces, to be released off the audio thread
+     * @param sourceSampleRate Sample rate the data was recorded at
+     * @param rootFrequency Pitch of the material in Hz, played back unshifted at this note
+     *
+     * Never allocates. Active grains end, since they read the old buffer.
+     * AudioSystem::loadGranularSample() prepares and hands over a sample.
+     */
+    void adoptSample(std::vector<float>& sample, float sourceSampleRate, float rootFrequency = 261.625565f);
+
+    /**
+     * @brief Append one sample to the live capture buffer (audio thread)
+     */
+    void writeLiveSample(float sample);
+
+    /**
+     * @brief Render the next stereo frame
+     * @param frequency Note frequency used for grains spawned on this frame
+     * @return Stereo frame with all active grains mixed
+     */
+    std::pair<float, float> process(float frequency);
+
+    /**
+     * @brief Retire all active grains and restart the onset scheduler
+     */
+    void reset();
+
+    void setSampleRate(float sampleRate);
+    void setBufferMode(BufferMode mode);
+    void setWindowShape(WindowShape shape);
+
+    /// Set the grain onset rate in grains per second
+    void setDensity(float grainsPerSecond);
+    /// Set the grain length in seconds
+    void setGrainDuration(float seconds);
+    /// Set the read position [0.0-1.0]; in live mode this is the distance behind the write head
+    void setPosition(float position);
+    /// Set the random spread added to the read position [0.0-1.0]
+    void setPositionSpread(float spread);
+    /// Set the random per-grain detune range in cents
+    void setPitchSpread(float cents);
+    /// Set the random stereo spread [0.0 = centre, 1.0 = full width]
+    void setPanSpread(float spread);
+    /// Set the random onset jitter relative to the grain interval [0.0-1.0]
+    void setOnsetJitter(float jitter);
+
+    /**
+     * @brief Cap the number of simultaneous grains (used by the load governor)
+     *
+     * Grains above a new limit end at once, quietest first; at the limit a
+     * new onset takes the slot of the quietest grain instead of adding one.
+     * kMaxGrains removes the cap.
+     */
+    void setGrainLimit(std::size_t limit);
+
+    std::size_t activeGrainCount() const { return m_activeGrains; }
+    std::size_t grainLimit() const { return m_grainLimit; }
+    /// Grains ended early by the grain limit since construction
+    std::uint64_t stolenGrainCount() const { return m_stolenGrains; }
+    BufferMode bufferMode() const { return m_mode; }
+
+    /// Bytes of the source: itself, the loaded sample, the live ring and the grain pool
+    std::size_t memoryBytes() const;
+
+    /// Bytes of the window tables shared by every source
+    static std::size_t windowTableBytes();
+
+private:
+    /// Shared, lazily-built window tables (one per WindowShape)
+    static const float* windowTable(WindowShape shape);
+
+    void spawnGrain(float frequency);
+    void retireGrain(std::size_t slot);
+    /// End the active grain with the lowest current level
+    void stealQuietestGrain();
+    float nextOnsetInterval();
+
+    const std::vector<float>& activeBuffer() const;
+
+    float m_sampleRate;                 ///< Engine sample rate in Hz
+    BufferMode m_mode;                  ///< Current source material
+    WindowShape m_windowShape;          ///< Window used for new grains
+    const float* m_window;              ///< Table for m_windowShape
+
+    std::vector<float> m_sample;        ///< Loaded sample with guard sample appended
+    std::atomic<std::size_t> m_sampleCapacity; ///< m_sample.capacity(), readable by memoryBytes()
+    float m_sampleSourceRate;           ///< Sample rate of the loaded material
+    float m_rootFrequency;              ///< Pitch of the loaded material
+
+    std::vector<float> m_live;          ///< Live capture ring (power-of-two length plus guard)
+    std::size_t m_liveMask;             ///< Index mask for the live ring
+    std::size_t m_liveWrite;            ///< Next write position in the live ring
+
+    float m_density;                    ///< Grains per second
+    float m_grainSeconds;               ///< Grain duration in seconds
+    float m_position;                   ///< Read position [0.0-1.0]
+    float m_positionSpread;             ///< Random read position spread [0.0-1.0]
+    float m_pitchSpreadCents;           ///< Random detune range in cents
+    float m_panSpread;                  ///< Random pan spread [0.0-1.0]
+    float m_onsetJitter;                ///< Random onset jitter [0.0-1.0]
+    float m_samplesToNextGrain;         ///< Countdown to the next onset in samples
+
+    // Grain pool in structure-of-arrays form; slots [0, m_activeGrains) are live
+    std::size_t m_activeGrains;
+    std::size_t m_grainLimit;               ///< Grains allowed at once, at most kMaxGrains
+    std::uint64_t m_stolenGrains;           ///< Grains ended early by m_grainLimit
+    std::vector<int32_t> m_grainStart;      ///< Integer read origin in the source buffer
+    std::vector<float> m_grainOffset;       ///< Fractional read offset from the origin
+    std::vector<float> m_grainIncrement;    ///< Read increment per output sample (pitch)
+    std::vector<float> m_grainWindowPos;    ///< Position in the window table
+    std::vector<float> m_grainWindowInc;    ///< Window table increment per output sample
+    std::vector<float> m_grainGainL;        ///< Left pan gain
+    std::vector<float> m_grainGainR;        ///< Right pan gain
+
+    // Per-frame scratch filled by the gather pass and consumed by the SIMD mix pass
+    std::vector<float> m_scratchSample;
+    std::vector<float> m_scratchWindow;
+
+    std::mt19937 m_random;              ///< Per-source random engine for grain parameters
+    const SimdKernels* m_kernels;       ///< Selected at construction
+};
@@ -0,0 +1,336 @@
+#include "EngineHost.h"
+#include "audioDevice.h"
+#include "StereoSampleRingBuffer.h"
+#include "Effects/TimeStretchEffect.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+constexpr std::size_t WaveformSnapshot::kMaxFrames;
+constexpr std::size_t HostCommand::kValues;
+constexpr std::size_t HostCommand::kTextBytes;
+constexpr std::size_t EngineHostShared::kSampleCapacity;
+constexpr std::size_t EngineHostShared::kMidiNameBytes;
+constexpr std::size_t EngineHostShared::kErrorBytes;
+
+namespace {
+    void copyText(char* destination, std::size_t bytes, const std::string& text) {
+        const std::size_t length = std::min(text.size(), bytes - 1U);
+        std::memcpy(destination, text.data(), length);
+        destination[length] = '\0';
+    }
+
+    std::string commandText(const HostCommand& command) {
+        return std::string(command.text, strnlen(command.text, HostCommand::kTextBytes));
+    }
+
+    /// The oscilloscope redraws at display rate, so faster copies of the 32 KB snapshot are wasted
+    constexpr std::int64_t kWaveformPublishNanos = 16000000;
+}
+
+EngineHost::EngineHost(EngineHostShared& shared, AudioSystem& audioSystem, AudioDevice* device)
+    : m_shared(shared)
+    , m_audioSystem(audioSystem)
+    , m_device(device)
+    , m_pendingTuning{}
+    , m_publishedWaveformFrames(0U)
+    , m_waveformPublishNanos(0)
+{
+    if (!m_shared.compatible())
+    {
+        throw std::runtime_error("Shared memory layout does not match this engine host");
+    }
+
+    const float sampleRate = m_shared.sampleRate;
+    m_waveformBuffer.reset(new StereoSampleRingBuffer(WaveformSnapshot::kMaxFrames));
+    m_audioSystem.setWaveformTapBuffer(m_waveformBuffer.get());
+
+    // The audio thread polls the shared words directly, with no copy in between
+    m_parameterBlock.reset(new ParameterBlock(m_shared.parameterWords));
+    m_audioSystem.setParameterBlock(m_parameterBlock.get());
+
+    m_controller.reset(new EngineController(m_audioSystem, sampleRate, m_shared.bufferFrames,
+                                            m_shared.effectPoolLimits));
+
+    m_shared.fullDuplex.store((m_device != nullptr && m_device->isFullDuplex()) ? 1U : 0U, std::memory_order_relaxed);
+}
+
+EngineHost::~EngineHost()
+{
+    m_controller->closeMidiInput();
+    m_audioSystem.setWaveformTapBuffer(nullptr);
+    m_audioSystem.setParameterBlock(nullptr);
+    m_shared.state.store(static_cast<std::uint32_t>(HostState::Stopped), std::memory_order_release);
+}
+
+void EngineHost::openMidiInput()
+{
+    const bool connected = m_controller->openMidiInput();
+    copyText(m_shared.midiName, EngineHostShared::kMidiNameBytes, m_controller->midiDeviceName());
+    m_shared.midiConnected.store(connected ? 1U : 0U, std::memory_order_relaxed);
+}
+
+void EngineHost::closeMidiInput()
+{
+    m_controller->closeMidiInput();
+}
+
+void EngineHost::markRunning()
+{
+    publish();
+    m_shared.state.store(static_cast<std::uint32_t>(HostState::Running), std::memory_order_release);
+}
+
+bool EngineHost::poll()
+{
+    HostCommand command;
+    bool running = true;
+    while (running && m_shared.commands.tryPop(command))
+    {
+        if (command.type == HostCommand::Type::Shutdown)
+        {
+            running = false;
+        }
+        else
+        {
+            apply(command);
+        }
+    }
+
+    publish();
+    return running;
+}
+
+void EngineHost::apply(const HostCommand& command)
+{
+    const float* values = command.values;
+
+    switch (command.type)
+    {
+        case HostCommand::Type::Start:
+        {
+            bool started = true;
+            if (m_device != nullptr)
+            {
+                try
+                {
+                    m_device->start();
+                }
+                catch (const std::exception& e)
+                {
+                    copyText(m_shared.error, EngineHostShared::kErrorBytes, e.what());
+                    started = false;
+                }
+            }
+            reply(command, started);
+            break;
+        }
+        case HostCommand::Type::Stop:
+            if (m_device != nullptr)
+            {
+                m_device->stop();
+            }
+            m_controller->forgetCurrentNote();
+            break;
+        case HostCommand::Type::TriggerNote:
+            m_controller->triggerNote(values[0]);
+            break;
+        case HostCommand::Type::TriggerNoteOff:
+            m_controller->triggerNoteOff(values[0]);
+            break;
+        case HostCommand::Type::NoteOn:
+            m_controller->noteOnAt(command.frame, command.ints[0], values[0], command.ints[1]);
+            break;
+        case HostCommand::Type::NoteOff:
+            m_controller->noteOffAt(command.frame, command.ints[0], command.ints[1]);
+            break;
+        case HostCommand::Type::PitchBend:
+            m_audioSystem.setPitchBendAt(command.frame, command.ints[0]);
+            break;
+        case HostCommand::Type::TuningChunk:
+            applyTuningChunk(command);
+            break;
+        case HostCommand::Type::ResetTuning:
+            m_audioSystem.resetTuning();
+            break;
+        case HostCommand::Type::ResetEffects:
+            m_audioSystem.resetEffects();
+            break;
+        case HostCommand::Type::ClearEffects:
+            m_audioSystem.clearEffects();
+            break;
+        case HostCommand::Type::Envelope:
+            m_audioSystem.updateADSRParameters(values[0], values[1], values[2], values[3]);
+            break;
+        case HostCommand::Type::Waveform:
+            if (!m_controller->setWaveform(commandText(command)))
+            {
+                std::cerr << "Warning: unknown waveform '" << commandText(command) << "'" << std::endl;
+            }
+            break;
+        case HostCommand::Type::AddDelay:
+            m_controller->addDelay(values[0], values[1], values[2]);
+            break;
+        case HostCommand::Type::AddLowPass:
+            m_controller->addLowPass(values[0], values[1], values[2]);
+            break;
+        case HostCommand::Type::LowPassCutoff:
+            m_audioSystem.setLowPassCutoff(values[0]);
+            break;
+        case HostCommand::Type::MemoryBudget:
+            m_audioSystem.setMemoryBudget(static_cast<std::size_t>(std::max(values[0], 0.0f) * 1024.0f * 1024.0f));
+            break;
+        case HostCommand::Type::AddOctave:
+            m_controller->addOctave(command.ints[0] != 0, values[0]);
+            break;
+        case HostCommand::Type::Drift:
+            m_audioSystem.setDriftParameters(values[0], values[1], values[2]);
+            break;
+        case HostCommand::Type::SecondaryOscillator:
+            m_audioSystem.configureSecondaryOscillator(command.ints[0] != 0, values[0], values[1], command.ints[1]);
+            break;
+        case HostCommand::Type::GranularEnabled:
+            m_controller->setGranularEnabled(command.ints[0] != 0);
+            break;
+        case HostCommand::Type::GranularConfig:
+            m_controller->configureGranular(values[0], values[1], values[2], values[3], values[4], values[5]);
+            break;
+        case HostCommand::Type::GranularBufferMode:
+            m_controller->setGranularBufferMode(commandText(command));
+            break;
+        case HostCommand::Type::LoadGranularSample:
+        {
+            std::vector<float> samples;
+            takeSample(command, samples);
+            m_controller->loadGranularSample(samples, values[0], values[1]);
+            break;
+        }
+        case HostCommand::Type::AddSpectralFreeze:
+            m_controller->addSpectralFreeze(values[0]);
+            break;
+        case HostCommand::Type::SpectralFreeze:
+            reply(command, m_audioSystem.setSpectralFreeze(command.ints[0] != 0));
+            break;
+        case HostCommand::Type::AddSpectralSmear:
+            m_controller->addSpectralSmear(values[0], values[1]);
+            break;
+        case HostCommand::Type::AddTimeStretch:
+            if (values[1] >= 0.0f)
+            {
+                m_controller->timeStretch().setGain(values[1]);
+            }
+            if (command.ints[0] != 0)
+            {
+                m_controller->timeStretch().setLooping(command.ints[1] != 0);
+            }
+            m_controller->addTimeStretch(values[0]);
+            break;
+        case HostCommand::Type::LoadTimeStretchSample:
+        {
+            std::vector<float> samples;
+            takeSample(command, samples);
+            m_controller->loadTimeStretchSample(samples, values[0]);
+            break;
+        }
+        case HostCommand::Type::TriggerTimeStretch:
+            m_controller->timeStretch().trigger();
+            break;
+        case HostCommand::Type::StopTimeStretch:
+            m_controller->timeStretch().stopPlayback();
+            break;
+        case HostCommand::Type::AddVocoder:
+            m_controller->addVocoder(static_cast<std::size_t>(std::max(0, command.ints[0])), values[0]);
+            break;
+        case HostCommand::Type::LoadVocoderModulator:
+        {
+            std::vector<float> samples;
+            takeSample(command, samples);
+            m_controller->loadVocoderModulator(samples, values[0]);
+            break;
+        }
+        case HostCommand::Type::VocoderModulatorSource:
+            m_controller->setVocoderModulatorSource(commandText(command));
+            break;
+        case HostCommand::Type::LiveInputMode:
+            m_audioSystem.setLiveInputMode(AudioSystem::liveInputModeFromString(commandText(command)), values[0]);
+            break;
+        case HostCommand::Type::Compressor:
+            m_audioSystem.configureCompressor(command.ints[0] != 0, values[0], values[1], values[2], values[3], values[4]);
+            break;
+        case HostCommand::Type::Limiter:
+            m_audioSystem.configureLimiter(command.ints[0] != 0, values[0], values[1]);
+            break;
+        case HostCommand::Type::EffectBypass:
+            reply(command, m_audioSystem.setEffectBypass(commandText(command), command.ints[0] != 0, command.ints[1] != 0));
+            break;
+        case HostCommand::Type::None:
+        case HostCommand::Type::Shutdown:
+            break;
+    }
+}
+
+void EngineHost::reply(const HostCommand& command, bool result)
+{
+    m_shared.replyValue.store(result ? 1U : 0U, std::memory_order_relaxed);
+    m_shared.replySequence.store(command.sequence, std::memory_order_release);
+}
+
+void EngineHost::applyTuningChunk(const HostCommand& command)
+{
+    const int first = command.ints[0];
+    for (std::size_t i = 0; i < HostCommand::kValues; ++i)
+    {
+        const int note = first + static_cast<int>(i);
+        if (note >= 0 && note < AudioSystem::kMidiNotes)
+        {
+            m_pendingTuning[static_cast<std::size_t>(note)] = command.values[i];
+        }
+    }
+
+    if (command.ints[1] != 0)
+    {
+        m_audioSystem.setTuningTable(m_pendingTuning);
+        m_pendingTuning.fill(0.0f);
+    }
+}
+
+std::size_t EngineHost::takeSample(const HostCommand& command, std::vector<float>& samples)
+{
+    const std::size_t frames = std::min(static_cast<std::size_t>(std::max(0, command.ints[0])),
+                                        EngineHostShared::kSampleCapacity);
+    samples.assign(m_shared.sampleFrames, m_shared.sampleFrames + frames);
+
+    // The addon may reuse the area as soon as the copy is taken
+    m_shared.sampleBusy.store(0U, std::memory_order_release);
+    return frames;
+}
+
+void EngineHost::publish()
+{
+    const AudioClockSnapshot clock = m_audioSystem.audioClock();
+    if (clock.hostTimeNanos != 0)
+    {
+        m_shared.clock.publish(clock.frame, clock.hostTimeNanos);
+    }
+
+    m_shared.telemetry.back() = m_audioSystem.telemetry();
+    m_shared.telemetry.publish();
+
+    // Only copy the waveform when the tap moved, and no faster than the display redraws
+    const std::size_t waveformFrames = m_waveformBuffer->totalFramesWritten();
+    const std::int64_t now = AudioClock::hostTimeNanos();
+    if (waveformFrames != m_publishedWaveformFrames && now - m_waveformPublishNanos >= kWaveformPublishNanos)
+    {
+        WaveformSnapshot& waveform = m_shared.waveform.back();
+        waveform.frames = static_cast<std::uint32_t>(
+            m_waveformBuffer->copyLatestInterleaved(waveform.samples, WaveformSnapshot::kMaxFrames));
+        m_shared.waveform.publish();
+        m_publishedWaveformFrames = waveformFrames;
+        m_waveformPublishNanos = now;
+    }
+
+    m_shared.masterLatencyFrames.store(m_audioSystem.masterLatencyFrames(), std::memory_order_relaxed);
+    m_shared.lowPassCutoffHz.store(m_audioSystem.getLowPassCutoff(), std::memory_order_relaxed);
+    m_shared.heartbeat.fetch_add(1U, std::memory_order_release);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "audioSystem.h"
+#include "EngineController.h"
+#include "EngineHostProtocol.h"
+
+class AudioDevice;
+class StereoSampleRingBuffer;
+
+/**
+ * @class EngineHost
+ * @brief Engine side of the out-of-process transport
+ *
+ * Drains commands from the shared ring into an EngineController and
+ * publishes the clock, telemetry, waveform and status back into the shared
+ * mapping.
+ * Runs on a plain control thread of the host process; the audio thread
+ * only ever sees the AudioSystem's own queues and the parameter block,
+ * which lives directly in shared memory.
+ *
+ * The process that owns the devices constructs the AudioSystem and
+ * AudioDevice; without a device (headless runs) Start succeeds and the
+ * caller drives renderBlock() itself.
+ */
+class EngineHost
+{
+public:
+    /**
+     * @param shared Mapping created by EngineHostClient; must outlive the host
+     * @param audioSystem Engine to control
+     * @param device Output device, or nullptr
+     */
+    EngineHost(EngineHostShared& shared, AudioSystem& audioSystem, AudioDevice* device);
+    ~EngineHost();
+
+    EngineHost(const EngineHost&) = delete;
+    EngineHost& operator=(const EngineHost&) = delete;
+
+    /**
+     * @brief Open the first hardware MIDI input and record it for getMidiStatus() (before markRunning())
+     */
+    void openMidiInput();
+
+    /// Stop the MIDI input, if open
+    void closeMidiInput();
+
+    /**
+     * @brief Tell the addon the host is ready for commands
+     */
+    void markRunning();
+
+    /**
+     * @brief Apply pending commands and publish state once
+     * @return false once a Shutdown command was received
+     */
+    bool poll();
+
+private:
+    void apply(const HostCommand& command);
+    void reply(const HostCommand& command, bool result);
+    void applyTuningChunk(const HostCommand& command);
+    std::size_t takeSample(const HostCommand& command, std::vector<float>& samples);
+    void publish();
+
+    EngineHostShared& m_shared;
+    AudioSystem& m_audioSystem;
+    AudioDevice* m_device;
+    std::unique_ptr<ParameterBlock> m_parameterBlock;           ///< View over m_shared.parameterWords
+    std::unique_ptr<StereoSampleRingBuffer> m_waveformBuffer;
+    std::unique_ptr<EngineController> m_controller;
+    std::array<float, AudioSystem::kMidiNotes> m_pendingTuning;     ///< Table assembled from TuningChunk commands
+    std::size_t m_publishedWaveformFrames;      ///< Tap frames written when the waveform was last published
+    std::int64_t m_waveformPublishNanos;        ///< Host time of that publish
+};
@@ -0,0 +1,197 @@
+#include "EngineHostClient.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+    constexpr auto kStartupTimeout = std::chrono::seconds(10);
+    constexpr auto kShutdownTimeout = std::chrono::seconds(1);
+    constexpr auto kFullRingTimeout = std::chrono::milliseconds(50);
+    constexpr auto kSampleTimeout = std::chrono::seconds(2);
+
+    std::string uniqueName() {
+        static std::atomic<unsigned int> counter(0U);
+        return "/audioEngine-" + std::to_string(static_cast<long>(::getpid())) + "-" +
+               std::to_string(counter.fetch_add(1U));
+    }
+
+    /**
+     * @brief Sleep-poll until done() holds or the timeout passes
+     * @return The last value of done()
+     */
+    template <typename Done, typename Duration>
+    bool waitFor(Done done, Duration timeout, std::chrono::microseconds interval) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!done()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return done();
+            }
+            std::this_thread::sleep_for(interval);
+        }
+        return true;
+    }
+}
+
+EngineHostClient::EngineHostClient(const std::string& executable, float sampleRate, unsigned int bufferFrames, bool fullDuplex,
+                                   const EffectPool::Limits& poolLimits)
+    : m_memory(SharedMemory::create(uniqueName(), sizeof(EngineHostShared)))
+    , m_shared(new (m_memory.data()) EngineHostShared(sampleRate, bufferFrames, fullDuplex, poolLimits))
+    , m_parameterBlock(m_shared->parameterWords)
+    , m_pid(-1)
+    , m_querySequence(0U)
+{
+    const std::string& name = m_memory.name();
+    char* const argv[] = {const_cast<char*>(executable.c_str()), const_cast<char*>(name.c_str()), nullptr};
+
+    pid_t pid = -1;
+    const int status = ::posix_spawn(&pid, executable.c_str(), nullptr, nullptr, argv, environ);
+    if (status != 0)
+    {
+        throw std::runtime_error("Cannot start engine host " + executable + ": " + std::strerror(status));
+    }
+    m_pid = pid;
+
+    try
+    {
+        waitUntilRunning();
+    }
+    catch (...)
+    {
+        terminate();
+        throw;
+    }
+
+    // Both sides hold the mapping now; dropping the name means nothing leaks if either crashes
+    m_memory.unlink();
+}
+
+EngineHostClient::~EngineHostClient()
+{
+    terminate();
+}
+
+bool EngineHostClient::post(const HostCommand& command)
+{
+    if (m_shared->commands.tryPush(command))
+    {
+        return true;
+    }
+
+    // Full: give the host's control thread a moment to catch up
+    return waitFor([this, &command]() { return !alive() || m_shared->commands.tryPush(command); },
+                   kFullRingTimeout, std::chrono::microseconds(200)) && m_pid > 0;
+}
+
+bool EngineHostClient::request(HostCommand command, unsigned int timeoutMs)
+{
+    m_querySequence = (m_querySequence + 1U == 0U) ? 1U : m_querySequence + 1U;
+    command.sequence = m_querySequence;
+    if (!post(command))
+    {
+        return false;
+    }
+
+    const std::uint32_t sequence = command.sequence;
+    const bool answered = waitFor(
+        [this, sequence]() { return m_shared->replySequence.load(std::memory_order_acquire) == sequence; },
+        std::chrono::milliseconds(timeoutMs), std::chrono::microseconds(50));
+    return answered && m_shared->replyValue.load(std::memory_order_relaxed) != 0U;
+}
+
+void EngineHostClient::postSample(HostCommand command, const float* samples, std::size_t count)
+{
+    if (count > EngineHostShared::kSampleCapacity)
+    {
+        throw std::runtime_error("Sample is too long for the engine host (" + std::to_string(count) + " frames, limit " +
+                                 std::to_string(EngineHostShared::kSampleCapacity) + ")");
+    }
+
+    const bool released = waitFor(
+        [this]() { return m_shared->sampleBusy.load(std::memory_order_acquire) == 0U || !alive(); },
+        kSampleTimeout, std::chrono::microseconds(500));
+    if (!released || m_pid <= 0)
+    {
+        throw std::runtime_error("Engine host did not take the previous sample");
+    }
+
+    std::memcpy(m_shared->sampleFrames, samples, count * sizeof(float));
+    m_shared->sampleBusy.store(1U, std::memory_order_relaxed);
+
+    // Publishing the command releases the sample data with it
+    command.ints[0] = static_cast<std::int32_t>(count);
+    if (!post(command))
+    {
+        m_shared->sampleBusy.store(0U, std::memory_order_relaxed);
+        throw std::runtime_error("Engine host is not accepting commands");
+    }
+}
+
+bool EngineHostClient::alive()
+{
+    if (m_pid <= 0)
+    {
+        return false;
+    }
+
+    int status = 0;
+    const pid_t result = ::waitpid(m_pid, &status, WNOHANG);
+    if (result == m_pid || (result < 0 && errno == ECHILD))
+    {
+        m_pid = -1;
+        return false;
+    }
+    return true;
+}
+
+void EngineHostClient::waitUntilRunning()
+{
+    const auto state = [this]() { return static_cast<HostState>(m_shared->state.load(std::memory_order_acquire)); };
+
+    const bool settled = waitFor([this, &state]() { return state() != HostState::Starting || !alive(); },
+                                 kStartupTimeout, std::chrono::milliseconds(2));
+    if (state() == HostState::Running)
+    {
+        return;
+    }
+
+    const std::string error = lastError();
+    if (!settled)
+    {
+        throw std::runtime_error("Engine host did not start in time");
+    }
+    throw std::runtime_error("Engine host failed to start" + (error.empty() ? std::string() : ": " + error));
+}
+
+void EngineHostClient::terminate()
+{
+    if (!alive())
+    {
+        return;
+    }
+
+    HostCommand shutdown;
+    shutdown.type = HostCommand::Type::Shutdown;
+    if (!m_shared->commands.tryPush(shutdown))
+    {
+        ::kill(m_pid, SIGTERM);
+    }
+
+    if (!waitFor([this]() { return !alive(); }, kShutdownTimeout, std::chrono::milliseconds(5)))
+    {
+        ::kill(m_pid, SIGKILL);
+        ::waitpid(m_pid, nullptr, 0);
+        m_pid = -1;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "EngineHostProtocol.h"
+#include "SharedMemory.h"
+
+/**
+ * @class EngineHostClient
+ * @brief Addon side of the out-of-process transport
+ *
+ * Creates the shared mapping, starts the engine host process on it and
+ * waits until the host reports Running. Control changes go into the
+ * shared command ring without any system call; telemetry, clock and
+ * waveform are read from the mapping. The destructor asks the host to
+ * shut down, and kills it if it does not exit in time.
+ *
+ * Only one thread may post commands and read telemetry or the waveform
+ * (the ring and triple buffers are single-producer, single-consumer);
+ * the parameter block may be written from any thread.
+ */
+class EngineHostClient
+{
+public:
+    /**
+     * @brief Start an engine host
+     * @param executable Path of the audioEngineHost binary
+     * @param sampleRate Output sample rate
+     * @param bufferFrames Device buffer size
+     * @param fullDuplex Also open the default input device
+     * @param poolLimits Effect instances the host builds per type
+     * @throws std::runtime_error if the process cannot be started or reports a failure
+     */
+    EngineHostClient(const std::string& executable, float sampleRate, unsigned int bufferFrames, bool fullDuplex,
+                     const EffectPool::Limits& poolLimits = EffectPool::defaultLimits());
+    ~EngineHostClient();
+
+    EngineHostClient(const EngineHostClient&) = delete;
+    EngineHostClient& operator=(const EngineHostClient&) = delete;
+
+    /**
+     * @brief Queue a command for the host
+     * @return false if the ring stayed full or the host has exited
+     */
+    bool post(const HostCommand& command);
+
+    /**
+     * @brief Queue a query and wait for the host's answer
+     * @return The reply, or false on timeout
+     */
+    bool request(HostCommand command, unsigned int timeoutMs);
+
+    /**
+     * @brief Copy a sample into the shared area and queue the command that loads it
+     *
+     * Waits for the host to release the area from the previous load.
+     * @throws std::runtime_error if the sample does not fit or the host does not respond
+     */
+    void postSample(HostCommand command, const float* samples, std::size_t count);
+
+    /// True while the host process runs
+    bool alive();
+
+    ParameterBlock& parameterBlock() { return m_parameterBlock; }
+    AudioClockSnapshot audioClock() const { return m_shared->clock.snapshot(); }
+    const EngineTelemetry& telemetry() { return m_shared->telemetry.read(); }
+    const WaveformSnapshot& waveform() { return m_shared->waveform.read(); }
+
+    bool fullDuplex() const { return m_shared->fullDuplex.load(std::memory_order_relaxed) != 0U; }
+    bool midiConnected() const { return m_shared->midiConnected.load(std::memory_order_relaxed) != 0U; }
+    std::string midiDeviceName() const { return std::string(m_shared->midiName); }
+    std::string lastError() const { return std::string(m_shared->error); }
+    unsigned int masterLatencyFrames() const { return m_shared->masterLatencyFrames.load(std::memory_order_relaxed); }
+    float lowPassCutoff() const { return m_shared->lowPassCutoffHz.load(std::memory_order_relaxed); }
+
+private:
+    void waitUntilRunning();
+    void terminate();
+
+    SharedMemory m_memory;
+    EngineHostShared* m_shared;
+    ParameterBlock m_parameterBlock;    ///< View over the shared parameter words
+    pid_t m_pid;
+    std::uint32_t m_querySequence;
+};
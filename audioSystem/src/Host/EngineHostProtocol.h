@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "AudioClock.h"
+#include "CommandQueue.h"
+#include "EngineTelemetry.h"
+#include "ParameterBlock.h"
+#include "TripleBuffer.h"
+#include "Effects/EffectPool.h"
+
+/**
+ * @file EngineHostProtocol.h
+ * @brief Shared-memory layout between the Node addon and the engine host process
+ */
+
+/**
+ * @struct HostCommand
+ * @brief One control change sent to the engine host
+ *
+ * Plain data so it can live in shared memory; the meaning of the integer,
+ * value and text fields depends on the type.
+ */
+struct HostCommand
+{
+    enum class Type : std::uint32_t
+    {
+        None,
+        Start,                      ///< Query: open the output stream; replies 1 on success
+        Stop,
+        TriggerNote,                ///< values[0] frequency
+        TriggerNoteOff,             ///< values[0] frequency, 0 releases every note
+        NoteOn,                     ///< ints[0] note, ints[1] channel, values[0] velocity, frame (0 = now)
+        NoteOff,                    ///< ints[0] note, ints[1] channel, frame (0 = now)
+        PitchBend,                  ///< ints[0] 14-bit bend, frame (0 = now)
+        TuningChunk,                ///< ints[0] first note, ints[1] 1 on the last chunk, values[] frequencies
+        ResetTuning,
+        ResetEffects,
+        ClearEffects,
+        Envelope,                   ///< values[0..3] attack, decay, sustain, release
+        Waveform,                   ///< text waveform name
+        AddDelay,                   ///< values[0..2] time, feedback, mix
+        AddLowPass,                 ///< values[0..2] cutoff, resonance, mix
+        LowPassCutoff,              ///< values[0] cutoff
+        AddOctave,                  ///< ints[0] higher, values[0] blend
+        Drift,                      ///< values[0..2] rate, amount, jitter
+        SecondaryOscillator,        ///< ints[0] enabled, ints[1] octave offset, values[0..1] mix, detune
+        GranularEnabled,            ///< ints[0] enabled
+        GranularConfig,             ///< values[0..5] density, grain ms, position, spread, pitch spread, pan spread
+        GranularBufferMode,         ///< text mode
+        LoadGranularSample,         ///< ints[0] frames in the sample area, values[0..1] rate, root frequency
+        AddSpectralFreeze,          ///< values[0] mix
+        SpectralFreeze,             ///< Query: ints[0] frozen; replies 1 if a freeze effect exists
+        AddSpectralSmear,           ///< values[0..1] amount, mix
+        AddTimeStretch,             ///< ints[0] 1 to set looping, ints[1] looping, values[0..1] speed, gain (< 0 keeps)
+        LoadTimeStretchSample,      ///< ints[0] frames in the sample area, values[0] rate
+        TriggerTimeStretch,
+        StopTimeStretch,
+        AddVocoder,                 ///< ints[0] bands, values[0] mix
+        LoadVocoderModulator,       ///< ints[0] frames in the sample area, values[0] rate
+        VocoderModulatorSource,     ///< text source
+        LiveInputMode,              ///< text mode, values[0] gain
+        Compressor,                 ///< ints[0] enabled, values[0..4] threshold, ratio, attack ms, release ms, makeup
+        Limiter,                    ///< ints[0] enabled, values[0..1] ceiling, release ms
+        EffectBypass,               ///< Query: text effect, ints[0] bypassed, ints[1] keep warm; replies 1 if found
+        MemoryBudget,               ///< values[0] megabytes, 0 for no limit
+        Shutdown
+    };
+
+    static constexpr std::size_t kValues = 6;
+    static constexpr std::size_t kTextBytes = 24;
+
+    Type type = Type::None;
+    std::uint32_t sequence = 0;                 ///< Query id echoed in the reply
+    std::int32_t ints[2] = {0, 0};
+    std::uint64_t frame = 0;
+    float values[kValues] = {};
+    char text[kTextBytes] = {};
+
+    /**
+     * @brief Copy a string into text, truncated and NUL-terminated
+     */
+    void setText(const char* value)
+    {
+        std::strncpy(text, value, kTextBytes - 1U);
+        text[kTextBytes - 1U] = '\0';
+    }
+};
+
+/**
+ * @struct WaveformSnapshot
+ * @brief Latest output frames for the oscilloscope
+ */
+struct WaveformSnapshot
+{
+    static constexpr std::size_t kMaxFrames = 4096;
+
+    std::uint32_t frames = 0;
+    float samples[kMaxFrames * 2];   ///< Interleaved stereo, oldest first
+};
+
+/**
+ * @enum HostState
+ * @brief Lifecycle of the engine host, written by the host
+ */
+enum class HostState : std::uint32_t
+{
+    Starting,
+    Running,
+    Failed,     ///< Startup failed; EngineHostShared::error says why
+    Stopped
+};
+
+/**
+ * @struct EngineHostShared
+ * @brief Everything the addon and the engine host exchange
+ *
+ * The addon creates the object in a fresh shared memory mapping before it
+ * spawns the host; the host maps the same object and checks magic and
+ * version. Every member is either written once before the state turns
+ * Running, or is a single-producer single-consumer structure:
+ *
+ *   commands          addon JS thread -> host control thread
+ *   parameterWords    addon forwarder thread -> audio thread (ParameterBlock)
+ *   clock, telemetry,
+ *   waveform          host control thread -> addon JS thread
+ *   sampleFrames      hand-off area for sample loads, owned by whichever side
+ *                     sampleBusy says
+ *
+ * Only lock-free atomics cross the process boundary, so no side ever waits
+ * on a lock the other may hold when it dies.
+ */
+struct EngineHostShared
+{
+    static constexpr std::uint32_t kMagic = 0x41454831U;   ///< "AEH1"
+    static constexpr std::uint32_t kVersion = 5;           ///< Bumped whenever this layout or EngineTelemetry changes
+    static constexpr std::size_t kCommandCapacity = 256;
+    static constexpr std::size_t kSampleCapacity = 1U << 22;   ///< Floats in the sample area (~95 s at 44.1 kHz)
+    static constexpr std::size_t kMidiNameBytes = 64;
+    static constexpr std::size_t kErrorBytes = 256;
+
+    static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t), "Atomics must be plain cells");
+
+    EngineHostShared(float rate, unsigned int frames, bool duplex, const EffectPool::Limits& poolLimits)
+        : magic(kMagic)
+        , version(kVersion)
+        , sampleRate(rate)
+        , bufferFrames(frames)
+        , fullDuplexRequested(duplex ? 1U : 0U)
+        , effectPoolLimits(poolLimits)
+        , state(static_cast<std::uint32_t>(HostState::Starting))
+        , heartbeat(0U)
+        , fullDuplex(0U)
+        , midiConnected(0U)
+        , masterLatencyFrames(0U)
+        , lowPassCutoffHz(0.0f)
+        , replySequence(0U)
+        , replyValue(0U)
+        , sampleBusy(0U)
+        , clock(rate)
+    {
+    }
+
+    EngineHostShared(const EngineHostShared&) = delete;
+    EngineHostShared& operator=(const EngineHostShared&) = delete;
+
+    /// True when the mapping holds a layout this build understands
+    bool compatible() const { return magic == kMagic && version == kVersion; }
+
+    // Written by the addon before the host starts
+    const std::uint32_t magic;
+    const std::uint32_t version;
+    const float sampleRate;
+    const std::uint32_t bufferFrames;
+    const std::uint32_t fullDuplexRequested;
+    const EffectPool::Limits effectPoolLimits;         ///< Instances the host's effect pool builds per type
+
+    // Written by the host
+    std::atomic<std::uint32_t> state;                  ///< HostState
+    std::atomic<std::uint64_t> heartbeat;              ///< Incremented every control poll
+    std::atomic<std::uint32_t> fullDuplex;             ///< Input stream opened
+    std::atomic<std::uint32_t> midiConnected;
+    char midiName[kMidiNameBytes] = {};                ///< Valid once state is Running
+    char error[kErrorBytes] = {};                      ///< Valid once state is Failed, or after a failed Start
+    std::atomic<std::uint32_t> masterLatencyFrames;
+    std::atomic<float> lowPassCutoffHz;                ///< AudioSystem::getLowPassCutoff()
+    std::atomic<std::uint32_t> replySequence;          ///< Sequence of the last query answered
+    std::atomic<std::uint32_t> replyValue;             ///< Its result, valid once replySequence matches
+
+    // Sample loads: the addon fills sampleFrames while sampleBusy is 0, sets it
+    // and posts the load command; the host clears it once it has copied the data
+    std::atomic<std::uint32_t> sampleBusy;
+
+    std::uint32_t parameterWords[ParameterBlock::kWords] = {};
+    AudioClock clock;
+    TripleBuffer<EngineTelemetry> telemetry;
+    TripleBuffer<WaveformSnapshot> waveform;
+    CommandQueue<HostCommand, kCommandCapacity> commands;
+    float sampleFrames[kSampleCapacity];
+};
@@ -0,0 +1,141 @@
+#include "SharedMemory.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    std::runtime_error systemError(const std::string& what, const std::string& name) {
+        return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+    }
+
+    void* mapDescriptor(int descriptor, std::size_t bytes, const std::string& name) {
+        void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (data == MAP_FAILED) {
+            const std::runtime_error error = systemError("Cannot map shared memory", name);
+            ::close(descriptor);
+            throw error;
+        }
+        // The mapping keeps the object alive; the descriptor is no longer needed
+        ::close(descriptor);
+        return data;
+    }
+}
+
+SharedMemory SharedMemory::create(const std::string& name, std::size_t bytes)
+{
+    const int descriptor = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (descriptor < 0)
+    {
+        throw systemError("Cannot create shared memory", name);
+    }
+    if (::ftruncate(descriptor, static_cast<off_t>(bytes)) != 0)
+    {
+        const std::runtime_error error = systemError("Cannot size shared memory", name);
+        ::close(descriptor);
+        ::shm_unlink(name.c_str());
+        throw error;
+    }
+
+    try
+    {
+        return SharedMemory(name, mapDescriptor(descriptor, bytes, name), bytes, true);
+    }
+    catch (...)
+    {
+        ::shm_unlink(name.c_str());
+        throw;
+    }
+}
+
+SharedMemory SharedMemory::open(const std::string& name)
+{
+    const int descriptor = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (descriptor < 0)
+    {
+        throw systemError("Cannot open shared memory", name);
+    }
+
+    struct stat info;
+    if (::fstat(descriptor, &info) != 0 || info.st_size <= 0)
+    {
+        const std::runtime_error error = systemError("Cannot size shared memory", name);
+        ::close(descriptor);
+        throw error;
+    }
+
+    const std::size_t bytes = static_cast<std::size_t>(info.st_size);
+    return SharedMemory(name, mapDescriptor(descriptor, bytes, name), bytes, false);
+}
+
+SharedMemory::SharedMemory()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_owner(false)
+{
+}
+
+SharedMemory::SharedMemory(std::string name, void* data, std::size_t size, bool owner)
+    : m_name(std::move(name))
+    , m_data(data)
+    , m_size(size)
+    , m_owner(owner)
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+    release();
+}
+
+SharedMemory::SharedMemory(SharedMemory&& other) noexcept
+    : m_name(std::move(other.m_name))
+    , m_data(other.m_data)
+    , m_size(other.m_size)
+    , m_owner(other.m_owner)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_owner = false;
+}
+
+SharedMemory& SharedMemory::operator=(SharedMemory&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_name = std::move(other.m_name);
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_owner = other.m_owner;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_owner = false;
+    }
+    return *this;
+}
+
+void SharedMemory::unlink()
+{
+    if (m_owner)
+    {
+        ::shm_unlink(m_name.c_str());
+        m_owner = false;
+    }
+}
+
+void SharedMemory::release()
+{
+    if (m_data != nullptr)
+    {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    unlink();
+}
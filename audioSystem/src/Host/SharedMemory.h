@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @file SharedMemory.h
+ * @brief Named POSIX shared memory mapping
+ */
+
+/**
+ * @class SharedMemory
+ * @brief Owns one mapping of a named POSIX shared memory object
+ *
+ * The creator sizes the object and may unlink its name once every other
+ * process has opened it; the mapping itself stays valid until it is
+ * destroyed. Failures throw std::runtime_error.
+ */
+class SharedMemory
+{
+public:
+    /**
+     * @brief Create a new, zero-filled object (fails if the name exists)
+     * @param name Object name, starting with '/'
+     * @param bytes Object size
+     */
+    static SharedMemory create(const std::string& name, std::size_t bytes);
+
+    /**
+     * @brief Map an existing object at its current size
+     * @param name Object name, starting with '/'
+     */
+    static SharedMemory open(const std::string& name);
+
+    SharedMemory();
+    ~SharedMemory();
+
+    SharedMemory(SharedMemory&& other) noexcept;
+    SharedMemory& operator=(SharedMemory&& other) noexcept;
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    /**
+     * @brief Remove the name so no other process can open it; the mapping stays valid
+     */
+    void unlink();
+
+    void* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    const std::string& name() const { return m_name; }
+
+private:
+    SharedMemory(std::string name, void* data, std::size_t size, bool owner);
+
+    void release();
+
+    std::string m_name;
+    void* m_data;
+    std::size_t m_size;
+    bool m_owner;   ///< Created the object, so unlinks it if still named
+};
@@ -2,6 +2,7 @@
 #include "MidiEvent.h"
 #include <iostream>
 #include "notes.h"
+#include "Trace.h"
 
 // Constructor with port selection
 MidiDevice::MidiDevice(int portNumber) : isInitialized(false) {
@@ -90,6 +91,8 @@ bool MidiDevice::changePort(unsigned int portNumber) {
 // Static callback function for MIDI messages
 void MidiDevice::midiCallback(double timeStamp, std::vector<unsigned char>* message, void* userData) {
     (void)timeStamp;
+    TRACE_THREAD_NAME("midi");
+    TRACE_ZONE("midiMessage");
     
     if (message->empty()) return;
 
@@ -0,0 +1,1118 @@
+/**
+ * @file test_engine.cpp
+ * @brief Tests for the engine's lock-free hand-offs, effect slots, DSP and control paths
+ *
+ * Covers what the benchmarks only measure: that the command queue and the
+ * triple buffer stay correct under contention, that effect slots crossfade,
+ * keep warm and fall back to stereo as documented, that spectral frames
+ * computed on the worker match inline processing, that the limiter and the
+ * sample converter keep their ceilings, that the control socket rejects
+ * malformed frames and that the engine host reports startup failures.
+ *
+ * Build with -DBUILD_TESTS=ON and run test_engine, or ctest. Configure with
+ * -DENABLE_TSAN=ON (or ./build.sh --tsan) to run the contention tests under
+ * ThreadSanitizer. Exits non-zero if any test fails.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Core/CommandQueue.h"
+#include "Core/TripleBuffer.h"
+#include "Core/ParameterBlock.h"
+#include "Core/audioSystem.h"
+#include "Effects/EffectSlot.h"
+#include "Effects/LowPassEffect.h"
+#include "Effects/SpectralEffect.h"
+#include "Dsp/Dynamics.h"
+#include "Dsp/SampleConverter.h"
+#include "Control/ControlProtocol.h"
+#include "Control/ControlServer.h"
+#include "Host/EngineHost.h"
+#include "Host/EngineHostClient.h"
+#include "Host/EngineHostProtocol.h"
+#include "Host/SharedMemory.h"
+
+// ANSI color codes for the report
+namespace Colors {
+    const std::string RESET = "\033[0m";
+    const std::string RED = "\033[31m";
+    const std::string GREEN = "\033[32m";
+    const std::string YELLOW = "\033[33m";
+    const std::string BLUE = "\033[34m";
+    const std::string MAGENTA = "\033[35m";
+    const std::string CYAN = "\033[36m";
+    const std::string WHITE = "\033[37m";
+    const std::string BOLD = "\033[1m";
+    const std::string DIM = "\033[2m";
+}
+
+// Test result tracking
+struct TestResult {
+    std::string testName;
+    bool passed;
+    std::string details;
+    std::chrono::milliseconds duration;
+};
+
+class TestFramework {
+private:
+    std::vector<TestResult> results;
+    int totalTests = 0;
+    int passedTests = 0;
+
+public:
+    void runTest(const std::string& testName, std::function<bool()> testFunc) {
+        std::cout << Colors::BLUE << "┌─ Running: " << Colors::BOLD << testName << Colors::RESET << std::endl;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        bool result = false;
+        std::string details = "";
+
+        try {
+            result = testFunc();
+        } catch (const std::exception& e) {
+            details = std::string("Exception: ") + e.what();
+        } catch (...) {
+            details = "Unknown exception occurred";
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+        totalTests++;
+        if (result) {
+            passedTests++;
+            std::cout << Colors::GREEN << "└─ ✓ PASSED" << Colors::DIM << " (" << duration.count() << "ms)" << Colors::RESET << std::endl;
+        } else {
+            std::cout << Colors::RED << "└─ ✗ FAILED" << Colors::DIM << " (" << duration.count() << "ms)";
+            if (!details.empty()) {
+                std::cout << " - " << details;
+            }
+            std::cout << Colors::RESET << std::endl;
+        }
+        std::cout << std::endl;
+
+        results.push_back({testName, result, details, duration});
+    }
+
+    bool allPassed() const { return passedTests == totalTests; }
+
+    void printSummary() {
+        std::cout << Colors::BOLD << Colors::CYAN << "═══════════════════════════════════════════════════════════════" << Colors::RESET << std::endl;
+        std::cout << Colors::BOLD << Colors::WHITE << "                        TEST SUMMARY                           " << Colors::RESET << std::endl;
+        std::cout << Colors::BOLD << Colors::CYAN << "═══════════════════════════════════════════════════════════════" << Colors::RESET << std::endl;
+
+        double successRate = totalTests > 0 ? (double)passedTests / totalTests * 100.0 : 0.0;
+
+        std::cout << Colors::WHITE << "Total Tests: " << Colors::BOLD << totalTests << Colors::RESET << std::endl;
+        std::cout << Colors::GREEN << "Passed:      " << Colors::BOLD << passedTests << Colors::RESET << std::endl;
+        std::cout << Colors::RED << "Failed:      " << Colors::BOLD << (totalTests - passedTests) << Colors::RESET << std::endl;
+        std::cout << Colors::YELLOW << "Success Rate:" << Colors::BOLD << std::fixed << std::setprecision(1) << successRate << "%" << Colors::RESET << std::endl;
+
+        std::cout << std::endl;
+
+        // Show failed tests if any
+        bool hasFailures = false;
+        for (const auto& result : results) {
+            if (!result.passed) {
+                if (!hasFailures) {
+                    std::cout << Colors::RED << Colors::BOLD << "Failed Tests:" << Colors::RESET << std::endl;
+                    hasFailures = true;
+                }
+                std::cout << Colors::RED << "  ✗ " << result.testName;
+                if (!result.details.empty()) {
+                    std::cout << " - " << result.details;
+                }
+                std::cout << Colors::RESET << std::endl;
+            }
+        }
+
+        if (hasFailures) {
+            std::cout << std::endl;
+        }
+
+        std::cout << Colors::BOLD << Colors::CYAN << "═══════════════════════════════════════════════════════════════" << Colors::RESET << std::endl;
+
+        if (allPassed()) {
+            std::cout << Colors::GREEN << Colors::BOLD << "🎉 ALL TESTS PASSED! 🎉" << Colors::RESET << std::endl;
+        } else {
+            std::cout << Colors::YELLOW << Colors::BOLD << "⚠️  SOME TESTS FAILED ⚠️" << Colors::RESET << std::endl;
+        }
+
+        std::cout << Colors::BOLD << Colors::CYAN << "═══════════════════════════════════════════════════════════════" << Colors::RESET << std::endl;
+    }
+};
+
+// Print why a check failed; tests return its result
+bool fail(const std::string& message) {
+    std::cout << Colors::RED << "│  " << message << Colors::RESET << std::endl;
+    return false;
+}
+
+bool near(float value, float expected, float tolerance) {
+    return std::fabs(value - expected) <= tolerance;
+}
+
+// Test effect: triples its input and counts calls and resets
+class ProbeEffect : public IEffect {
+public:
+    std::pair<float, float> process(std::pair<float, float> stereoSample) override {
+        calls++;
+        return {3.0f * stereoSample.first, 3.0f * stereoSample.second};
+    }
+
+    void reset() override { resets++; }
+    const char* name() const override { return "probe"; }
+    std::size_t memoryBytes() const override { return 0; }
+
+    int calls = 0;
+    int resets = 0;
+};
+
+// Test effect: passes every spectrum through, optionally slowly
+class IdentitySpectralEffect : public SpectralEffect {
+public:
+    IdentitySpectralEffect(std::size_t frameSize, bool background, int frameDelayMicros = 0)
+        : SpectralEffect(frameSize, 48000.0f, background)
+        , frameDelay(frameDelayMicros) {}
+
+    ~IdentitySpectralEffect() override { stopWorker(); }
+
+    bool busy() const { return frameInFlight(); }
+    const char* name() const override { return "identity"; }
+    std::size_t memoryBytes() const override { return spectralBufferBytes(); }
+
+protected:
+    void processSpectrum(std::size_t, float*) override {
+        if (frameDelay > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(frameDelay));
+        }
+    }
+
+private:
+    int frameDelay;
+};
+
+// ============================================================================
+// Lock-free hand-offs
+// ============================================================================
+
+bool testCommandQueueContention() {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr std::uint64_t kPerProducer = 100000;
+
+    // Small, so producers keep finding it full
+    CommandQueue<std::uint64_t, 64> queue;
+    std::atomic<std::uint64_t> failedPushes{0};
+    std::atomic<std::uint64_t> popped{0};
+    std::vector<std::vector<std::uint64_t>> received(kConsumers);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; p++) {
+        threads.emplace_back([&, p]() {
+            std::uint64_t failures = 0;
+            for (std::uint64_t i = 0; i < kPerProducer; i++) {
+                const std::uint64_t value = (static_cast<std::uint64_t>(p) << 32) | i;
+                while (!queue.tryPush(value)) {
+                    failures++;
+                    std::this_thread::yield();
+                }
+            }
+            failedPushes += failures;
+        });
+    }
+    for (int c = 0; c < kConsumers; c++) {
+        threads.emplace_back([&, c]() {
+            std::uint64_t value = 0;
+            while (popped.load() < kProducers * kPerProducer) {
+                if (queue.tryPop(value)) {
+                    received[c].push_back(value);
+                    popped++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // Every value exactly once, and each consumer sees each producer in order
+    std::vector<std::vector<bool>> seen(kProducers, std::vector<bool>(kPerProducer, false));
+    for (const auto& values : received) {
+        std::vector<std::int64_t> last(kProducers, -1);
+        for (std::uint64_t value : values) {
+            const std::size_t producer = static_cast<std::size_t>(value >> 32);
+            const std::uint64_t index = value & 0xFFFFFFFFU;
+            if (producer >= kProducers || index >= kPerProducer || seen[producer][index]) {
+                return fail("value lost, duplicated or corrupted: " + std::to_string(value));
+            }
+            if (static_cast<std::int64_t>(index) <= last[producer]) {
+                return fail("producer " + std::to_string(producer) + " reordered");
+            }
+            seen[producer][index] = true;
+            last[producer] = static_cast<std::int64_t>(index);
+        }
+    }
+    if (popped.load() != kProducers * kPerProducer) {
+        return fail("popped " + std::to_string(popped.load()) + " values");
+    }
+
+    if (queue.rejectedCount() != failedPushes.load()) {
+        return fail("rejectedCount " + std::to_string(queue.rejectedCount()) + " != failed pushes " +
+                    std::to_string(failedPushes.load()));
+    }
+    if (queue.sizeApprox() != 0) {
+        return fail("queue not empty after draining");
+    }
+
+    // A rejected push leaves a move-only value with the caller
+    CommandQueue<std::unique_ptr<int>, 2> small;
+    small.tryPush(std::unique_ptr<int>(new int(1)));
+    small.tryPush(std::unique_ptr<int>(new int(2)));
+    std::unique_ptr<int> extra(new int(3));
+    if (small.tryPush(std::move(extra)) || !extra || *extra != 3) {
+        return fail("rejected push consumed its value");
+    }
+    std::unique_ptr<int> out;
+    if (!small.tryPop(out) || !out || *out != 1) {
+        return fail("move-only values not popped in order");
+    }
+
+    return true;
+}
+
+bool testTripleBufferContention() {
+    struct Snapshot {
+        std::uint64_t sequence;
+        std::uint64_t words[15];
+    };
+    constexpr std::uint64_t kWrites = 500000;
+
+    TripleBuffer<Snapshot> buffer;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]() {
+        for (std::uint64_t s = 1; s <= kWrites; s++) {
+            Snapshot& slot = buffer.back();
+            slot.sequence = s;
+            for (std::uint64_t i = 0; i < 15; i++) {
+                slot.words[i] = s * 31 + i;
+            }
+            buffer.publish();
+        }
+        done = true;
+    });
+
+    std::uint64_t last = 0;
+    std::uint64_t distinct = 0;
+    bool ok = true;
+    std::string problem;
+    for (;;) {
+        const bool finished = done.load();
+        const Snapshot& snapshot = buffer.read();
+        if (snapshot.sequence < last) {
+            ok = false;
+            problem = "went back from " + std::to_string(last) + " to " + std::to_string(snapshot.sequence);
+            break;
+        }
+        for (std::uint64_t i = 0; snapshot.sequence != 0 && i < 15; i++) {
+            if (snapshot.words[i] != snapshot.sequence * 31 + i) {
+                ok = false;
+                problem = "torn value at sequence " + std::to_string(snapshot.sequence);
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        if (snapshot.sequence != last) {
+            distinct++;
+            last = snapshot.sequence;
+        }
+        // Once the writer is done, the next read must be its final value
+        if (finished) {
+            break;
+        }
+    }
+    writer.join();
+
+    if (!ok) {
+        return fail(problem);
+    }
+    if (last != kWrites) {
+        return fail("reader ended on " + std::to_string(last) + " instead of the last value");
+    }
+    if (distinct < 2) {
+        return fail("reader never saw an intermediate value");
+    }
+    return true;
+}
+
+// ============================================================================
+// Effect slots
+// ============================================================================
+
+bool testEffectSlotCrossfade() {
+    auto probe = std::make_shared<ProbeEffect>();
+    EffectSlot slot(probe, 1000.0f);
+    slot.setCrossfadeTime(0.01f, 1000.0f);   // 10 frames
+
+    if (!near(slot.process({1.0f, 1.0f}).first, 3.0f, 1e-6f)) {
+        return fail("active slot does not play the effect");
+    }
+
+    // Wet level falls by a tenth per frame: output = 1 + 2 * wet
+    slot.setBypassed(true);
+    for (int k = 1; k <= 10; k++) {
+        const auto out = slot.process({1.0f, 1.0f});
+        const float expected = 1.0f + 2.0f * (1.0f - k / 10.0f);
+        if (!near(out.first, expected, 1e-5f) || !near(out.second, expected, 1e-5f)) {
+            return fail("fade out frame " + std::to_string(k) + ": " + std::to_string(out.first));
+        }
+    }
+
+    // Settled and cold: the input passes and the effect is not called
+    const int callsBefore = probe->calls;
+    for (int k = 0; k < 50; k++) {
+        if (slot.process({0.5f, -0.5f}) != std::make_pair(0.5f, -0.5f)) {
+            return fail("bypassed slot altered the input");
+        }
+    }
+    if (probe->calls != callsBefore) {
+        return fail("cold bypassed effect was processed");
+    }
+
+    // Coming back from silence resets the stale effect once, then fades in
+    slot.setBypassed(false);
+    for (int k = 1; k <= 10; k++) {
+        const float out = slot.process({1.0f, 1.0f}).first;
+        if (!near(out, 1.0f + 2.0f * (k / 10.0f), 1e-5f)) {
+            return fail("fade in frame " + std::to_string(k) + ": " + std::to_string(out));
+        }
+    }
+    if (probe->resets != 1) {
+        return fail("stale effect reset " + std::to_string(probe->resets) + " times");
+    }
+
+    // Reversing mid-fade continues from the current level without a reset
+    slot.setBypassed(true);
+    for (int k = 0; k < 4; k++) {
+        slot.process({1.0f, 1.0f});
+    }
+    slot.setBypassed(false);
+    const float resumed[] = {1.0f + 2.0f * 0.7f, 1.0f + 2.0f * 0.8f, 1.0f + 2.0f * 0.9f, 3.0f};
+    for (float expected : resumed) {
+        const float out = slot.process({1.0f, 1.0f}).first;
+        if (!near(out, expected, 1e-5f)) {
+            return fail("reversed fade: " + std::to_string(out) + " instead of " + std::to_string(expected));
+        }
+    }
+    if (probe->resets != 1) {
+        return fail("reversing a fade reset the effect");
+    }
+
+    // The block path matches the per-frame path through a fade
+    auto probeA = std::make_shared<ProbeEffect>();
+    auto probeB = std::make_shared<ProbeEffect>();
+    EffectSlot perFrame(probeA, 1000.0f);
+    EffectSlot block(probeB, 1000.0f);
+    perFrame.setBypassed(true);
+    block.setBypassed(true);
+    std::vector<float> left(32), right(32);
+    for (int i = 0; i < 32; i++) {
+        left[i] = 0.01f * i;
+        right[i] = -0.02f * i;
+    }
+    std::vector<float> blockLeft(left), blockRight(right);
+    block.processBlock(blockLeft.data(), blockRight.data(), 32);
+    for (int i = 0; i < 32; i++) {
+        const auto out = perFrame.process({left[i], right[i]});
+        if (out.first != blockLeft[i] || out.second != blockRight[i]) {
+            return fail("processBlock differs from process at frame " + std::to_string(i));
+        }
+    }
+
+    return true;
+}
+
+bool testEffectSlotKeepWarm() {
+    auto probe = std::make_shared<ProbeEffect>();
+    EffectSlot slot(probe, 1000.0f);
+    slot.setCrossfadeTime(0.01f, 1000.0f);
+    slot.setKeepWarm(true);
+    if (!slot.keepsWarm()) {
+        return fail("keepsWarm() not reported");
+    }
+
+    slot.setBypassed(true);
+    for (int k = 0; k < 10; k++) {
+        slot.process({1.0f, 1.0f});
+    }
+
+    // Warm: the effect runs on every bypassed frame and its output is dropped
+    const int callsBefore = probe->calls;
+    for (int k = 0; k < 100; k++) {
+        if (slot.process({0.25f, 0.25f}).first != 0.25f) {
+            return fail("warm bypassed slot leaked the effect output");
+        }
+    }
+    if (probe->calls != callsBefore + 100) {
+        return fail("warm effect processed " + std::to_string(probe->calls - callsBefore) + " of 100 frames");
+    }
+
+    slot.setBypassed(false);
+    for (int k = 0; k < 10; k++) {
+        slot.process({1.0f, 1.0f});
+    }
+    if (probe->resets != 0) {
+        return fail("warm effect was reset on return");
+    }
+
+    // Shedding does not keep warm, so the effect is stale and resets on return
+    slot.setShed(1);
+    for (int k = 0; k < 10; k++) {
+        slot.process({1.0f, 1.0f});
+    }
+    const int callsShed = probe->calls;
+    for (int k = 0; k < 20; k++) {
+        slot.process({1.0f, 1.0f});
+    }
+    if (probe->calls != callsShed) {
+        return fail("shed effect kept processing");
+    }
+    slot.setShed(0);
+    slot.process({1.0f, 1.0f});
+    if (probe->resets != 1) {
+        return fail("shed effect not reset on return");
+    }
+
+    return true;
+}
+
+bool testEffectSlotStereoFallback() {
+    auto filter = std::make_shared<LowPassEffect>(800.0f, 48000.0f, 0.7f, 1.0f);
+    EffectSlot slot(filter, 48000.0f);
+
+    if (!slot.canProcessMono()) {
+        return fail("fresh filter refused mono");
+    }
+
+    // Different channels leave different states: the chain must stay stereo
+    for (int i = 0; i < 64; i++) {
+        const float x = std::sin(0.05f * i);
+        slot.process({x, -x});
+    }
+    if (slot.canProcessMono()) {
+        return fail("mono allowed with diverged channel states");
+    }
+    slot.reset();
+    if (!slot.canProcessMono()) {
+        return fail("mono refused after reset");
+    }
+
+    // A cold bypassed effect is stale and resets before it is heard, so it qualifies
+    for (int i = 0; i < 64; i++) {
+        slot.process({0.5f, -0.5f});
+    }
+    slot.setBypassed(true);
+    for (int i = 0; i < 1000; i++) {
+        slot.process({0.5f, -0.5f});
+    }
+    if (!slot.canProcessMono()) {
+        return fail("stale bypassed effect refused mono");
+    }
+    slot.setBypassed(false);
+    slot.process({0.0f, 0.0f});
+    if (!filter->channelsMatch()) {
+        return fail("stale effect not reset on return");
+    }
+
+    // Leaving mono copies the mono state to both channels
+    auto reference = std::make_shared<LowPassEffect>(800.0f, 48000.0f, 0.7f, 1.0f);
+    auto monoFilter = std::make_shared<LowPassEffect>(800.0f, 48000.0f, 0.7f, 1.0f);
+    EffectSlot monoSlot(monoFilter, 48000.0f);
+    monoSlot.setMono(true);
+    for (int i = 0; i < 200; i++) {
+        const float x = std::sin(0.03f * i);
+        const float out = monoSlot.processMono(x);
+        if (out != reference->process({x, x}).first) {
+            return fail("mono path differs from stereo at sample " + std::to_string(i));
+        }
+    }
+    monoSlot.setMono(false);
+    for (int i = 0; i < 200; i++) {
+        const float x = std::cos(0.07f * i);
+        const auto out = monoSlot.process({x, x});
+        const auto expected = reference->process({x, x});
+        if (out.first != expected.first || out.second != expected.second) {
+            return fail("split state differs from stereo at sample " + std::to_string(i));
+        }
+    }
+
+    return true;
+}
+
+// ============================================================================
+// DSP
+// ============================================================================
+
+bool testSpectralWorkerHandOff() {
+    constexpr std::size_t kFrameSize = 1024;
+    IdentitySpectralEffect inlineEffect(kFrameSize, false);
+    IdentitySpectralEffect workerEffect(kFrameSize, true);
+
+    if (inlineEffect.backgroundProcessing() || !workerEffect.backgroundProcessing()) {
+        return fail("background processing not as requested");
+    }
+    const std::size_t hop = workerEffect.hopSize();
+    if (workerEffect.latencySamples() != inlineEffect.latencySamples() + hop) {
+        return fail("worker latency is not one hop more than inline");
+    }
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    const std::size_t length = kFrameSize + 64 * hop;
+    std::vector<float> inputLeft(length), inputRight(length);
+    std::vector<std::pair<float, float>> inlineOut(length), workerOut(length);
+    for (std::size_t i = 0; i < length; i++) {
+        inputLeft[i] = noise(random);
+        inputRight[i] = noise(random);
+    }
+
+    for (std::size_t i = 0; i < length; i++) {
+        inlineOut[i] = inlineEffect.process({inputLeft[i], inputRight[i]});
+        // Give the worker the time a device buffer would, so no hop finds it busy
+        while (workerEffect.busy()) {
+            std::this_thread::yield();
+        }
+        workerOut[i] = workerEffect.process({inputLeft[i], inputRight[i]});
+    }
+
+    if (workerEffect.lateFrames() != 0) {
+        return fail(std::to_string(workerEffect.lateFrames()) + " frames late with a paced worker");
+    }
+
+    // Frames from the worker land one hop after the same frames inline
+    for (std::size_t i = hop; i < length; i++) {
+        if (!near(workerOut[i].first, inlineOut[i - hop].first, 1e-6f) ||
+            !near(workerOut[i].second, inlineOut[i - hop].second, 1e-6f)) {
+            return fail("worker output differs from inline at sample " + std::to_string(i));
+        }
+    }
+
+    // An identity spectrum reconstructs the input after the latency
+    const std::size_t latency = inlineEffect.latencySamples();
+    for (std::size_t i = latency + kFrameSize; i < length; i++) {
+        if (!near(inlineOut[i].first, inputLeft[i - latency], 1e-4f) ||
+            !near(inlineOut[i].second, inputRight[i - latency], 1e-4f)) {
+            return fail("identity spectrum did not reconstruct sample " + std::to_string(i - latency));
+        }
+    }
+
+    // A worker that cannot keep up drops frames and counts them
+    IdentitySpectralEffect slowEffect(256, true, 2000);
+    for (std::size_t i = 0; i < 40 * slowEffect.hopSize(); i++) {
+        const auto out = slowEffect.process({inputLeft[i], inputRight[i]});
+        if (!std::isfinite(out.first) || !std::isfinite(out.second)) {
+            return fail("late frames produced non-finite output");
+        }
+    }
+    if (slowEffect.lateFrames() == 0) {
+        return fail("late frames not counted");
+    }
+
+    return true;
+}
+
+bool testLimiterCeiling() {
+    constexpr float kRate = 48000.0f;
+    constexpr std::size_t kBlock = 256;
+    const float ceiling = std::pow(10.0f, -3.0f / 20.0f);
+
+    for (int truePeak = 0; truePeak < 2; truePeak++) {
+        LookaheadLimiter limiter(kRate);
+        limiter.setCeiling(-3.0f);
+        limiter.setTruePeak(truePeak != 0);
+
+        // 997 Hz at +6 dBFS
+        std::vector<float> block(2 * kBlock);
+        float worst = 0.0f;
+        float reduction = 0.0f;
+        std::size_t frame = 0;
+        for (int b = 0; b < 100; b++) {
+            for (std::size_t i = 0; i < kBlock; i++, frame++) {
+                const float x = 2.0f * std::sin(2.0f * 3.14159265f * 997.0f * frame / kRate);
+                block[2 * i] = x;
+                block[2 * i + 1] = -x;
+            }
+            limiter.process(block.data(), kBlock);
+            reduction = std::max(reduction, limiter.gainReductionDb());
+            for (float sample : block) {
+                worst = std::max(worst, std::fabs(sample));
+            }
+        }
+
+        if (worst > ceiling * 1.0001f) {
+            return fail("peak " + std::to_string(worst) + " above the ceiling " + std::to_string(ceiling));
+        }
+        if (worst < ceiling * 0.9f) {
+            return fail("limiter pulled the signal far below the ceiling: " + std::to_string(worst));
+        }
+        if (reduction < 8.0f) {
+            return fail("gain reduction " + std::to_string(reduction) + " dB reported for a 9 dB overshoot");
+        }
+    }
+
+    return true;
+}
+
+bool testLimiterLookahead() {
+    constexpr float kRate = 48000.0f;
+    constexpr std::size_t kStep = 2000;
+    constexpr std::size_t kFrames = 4000;
+    const float ceiling = std::pow(10.0f, -1.0f / 20.0f);
+
+    LookaheadLimiter limiter(kRate, 0.0015f);
+    limiter.setCeiling(-1.0f);
+    const std::size_t latency = limiter.latencyFrames();
+    if (latency == 0 || latency > kStep / 2) {
+        return fail("unexpected latency " + std::to_string(latency));
+    }
+
+    // Quiet level, then a jump well over the ceiling
+    std::vector<float> signal(2 * kFrames);
+    for (std::size_t i = 0; i < kFrames; i++) {
+        signal[2 * i] = signal[2 * i + 1] = (i < kStep) ? 0.25f : 2.0f;
+    }
+    for (std::size_t offset = 0; offset < kFrames; offset += 100) {
+        limiter.process(signal.data() + 2 * offset, 100);
+    }
+
+    for (std::size_t i = 0; i < latency; i++) {
+        if (signal[2 * i] != 0.0f) {
+            return fail("output before the latency is not silent");
+        }
+    }
+    // Well before the jump the quiet level passes untouched, delayed by the latency
+    for (std::size_t i = latency; i < kStep + latency - 4 * latency; i++) {
+        if (!near(signal[2 * i], 0.25f, 1e-6f)) {
+            return fail("quiet frame " + std::to_string(i) + " changed to " + std::to_string(signal[2 * i]));
+        }
+    }
+    // The gain is already down when the jump comes out of the delay line
+    const float beforeJump = signal[2 * (kStep + latency - 1)];
+    if (beforeJump >= 0.25f * 0.5f) {
+        return fail("gain ramp did not start ahead of the peak: " + std::to_string(beforeJump));
+    }
+    for (std::size_t i = kStep + latency - 4 * latency; i < kStep + latency - 1; i++) {
+        if (signal[2 * (i + 1)] > signal[2 * i] + 1e-7f) {
+            return fail("gain ramp ahead of the peak is not monotonic at frame " + std::to_string(i));
+        }
+    }
+    for (std::size_t i = 0; i < 2 * kFrames; i++) {
+        if (std::fabs(signal[i]) > ceiling * 1.0001f) {
+            return fail("sample " + std::to_string(i / 2) + " above the ceiling: " + std::to_string(signal[i]));
+        }
+    }
+
+    return true;
+}
+
+bool testSampleConverterClipping() {
+    const float input[] = {1.5f, -1.5f, 1.0f, -1.0f, 0.5f, -0.5f, 0.0f, 100.4f / 32768.0f};
+
+    SampleConverter int16(SampleFormat::Int16, false);
+    std::int16_t codes16[8];
+    int16.fromFloat(input, codes16, 4);
+    const std::int16_t expected16[] = {32767, -32768, 32767, -32768, 16384, -16384, 0, 100};
+    for (int i = 0; i < 8; i++) {
+        if (codes16[i] != expected16[i]) {
+            return fail("s16 sample " + std::to_string(i) + " = " + std::to_string(codes16[i]));
+        }
+    }
+
+    // 24-bit samples are packed little endian in 3 bytes
+    SampleConverter int24(SampleFormat::Int24, false);
+    const float input24[] = {2.0f, -2.0f, 0.5f, -1.0f};
+    std::uint8_t bytes24[12];
+    int24.fromFloat(input24, bytes24, 2);
+    const std::uint8_t expected24[] = {0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x80, 0x00, 0x00, 0x40, 0x00, 0x00, 0x80};
+    if (std::memcmp(bytes24, expected24, sizeof(expected24)) != 0) {
+        return fail("s24 packing or clipping wrong");
+    }
+
+    // 32-bit clips instead of wrapping
+    SampleConverter int32(SampleFormat::Int32, false);
+    std::int32_t codes32[4];
+    const float input32[] = {1.5f, -1.5f, 1.0f, -1.0f};
+    int32.fromFloat(input32, codes32, 2);
+    if (codes32[0] <= 0 || codes32[2] <= 0 || codes32[1] != std::numeric_limits<std::int32_t>::min() ||
+        codes32[3] != std::numeric_limits<std::int32_t>::min()) {
+        return fail("s32 wrapped around");
+    }
+
+    // Back to float
+    float back[8];
+    SampleConverter::toFloat(codes16, SampleFormat::Int16, back, 8);
+    if (back[3] != -1.0f || back[4] != 0.5f || back[6] != 0.0f || back[0] >= 1.0f) {
+        return fail("s16 to float out of [-1, 1)");
+    }
+
+    return true;
+}
+
+bool testSampleConverterDither() {
+    if (SampleConverter(SampleFormat::Int32, true).dithers() || SampleConverter(SampleFormat::Float32, true).dithers()) {
+        return fail("dither reported for a format that does not use it");
+    }
+
+    constexpr std::size_t kFrames = 20000;
+    const float level = 1000.3f / 32768.0f;
+    std::vector<float> input(2 * kFrames, level);
+    std::vector<std::int16_t> output(2 * kFrames);
+
+    SampleConverter plain(SampleFormat::Int16, false);
+    plain.fromFloat(input.data(), output.data(), kFrames);
+    for (std::int16_t code : output) {
+        if (code != 1000) {
+            return fail("undithered output " + std::to_string(code));
+        }
+    }
+
+    for (int shaping = 0; shaping < 2; shaping++) {
+        SampleConverter dithered(SampleFormat::Int16, true, shaping != 0);
+        if (!dithered.dithers()) {
+            return fail("s16 dither not enabled");
+        }
+        dithered.fromFloat(input.data(), output.data(), kFrames);
+
+        // TPDF spans +/-1 LSB before rounding; shaping adds the previous error
+        const int spread = shaping ? 3 : 2;
+        double sum = 0.0;
+        std::vector<bool> used(16, false);
+        for (std::int16_t code : output) {
+            if (code < 1000 - spread || code > 1000 + spread) {
+                return fail("dithered code " + std::to_string(code) + " too far from 1000.3");
+            }
+            used[code - 1000 + 8] = true;
+            sum += code;
+        }
+        const double mean = sum / output.size();
+        if (std::fabs(mean - 1000.3) > 0.05) {
+            return fail("dithered mean " + std::to_string(mean) + " is biased");
+        }
+        if (std::count(used.begin(), used.end(), true) < 3) {
+            return fail("dither did not spread the codes");
+        }
+
+        // Dither never pushes full scale past the clip points
+        const float loud[] = {1.5f, -1.5f, 1.0f, -1.0f};
+        std::int16_t clipped[4];
+        for (int k = 0; k < 1000; k++) {
+            dithered.fromFloat(loud, clipped, 2);
+            if (clipped[0] != 32767 || clipped[1] != -32768 || clipped[2] < 32766 || clipped[3] > -32767) {
+                return fail("dithered full scale wrapped or clipped wrong");
+            }
+        }
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Control socket and engine host
+// ============================================================================
+
+bool sendFrame(int fd, std::uint8_t type, std::uint8_t reserved, const void* payload, std::size_t length) {
+    std::vector<std::uint8_t> frame(sizeof(ControlFrameHeader) + length);
+    const ControlFrameHeader header{type, reserved, static_cast<std::uint16_t>(length)};
+    std::memcpy(frame.data(), &header, sizeof(header));
+    if (length > 0) {
+        std::memcpy(frame.data() + sizeof(header), payload, length);
+    }
+    return ::send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(frame.size());
+}
+
+bool receiveExactly(int fd, void* data, std::size_t length) {
+    std::uint8_t* bytes = static_cast<std::uint8_t*>(data);
+    while (length > 0) {
+        const ssize_t received = ::recv(fd, bytes, length, 0);
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        length -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+// Read one reply; false on timeout or a closed connection
+bool receiveFrame(int fd, ControlFrameHeader& header, std::vector<std::uint8_t>& payload) {
+    if (!receiveExactly(fd, &header, sizeof(header))) {
+        return false;
+    }
+    payload.resize(header.length);
+    return header.length == 0 || receiveExactly(fd, payload.data(), header.length);
+}
+
+bool expectError(int fd, ControlMessage request, ControlErrorCode code, const std::string& what) {
+    ControlFrameHeader header{};
+    std::vector<std::uint8_t> payload;
+    if (!receiveFrame(fd, header, payload)) {
+        return fail(what + ": no reply");
+    }
+    ControlError error{};
+    if (header.type != static_cast<std::uint8_t>(ControlMessage::Error) || payload.size() != sizeof(error)) {
+        return fail(what + ": reply type " + std::to_string(header.type));
+    }
+    std::memcpy(&error, payload.data(), sizeof(error));
+    if (error.request != static_cast<std::uint8_t>(request) || error.code != static_cast<std::uint8_t>(code)) {
+        return fail(what + ": error " + std::to_string(error.code) + " for request " + std::to_string(error.request));
+    }
+    return true;
+}
+
+int connectControl(const std::string& path) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    timeval timeout{2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool testControlDecodeRejection() {
+    const std::string path = "/tmp/test_engine_" + std::to_string(::getpid()) + ".sock";
+    AudioSystem audio(48000.0f);
+    std::array<std::uint32_t, ParameterBlock::kWords> words{};
+    ParameterBlock parameters(words.data());
+    audio.setParameterBlock(&parameters);
+
+    ControlServer server(path, "/nonexistent", audio, parameters);
+    server.start();
+
+    const int fd = connectControl(path);
+    if (fd < 0) {
+        server.Stop();
+        return fail("cannot connect to " + path);
+    }
+
+    const auto noteOn = static_cast<std::uint8_t>(ControlMessage::NoteOn);
+    const auto bend = static_cast<std::uint8_t>(ControlMessage::PitchBend);
+    const auto params = static_cast<std::uint8_t>(ControlMessage::Parameters);
+    const auto preset = static_cast<std::uint8_t>(ControlMessage::Preset);
+
+    ControlNoteEvent note{};
+    note.note = 60;
+    note.velocity = 100;
+
+    bool ok = true;
+    std::uint32_t rejected = 0;
+    auto check = [&](bool sent, ControlMessage request, ControlErrorCode code, const std::string& what) {
+        ok = ok && sent && expectError(fd, request, code, what);
+        rejected++;
+    };
+
+    check(sendFrame(fd, noteOn, 1, &note, sizeof(note)), ControlMessage::NoteOn, ControlErrorCode::BadValue,
+          "reserved header byte");
+    check(sendFrame(fd, noteOn, 0, &note, sizeof(note) - 1), ControlMessage::NoteOn, ControlErrorCode::BadLength,
+          "short note");
+
+    ControlNoteEvent badNote = note;
+    badNote.note = 128;
+    check(sendFrame(fd, noteOn, 0, &badNote, sizeof(badNote)), ControlMessage::NoteOn, ControlErrorCode::BadValue,
+          "note 128");
+    badNote = note;
+    badNote.channel = 16;
+    check(sendFrame(fd, noteOn, 0, &badNote, sizeof(badNote)), ControlMessage::NoteOn, ControlErrorCode::BadValue,
+          "channel 16");
+    badNote = note;
+    badNote.reserved[2] = 1;
+    check(sendFrame(fd, noteOn, 0, &badNote, sizeof(badNote)), ControlMessage::NoteOn, ControlErrorCode::BadValue,
+          "reserved note byte");
+
+    ControlPitchBend badBend{};
+    badBend.value = 8192;
+    check(sendFrame(fd, bend, 0, &badBend, sizeof(badBend)), ControlMessage::PitchBend, ControlErrorCode::BadValue,
+          "bend 8192");
+
+    ControlParameter entries[2] = {{0, 10.0f}, {0, 0.0f}};
+    check(sendFrame(fd, params, 0, entries, sizeof(entries) - 4), ControlMessage::Parameters,
+          ControlErrorCode::BadLength, "partial parameter");
+    entries[1].id = static_cast<std::uint32_t>(ParameterBlock::kCount);
+    check(sendFrame(fd, params, 0, entries, sizeof(entries)), ControlMessage::Parameters,
+          ControlErrorCode::BadValue, "parameter id out of range");
+    entries[1] = {0, std::numeric_limits<float>::quiet_NaN()};
+    check(sendFrame(fd, params, 0, entries, sizeof(entries)), ControlMessage::Parameters,
+          ControlErrorCode::BadValue, "NaN parameter");
+
+    const char escape[] = "../etc/passwd";
+    check(sendFrame(fd, preset, 0, escape, sizeof(escape) - 1), ControlMessage::Preset,
+          ControlErrorCode::PresetFailed, "preset path");
+    check(sendFrame(fd, 0x42, 0, nullptr, 0), static_cast<ControlMessage>(0x42), ControlErrorCode::UnknownMessage,
+          "unknown type");
+
+    // A valid note gets no reply, so the next reply is the stats
+    ok = ok && sendFrame(fd, noteOn, 0, &note, sizeof(note));
+    ok = ok && sendFrame(fd, static_cast<std::uint8_t>(ControlMessage::StatsRequest), 0, nullptr, 0);
+    ControlFrameHeader header{};
+    std::vector<std::uint8_t> payload;
+    ControlStats stats{};
+    if (ok && receiveFrame(fd, header, payload) && header.type == static_cast<std::uint8_t>(ControlMessage::Stats) &&
+        payload.size() == sizeof(stats)) {
+        std::memcpy(&stats, payload.data(), sizeof(stats));
+        if (stats.protocolErrors != rejected || stats.messages != rejected + 2) {
+            ok = fail("stats count " + std::to_string(stats.protocolErrors) + " errors, " +
+                      std::to_string(stats.messages) + " messages");
+        }
+    } else if (ok) {
+        ok = fail("valid note answered, or no stats reply");
+    }
+
+    // An oversized frame cannot be skipped: error, then the connection closes
+    if (ok) {
+        const ControlFrameHeader huge{noteOn, 0, static_cast<std::uint16_t>(ControlProtocol::kMaxPayload + 1)};
+        ok = ::send(fd, &huge, sizeof(huge), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(huge)) &&
+             expectError(fd, ControlMessage::NoteOn, ControlErrorCode::FrameTooLarge, "oversized frame");
+        std::uint8_t byte = 0;
+        if (ok && ::recv(fd, &byte, 1, 0) != 0) {
+            ok = fail("connection left open after an oversized frame");
+        }
+    }
+
+    ::close(fd);
+    server.Stop();
+    return ok;
+}
+
+// Shared memory names the client left behind for this process
+int leftoverHostMappings() {
+    const std::string prefix = "audioEngine-" + std::to_string(static_cast<long>(::getpid())) + "-";
+    int count = 0;
+    if (DIR* dir = ::opendir("/dev/shm")) {
+        while (dirent* entry = ::readdir(dir)) {
+            if (std::strncmp(entry->d_name, prefix.c_str(), prefix.size()) == 0) {
+                count++;
+            }
+        }
+        ::closedir(dir);
+    }
+    return count;
+}
+
+bool testEngineHostStartupFailure() {
+    // The host accepts a mapping with this build's layout
+    const std::string name = "/audioEngineTest-" + std::to_string(::getpid());
+    SharedMemory memory = SharedMemory::create(name, sizeof(EngineHostShared));
+    memory.unlink();
+    EngineHostShared* shared =
+        new (memory.data()) EngineHostShared(48000.0f, 256, false, EffectPool::defaultLimits());
+    {
+        AudioSystem audio(48000.0f);
+        EngineHost host(*shared, audio, nullptr);
+    }
+
+    // ...and refuses one written by another version
+    const std::uint32_t otherVersion = EngineHostShared::kVersion + 1;
+    std::memcpy(const_cast<std::uint32_t*>(&shared->version), &otherVersion, sizeof(otherVersion));
+    bool refused = false;
+    try {
+        AudioSystem audio(48000.0f);
+        EngineHost host(*shared, audio, nullptr);
+    } catch (const std::runtime_error&) {
+        refused = true;
+    }
+    shared->~EngineHostShared();
+    if (!refused) {
+        return fail("host accepted a mismatched layout");
+    }
+
+    // The client reports a binary that cannot start, and one that exits early
+    const std::pair<const char*, const char*> failures[] = {
+        {"/nonexistent/audioEngineHost", "Cannot start engine host"},
+        {"/bin/false", "Engine host failed to start"},
+    };
+    for (const auto& failure : failures) {
+        try {
+            EngineHostClient client(failure.first, 48000.0f, 256, false);
+            return fail(std::string(failure.first) + " reported as started");
+        } catch (const std::runtime_error& e) {
+            if (std::string(e.what()).find(failure.second) != 0) {
+                return fail(std::string(failure.first) + ": " + e.what());
+            }
+        }
+    }
+    if (leftoverHostMappings() != 0) {
+        return fail("failed starts left shared memory behind");
+    }
+
+    return true;
+}
+
+void printHeader() {
+    std::cout << Colors::BOLD << Colors::CYAN;
+    std::cout << "╔══════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "║                     ENGINE TEST SUITE                        ║" << std::endl;
+    std::cout << "╚══════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << Colors::RESET << std::endl;
+}
+
+int main() {
+    printHeader();
+
+    TestFramework framework;
+
+    std::cout << Colors::BOLD << Colors::MAGENTA << "🧪 Starting engine tests..." << Colors::RESET << std::endl << std::endl;
+
+    framework.runTest("CommandQueue Under Producer/Consumer Contention", testCommandQueueContention);
+    framework.runTest("TripleBuffer Under Writer/Reader Contention", testTripleBufferContention);
+    framework.runTest("EffectSlot Bypass Crossfade", testEffectSlotCrossfade);
+    framework.runTest("EffectSlot Keep-Warm and Shedding", testEffectSlotKeepWarm);
+    framework.runTest("EffectSlot Mono/Stereo Fallback", testEffectSlotStereoFallback);
+    framework.runTest("SpectralEffect Worker Hand-off", testSpectralWorkerHandOff);
+    framework.runTest("LookaheadLimiter Ceiling", testLimiterCeiling);
+    framework.runTest("LookaheadLimiter Lookahead Ramp", testLimiterLookahead);
+    framework.runTest("SampleConverter Clipping and Packing", testSampleConverterClipping);
+    framework.runTest("SampleConverter Dither", testSampleConverterDither);
+    framework.runTest("ControlServer Decode Rejection", testControlDecodeRejection);
+    framework.runTest("EngineHost Startup Failure", testEngineHostStartupFailure);
+
+    std::cout << std::endl;
+    framework.printSummary();
+
+    return framework.allPassed() ? 0 : 1;
+}
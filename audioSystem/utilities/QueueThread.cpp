@@ -1,4 +1,5 @@
 #include "QueueThread.h"
+#include "Trace.h"
 #include <iostream>
 
 
@@ -56,6 +57,8 @@ void QueueThread::thread()
 
         // Execute task with exception handling
         if (task) {
+            TRACE_THREAD_NAME("QueueThread");
+            TRACE_ZONE("QueueThread task");
             try {
                 task();
             } catch (const std::exception& e) {
@@ -0,0 +1,284 @@
+#include "Trace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <unistd.h>
+
+
+
+namespace Trace
+{
+    namespace detail
+    {
+        std::atomic<bool> g_enabled(false);
+    }
+
+    namespace
+    {
+        /**
+         * @brief Single-producer, single-consumer event ring owned by one thread
+         */
+        struct Ring
+        {
+            alignas(64) std::atomic<std::uint32_t>  head{0U};           // Next write (owning thread)
+            alignas(64) std::atomic<std::uint32_t>  tail{0U};           // Next read (dumper)
+            std::atomic<const char*>                name{nullptr};      // Thread label
+            std::atomic<std::uint32_t>              dropped{0U};        // Events lost to a full ring
+            Event                                   events[kRingEvents];
+        };
+
+        static_assert((kRingEvents & (kRingEvents - 1U)) == 0U, "Ring size must be a power of two");
+
+        /**
+         * @brief One entry of the thread table; its ring outlives the threads that use it
+         */
+        struct Slot
+        {
+            std::atomic<Ring*>  ring{nullptr};      // Allocated by the first thread to claim the slot, never freed
+            std::atomic<bool>   owned{false};       // A live thread records into the ring
+        };
+
+        Slot                        g_slots[kMaxThreads];
+        std::atomic<std::uint32_t>  g_unclaimedDrops(0U);              // Events from threads beyond kMaxThreads
+        std::atomic<bool>           g_dumperActive(false);
+
+        /**
+         * @brief Holds the calling thread's slot and hands it back when the thread exits
+         */
+        struct RingOwner
+        {
+            Slot*   slot = nullptr;
+
+            ~RingOwner()
+            {
+                if (slot != nullptr)
+                {
+                    // Events not drained yet stay in the ring for the dumper
+                    slot->ring.load(std::memory_order_relaxed)->name.store(nullptr, std::memory_order_relaxed);
+                    slot->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local RingOwner      t_owner;
+
+        /// The calling thread's ring, claimed on first use; nullptr while every slot is owned
+        Ring* threadRing()
+        {
+            if (t_owner.slot == nullptr)
+            {
+                for (Slot& slot : g_slots)
+                {
+                    bool expected = false;
+                    if (!slot.owned.load(std::memory_order_relaxed) &&
+                        slot.owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    {
+                        if (slot.ring.load(std::memory_order_relaxed) == nullptr)
+                        {
+                            // Ring is cache-line aligned, which plain new does not honour before C++17
+                            void* storage = nullptr;
+                            if (::posix_memalign(&storage, alignof(Ring), sizeof(Ring)) != 0)
+                            {
+                                slot.owned.store(false, std::memory_order_release);
+                                return nullptr;
+                            }
+                            slot.ring.store(new (storage) Ring(), std::memory_order_release);
+                        }
+                        t_owner.slot = &slot;
+                        break;
+                    }
+                }
+                if (t_owner.slot == nullptr)
+                {
+                    return nullptr;
+                }
+            }
+            return t_owner.slot->ring.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t nowNanos()
+    {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<std::uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<std::uint64_t>(now.tv_nsec);
+    }
+
+    void record(const char* name, std::uint64_t beginNanos, std::uint64_t endNanos)
+    {
+        Ring* ring = threadRing();
+        if (ring == nullptr)
+        {
+            g_unclaimedDrops.fetch_add(1U, std::memory_order_relaxed);
+            return;
+        }
+
+        const std::uint32_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->tail.load(std::memory_order_acquire) >= kRingEvents)
+        {
+            ring->dropped.fetch_add(1U, std::memory_order_relaxed);
+            return;
+        }
+
+        ring->events[head & (kRingEvents - 1U)] = Event{name, beginNanos, endNanos};
+        ring->head.store(head + 1U, std::memory_order_release);
+    }
+
+    void setThreadName(const char* name)
+    {
+        Ring* ring = threadRing();
+        if (ring != nullptr)
+        {
+            ring->name.store(name, std::memory_order_relaxed);
+        }
+    }
+
+
+
+    TraceDumper::TraceDumper(const std::string& path, std::chrono::milliseconds interval)
+        : m_file(nullptr), m_origin(nowNanos()), m_first(true), m_threadNames()
+    {
+        if (g_dumperActive.exchange(true))
+        {
+            throw std::runtime_error("A trace is already being written");
+        }
+
+        m_file = std::fopen(path.c_str(), "w");
+        if (m_file == nullptr)
+        {
+            g_dumperActive.store(false);
+            throw std::runtime_error("Cannot open trace file " + path + ": " + std::string(strerror(errno)));
+        }
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", m_file);
+
+        // Skip whatever was recorded by an earlier dumper
+        for (Slot& slot : g_slots)
+        {
+            Ring* ring = slot.ring.load(std::memory_order_acquire);
+            if (ring != nullptr)
+            {
+                ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+            }
+        }
+
+        detail::g_enabled.store(true, std::memory_order_relaxed);
+        SetTimer(interval, interval);
+        Start();
+    }
+
+    TraceDumper::~TraceDumper()
+    {
+        detail::g_enabled.store(false, std::memory_order_relaxed);
+        Stop();
+        drain();
+
+        std::uint32_t dropped = g_unclaimedDrops.exchange(0U);
+        for (Slot& slot : g_slots)
+        {
+            Ring* ring = slot.ring.load(std::memory_order_acquire);
+            if (ring != nullptr)
+            {
+                dropped += ring->dropped.exchange(0U);
+            }
+        }
+        if (dropped > 0U)
+        {
+            std::cerr << "Trace: " << dropped << " events dropped (rings full or too many threads)" << std::endl;
+        }
+
+        std::fputs("\n]}\n", m_file);
+        std::fclose(m_file);
+        g_dumperActive.store(false);
+    }
+
+    std::unique_ptr<TraceDumper> TraceDumper::fromEnvironment()
+    {
+        const char* path = std::getenv("AUDIO_TRACE");
+        if (path == nullptr || path[0] == '\0')
+        {
+            return nullptr;
+        }
+
+#if defined(AUDIO_TRACE_ENABLED) && AUDIO_TRACE_ENABLED
+        try
+        {
+            std::unique_ptr<TraceDumper> dumper(new TraceDumper(path));
+            std::cout << "Tracing to " << path << std::endl;
+            return dumper;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Warning: tracing disabled: " << e.what() << std::endl;
+            return nullptr;
+        }
+#else
+        std::cerr << "Warning: AUDIO_TRACE is set but trace zones were not compiled in (ENABLE_TRACING)" << std::endl;
+        return nullptr;
+#endif
+    }
+
+    void TraceDumper::onTimeout()
+    {
+        drain();
+    }
+
+    void TraceDumper::drain()
+    {
+        const int pid = static_cast<int>(getpid());
+        char json[256];
+
+        for (std::uint32_t index = 0; index < kMaxThreads; ++index)
+        {
+            Ring* slotRing = g_slots[index].ring.load(std::memory_order_acquire);
+            if (slotRing == nullptr)
+            {
+                continue;
+            }
+            Ring& ring = *slotRing;
+            const unsigned int tid = index + 1U;
+
+            const char* name = ring.name.load(std::memory_order_relaxed);
+            if (name != nullptr && name != m_threadNames[index])
+            {
+                m_threadNames[index] = name;
+                std::snprintf(json, sizeof(json),
+                              "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                              pid, tid, name);
+                writeEvent(json);
+            }
+
+            const std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+            const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+            for (std::uint32_t position = tail; position != head; ++position)
+            {
+                const Event& event = ring.events[position & (kRingEvents - 1U)];
+                if (event.beginNanos < m_origin)
+                {
+                    continue;
+                }
+                std::snprintf(json, sizeof(json),
+                              "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                              event.name, pid, tid,
+                              static_cast<double>(event.beginNanos - m_origin) / 1000.0,
+                              static_cast<double>(event.endNanos - event.beginNanos) / 1000.0);
+                writeEvent(json);
+            }
+            ring.tail.store(head, std::memory_order_release);
+        }
+
+        std::fflush(m_file);
+    }
+
+    void TraceDumper::writeEvent(const char* json)
+    {
+        if (!m_first)
+        {
+            std::fputs(",\n", m_file);
+        }
+        m_first = false;
+        std::fputs(json, m_file);
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include "TimerFd.h"
+
+/**
+ * @file Trace.h
+ * @brief Scoped trace zones written to per-thread rings, exported as a Chrome trace
+ *
+ * TRACE_ZONE("name") records the time spent in the enclosing scope and
+ * TRACE_THREAD_NAME("name") labels the calling thread. Both compile to
+ * nothing unless AUDIO_TRACE_ENABLED is defined to 1 (CMake option
+ * ENABLE_TRACING). Zone and thread names must be string literals or
+ * otherwise outlive the trace; only the pointer is recorded.
+ *
+ * A zone costs two clock reads and one store into the calling thread's
+ * single-producer ring, and nothing but a relaxed load while no
+ * TraceDumper is running. A thread's ring is allocated the first time it
+ * records and goes back to a shared table when the thread exits, so a
+ * later thread reuses it. The dumper drains every ring from its own
+ * thread and writes Chrome trace_event JSON, which chrome://tracing and
+ * ui.perfetto.dev both open. Events that find their ring full are counted
+ * and dropped, never waited for.
+ */
+namespace Trace
+{
+    constexpr std::size_t kRingEvents = 8192;      // Events per thread between drains
+    constexpr std::size_t kMaxThreads = 32;        // Threads that can record at once; others are dropped
+
+    /**
+     * @struct Event
+     * @brief One completed zone
+     */
+    struct Event
+    {
+        const char*     name;           // Zone name (static storage)
+        std::uint64_t   beginNanos;     // Monotonic clock at scope entry
+        std::uint64_t   endNanos;       // Monotonic clock at scope exit
+    };
+
+    /**
+     * @brief Monotonic clock in nanoseconds, the time base of every event
+     */
+    std::uint64_t nowNanos          ();
+
+    namespace detail
+    {
+        extern std::atomic<bool> g_enabled;
+    }
+
+    /**
+     * @brief True while a TraceDumper is collecting events
+     */
+    inline bool enabled             ()
+    {
+        return detail::g_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record a completed zone in the calling thread's ring
+     */
+    void record                     ( const char* name, std::uint64_t beginNanos, std::uint64_t endNanos );
+
+    /**
+     * @brief Label the calling thread in the trace
+     */
+    void setThreadName              ( const char* name );
+
+    /**
+     * @class Zone
+     * @brief Records the lifetime of a scope; use through TRACE_ZONE
+     */
+    class Zone
+    {
+    public:
+
+        explicit Zone               ( const char* name )
+            : m_name(name), m_begin(enabled() ? nowNanos() : 0U) {}
+
+        ~Zone                       ()
+        {
+            if (m_begin != 0U)
+            {
+                record(m_name, m_begin, nowNanos());
+            }
+        }
+
+        Zone                        ( const Zone& ) = delete;
+        Zone& operator=             ( const Zone& ) = delete;
+
+    private:
+
+        const char*     m_name;         // Zone name (static storage)
+        std::uint64_t   m_begin;        // Entry time, 0 when tracing was off at entry
+    };
+
+    /**
+     * @class TraceDumper
+     * @brief Periodically drains every thread's ring into a Chrome trace file
+     *
+     * Collection starts when the dumper is constructed and stops when it
+     * is destroyed, which also completes the JSON. Only one dumper may
+     * exist at a time.
+     */
+    class TraceDumper : public TimerFd
+    {
+    public:
+
+        /**
+         * @brief Open the trace file and start collecting
+         * @param path Output file, overwritten
+         * @param interval How often the rings are drained; rings hold kRingEvents each
+         * @throws std::runtime_error if the file cannot be opened or a dumper already runs
+         */
+        explicit TraceDumper        ( const std::string& path,
+                                      std::chrono::milliseconds interval = std::chrono::milliseconds(100) );
+
+        /**
+         * @brief Stop collecting, write the remaining events and close the file
+         */
+        ~TraceDumper                ();
+
+        /**
+         * @brief Start a dumper writing to $AUDIO_TRACE, if that is set
+         * @return The running dumper, or nullptr when the variable is unset,
+         *         tracing is compiled out, or the file cannot be opened
+         */
+        static std::unique_ptr<TraceDumper> fromEnvironment ();
+
+    protected:
+
+        void onTimeout              () override;
+
+    private:
+
+        /// Write every event collected so far
+        void drain                  ();
+
+        /// Append one JSON object to the event array
+        void writeEvent             ( const char* json );
+
+        std::FILE*      m_file;                         // Trace output
+        std::uint64_t   m_origin;                       // Clock at construction, timestamp zero in the file
+        bool            m_first;                        // No event written yet (comma handling)
+        const char*     m_threadNames[kMaxThreads];     // Name last written for each ring
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if defined(AUDIO_TRACE_ENABLED) && AUDIO_TRACE_ENABLED
+#define TRACE_ZONE(name) ::Trace::Zone TRACE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) ::Trace::setThreadName(name)
+#else
+#define TRACE_ZONE(name) static_cast<void>(0)
+#define TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+#endif /* TRACE_H */
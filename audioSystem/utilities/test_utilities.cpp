@@ -6,6 +6,12 @@
 #include <atomic>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
 
 // Include all utility headers
 #include "IObserver.h"
@@ -390,6 +396,325 @@ bool testThreadSafety() {
     return true;
 }
 
+// ============================================================================
+// Benchmark mode (--bench [file.json])
+//
+// Measures the primitives rather than checking them, so replacements can be
+// compared against the current implementations. Progress goes to stderr and
+// the results are written as JSON to the given file, or to stdout.
+// ============================================================================
+
+using BenchClock = std::chrono::steady_clock;
+
+double elapsedMicros(BenchClock::time_point from, BenchClock::time_point to) {
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+// Summary of a set of samples (microseconds unless stated otherwise)
+struct BenchStats {
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+BenchStats summarize(std::vector<double> samples) {
+    BenchStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double fraction) {
+        size_t index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+        return samples[index];
+    };
+
+    double sum = 0.0;
+    for (double value : samples) {
+        sum += value;
+    }
+
+    stats.count = samples.size();
+    stats.mean = sum / static_cast<double>(samples.size());
+    stats.p50 = at(0.50);
+    stats.p90 = at(0.90);
+    stats.p99 = at(0.99);
+    stats.max = samples.back();
+    return stats;
+}
+
+std::string statsJson(const BenchStats& stats) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3)
+        << "{\"count\": " << stats.count
+        << ", \"mean\": " << stats.mean
+        << ", \"p50\": " << stats.p50
+        << ", \"p90\": " << stats.p90
+        << ", \"p99\": " << stats.p99
+        << ", \"max\": " << stats.max << "}";
+    return out.str();
+}
+
+void benchProgress(const std::string& name, const BenchStats& stats, const std::string& unit) {
+    std::cerr << Colors::BLUE << "  " << std::left << std::setw(34) << name << Colors::RESET
+              << std::fixed << std::setprecision(2)
+              << " p50 " << std::setw(9) << stats.p50
+              << " p99 " << std::setw(9) << stats.p99
+              << " max " << std::setw(9) << stats.max << " " << unit << std::endl;
+}
+
+// Wait until an atomic counter reaches a target, yielding meanwhile
+void waitForCount(const std::atomic<size_t>& counter, size_t target) {
+    while (counter.load() < target) {
+        std::this_thread::yield();
+    }
+}
+
+// QueueThread: put() -> execution latency, idle and under producer contention
+std::string benchQueueThread() {
+    std::ostringstream json;
+
+    // Idle latency: one producer, spaced puts so the worker is asleep on each one
+    const size_t idleTasks = 2000;
+    std::vector<double> idleLatency;
+    idleLatency.reserve(idleTasks);
+    {
+        QueueThread queue;
+        std::atomic<size_t> done{0};
+        for (size_t i = 0; i < idleTasks; ++i) {
+            queue.put([&idleLatency, &done, posted = BenchClock::now()]() {
+                idleLatency.push_back(elapsedMicros(posted, BenchClock::now()));
+                done++;
+            });
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        waitForCount(done, idleTasks);
+    }
+    BenchStats idle = summarize(idleLatency);
+    benchProgress("QueueThread idle put->run", idle, "us");
+
+    json << "{\"idle_latency_us\": " << statsJson(idle) << ", \"contention\": [";
+
+    // Contention: several producers flooding one queue
+    const size_t totalTasks = 200000;
+    const size_t producerCounts[] = {1, 2, 4, 8};
+    bool first = true;
+    for (size_t producers : producerCounts) {
+        const size_t perProducer = totalTasks / producers;
+        const size_t expected = perProducer * producers;
+        std::vector<double> latency;
+        latency.reserve(expected);
+        std::atomic<size_t> done{0};
+        double seconds = 0.0;
+
+        {
+            QueueThread queue;
+            std::atomic<bool> go{false};
+            std::vector<std::thread> threads;
+            for (size_t p = 0; p < producers; ++p) {
+                threads.emplace_back([&]() {
+                    while (!go) {
+                        std::this_thread::yield();
+                    }
+                    for (size_t i = 0; i < perProducer; ++i) {
+                        queue.put([&latency, &done, posted = BenchClock::now()]() {
+                            latency.push_back(elapsedMicros(posted, BenchClock::now()));
+                            done++;
+                        });
+                    }
+                });
+            }
+
+            auto start = BenchClock::now();
+            go = true;
+            for (auto& t : threads) {
+                t.join();
+            }
+            waitForCount(done, expected);
+            seconds = elapsedMicros(start, BenchClock::now()) / 1e6;
+        }
+
+        BenchStats stats = summarize(latency);
+        const double tasksPerSecond = static_cast<double>(expected) / seconds;
+        benchProgress("QueueThread " + std::to_string(producers) + " producer(s) put->run", stats, "us");
+        std::cerr << "    " << std::fixed << std::setprecision(0) << tasksPerSecond << " tasks/s" << std::endl;
+
+        json << (first ? "" : ", ") << std::fixed << std::setprecision(1)
+             << "{\"producers\": " << producers
+             << ", \"tasks\": " << expected
+             << ", \"tasks_per_sec\": " << tasksPerSecond
+             << ", \"latency_us\": " << statsJson(stats) << "}";
+        first = false;
+    }
+
+    json << "]}";
+    return json.str();
+}
+
+// Subject::notify cost as the number of observers grows
+std::string benchSubject() {
+    std::ostringstream json;
+    json << "[";
+
+    const size_t observerCounts[] = {1, 4, 16, 64, 256};
+    bool first = true;
+    for (size_t count : observerCounts) {
+        Subject subject;
+        std::vector<std::unique_ptr<TestObserver>> observers;
+        for (size_t i = 0; i < count; ++i) {
+            observers.emplace_back(new TestObserver());
+            subject.attach(observers.back().get());
+        }
+
+        // Median of several batches, in nanoseconds per notify()
+        const size_t iterations = std::max<size_t>(1000, 200000 / count);
+        std::vector<double> batches;
+        int value = 0;
+        for (int batch = 0; batch < 9; ++batch) {
+            auto start = BenchClock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                subject.notify(&value);
+            }
+            batches.push_back(elapsedMicros(start, BenchClock::now()) * 1000.0 / static_cast<double>(iterations));
+        }
+
+        BenchStats stats = summarize(batches);
+        benchProgress("Subject::notify " + std::to_string(count) + " observer(s)", stats, "ns");
+
+        json << (first ? "" : ", ") << std::fixed << std::setprecision(2)
+             << "{\"observers\": " << count
+             << ", \"ns_per_notify\": " << stats.p50
+             << ", \"ns_per_observer\": " << stats.p50 / static_cast<double>(count) << "}";
+        first = false;
+    }
+
+    json << "]";
+    return json.str();
+}
+
+// Timer that records the time of every expiration
+class JitterTimer : public TimerFd {
+public:
+    explicit JitterTimer(size_t expected) { wakeups.reserve(expected); }
+
+    void onTimeout() override {
+        if (wakeups.size() < wakeups.capacity()) {
+            wakeups.push_back(BenchClock::now());
+        }
+    }
+
+    std::vector<BenchClock::time_point> wakeups;
+};
+
+// TimerFd wake-up jitter: deviation of each interval from the period
+std::string benchTimerFd() {
+    std::ostringstream json;
+    json << "[";
+
+    const int periods[] = {1, 2, 5, 10};
+    const size_t wakeupsPerPeriod = 300;
+    bool first = true;
+    for (int periodMs : periods) {
+        JitterTimer timer(wakeupsPerPeriod);
+        timer.SetTimer(std::chrono::milliseconds(periodMs), std::chrono::milliseconds(periodMs));
+        timer.Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(periodMs * static_cast<int>(wakeupsPerPeriod + 5)));
+        timer.Stop();
+
+        std::vector<double> jitter;
+        const double periodUs = periodMs * 1000.0;
+        for (size_t i = 1; i < timer.wakeups.size(); ++i) {
+            const double interval = elapsedMicros(timer.wakeups[i - 1], timer.wakeups[i]);
+            jitter.push_back(interval > periodUs ? interval - periodUs : periodUs - interval);
+        }
+
+        BenchStats stats = summarize(jitter);
+        benchProgress("TimerFd " + std::to_string(periodMs) + " ms jitter", stats, "us");
+
+        json << (first ? "" : ", ")
+             << "{\"period_ms\": " << periodMs
+             << ", \"wakeups\": " << timer.wakeups.size()
+             << ", \"jitter_us\": " << statsJson(stats) << "}";
+        first = false;
+    }
+
+    json << "]";
+    return json.str();
+}
+
+// Thread that exits as soon as it is asked to, so stop() measures the join itself
+class IdleThread : public ThreadBase {
+public:
+    void thread() override {
+        while (m_running) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// ThreadBase start()/stop() cost over repeated cycles on one object
+std::string benchThreadBase() {
+    const size_t cycles = 500;
+    std::vector<double> startCost;
+    std::vector<double> stopCost;
+    startCost.reserve(cycles);
+    stopCost.reserve(cycles);
+
+    IdleThread idle;
+    for (size_t i = 0; i < cycles; ++i) {
+        auto before = BenchClock::now();
+        idle.start();
+        auto started = BenchClock::now();
+        idle.stop();
+        auto stopped = BenchClock::now();
+        startCost.push_back(elapsedMicros(before, started));
+        stopCost.push_back(elapsedMicros(started, stopped));
+    }
+
+    BenchStats start = summarize(startCost);
+    BenchStats stop = summarize(stopCost);
+    benchProgress("ThreadBase::start", start, "us");
+    benchProgress("ThreadBase::stop", stop, "us");
+
+    std::ostringstream json;
+    json << "{\"cycles\": " << cycles
+         << ", \"start_us\": " << statsJson(start)
+         << ", \"stop_us\": " << statsJson(stop) << "}";
+    return json.str();
+}
+
+int runBenchmarks(const char* outputPath) {
+    std::cerr << Colors::BOLD << Colors::MAGENTA << "⏱  Benchmarking utilities..." << Colors::RESET << std::endl;
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"schema\": 1,\n"
+         << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n"
+         << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n"
+         << "  \"queue_thread\": " << benchQueueThread() << ",\n"
+         << "  \"subject_notify\": " << benchSubject() << ",\n"
+         << "  \"timer_fd\": " << benchTimerFd() << ",\n"
+         << "  \"thread_base\": " << benchThreadBase() << "\n"
+         << "}\n";
+
+    if (outputPath == nullptr) {
+        std::cout << json.str();
+        return 0;
+    }
+
+    std::ofstream file(outputPath);
+    if (!file) {
+        std::cerr << Colors::RED << "Cannot write " << outputPath << Colors::RESET << std::endl;
+        return 1;
+    }
+    file << json.str();
+    std::cerr << Colors::GREEN << "Results written to " << outputPath << Colors::RESET << std::endl;
+    return 0;
+}
+
 void printHeader() {
     std::cout << Colors::BOLD << Colors::CYAN << std::endl;
     std::cout << "╔══════════════════════════════════════════════════════════════╗" << std::endl;
@@ -399,7 +724,11 @@ void printHeader() {
     std::cout << Colors::RESET << std::endl;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        return runBenchmarks(argc > 2 ? argv[2] : nullptr);
+    }
+
     printHeader();
     
     TestFramework framework;